@@ -2,9 +2,15 @@
 #include "../common/AppConfig.h"
 #include "../data/DatabaseManager.h"
 #include "../service/DownloadService.h"
+#include "../common/StartupProfiler.h"
+#include "../common/StallWatchdog.h"
+#include "../common/SessionJournal.h"
+#include "../ui/themes/ThemeManager.h"
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
 #include <QCoreApplication>
+#include <QThreadPool>
 
 BiliMusicPlayerApp::BiliMusicPlayerApp(QObject* parent)
     : QObject(parent)
@@ -19,6 +25,8 @@ BiliMusicPlayerApp::BiliMusicPlayerApp(QObject* parent)
 
 BiliMusicPlayerApp::~BiliMusicPlayerApp()
 {
+    StallWatchdog::instance().stop();
+    SessionJournal::instance().close();
     if (m_downloadService) {
         delete m_downloadService;
         m_downloadService = nullptr;
@@ -37,16 +45,33 @@ bool BiliMusicPlayerApp::initialize() {
     qDebug() << "✅ 配置加载成功:" << config.getConfigFilePath();
     qDebug() << "📊 数据库路径:" << config.getDatabasePath();
     qDebug() << "📁 下载路径:" << config.getDownloadPath();
+    StartupProfiler::mark("配置加载");
+
+    // 卡顿日志、会话日志与配置文件放在同一目录
+    const QDir configDir = QFileInfo(config.getConfigFilePath()).absoluteDir();
+    StallWatchdog::instance().start(config.getStallThresholdMs(), configDir.filePath("stall.log"));
+    openSessionJournal(configDir.filePath("session.journal"));
+
+    // 以下几步互不依赖：主题读取编译、下载目录检查放到后台线程，与主线程的数据库打开并行
+    // （数据库连接只能在创建它的线程使用，因此留在主线程）
+    ThemeManager::instance().preloadAsync(config.getTheme());
+    const QString downloadPath = config.getDownloadPath();
+    QThreadPool::globalInstance()->start([downloadPath]() {
+        ensureDownloadDirectory(downloadPath);
+        StartupProfiler::mark("下载目录检查");
+        });
 
     if (!initializeDatabase()) {
         qCritical() << "数据库初始化失败";
         return false;
     }
+    StartupProfiler::mark("数据库打开与迁移");
 
     if (!initializeServices()) {
         qCritical() << "服务初始化失败";
         return false;
     }
+    StartupProfiler::mark("服务初始化");
 
     qDebug() << "✅ BiliMusicPlayer 初始化成功";
     return true;
@@ -71,9 +96,32 @@ bool BiliMusicPlayerApp::initializeDatabase() {
 bool BiliMusicPlayerApp::initializeServices() {
     qDebug() << "初始化服务...";
 
-    AppConfig& config = AppConfig::instance();
+    m_downloadService = new DownloadService(this);
 
-    QString downloadPath = config.getDownloadPath();
+    qDebug() << "✅ 下载服务初始化成功";
+
+    qDebug() << "✅ 服务初始化成功";
+    return true;
+}
+
+void BiliMusicPlayerApp::openSessionJournal(const QString& path) {
+    SessionJournal& journal = SessionJournal::instance();
+    journal.open(path);
+    if (journal.hasState()) return;
+
+    // 首次使用会话日志：迁移旧版本写在配置文件里的会话状态
+    const AppConfig& config = AppConfig::instance();
+    if (config.getLastPlaylistIds().isEmpty() && config.getLastSongId().isEmpty()) return;
+
+    journal.setPlaylistIds(config.getLastPlaylistIds());
+    journal.setQueueIds(config.getLastQueueIds());
+    journal.setLastSongId(config.getLastSongId());
+    journal.setLastPositionMs(config.getLastPositionMs());
+    journal.setVolume(config.getPlayerVolume());
+    qDebug() << "📒 已从配置文件迁移会话状态到会话日志";
+}
+
+void BiliMusicPlayerApp::ensureDownloadDirectory(const QString& downloadPath) {
     QDir downloadDir(downloadPath);
     if (!downloadDir.exists()) {
         qDebug() << "📁 下载目录不存在，正在创建:" << downloadPath;
@@ -87,13 +135,6 @@ bool BiliMusicPlayerApp::initializeServices() {
     else {
         qDebug() << "📁 下载目录已存在:" << downloadDir.absolutePath();
     }
-
-    m_downloadService = new DownloadService(this);
-
-    qDebug() << "✅ 下载服务初始化成功";
-
-    qDebug() << "✅ 服务初始化成功";
-    return true;
 }
 
 void BiliMusicPlayerApp::setupLogging() {
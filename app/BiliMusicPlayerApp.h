@@ -18,6 +18,8 @@ private:
     bool initializeDatabase();
     bool initializeServices();
     void setupLogging();
+    static void ensureDownloadDirectory(const QString& downloadPath);
+    static void openSessionJournal(const QString& path);
 
     DownloadService* m_downloadService;
 };
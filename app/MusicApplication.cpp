@@ -0,0 +1,13 @@
+#include "MusicApplication.h"
+#include "../common/StallWatchdog.h"
+
+MusicApplication::MusicApplication(int& argc, char** argv)
+    : QApplication(argc, argv)
+{
+}
+
+bool MusicApplication::notify(QObject* receiver, QEvent* event)
+{
+    StallWatchdog::Scope scope(receiver, event);
+    return QApplication::notify(receiver, event);
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <QApplication>
+
+/**
+ * @brief 应用对象：在事件分发外层挂上卡顿看门狗的帧栈记录
+ *
+ * 只重写 notify，每个事件多两次原子写，其余行为与 QApplication 完全相同。
+ */
+class MusicApplication : public QApplication {
+    Q_OBJECT
+
+public:
+    MusicApplication(int& argc, char** argv);
+
+    bool notify(QObject* receiver, QEvent* event) override;
+};
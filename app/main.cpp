@@ -2,14 +2,20 @@
 #include <QDebug>
 #include <QFile>
 #include <QStringList>
+#include <QTimer>
 #include "BiliMusicPlayerApp.h"
+#include "MusicApplication.h"
+#include "../common/StartupProfiler.h"
 #include "../ui/windows/MainWindow.h"
 
 int main(int argc, char* argv[])
 {
+    StartupProfiler::start();
+
     QApplication::setHighDpiScaleFactorRoundingPolicy(Qt::HighDpiScaleFactorRoundingPolicy::PassThrough);
 
-    QApplication app(argc, argv);
+    MusicApplication app(argc, argv);
+    StartupProfiler::mark("QApplication 创建");
 
     // 创建应用管理器
     BiliMusicPlayerApp appManager;
@@ -22,12 +28,29 @@ int main(int argc, char* argv[])
 
     // 创建主窗口
     MainWindow mainWindow;
+    StartupProfiler::mark("主窗口构建");
 
-    // 将应用管理器实例传递给主窗口
+    // 将应用管理器实例传递给主窗口（只构建首屏页面，其余页面首次切换时再构建）
     mainWindow.setApp(&appManager);
+    StartupProfiler::mark("首屏页面构建");
 
-    // 显示主窗口
+    // 显示主窗口；第一次绘制完成后输出启动耗时汇总
+    StartupProfiler::watchFirstFrame(&mainWindow);
     mainWindow.show();
+    StartupProfiler::mark("窗口显示");
+
+    // --benchmark-theme[=N]：窗口就绪后测量主题切换耗时（默认 20 次），完成后退出
+    const QStringList args = app.arguments();
+    for (const QString& arg : args) {
+        if (arg == "--benchmark-theme" || arg.startsWith("--benchmark-theme=")) {
+            const int rounds = arg.contains('=') ? qMax(1, arg.section('=', 1).toInt()) : 20;
+            QTimer::singleShot(0, &mainWindow, [&mainWindow, rounds]() {
+                mainWindow.runThemeSwitchBenchmark(rounds);
+                QApplication::quit();
+            });
+            break;
+        }
+    }
 
     return app.exec();
 }
\ No newline at end of file
@@ -30,6 +30,26 @@ AppConfig& AppConfig::instance() {
 
 AppConfig::AppConfig() : QObject(nullptr) {
     setDefaultValues();
+    publishSnapshot();
+}
+
+// ========== 只读快照 ==========
+ConfigSnapshot AppConfig::snapshot() const {
+    return m_snapshot.load(std::memory_order_acquire);
+}
+
+void AppConfig::publishSnapshot() {
+    auto snap = std::make_shared<AppConfigSnapshot>();
+    snap->version = ++m_snapshotVersion;
+    snap->downloadPath = m_downloadPath;
+    snap->ytDlpPath = m_ytDlpPath;
+    snap->ffmpegPath = m_ffmpegPath;
+    snap->defaultQualityPreset = m_defaultQualityPreset;
+    snap->defaultAudioFormat = m_defaultAudioFormat;
+    snap->maxConcurrentDownloads = m_maxConcurrentDownloads;
+    snap->proxyEnabled = m_proxyEnabled;
+    snap->proxyUrl = m_proxyUrl;
+    m_snapshot.store(std::move(snap), std::memory_order_release);
 }
 
 bool AppConfig::load() {
@@ -82,6 +102,7 @@ bool AppConfig::load() {
     qDebug() << "✅ 最终 yt-dlp 路径:" << m_ytDlpPath;
     qDebug() << "✅ 最终 ffmpeg 路径:" << m_ffmpegPath;
 
+    publishSnapshot();
     return true;
 }
 
@@ -105,6 +126,9 @@ void AppConfig::ensureDatabaseDirectoryExists() {
 }
 
 bool AppConfig::save() {
+    // 设置页的一组修改在保存时一次性对工作线程生效
+    publishSnapshot();
+
     QString configPath = getConfigFilePath();
     QFileInfo fileInfo(configPath);
     QDir dir = fileInfo.dir();
@@ -172,14 +196,25 @@ void AppConfig::setDefaultValues() {
     // 界面设置
     m_theme = "dark";
     m_fontSize = 13;
+    m_sortByPinyin = true;
 
     // 高级设置
     m_proxyEnabled = false;
     m_proxyUrl = "";
+    m_stallThresholdMs = 200;
+    m_positionUpdateIntervalMs = 250;
 
     // 播放默认
     m_playerVolume = 70;
     m_playerPlaybackMode = 0; // 顺序
+    m_gaplessPlayback = true;
+    m_crossfadeMs = 0;
+    m_prefetchTrackCount = 3;
+    m_prefetchBudgetMb = 256;
+    m_renderPipelineEnabled = false;
+    m_eqGainsDb.clear();
+    m_limiterEnabled = true;
+    m_weightedShuffle = false;
     m_resumeOnStartup = true;
     m_lastSongId.clear();
     m_lastPositionMs = 0;
@@ -248,13 +283,29 @@ void AppConfig::loadFromJson(const QJsonObject& json) {
     }
 
     if (json.contains("fontSize"))      m_fontSize = json["fontSize"].toInt();
+    if (json.contains("sortByPinyin"))  m_sortByPinyin = json["sortByPinyin"].toBool();
     if (json.contains("proxyEnabled"))  m_proxyEnabled = json["proxyEnabled"].toBool();
     if (json.contains("proxyUrl"))      m_proxyUrl = json["proxyUrl"].toString();
+    if (json.contains("stallThresholdMs")) m_stallThresholdMs = qMax(0, json["stallThresholdMs"].toInt());
+    if (json.contains("positionUpdateIntervalMs")) m_positionUpdateIntervalMs = qMax(0, json["positionUpdateIntervalMs"].toInt());
 
     // 播放持久化
-    if (json.contains("playerVolume"))        m_playerVolume = qBound(0, json["playerVolume"].toInt(), 100);
     if (json.contains("playerPlaybackMode"))  m_playerPlaybackMode = qBound(0, json["playerPlaybackMode"].toInt(), 3);
     if (json.contains("resumeOnStartup"))    m_resumeOnStartup = json["resumeOnStartup"].toBool();
+    if (json.contains("gaplessPlayback"))    m_gaplessPlayback = json["gaplessPlayback"].toBool();
+    if (json.contains("weightedShuffle"))    m_weightedShuffle = json["weightedShuffle"].toBool();
+    if (json.contains("crossfadeMs"))        m_crossfadeMs = qBound(0, json["crossfadeMs"].toInt(), 12000);
+    if (json.contains("prefetchTrackCount")) m_prefetchTrackCount = qBound(0, json["prefetchTrackCount"].toInt(), 20);
+    if (json.contains("prefetchBudgetMb"))   m_prefetchBudgetMb = qMax(0, json["prefetchBudgetMb"].toInt());
+    if (json.contains("renderPipelineEnabled")) m_renderPipelineEnabled = json["renderPipelineEnabled"].toBool();
+    if (json.contains("eqGainsDb")) {
+        m_eqGainsDb.clear();
+        for (auto v : json["eqGainsDb"].toArray()) m_eqGainsDb << qBound(-12, v.toInt(), 12);
+    }
+    if (json.contains("limiterEnabled"))     m_limiterEnabled = json["limiterEnabled"].toBool();
+
+    // 旧版本写在配置文件里的会话状态：只读，用于首次迁移到 SessionJournal，保存时不再写回
+    if (json.contains("playerVolume"))        m_playerVolume = qBound(0, json["playerVolume"].toInt(), 100);
     if (json.contains("lastSongId"))         m_lastSongId = json["lastSongId"].toString();
     if (json.contains("lastPositionMs"))     m_lastPositionMs = static_cast<qint64>(json["lastPositionMs"].toDouble());
     if (json.contains("lastPlaylistIds"))    for (auto v : json["lastPlaylistIds"].toArray()) m_lastPlaylistIds << v.toString();
@@ -271,21 +322,24 @@ void AppConfig::saveToJson(QJsonObject& json) const {
     json["databasePath"] = m_databasePath;
     json["theme"] = m_theme;
     json["fontSize"] = m_fontSize;
+    json["sortByPinyin"] = m_sortByPinyin;
     json["proxyEnabled"] = m_proxyEnabled;
     json["proxyUrl"] = m_proxyUrl;
+    json["stallThresholdMs"] = m_stallThresholdMs;
+    json["positionUpdateIntervalMs"] = m_positionUpdateIntervalMs;
 
-    // 播放持久化
-    json["playerVolume"] = m_playerVolume;
+    // 播放持久化（进度/音量/列表等会话状态见 SessionJournal）
     json["playerPlaybackMode"] = m_playerPlaybackMode;
     json["resumeOnStartup"] = m_resumeOnStartup;
-    json["lastSongId"] = m_lastSongId;
-    json["lastPositionMs"] = static_cast<double>(m_lastPositionMs);
-    {
-        QJsonArray arr; for (auto& id : m_lastPlaylistIds) arr.append(id); json["lastPlaylistIds"] = arr;
-    }
-    {
-        QJsonArray arr; for (auto& id : m_lastQueueIds) arr.append(id); json["lastQueueIds"] = arr;
-    }
+    json["gaplessPlayback"] = m_gaplessPlayback;
+    json["weightedShuffle"] = m_weightedShuffle;
+    json["crossfadeMs"] = m_crossfadeMs;
+    json["prefetchTrackCount"] = m_prefetchTrackCount;
+    json["prefetchBudgetMb"] = m_prefetchBudgetMb;
+    json["renderPipelineEnabled"] = m_renderPipelineEnabled;
+    QJsonArray eqArr; for (int g : m_eqGainsDb) eqArr.append(g);
+    json["eqGainsDb"] = eqArr;
+    json["limiterEnabled"] = m_limiterEnabled;
 }
 
 bool AppConfig::isValidTheme(const QString& theme) const {
@@ -308,7 +362,18 @@ QString AppConfig::getTheme() const { return m_theme; }
 int AppConfig::getFontSize() const { return m_fontSize; }
 bool AppConfig::getProxyEnabled() const { return m_proxyEnabled; }
 QString AppConfig::getProxyUrl() const { return m_proxyUrl; }
+bool AppConfig::getSortByPinyin() const { return m_sortByPinyin; }
+int AppConfig::getStallThresholdMs() const { return m_stallThresholdMs; }
+int AppConfig::getPositionUpdateIntervalMs() const { return m_positionUpdateIntervalMs; }
 bool AppConfig::getResumeOnStartup() const { return m_resumeOnStartup; }
+bool AppConfig::getGaplessPlayback() const { return m_gaplessPlayback; }
+int AppConfig::getCrossfadeMs() const { return m_crossfadeMs; }
+int AppConfig::getPrefetchTrackCount() const { return m_prefetchTrackCount; }
+int AppConfig::getPrefetchBudgetMb() const { return m_prefetchBudgetMb; }
+bool AppConfig::getRenderPipelineEnabled() const { return m_renderPipelineEnabled; }
+QList<int> AppConfig::getEqGainsDb() const { return m_eqGainsDb; }
+bool AppConfig::getLimiterEnabled() const { return m_limiterEnabled; }
+bool AppConfig::getWeightedShuffle() const { return m_weightedShuffle; }
 QString AppConfig::getLastSongId() const { return m_lastSongId; }
 qint64 AppConfig::getLastPositionMs() const { return m_lastPositionMs; }
 QStringList AppConfig::getLastPlaylistIds() const { return m_lastPlaylistIds; }
@@ -316,7 +381,6 @@ QStringList AppConfig::getLastQueueIds() const { return m_lastQueueIds; }
 // 播放相关
 int  AppConfig::getPlayerVolume() const { return m_playerVolume; }
 int  AppConfig::getPlayerPlaybackMode() const { return m_playerPlaybackMode; }
-void AppConfig::setPlayerVolume(int volume) { m_playerVolume = qBound(0, volume, 100); }
 void AppConfig::setPlayerPlaybackMode(int mode) { m_playerPlaybackMode = qBound(0, mode, 3); }
 
 // Setters
@@ -336,6 +400,9 @@ void AppConfig::setDatabasePath(const QString& path) { m_databasePath = path; }
 void AppConfig::setFontSize(int size) { m_fontSize = size; }
 void AppConfig::setProxyEnabled(bool enabled) { m_proxyEnabled = enabled; }
 void AppConfig::setProxyUrl(const QString& url) { m_proxyUrl = url; }
+void AppConfig::setSortByPinyin(bool enabled) { m_sortByPinyin = enabled; }
+void AppConfig::setStallThresholdMs(int ms) { m_stallThresholdMs = qMax(0, ms); }
+void AppConfig::setPositionUpdateIntervalMs(int ms) { m_positionUpdateIntervalMs = qMax(0, ms); }
 void AppConfig::setTheme(const QString& theme) {
     if (m_theme == theme) return;
 
@@ -349,7 +416,14 @@ void AppConfig::setTheme(const QString& theme) {
     }
 }
 void AppConfig::setResumeOnStartup(bool e) { m_resumeOnStartup = e; }
-void AppConfig::setLastSongId(const QString& id) { m_lastSongId = id; }
-void AppConfig::setLastPositionMs(qint64 ms) { m_lastPositionMs = qMax<qint64>(0, ms); }
-void AppConfig::setLastPlaylistIds(const QStringList& ids) { m_lastPlaylistIds = ids; }
-void AppConfig::setLastQueueIds(const QStringList& ids) { m_lastQueueIds = ids; }
\ No newline at end of file
+void AppConfig::setGaplessPlayback(bool e) { m_gaplessPlayback = e; }
+void AppConfig::setWeightedShuffle(bool e) { m_weightedShuffle = e; }
+void AppConfig::setCrossfadeMs(int ms) { m_crossfadeMs = qBound(0, ms, 12000); }
+void AppConfig::setPrefetchTrackCount(int count) { m_prefetchTrackCount = qBound(0, count, 20); }
+void AppConfig::setPrefetchBudgetMb(int mb) { m_prefetchBudgetMb = qMax(0, mb); }
+void AppConfig::setRenderPipelineEnabled(bool e) { m_renderPipelineEnabled = e; }
+void AppConfig::setEqGainsDb(const QList<int>& gains) {
+    m_eqGainsDb.clear();
+    for (int g : gains) m_eqGainsDb << qBound(-12, g, 12);
+}
+void AppConfig::setLimiterEnabled(bool e) { m_limiterEnabled = e; }
\ No newline at end of file
@@ -2,9 +2,32 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include <atomic>
+#include <memory>
 #include "entities/Song.h"
 #include "../infra/DownloadConfig.h"
 
+/**
+ * @brief 配置的只读快照，供工作线程使用
+ *
+ * AppConfig 的字段只在主线程读写；每次 load()/save()（即设置真正生效时）
+ * 都会生成一份新快照并原子替换。工作线程通过 AppConfig::snapshot() 拿到 shared_ptr 后
+ * 整个任务期间都用这一份，不加锁，也不会看到“改了一半”的设置；旧快照在最后一个持有者释放时销毁。
+ */
+struct AppConfigSnapshot {
+    quint64 version = 0;
+    QString downloadPath;
+    QString ytDlpPath;
+    QString ffmpegPath;
+    QString defaultQualityPreset;
+    AudioFormat defaultAudioFormat = AudioFormat::MP3;
+    int maxConcurrentDownloads = 3;
+    bool proxyEnabled = false;
+    QString proxyUrl;
+};
+
+using ConfigSnapshot = std::shared_ptr<const AppConfigSnapshot>;
+
 class AppConfig : public QObject {
     Q_OBJECT
 
@@ -14,6 +37,11 @@ public:
     bool load();
     bool save();
 
+    // 当前生效的只读快照（任意线程可调用）
+    ConfigSnapshot snapshot() const;
+    // 按当前字段发布新快照（load/save 会自动调用）
+    void publishSnapshot();
+
     // Getters
     QString getDownloadPath() const;
     QString getYtDlpPath() const;
@@ -26,11 +54,20 @@ public:
     int getFontSize() const;
     bool getProxyEnabled() const;
     QString getProxyUrl() const;
+    bool getSortByPinyin() const;        // 中文标题按拼音排序（影响预计算的排序键）
+    int getStallThresholdMs() const;     // 主线程卡顿记录阈值，0 表示关闭看门狗
+    int getPositionUpdateIntervalMs() const; // 播放位置推送间隔，0 表示跟随显示器刷新率
+    bool getGaplessPlayback() const;     // 预加载下一首，结尾无缝衔接
+    int getCrossfadeMs() const;          // 交叉淡化时长，0 表示不淡化
+    int getPrefetchTrackCount() const;   // 预读接下来几首，0 表示关闭
+    int getPrefetchBudgetMb() const;     // 预读总量上限
+    bool getRenderPipelineEnabled() const;   // 自有渲染管线（解码 → DSP → 音频输出）
+    QList<int> getEqGainsDb() const;     // 图示均衡各段增益（dB），频点见 DspChain::kGraphicEqFrequencies
+    bool getLimiterEnabled() const;
+    bool getWeightedShuffle() const;     // 随机播放时收藏的歌曲更可能排在前面
 
     // 播放相关（持久化）
-    int  getPlayerVolume() const;        // 0-100
     int  getPlayerPlaybackMode() const;  // 0 顺序、1 随机、2 单曲、3 列表
-    void setPlayerVolume(int volume);
     void setPlayerPlaybackMode(int mode);
 
     // Setters
@@ -45,17 +82,27 @@ public:
     void setFontSize(int size);
     void setProxyEnabled(bool enabled);
     void setProxyUrl(const QString& url);
+    void setSortByPinyin(bool enabled);
+    void setStallThresholdMs(int ms);
+    void setPositionUpdateIntervalMs(int ms);
+    void setGaplessPlayback(bool enabled);
+    void setCrossfadeMs(int ms);
+    void setPrefetchTrackCount(int count);
+    void setPrefetchBudgetMb(int mb);
+    void setRenderPipelineEnabled(bool enabled);
+    void setEqGainsDb(const QList<int>& gains);
+    void setLimiterEnabled(bool enabled);
+    void setWeightedShuffle(bool enabled);
     // 会话恢复
     bool getResumeOnStartup() const;
     void setResumeOnStartup(bool enabled);
+
+    // 旧版本配置文件中的会话状态（只读，仅用于迁移到 SessionJournal）
+    int  getPlayerVolume() const;        // 0-100
     QString getLastSongId() const;
-    void setLastSongId(const QString& id);
     qint64 getLastPositionMs() const;
-    void setLastPositionMs(qint64 ms);
     QStringList getLastPlaylistIds() const;
-    void setLastPlaylistIds(const QStringList& ids);
     QStringList getLastQueueIds() const;
-    void setLastQueueIds(const QStringList& ids);
 
     bool isValidTheme(const QString& theme) const;
     static QStringList availableThemes();
@@ -78,6 +125,9 @@ private:
     void ensureDatabaseDirectoryExists();
 
     static QStringList s_validThemes;
+
+    std::atomic<ConfigSnapshot> m_snapshot;
+    quint64 m_snapshotVersion = 0;
     static AudioFormat formatForPreset(const QString& preset); // 映射方法
 
     // 下载设置
@@ -94,14 +144,25 @@ private:
     // 界面设置
     QString m_theme;
     int m_fontSize = 13;
+    bool m_sortByPinyin = true;
 
     // 高级设置
     bool m_proxyEnabled = false;
     QString m_proxyUrl;
+    int m_stallThresholdMs = 200;
+    int m_positionUpdateIntervalMs = 250;
 
     // 播放持久化
     int m_playerVolume = 70;         // 0-100
     int m_playerPlaybackMode = 0;    // 0 顺序
+    bool m_gaplessPlayback = true;
+    int m_crossfadeMs = 0;
+    int m_prefetchTrackCount = 3;
+    int m_prefetchBudgetMb = 256;
+    bool m_renderPipelineEnabled = false;
+    QList<int> m_eqGainsDb;
+    bool m_limiterEnabled = true;
+    bool m_weightedShuffle = false;
     bool m_resumeOnStartup = true;
     QString m_lastSongId;
     qint64 m_lastPositionMs = 0;
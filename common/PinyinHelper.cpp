@@ -0,0 +1,286 @@
+// common/PinyinHelper.cpp
+#include "PinyinHelper.h"
+#include <QHash>
+#include <QFile>
+#include <QTextStream>
+#include <QCollator>
+#include <QLocale>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDebug>
+
+namespace {
+    // 平假名 U+3041..U+3094 的罗马字（片假名 = 平假名 + 0x60）
+    const char* const kKanaRomaji[] = {
+        "a", "a", "i", "i", "u", "u", "e", "e", "o", "o",                 // ぁ..お
+        "ka", "ga", "ki", "gi", "ku", "gu", "ke", "ge", "ko", "go",       // か..ご
+        "sa", "za", "shi", "ji", "su", "zu", "se", "ze", "so", "zo",      // さ..ぞ
+        "ta", "da", "chi", "ji", "", "tsu", "zu", "te", "de", "to", "do", // た..ど（っ 单独处理）
+        "na", "ni", "nu", "ne", "no",                                     // な..の
+        "ha", "ba", "pa", "hi", "bi", "pi", "fu", "bu", "pu",             // は..ぷ
+        "he", "be", "pe", "ho", "bo", "po",                               // へ..ぽ
+        "ma", "mi", "mu", "me", "mo",                                     // ま..も
+        "ya", "ya", "yu", "yu", "yo", "yo",                               // ゃ..よ
+        "ra", "ri", "ru", "re", "ro",                                     // ら..ろ
+        "wa", "wa", "i", "e", "o", "n", "vu"                              // ゎ..ゔ
+    };
+    constexpr ushort kHiraganaFirst = 0x3041;
+    constexpr ushort kHiraganaLast = 0x3094;
+    constexpr ushort kKatakanaOffset = 0x60;
+    constexpr ushort kSmallTsuHiragana = 0x3063;
+    constexpr ushort kProlongedSoundMark = 0x30FC;
+
+    ushort toHiragana(QChar c) {
+        const ushort u = c.unicode();
+        if (u >= kHiraganaFirst + kKatakanaOffset && u <= kHiraganaLast + kKatakanaOffset) {
+            return u - kKatakanaOffset;
+        }
+        return u;
+    }
+
+    bool isSmallYoon(ushort hira) {
+        return hira == 0x3083 || hira == 0x3085 || hira == 0x3087; // ゃ ゅ ょ
+    }
+
+    // 中文排序规则下各声母的边界字（按拼音序排列的每个首字母的第一个字）
+    struct InitialBoundary { const char* han; char initial; };
+    const InitialBoundary kInitialBoundaries[] = {
+        { "吖", 'a' }, { "八", 'b' }, { "嚓", 'c' }, { "咑", 'd' }, { "妸", 'e' },
+        { "发", 'f' }, { "旮", 'g' }, { "铪", 'h' }, { "丌", 'j' }, { "咔", 'k' },
+        { "垃", 'l' }, { "呣", 'm' }, { "拏", 'n' }, { "噢", 'o' }, { "妑", 'p' },
+        { "七", 'q' }, { "呥", 'r' }, { "仨", 's' }, { "他", 't' }, { "屲", 'w' },
+        { "夕", 'x' }, { "丫", 'y' }, { "帀", 'z' }
+    };
+
+    QString stripTones(const QString& syllable) {
+        QString out;
+        const QString decomposed = syllable.normalized(QString::NormalizationForm_D);
+        for (int i = 0; i < decomposed.size(); ++i) {
+            const QChar c = decomposed.at(i);
+            if (c.unicode() == 0x0308) { // 分音符：ü -> v
+                if (!out.isEmpty() && out.back() == QLatin1Char('u')) out.back() = QLatin1Char('v');
+                continue;
+            }
+            if (c.category() == QChar::Mark_NonSpacing) continue;
+            out.append(c.toLower());
+        }
+        return out;
+    }
+
+    class PinyinTable {
+    public:
+        static PinyinTable& instance() {
+            static PinyinTable table;
+            return table;
+        }
+
+        QString pinyin(QChar c) const { return m_pinyin.value(c.unicode()); }
+        bool isEmpty() const { return m_pinyin.isEmpty(); }
+
+        QChar collatorInitial(QChar c) {
+            QMutexLocker locker(&m_collatorMutex);
+            auto it = m_initialCache.constFind(c.unicode());
+            if (it != m_initialCache.constEnd()) return it.value();
+
+            // 二分查找：最后一个不大于 c 的边界字
+            const QString s(c);
+            const int n = int(sizeof(kInitialBoundaries) / sizeof(kInitialBoundaries[0]));
+            int lo = 0, hi = n - 1, found = -1;
+            while (lo <= hi) {
+                const int mid = (lo + hi) / 2;
+                if (m_collator.compare(s, QString::fromUtf8(kInitialBoundaries[mid].han)) >= 0) {
+                    found = mid;
+                    lo = mid + 1;
+                }
+                else {
+                    hi = mid - 1;
+                }
+            }
+            const QChar initial = found >= 0 ? QChar(QLatin1Char(kInitialBoundaries[found].initial)) : QChar();
+            m_initialCache.insert(c.unicode(), initial);
+            return initial;
+        }
+
+    private:
+        PinyinTable()
+            : m_collator(QLocale(QLocale::Chinese, QLocale::China))
+        {
+            const QStringList candidates = {
+                QStringLiteral(":/pinyin/pinyin.txt"),
+                QCoreApplication::applicationDirPath() + QStringLiteral("/data/pinyin.txt")
+            };
+            for (const QString& path : candidates) {
+                if (load(path)) break;
+            }
+            if (m_pinyin.isEmpty()) {
+                qDebug() << "PinyinHelper: 未找到拼音数据表，仅支持首字母匹配";
+            }
+        }
+
+        bool load(const QString& path) {
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+
+            QTextStream in(&file);
+            while (!in.atEnd()) {
+                const QString line = in.readLine().trimmed();
+                if (line.isEmpty() || line.startsWith('#') || !line.startsWith(QLatin1String("U+"))) continue;
+
+                // U+4E00: yī,yí  # 一
+                const int colon = line.indexOf(':');
+                if (colon < 0) continue;
+                bool ok = false;
+                const uint code = line.mid(2, colon - 2).toUInt(&ok, 16);
+                if (!ok || code > 0xFFFF) continue;
+
+                QString readings = line.mid(colon + 1);
+                const int hash = readings.indexOf('#');
+                if (hash >= 0) readings.truncate(hash);
+                const QString first = readings.split(',', Qt::SkipEmptyParts).value(0).trimmed();
+                if (!first.isEmpty()) {
+                    m_pinyin.insert(static_cast<ushort>(code), stripTones(first));
+                }
+            }
+            qDebug() << "PinyinHelper: 已加载拼音数据表" << path << "，共" << m_pinyin.size() << "字";
+            return !m_pinyin.isEmpty();
+        }
+
+        QHash<ushort, QString> m_pinyin; // 只在构造时写入，之后只读
+
+        QMutex m_collatorMutex;
+        QCollator m_collator;
+        QHash<ushort, QChar> m_initialCache;
+    };
+}
+
+bool PinyinHelper::isHan(QChar c) {
+    const ushort u = c.unicode();
+    return (u >= 0x4E00 && u <= 0x9FFF) || (u >= 0x3400 && u <= 0x4DBF) || (u >= 0xF900 && u <= 0xFAFF);
+}
+
+bool PinyinHelper::isKana(QChar c) {
+    const ushort u = toHiragana(c);
+    return (u >= kHiraganaFirst && u <= kHiraganaLast) || c.unicode() == kProlongedSoundMark;
+}
+
+QString PinyinHelper::pinyinOf(QChar c) {
+    if (!isHan(c)) return QString();
+    return PinyinTable::instance().pinyin(c);
+}
+
+QChar PinyinHelper::initialOf(QChar c) {
+    if (!isHan(c)) return QChar();
+    PinyinTable& table = PinyinTable::instance();
+    const QString py = table.pinyin(c);
+    if (!py.isEmpty()) return py.at(0);
+    return table.collatorInitial(c);
+}
+
+QString PinyinHelper::toPinyin(const QString& text) {
+    QString out;
+    out.reserve(text.size() * 4);
+    bool lastWasSyllable = false;
+    for (const QChar c : text) {
+        const QString py = pinyinOf(c);
+        if (!py.isEmpty()) {
+            if (!out.isEmpty() && !out.back().isSpace()) out.append(' ');
+            out.append(py);
+            lastWasSyllable = true;
+        }
+        else {
+            if (lastWasSyllable && !c.isSpace()) out.append(' ');
+            out.append(c);
+            lastWasSyllable = false;
+        }
+    }
+    return out;
+}
+
+QString PinyinHelper::toInitials(const QString& text) {
+    QString out;
+    out.reserve(text.size());
+    for (const QChar c : text) {
+        if (isHan(c)) {
+            const QChar initial = initialOf(c);
+            if (!initial.isNull()) out.append(initial);
+        }
+        else if (c.isLetterOrNumber()) {
+            out.append(c.toLower());
+        }
+    }
+    return out;
+}
+
+QString PinyinHelper::toRomaji(const QString& text) {
+    QString out;
+    out.reserve(text.size() * 2);
+    bool doubleNext = false; // っ：重复下一个音节的辅音
+
+    for (int i = 0; i < text.size(); ++i) {
+        const QChar c = text.at(i);
+        if (c.unicode() == kProlongedSoundMark) {
+            if (!out.isEmpty()) out.append(out.back()); // 长音：重复前一个元音
+            continue;
+        }
+
+        const ushort hira = toHiragana(c);
+        if (hira < kHiraganaFirst || hira > kHiraganaLast) {
+            doubleNext = false;
+            out.append(c);
+            continue;
+        }
+        if (hira == kSmallTsuHiragana) {
+            doubleNext = true;
+            continue;
+        }
+
+        QString syllable = QString::fromLatin1(kKanaRomaji[hira - kHiraganaFirst]);
+
+        // 拗音：き + ゃ -> kya，し + ゃ -> sha
+        if (i + 1 < text.size()) {
+            const ushort next = toHiragana(text.at(i + 1));
+            if (isSmallYoon(next) && syllable.size() >= 2 && syllable.endsWith('i')) {
+                const QString glide = QString::fromLatin1(kKanaRomaji[next - kHiraganaFirst]); // ya/yu/yo
+                syllable.chop(1);
+                if (syllable.endsWith(QLatin1String("sh")) || syllable.endsWith(QLatin1String("ch"))
+                    || syllable == QLatin1String("j")) {
+                    syllable.append(glide.mid(1));
+                }
+                else {
+                    syllable.append(glide);
+                }
+                ++i;
+            }
+        }
+
+        if (doubleNext && !syllable.isEmpty()) {
+            out.append(syllable.startsWith(QLatin1String("ch")) ? QChar('t') : syllable.at(0));
+            doubleNext = false;
+        }
+        out.append(syllable);
+    }
+    return out;
+}
+
+QString PinyinHelper::normalize(const QString& text) {
+    const QString folded = text.normalized(QString::NormalizationForm_KC).toCaseFolded();
+    QString out;
+    out.reserve(folded.size());
+    bool pendingSpace = false;
+    for (const QChar c : folded) {
+        if (c.isLetterOrNumber() || isKana(c)) {
+            if (pendingSpace && !out.isEmpty()) out.append(' ');
+            pendingSpace = false;
+            out.append(c);
+        }
+        else {
+            pendingSpace = true;
+        }
+    }
+    return out;
+}
+
+bool PinyinHelper::hasFullTable() {
+    return !PinyinTable::instance().isEmpty();
+}
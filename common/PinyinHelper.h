@@ -0,0 +1,39 @@
+// common/PinyinHelper.h
+#pragma once
+#include <QString>
+
+/**
+ * @brief 汉字拼音 / 假名罗马字转换（用于搜索索引与排序键）
+ *
+ * - 全拼：读取拼音数据表（pinyin-data 格式 "U+4E00: yī  # 一"），
+ *   依次查找 :/pinyin/pinyin.txt 与 <程序目录>/data/pinyin.txt；无数据表时返回空
+ * - 首字母：优先取数据表；无数据表时使用中文排序规则（QCollator zh_CN）按边界字推算
+ * - 罗马字：平假名 / 片假名按平文式（Hepburn）转换
+ *
+ * 所有函数均可在任意线程调用。
+ */
+class PinyinHelper {
+public:
+    // 是否为 CJK 统一表意文字
+    static bool isHan(QChar c);
+    // 是否为平假名 / 片假名
+    static bool isKana(QChar c);
+
+    // 单字全拼（无声调，ü 记作 v）；未知时返回空
+    static QString pinyinOf(QChar c);
+    // 单字拼音首字母；未知时返回空 QChar
+    static QChar initialOf(QChar c);
+
+    // 整段文本的全拼，音节之间以空格分隔；非汉字原样保留
+    static QString toPinyin(const QString& text);
+    // 整段文本的首字母串（仅汉字转换，其他字母数字原样保留，去掉空白）
+    static QString toInitials(const QString& text);
+    // 假名转罗马字；非假名原样保留
+    static QString toRomaji(const QString& text);
+
+    // 搜索 / 排序用规范化：NFKC + 大小写折叠，标点与空白统一为单个空格
+    static QString normalize(const QString& text);
+
+    // 是否加载到了全拼数据表
+    static bool hasFullTable();
+};
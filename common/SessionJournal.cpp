@@ -0,0 +1,463 @@
+#include "SessionJournal.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDebug>
+
+namespace {
+    constexpr char kMagic[4] = { 'B', 'M', 'S', 'J' };
+    constexpr int kHeaderSize = 5;
+    constexpr int kRecordOverhead = 1 + 4 + 2;   // 类型 + 长度 + CRC
+    constexpr quint32 kMaxPayload = 16 * 1024 * 1024;
+
+    quint32 readU32(const char* p) {
+        return quint32(quint8(p[0])) | (quint32(quint8(p[1])) << 8)
+            | (quint32(quint8(p[2])) << 16) | (quint32(quint8(p[3])) << 24);
+    }
+
+    void appendU32(QByteArray& out, quint32 v) {
+        out.append(char(v & 0xFF));
+        out.append(char((v >> 8) & 0xFF));
+        out.append(char((v >> 16) & 0xFF));
+        out.append(char((v >> 24) & 0xFF));
+    }
+
+    // 末尾 / 开头插入不搬动已有元素（QList 两端都留有余量），中间插入整体重建一次
+    void insertIds(QStringList& list, int index, const QStringList& ids) {
+        if (index >= list.size()) list += ids;
+        else if (index <= 0) for (auto it = ids.crbegin(); it != ids.crend(); ++it) list.prepend(*it);
+        else list = list.mid(0, index) + ids + list.mid(index);
+    }
+
+    QByteArray encodeI64(qint64 v) {
+        QByteArray b;
+        appendU32(b, quint32(quint64(v) & 0xFFFFFFFFu));
+        appendU32(b, quint32(quint64(v) >> 32));
+        return b;
+    }
+}
+
+SessionJournal& SessionJournal::instance() {
+    static SessionJournal instance;
+    return instance;
+}
+
+SessionJournal::~SessionJournal() {
+    close();
+}
+
+// ========== 编码 ==========
+QByteArray SessionJournal::header() {
+    QByteArray h(kMagic, 4);
+    h.append(char(kVersion));
+    return h;
+}
+
+QByteArray SessionJournal::encodeRecord(RecordType type, const QByteArray& payload) {
+    QByteArray rec;
+    rec.reserve(kRecordOverhead + payload.size());
+    rec.append(char(type));
+    appendU32(rec, quint32(payload.size()));
+    rec.append(payload);
+    const quint16 crc = qChecksum(QByteArrayView(rec));
+    rec.append(char(crc & 0xFF));
+    rec.append(char((crc >> 8) & 0xFF));
+    return rec;
+}
+
+QByteArray SessionJournal::encodeString(const QString& s) {
+    return s.toUtf8();
+}
+
+QByteArray SessionJournal::encodeStringList(const QStringList& list) {
+    QByteArray out;
+    QDataStream ds(&out, QIODevice::WriteOnly);
+    ds.setVersion(QDataStream::Qt_6_0);
+    ds << list;
+    return out;
+}
+
+QByteArray SessionJournal::encodeIntList(const QList<int>& list) {
+    // 定长小端 u32：10 万首约 400KB，比 QDataStream 省去逐项的流状态检查
+    QByteArray out;
+    out.reserve(list.size() * 4);
+    for (int v : list) appendU32(out, quint32(v));
+    return out;
+}
+
+bool SessionJournal::applyRecord(quint8 type, const QByteArray& payload) {
+    switch (type) {
+    case SongIdRecord:
+        m_lastSongId = QString::fromUtf8(payload);
+        break;
+    case PositionRecord:
+    case VolumeRecord:
+    case ShuffleCursorRecord: {
+        if (payload.size() != 8) return false;
+        const qint64 v = qint64(readU32(payload.constData()))
+            | (qint64(readU32(payload.constData() + 4)) << 32);
+        if (type == PositionRecord) m_lastPositionMs = v;
+        else if (type == VolumeRecord) m_volume = int(v);
+        else m_shuffleCursor = int(v);
+        break;
+    }
+    case QueueInsertRecord:
+    case QueueRemoveRecord:
+    case QueueMoveRecord:
+    case PlaylistInsertRecord:
+    case PlaylistRemoveRecord:
+        if (!applyListDelta(type, payload)) return false;
+        break;
+    case ShuffleInsertRecord:
+    case ShuffleRemoveRecord:
+        if (payload.size() != 4) return false;
+        applyShuffleDelta(type, int(readU32(payload.constData())), -1);
+        break;
+    case ShuffleSwapRecord:
+    case ShuffleMoveRecord:
+        if (payload.size() != 8) return false;
+        applyShuffleDelta(type, int(readU32(payload.constData())), int(readU32(payload.constData() + 4)));
+        break;
+    case ShuffleOrderRecord: {
+        if (payload.size() % 4 != 0) return false;
+        const int count = int(payload.size() / 4);
+        m_shuffleOrder.clear();
+        m_shuffleOrder.reserve(count);
+        for (int i = 0; i < count; ++i) m_shuffleOrder << int(readU32(payload.constData() + i * 4));
+        break;
+    }
+    case PlaylistRecord:
+    case QueueRecord: {
+        QDataStream ds(payload);
+        ds.setVersion(QDataStream::Qt_6_0);
+        QStringList list;
+        ds >> list;
+        if (ds.status() != QDataStream::Ok) return false;
+        if (type == PlaylistRecord) m_playlistIds = list;
+        else m_queueIds = list;
+        break;
+    }
+    default:
+        // 未知类型：来自更新版本的记录，跳过但不视为损坏
+        return true;
+    }
+    m_hasState = true;
+    return true;
+}
+
+bool SessionJournal::applyListDelta(quint8 type, const QByteArray& payload) {
+    const bool isInsert = type == QueueInsertRecord || type == PlaylistInsertRecord;
+    if (payload.size() < (isInsert ? 4 : 8)) return false;
+    QStringList& list = (type == PlaylistInsertRecord || type == PlaylistRemoveRecord) ? m_playlistIds : m_queueIds;
+    const int a = int(readU32(payload.constData()));
+    const int size = list.size();
+
+    if (isInsert) {
+        QDataStream ds(payload.mid(4));
+        ds.setVersion(QDataStream::Qt_6_0);
+        QStringList ids;
+        ds >> ids;
+        if (ds.status() != QDataStream::Ok) return false;
+        // 与之前的记录对不上（理论上不会发生）时按追加处理，不丢弃后面的记录
+        const int index = (a >= 0 && a <= size) ? a : size;
+        insertIds(list, index, ids);
+        return true;
+    }
+
+    const int b = int(readU32(payload.constData() + 4));
+    if (type == QueueMoveRecord) {
+        if (a >= 0 && a < size && b >= 0 && b < size) list.move(a, b);
+    }
+    else if (a >= 0 && a < size && b > 0) {
+        list.remove(a, qMin(b, size - a));
+    }
+    return true;
+}
+
+void SessionJournal::applyShuffleDelta(quint8 type, int a, int b) {
+    QList<int>& order = m_shuffleOrder;
+    const int size = order.size();
+    bool ok = true;
+
+    switch (type) {
+    case ShuffleInsertRecord:
+        ok = a >= 0 && a <= size;
+        if (ok) {
+            order.append(size);
+            if (a != size) order.swapItemsAt(a, size);
+        }
+        break;
+    case ShuffleRemoveRecord: {
+        const int pos = order.indexOf(a);
+        ok = pos >= 0;
+        if (ok) {
+            order.remove(pos);
+            for (int& index : order) {
+                if (index > a) --index;
+            }
+        }
+        break;
+    }
+    case ShuffleSwapRecord:
+    case ShuffleMoveRecord:
+        ok = a >= 0 && a < size && b >= 0 && b < size;
+        if (ok && type == ShuffleSwapRecord) order.swapItemsAt(a, b);
+        else if (ok) order.move(a, b);
+        break;
+    default:
+        break;
+    }
+
+    // 与之前的记录对不上（理论上不会发生）：丢掉排列，恢复时重新洗牌
+    if (!ok) {
+        order.clear();
+        m_shuffleCursor = -1;
+    }
+}
+
+QByteArray SessionJournal::snapshot() const {
+    QByteArray out = header();
+    if (!m_hasState) return out;
+    out += encodeRecord(PlaylistRecord, encodeStringList(m_playlistIds));
+    out += encodeRecord(QueueRecord, encodeStringList(m_queueIds));
+    out += encodeRecord(SongIdRecord, encodeString(m_lastSongId));
+    out += encodeRecord(PositionRecord, encodeI64(m_lastPositionMs));
+    if (m_volume >= 0) out += encodeRecord(VolumeRecord, encodeI64(m_volume));
+    if (!m_shuffleOrder.isEmpty()) {
+        out += encodeRecord(ShuffleOrderRecord, encodeIntList(m_shuffleOrder));
+        out += encodeRecord(ShuffleCursorRecord, encodeI64(m_shuffleCursor));
+    }
+    return out;
+}
+
+// ========== 打开与重放 ==========
+bool SessionJournal::open(const QString& path) {
+    close();
+    m_path = path;
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "⚠️ 无法打开会话日志:" << path << m_file.errorString();
+        return false;
+    }
+
+    const QByteArray data = m_file.readAll();
+    qint64 validEnd = 0;
+    int records = 0;
+
+    if (data.size() >= kHeaderSize && data.startsWith(QByteArray(kMagic, 4))) {
+        validEnd = kHeaderSize;
+        const char* p = data.constData();
+        while (validEnd + kRecordOverhead <= data.size()) {
+            const quint8 type = quint8(p[validEnd]);
+            const quint32 len = readU32(p + validEnd + 1);
+            if (len > kMaxPayload || validEnd + kRecordOverhead + qint64(len) > data.size()) break;
+
+            const QByteArrayView body(p + validEnd, 5 + len);
+            const quint16 stored = quint16(quint8(p[validEnd + 5 + len]))
+                | quint16(quint8(p[validEnd + 6 + len]) << 8);
+            if (qChecksum(body) != stored) break;
+
+            if (!applyRecord(type, QByteArray(p + validEnd + 5, len))) break;
+            validEnd += kRecordOverhead + len;
+            ++records;
+        }
+    }
+    else if (!data.isEmpty()) {
+        qWarning() << "⚠️ 会话日志格式无法识别，已重建:" << path;
+    }
+
+    if (validEnd == 0) {
+        // 新文件或无法识别：写入文件头
+        m_file.resize(0);
+        m_file.seek(0);
+        m_file.write(header());
+        validEnd = kHeaderSize;
+    }
+    else if (validEnd < data.size()) {
+        qWarning() << "⚠️ 会话日志尾部残缺，截断" << (data.size() - validEnd) << "字节";
+        m_file.resize(validEnd);
+    }
+    m_file.seek(validEnd);
+    m_file.flush();
+    m_fileBytes = validEnd;
+
+    qDebug() << "📒 会话日志已打开:" << path << "记录数:" << records;
+
+    // 记录过多时先压缩一次，缩短下次重放；以当前状态的快照大小为基准
+    m_snapshotBytes = snapshot().size();
+    if (needsCompaction()) compact();
+    return true;
+}
+
+void SessionJournal::close() {
+    if (!m_file.isOpen()) return;
+    compact();
+    m_file.close();
+}
+
+// ========== 写入 ==========
+void SessionJournal::append(RecordType type, const QByteArray& payload) {
+    m_hasState = true;
+    if (!m_file.isOpen()) return;
+
+    const QByteArray rec = encodeRecord(type, payload);
+    if (m_file.write(rec) != rec.size() || !m_file.flush()) {
+        qWarning() << "⚠️ 写入会话日志失败:" << m_file.errorString();
+        return;
+    }
+    m_fileBytes += rec.size();
+    if (needsCompaction()) compact();
+}
+
+// 快照之后追加的量超过 max(kCompactBytes, 快照大小) 才压缩：快照越大压缩越少，不会每条记录都重写
+bool SessionJournal::needsCompaction() const {
+    return m_fileBytes - m_snapshotBytes > qMax(kCompactBytes, m_snapshotBytes);
+}
+
+bool SessionJournal::compact() {
+    if (!m_file.isOpen() || m_path.isEmpty()) return false;
+
+    QSaveFile out(m_path);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qWarning() << "⚠️ 会话日志压缩失败:" << out.errorString();
+        return false;
+    }
+    const QByteArray snap = snapshot();
+    out.write(snap);
+
+    // QSaveFile 通过改名替换原文件，原句柄需重新打开
+    m_file.close();
+    const bool ok = out.commit();
+    if (!ok) qWarning() << "⚠️ 会话日志压缩提交失败:" << out.errorString();
+
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "⚠️ 无法重新打开会话日志:" << m_path;
+        return false;
+    }
+    m_file.seek(m_file.size());
+    m_fileBytes = ok ? snap.size() : m_file.size();
+    m_snapshotBytes = ok ? snap.size() : m_fileBytes;   // 失败时等再追加一轮再试，不逐条重试
+    return ok;
+}
+
+void SessionJournal::setLastSongId(const QString& id) {
+    if (m_hasState && id == m_lastSongId) return;
+    m_lastSongId = id;
+    append(SongIdRecord, encodeString(id));
+}
+
+void SessionJournal::setLastPositionMs(qint64 ms) {
+    ms = qMax<qint64>(0, ms);
+    if (m_hasState && ms == m_lastPositionMs) return;
+    m_lastPositionMs = ms;
+    append(PositionRecord, encodeI64(ms));
+}
+
+void SessionJournal::setVolume(int volume) {
+    volume = qBound(0, volume, 100);
+    if (volume == m_volume) return;
+    m_volume = volume;
+    append(VolumeRecord, encodeI64(volume));
+}
+
+void SessionJournal::setPlaylistIds(const QStringList& ids) {
+    if (m_hasState && ids == m_playlistIds) return;
+    m_playlistIds = ids;
+    append(PlaylistRecord, encodeStringList(ids));
+}
+
+void SessionJournal::setQueueIds(const QStringList& ids) {
+    if (m_hasState && ids == m_queueIds) return;
+    m_queueIds = ids;
+    append(QueueRecord, encodeStringList(ids));
+}
+
+
+void SessionJournal::appendListInsert(RecordType type, QStringList& list, int index, const QStringList& ids) {
+    if (ids.isEmpty()) return;
+    index = (index >= 0 && index <= list.size()) ? index : list.size();
+    insertIds(list, index, ids);
+
+    QByteArray payload;
+    appendU32(payload, quint32(index));
+    payload += encodeStringList(ids);
+    append(type, payload);
+}
+
+void SessionJournal::appendListRemove(RecordType type, QStringList& list, int index, int count) {
+    if (index < 0 || index >= list.size() || count <= 0) return;
+    count = qMin(count, int(list.size()) - index);
+    list.remove(index, count);
+
+    QByteArray payload;
+    appendU32(payload, quint32(index));
+    appendU32(payload, quint32(count));
+    append(type, payload);
+}
+
+void SessionJournal::insertQueueIds(int index, const QStringList& ids) {
+    appendListInsert(QueueInsertRecord, m_queueIds, index, ids);
+}
+
+void SessionJournal::removeQueueIds(int index, int count) {
+    appendListRemove(QueueRemoveRecord, m_queueIds, index, count);
+}
+
+void SessionJournal::insertPlaylistIds(int index, const QStringList& ids) {
+    appendListInsert(PlaylistInsertRecord, m_playlistIds, index, ids);
+}
+
+void SessionJournal::removePlaylistIds(int index, int count) {
+    appendListRemove(PlaylistRemoveRecord, m_playlistIds, index, count);
+}
+
+void SessionJournal::moveQueueId(int from, int to) {
+    if (from < 0 || from >= m_queueIds.size() || to < 0 || to >= m_queueIds.size() || from == to) return;
+    m_queueIds.move(from, to);
+
+    QByteArray payload;
+    appendU32(payload, quint32(from));
+    appendU32(payload, quint32(to));
+    append(QueueMoveRecord, payload);
+}
+
+void SessionJournal::setShuffleOrder(const QList<int>& order) {
+    if (m_hasState && order == m_shuffleOrder) return;
+    m_shuffleOrder = order;
+    append(ShuffleOrderRecord, encodeIntList(order));
+}
+
+void SessionJournal::setShuffleCursor(int cursor) {
+    if (m_hasState && cursor == m_shuffleCursor) return;
+    m_shuffleCursor = cursor;
+    append(ShuffleCursorRecord, encodeI64(cursor));
+}
+
+void SessionJournal::appendShuffleDelta(RecordType type, int a, int b) {
+    if (m_shuffleOrder.isEmpty()) return;   // 没有排列可改：恢复时本来就会重新洗牌
+    applyShuffleDelta(type, a, b);
+
+    QByteArray payload;
+    appendU32(payload, quint32(a));
+    if (b >= 0) appendU32(payload, quint32(b));
+    append(type, payload);
+}
+
+void SessionJournal::insertShuffleAppended(int position) {
+    appendShuffleDelta(ShuffleInsertRecord, position);
+}
+
+void SessionJournal::removeShuffleIndex(int index) {
+    appendShuffleDelta(ShuffleRemoveRecord, index);
+}
+
+void SessionJournal::swapShufflePositions(int from, int to) {
+    appendShuffleDelta(ShuffleSwapRecord, from, to);
+}
+
+void SessionJournal::moveShufflePosition(int from, int to) {
+    appendShuffleDelta(ShuffleMoveRecord, from, to);
+}
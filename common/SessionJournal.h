@@ -0,0 +1,121 @@
+#pragma once
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief 播放会话日志（只追加的二进制文件）
+ *
+ * 当前歌曲、播放进度、音量、播放列表、队列与随机排列这类高频变化的会话状态不再写进 app_config.json，
+ * 而是以记录的形式追加到 session.journal：
+ *
+ *   文件头  "BMSJ" + 版本号(1 字节)
+ *   记录    类型(1) + 负载长度(4) + 负载 + CRC16(2)
+ *
+ * 每条记录只描述一次变化（进度记录约 20 字节），写入后立即 flush，进程崩溃最多丢失最后一条。
+ * 播放队列与播放列表的编辑按增量记录（插入一段 / 删除一段 / 移动一首），出队一首只追加十几字节；
+ * 整体替换列表时才写完整的 ID 列表。随机排列同样按增量记录（追加一首 / 删除一首 / 点选造成的对换或挪动），
+ * 只在重新洗牌时写完整排列；单纯换歌只追加游标。
+ * 打开时顺序重放，遇到长度或校验不对的残缺尾部即截断。
+ * 快照之后追加的字节超过 max(kCompactBytes, 快照大小) 时把当前状态写成新快照（QSaveFile 原子替换），
+ * 大列表的快照本身很大，压缩频率随之降低，摊销下来每条记录的写入量仍与记录大小同阶。
+ */
+class SessionJournal {
+public:
+    static SessionJournal& instance();
+
+    // 打开（不存在则创建）并重放；失败时仍可读写内存状态，只是不落盘
+    bool open(const QString& path);
+    // 压缩为快照并关闭
+    void close();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    bool hasState() const { return m_hasState; }
+
+    QString lastSongId() const { return m_lastSongId; }
+    qint64 lastPositionMs() const { return m_lastPositionMs; }
+    int volume() const { return m_volume; }            // -1 表示没有记录
+    QStringList playlistIds() const { return m_playlistIds; }
+    QStringList queueIds() const { return m_queueIds; }
+    QList<int> shuffleOrder() const { return m_shuffleOrder; }   // 播放列表下标的排列，空表示没有
+    int shuffleCursor() const { return m_shuffleCursor; }
+
+    // 值未变化时不写入
+    void setLastSongId(const QString& id);
+    void setLastPositionMs(qint64 ms);
+    void setVolume(int volume);
+    void setPlaylistIds(const QStringList& ids);
+    void insertPlaylistIds(int index, const QStringList& ids);
+    void removePlaylistIds(int index, int count);
+    void setQueueIds(const QStringList& ids);
+    void insertQueueIds(int index, const QStringList& ids);
+    void removeQueueIds(int index, int count);
+    void moveQueueId(int from, int to);
+    void setShuffleOrder(const QList<int>& order);
+    void setShuffleCursor(int cursor);
+    // 排列的增量（与 ShuffleOrder 的就地修正一一对应），游标另由 setShuffleCursor 记录
+    void insertShuffleAppended(int position);
+    void removeShuffleIndex(int index);
+    void swapShufflePositions(int from, int to);
+    void moveShufflePosition(int from, int to);
+
+    // 立即写快照（正常退出时由 close 调用）
+    bool compact();
+
+private:
+    SessionJournal() = default;
+    ~SessionJournal();
+    SessionJournal(const SessionJournal&) = delete;
+    SessionJournal& operator=(const SessionJournal&) = delete;
+
+    enum RecordType : quint8 {
+        SongIdRecord = 1,
+        PositionRecord = 2,
+        VolumeRecord = 3,
+        PlaylistRecord = 4,
+        QueueRecord = 5,
+        ShuffleOrderRecord = 6,
+        ShuffleCursorRecord = 7,
+        QueueInsertRecord = 8,      // 下标(4) + ID 列表
+        QueueRemoveRecord = 9,      // 下标(4) + 数量(4)
+        QueueMoveRecord = 10,       // 原下标(4) + 新下标(4)
+        PlaylistInsertRecord = 11,  // 同 QueueInsertRecord
+        PlaylistRemoveRecord = 12,  // 同 QueueRemoveRecord
+        ShuffleInsertRecord = 13,   // 位置(4)：新追加的列表下标放到该位置，原处的挪到末尾
+        ShuffleRemoveRecord = 14,   // 列表下标(4)：移出排列，之后的下标减一
+        ShuffleSwapRecord = 15,     // 位置(4) + 位置(4)
+        ShuffleMoveRecord = 16      // 原位置(4) + 新位置(4)
+    };
+
+    static constexpr quint8 kVersion = 1;
+    static constexpr qint64 kCompactBytes = 64 * 1024;
+
+    void append(RecordType type, const QByteArray& payload);
+    bool needsCompaction() const;
+    bool applyRecord(quint8 type, const QByteArray& payload);
+    bool applyListDelta(quint8 type, const QByteArray& payload);
+    void applyShuffleDelta(quint8 type, int a, int b);
+    void appendShuffleDelta(RecordType type, int a, int b = -1);
+    void appendListInsert(RecordType type, QStringList& list, int index, const QStringList& ids);
+    void appendListRemove(RecordType type, QStringList& list, int index, int count);
+    QByteArray snapshot() const;
+    static QByteArray header();
+    static QByteArray encodeRecord(RecordType type, const QByteArray& payload);
+    static QByteArray encodeString(const QString& s);
+    static QByteArray encodeStringList(const QStringList& list);
+    static QByteArray encodeIntList(const QList<int>& list);
+
+    QFile m_file;
+    QString m_path;
+    qint64 m_fileBytes = 0;       // 当前文件大小（快照 + 之后追加的记录）
+    qint64 m_snapshotBytes = 0;   // 最近一次快照的大小
+
+    bool m_hasState = false;
+    QString m_lastSongId;
+    qint64 m_lastPositionMs = 0;
+    int m_volume = -1;
+    QStringList m_playlistIds;
+    QStringList m_queueIds;
+    QList<int> m_shuffleOrder;
+    int m_shuffleCursor = -1;
+};
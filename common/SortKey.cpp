@@ -0,0 +1,92 @@
+// common/SortKey.cpp
+#include "SortKey.h"
+#include "PinyinHelper.h"
+#include "AppConfig.h"
+
+namespace {
+    constexpr char kSyllableSeparator = 0x01;
+    constexpr char kKeySeparator = 0x00;
+    constexpr int kMaxDigitRun = 250;
+
+    void appendUtf8(QByteArray& out, QChar c) {
+        out.append(QString(c).toUtf8());
+    }
+
+    // 数字串：长度前缀 + 去掉前导零的数字（长度前缀 < '0'，数字整体排在字母之前）
+    int appendNumber(QByteArray& out, const QString& text, int pos) {
+        int end = pos;
+        while (end < text.size() && text.at(end).isDigit()) ++end;
+
+        int start = pos;
+        while (start + 1 < end && text.at(start).digitValue() == 0) ++start;
+
+        const int len = qMin(end - start, kMaxDigitRun);
+        out.append(char(len + 1));
+        for (int i = start; i < start + len; ++i) {
+            out.append(char('0' + text.at(i).digitValue()));
+        }
+        return end;
+    }
+}
+
+QByteArray SortKey::build(const QString& text, Mode mode) {
+    // NFKD 拆出重音符号，便于忽略；全角字母数字同时折叠为半角
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD).toCaseFolded();
+
+    QByteArray key;
+    key.reserve(decomposed.size() * 3 + 8);
+
+    for (int i = 0; i < decomposed.size();) {
+        const QChar c = decomposed.at(i);
+
+        if (c.isDigit()) {
+            i = appendNumber(key, decomposed, i);
+            continue;
+        }
+        ++i;
+
+        if (c.category() == QChar::Mark_NonSpacing || c.category() == QChar::Mark_Enclosing) {
+            continue; // 重音
+        }
+
+        if (PinyinHelper::isHan(c)) {
+            if (mode == Mode::Pinyin) {
+                const QString pinyin = PinyinHelper::pinyinOf(c);
+                if (!pinyin.isEmpty()) {
+                    key.append(pinyin.toLatin1());
+                }
+                else {
+                    // 无拼音表：首字母分组，组内按码位
+                    const QChar initial = PinyinHelper::initialOf(c);
+                    if (!initial.isNull()) key.append(char(initial.unicode()));
+                    appendUtf8(key, c);
+                }
+                key.append(kSyllableSeparator);
+            }
+            else {
+                appendUtf8(key, c);
+            }
+            continue;
+        }
+
+        if (PinyinHelper::isKana(c)) {
+            // 片假名折叠为平假名：两者按五十音混排
+            const ushort u = c.unicode();
+            appendUtf8(key, (u >= 0x30A1 && u <= 0x30F6) ? QChar(ushort(u - 0x60)) : c);
+            continue;
+        }
+
+        if (c.isLetter()) {
+            appendUtf8(key, c);
+        }
+        // 空白与标点忽略
+    }
+
+    key.append(kKeySeparator);
+    key.append(text.normalized(QString::NormalizationForm_C).toUtf8().replace('\0', ""));
+    return key;
+}
+
+SortKey::Mode SortKey::configuredMode() {
+    return AppConfig::instance().getSortByPinyin() ? Mode::Pinyin : Mode::Standard;
+}
@@ -0,0 +1,26 @@
+// common/SortKey.h
+#pragma once
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief 预计算的排序键：可直接用 memcmp（或 SQLite 的 BLOB 比较）比较的字节串
+ *
+ * 键 = 主键 0x00 次键
+ * - 主键：忽略大小写、重音与标点；数字串按数值大小排序（"2" < "10"）；
+ *         拼音模式下汉字转为拼音（音节之间以 0x01 分隔），片假名折叠为平假名（五十音序）
+ * - 次键：规范化后的原文（UTF-8），主键相同时保证结果稳定
+ * 主键与次键中都不会出现 0x00，因此多个键直接拼接后仍可逐字节比较。
+ */
+class SortKey {
+public:
+    enum class Mode {
+        Standard = 0, // 汉字按码位
+        Pinyin = 1    // 汉字按拼音
+    };
+
+    static QByteArray build(const QString& text, Mode mode);
+
+    // 当前配置的模式（AppConfig::getSortByPinyin）
+    static Mode configuredMode();
+};
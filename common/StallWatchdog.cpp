@@ -0,0 +1,261 @@
+#include "StallWatchdog.h"
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+#include <QEvent>
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaEnum>
+#include <QMutexLocker>
+#include <QObject>
+#include <QTextStream>
+#include <QThread>
+#include <QDebug>
+#include <chrono>
+
+StallWatchdog& StallWatchdog::instance() {
+    static StallWatchdog instance;
+    return instance;
+}
+
+StallWatchdog::~StallWatchdog() {
+    stop();
+}
+
+qint64 StallWatchdog::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ========== 帧栈 ==========
+StallWatchdog::Scope::Scope(const QObject* receiver, const QEvent* event) {
+    StallWatchdog& w = StallWatchdog::instance();
+    const QThread* mainThread = w.m_mainThread.load(std::memory_order_relaxed);
+    if (!mainThread || QThread::currentThread() != mainThread) return;
+    w.push(receiver ? receiver->metaObject() : nullptr, event ? int(event->type()) : 0, nullptr);
+    m_active = true;
+}
+
+StallWatchdog::Scope::Scope(const char* label) {
+    StallWatchdog& w = StallWatchdog::instance();
+    const QThread* mainThread = w.m_mainThread.load(std::memory_order_relaxed);
+    if (!mainThread || QThread::currentThread() != mainThread) return;
+    w.push(nullptr, 0, label);
+    m_active = true;
+}
+
+StallWatchdog::Scope::~Scope() {
+    if (m_active) StallWatchdog::instance().pop();
+}
+
+void StallWatchdog::push(const QMetaObject* metaObject, int eventType, const char* label) {
+    const int depth = m_depth.load(std::memory_order_relaxed);
+    if (depth < kMaxDepth) {
+        Frame& f = m_frames[depth];
+        f.metaObject.store(metaObject, std::memory_order_relaxed);
+        f.label.store(label, std::memory_order_relaxed);
+        f.eventType.store(eventType, std::memory_order_relaxed);
+    }
+    // 嵌套分发（菜单/对话框的 exec 等）说明主线程回到了事件循环：外层那段到此为止，重新计时
+    // 文字标签只标注阻塞点，不重新计时
+    if (depth == 0 || !label) {
+        const qint64 now = nowNs();
+        if (depth > 0) m_dispatchEndNs.store(now, std::memory_order_relaxed);
+        m_dispatchStartNs.store(now, std::memory_order_relaxed);
+        m_dispatchSeq.fetch_add(1, std::memory_order_release);
+    }
+    m_depth.store(depth + 1, std::memory_order_release);
+}
+
+void StallWatchdog::pop() {
+    const int depth = m_depth.load(std::memory_order_relaxed) - 1;
+    if (depth < 0) return;
+    const bool eventFrame = depth >= kMaxDepth || !m_frames[depth].label.load(std::memory_order_relaxed);
+    if (depth == 0 || eventFrame) {
+        const qint64 now = nowNs();
+        m_dispatchEndNs.store(now, std::memory_order_relaxed);
+        // 嵌套分发结束，回到外层处理函数：从这里开始算外层剩下的部分
+        if (depth > 0) {
+            m_dispatchStartNs.store(now, std::memory_order_relaxed);
+            m_dispatchSeq.fetch_add(1, std::memory_order_release);
+        }
+    }
+    m_depth.store(depth, std::memory_order_release);
+}
+
+// 嵌套事件循环空闲等待（菜单/对话框开着没人操作）时没有任何分发，靠事件派发器的阻塞/唤醒区分
+void StallWatchdog::loopBlocked() {
+    m_dispatchEndNs.store(nowNs(), std::memory_order_relaxed);
+    m_loopIdle.store(true, std::memory_order_relaxed);
+    m_dispatchSeq.fetch_add(1, std::memory_order_release);
+}
+
+void StallWatchdog::loopAwake() {
+    m_loopIdle.store(false, std::memory_order_relaxed);
+    if (m_depth.load(std::memory_order_relaxed) > 0) {
+        m_dispatchStartNs.store(nowNs(), std::memory_order_relaxed);
+        m_dispatchSeq.fetch_add(1, std::memory_order_release);
+    }
+}
+
+QStringList StallWatchdog::snapshotFrames() const {
+    static const QMetaEnum eventTypes = QMetaEnum::fromType<QEvent::Type>();
+
+    QStringList frames;
+    const int depth = qMin(m_depth.load(std::memory_order_acquire), kMaxDepth);
+    for (int i = 0; i < depth; ++i) {
+        const Frame& f = m_frames[i];
+        if (const char* label = f.label.load(std::memory_order_relaxed)) {
+            frames << QString::fromUtf8(label);
+            continue;
+        }
+        const QMetaObject* mo = f.metaObject.load(std::memory_order_relaxed);
+        const int type = f.eventType.load(std::memory_order_relaxed);
+        const char* typeName = eventTypes.valueToKey(type);
+        frames << QString("%1 ← %2")
+            .arg(mo ? QString::fromLatin1(mo->className()) : QStringLiteral("?"),
+                typeName ? QString::fromLatin1(typeName) : QString::number(type));
+    }
+    return frames;
+}
+
+// ========== 启停 ==========
+void StallWatchdog::start(int thresholdMs, const QString& logFilePath) {
+    stop();
+    {
+        QMutexLocker locker(&m_logMutex);
+        m_logFilePath = logFilePath;
+    }
+    setThresholdMs(thresholdMs);
+    if (thresholdMs <= 0) {
+        qDebug() << "🐕 卡顿看门狗已关闭";
+        return;
+    }
+
+    const QCoreApplication* app = QCoreApplication::instance();
+    QThread* mainThread = app ? app->thread() : QThread::currentThread();
+    m_mainThread.store(mainThread);
+    m_stopRequested.store(false);
+    m_loopIdle.store(false);
+
+    if (QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance(mainThread)) {
+        m_blockConnection = QObject::connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock,
+            dispatcher, [this]() { loopBlocked(); }, Qt::DirectConnection);
+        m_awakeConnection = QObject::connect(dispatcher, &QAbstractEventDispatcher::awake,
+            dispatcher, [this]() { loopAwake(); }, Qt::DirectConnection);
+    }
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName("StallWatchdog");
+    m_thread->start(QThread::LowPriority);
+
+    qDebug() << "🐕 卡顿看门狗已启动，阈值" << thresholdMs << "ms，日志:" << logFilePath;
+}
+
+void StallWatchdog::stop() {
+    QObject::disconnect(m_blockConnection);
+    QObject::disconnect(m_awakeConnection);
+    if (!m_thread) return;
+    m_stopRequested.store(true);
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+void StallWatchdog::setThresholdMs(int thresholdMs) {
+    m_thresholdMs.store(qMax(0, thresholdMs), std::memory_order_relaxed);
+}
+
+QString StallWatchdog::logFilePath() const {
+    QMutexLocker locker(&m_logMutex);
+    return m_logFilePath;
+}
+
+// ========== 监视线程 ==========
+void StallWatchdog::run() {
+    quint64 reportedSeq = 0;
+
+    while (!m_stopRequested.load()) {
+        const int threshold = m_thresholdMs.load(std::memory_order_relaxed);
+        QThread::msleep(qBound(10, threshold / 4, 250));
+        if (threshold <= 0) continue;
+
+        if (m_depth.load(std::memory_order_acquire) == 0) continue;
+        if (m_loopIdle.load(std::memory_order_relaxed)) continue;
+        const quint64 seq = m_dispatchSeq.load(std::memory_order_acquire);
+        if (seq == reportedSeq) continue;
+
+        const qint64 startNs = m_dispatchStartNs.load(std::memory_order_relaxed);
+        const qint64 stalledMs = (nowNs() - startNs) / 1000000;
+        if (stalledMs < threshold) continue;
+
+        // 主线程仍卡在这一段里：此刻的帧栈就是“正在执行什么”
+        reportedSeq = seq;
+        Entry entry;
+        entry.startedAt = QDateTime::currentDateTime().addMSecs(-stalledMs);
+        entry.frames = snapshotFrames();
+        qWarning().noquote() << "🐢 主线程已卡顿" << stalledMs << "ms:" << entry.frames.join(" → ");
+
+        // 等这一段结束（分发返回或进入嵌套分发）后再记录总耗时
+        while (!m_stopRequested.load()
+            && m_dispatchSeq.load(std::memory_order_acquire) == seq
+            && m_depth.load(std::memory_order_acquire) > 0) {
+            QThread::msleep(10);
+        }
+        const qint64 endNs = m_dispatchEndNs.load(std::memory_order_relaxed);
+        entry.durationMs = ((endNs > startNs ? endNs : nowNs()) - startNs) / 1000000;
+        record(entry);
+    }
+}
+
+// ========== 日志 ==========
+QString StallWatchdog::formatEntry(const Entry& entry) {
+    return QString("%1  %2 ms  %3")
+        .arg(entry.startedAt.toString("yyyy-MM-dd HH:mm:ss.zzz"))
+        .arg(entry.durationMs, 5)
+        .arg(entry.frames.join(" → "));
+}
+
+void StallWatchdog::record(const Entry& entry) {
+    QMutexLocker locker(&m_logMutex);
+    if (m_logFilePath.isEmpty()) return;
+
+    // 超过上限时轮转一次，只保留一个旧文件
+    if (QFileInfo(m_logFilePath).size() > kMaxLogBytes) {
+        QFile::remove(m_logFilePath + ".1");
+        QFile::rename(m_logFilePath, m_logFilePath + ".1");
+    }
+
+    QFile file(m_logFilePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "⚠️ 无法写入卡顿日志:" << m_logFilePath;
+        return;
+    }
+    QTextStream out(&file);
+    out << formatEntry(entry) << '\n';
+}
+
+QStringList StallWatchdog::recentLines(int maxLines) const {
+    QMutexLocker locker(&m_logMutex);
+
+    QStringList lines;
+    for (const QString& path : { m_logFilePath + ".1", m_logFilePath }) {
+        QFile file(path);
+        if (m_logFilePath.isEmpty() || !file.open(QIODevice::ReadOnly | QIODevice::Text)) continue;
+        QTextStream in(&file);
+        while (!in.atEnd()) {
+            const QString line = in.readLine();
+            if (!line.isEmpty()) lines << line;
+        }
+    }
+    if (lines.size() > maxLines) {
+        lines = lines.mid(lines.size() - maxLines);
+    }
+    return lines;
+}
+
+void StallWatchdog::clearLog() {
+    QMutexLocker locker(&m_logMutex);
+    if (m_logFilePath.isEmpty()) return;
+    QFile::remove(m_logFilePath);
+    QFile::remove(m_logFilePath + ".1");
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <QDateTime>
+#include <QMetaObject>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <array>
+#include <atomic>
+
+class QEvent;
+class QObject;
+class QThread;
+
+/**
+ * @brief GUI 线程卡顿看门狗
+ *
+ * 主线程每分发一个事件（由 MusicApplication::notify 调用 Scope）就在一个固定大小的帧栈里
+ * 记下“接收者类名 + 事件类型”，已知的阻塞调用点（启动子进程、同步等待等）再用 Scope 压入文字标签。
+ * 帧栈只写原子变量，不分配内存、不加锁。
+ *
+ * 后台线程按阈值的 1/4 周期检查：一段分发持续超过阈值即视为卡顿，拍下此刻的帧栈，
+ * 等这一段结束后把“开始时间 / 总耗时 / 帧栈”追加到滚动日志 stall.log
+ * （超过 kMaxLogBytes 时轮转为 stall.log.1），日志跨会话保留，供高级设置页查看。
+ *
+ * “一段”从事件分发开始或嵌套分发的进出算起：菜单、对话框的 exec 会在外层分发里跑嵌套事件循环，
+ * 每分发一个内层事件都会重新计时；嵌套循环空闲等待期间（事件派发器 aboutToBlock 到 awake）不计时，
+ * 开着的菜单/对话框不会被当成卡顿。
+ *
+ * 只能发现事件分发内部的卡顿；两次分发之间（事件循环自身）的阻塞不在统计范围内。
+ */
+class StallWatchdog {
+public:
+    struct Entry {
+        QDateTime startedAt;
+        qint64 durationMs = 0;
+        QStringList frames;     // 由外到内
+    };
+
+    // 帧栈作用域：构造时压栈，析构时出栈；非主线程调用时什么也不做
+    class Scope {
+    public:
+        Scope(const QObject* receiver, const QEvent* event);
+        explicit Scope(const char* label);   // label 须为静态字符串
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        bool m_active = false;
+    };
+
+    static StallWatchdog& instance();
+
+    // 在主线程调用；thresholdMs <= 0 时只停止监视
+    void start(int thresholdMs, const QString& logFilePath);
+    void stop();
+    void setThresholdMs(int thresholdMs);
+
+    bool isRunning() const { return m_thread != nullptr; }
+    int thresholdMs() const { return m_thresholdMs.load(std::memory_order_relaxed); }
+    QString logFilePath() const;
+
+    // 最近的日志行（含轮转出的旧文件），新的在后
+    QStringList recentLines(int maxLines = 200) const;
+    void clearLog();
+
+    static QString formatEntry(const Entry& entry);
+
+private:
+    StallWatchdog() = default;
+    ~StallWatchdog();
+    StallWatchdog(const StallWatchdog&) = delete;
+    StallWatchdog& operator=(const StallWatchdog&) = delete;
+
+    static constexpr int kMaxDepth = 16;
+    static constexpr qint64 kMaxLogBytes = 512 * 1024;
+
+    struct Frame {
+        std::atomic<const QMetaObject*> metaObject{ nullptr };
+        std::atomic<const char*> label{ nullptr };
+        std::atomic<int> eventType{ 0 };
+    };
+
+    void push(const QMetaObject* metaObject, int eventType, const char* label);
+    void pop();
+    void loopBlocked();
+    void loopAwake();
+    void run();
+    QStringList snapshotFrames() const;
+    void record(const Entry& entry);
+    static qint64 nowNs();
+
+    // ===== 主线程写、看门狗线程读 =====
+    std::array<Frame, kMaxDepth> m_frames;
+    std::atomic<int> m_depth{ 0 };
+    std::atomic<quint64> m_dispatchSeq{ 0 };     // 每开始新的一段 +1
+    std::atomic<qint64> m_dispatchStartNs{ 0 };
+    std::atomic<qint64> m_dispatchEndNs{ 0 };
+    std::atomic<bool> m_loopIdle{ false };       // 主线程事件循环正阻塞等待
+
+    std::atomic<int> m_thresholdMs{ 200 };
+    std::atomic<bool> m_stopRequested{ false };
+    std::atomic<const QThread*> m_mainThread{ nullptr };   // 其他线程的事件分发也会经过 Scope
+    QThread* m_thread = nullptr;
+    QMetaObject::Connection m_blockConnection;
+    QMetaObject::Connection m_awakeConnection;
+
+    mutable QMutex m_logMutex;     // 保护日志路径与文件读写
+    QString m_logFilePath;
+};
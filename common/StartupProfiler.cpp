@@ -0,0 +1,95 @@
+#include "StartupProfiler.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <QDebug>
+
+namespace {
+    struct Mark {
+        QString phase;
+        qint64 ms = 0;
+        bool mainThread = true;
+    };
+
+    struct ProfilerState {
+        QMutex mutex;
+        QElapsedTimer clock;
+        QVector<Mark> marks;
+        bool reported = false;
+    };
+
+    ProfilerState& state() {
+        static ProfilerState s;
+        return s;
+    }
+
+    // 第一次 Paint 之后（本轮事件处理完）记为首帧
+    class FirstFrameWatcher : public QObject {
+    public:
+        using QObject::QObject;
+    protected:
+        bool eventFilter(QObject* watched, QEvent* event) override {
+            if (event->type() == QEvent::Paint) {
+                watched->removeEventFilter(this);
+                QTimer::singleShot(0, [] {
+                    StartupProfiler::mark(QStringLiteral("首帧可交互"));
+                    StartupProfiler::report();
+                    });
+                deleteLater();
+            }
+            return false;
+        }
+    };
+}
+
+void StartupProfiler::start() {
+    ProfilerState& s = state();
+    QMutexLocker locker(&s.mutex);
+    if (!s.clock.isValid()) s.clock.start();
+}
+
+qint64 StartupProfiler::elapsedMs() {
+    ProfilerState& s = state();
+    QMutexLocker locker(&s.mutex);
+    if (!s.clock.isValid()) s.clock.start();
+    return s.clock.elapsed();
+}
+
+void StartupProfiler::mark(const QString& phase) {
+    ProfilerState& s = state();
+    QMutexLocker locker(&s.mutex);
+    if (!s.clock.isValid()) s.clock.start();
+
+    Mark m;
+    m.phase = phase;
+    m.ms = s.clock.elapsed();
+    const QCoreApplication* app = QCoreApplication::instance();
+    m.mainThread = !app || QThread::currentThread() == app->thread();
+    s.marks.append(m);
+}
+
+void StartupProfiler::watchFirstFrame(QObject* window) {
+    if (!window) return;
+    window->installEventFilter(new FirstFrameWatcher(window));
+}
+
+void StartupProfiler::report() {
+    ProfilerState& s = state();
+    QMutexLocker locker(&s.mutex);
+    if (s.reported) return;
+    s.reported = true;
+
+    qDebug() << "⏱️ 启动耗时：";
+    qint64 previous = 0;
+    for (const Mark& m : std::as_const(s.marks)) {
+        qDebug().noquote() << QString("   %1 ms  +%2  %3%4")
+            .arg(m.ms, 5).arg(m.ms - previous, -4).arg(m.phase)
+            .arg(m.mainThread ? QString() : QStringLiteral(" (后台线程)"));
+        previous = m.ms;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <QObject>
+#include <QString>
+
+/**
+ * @brief 启动阶段计时
+ *
+ * 以首次调用（main 开头）为零点，记录各启动阶段的时间戳，可在任意线程调用。
+ * 主窗口第一次绘制完成时记为“首帧可交互”，随后输出一次汇总：
+ *
+ *   [启动]    12 ms  +12  配置加载
+ *   [启动]    40 ms  +28  数据库打开 (主线程)
+ *   ...
+ */
+class StartupProfiler {
+public:
+    // 开始计时（main 第一行调用；未调用时首次 mark 即为零点）
+    static void start();
+
+    // 记录一个阶段完成
+    static void mark(const QString& phase);
+
+    // 监听窗口的第一次绘制，绘制完成后记为首帧并输出汇总
+    static void watchFirstFrame(QObject* window);
+
+    // 自零点以来的毫秒数
+    static qint64 elapsedMs();
+
+    // 输出汇总（只输出一次）
+    static void report();
+};
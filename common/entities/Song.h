@@ -1,6 +1,7 @@
 #pragma once
 #include <QString>
 #include <QDateTime>
+#include <QByteArray>
 
 class Song {
 public:
@@ -21,6 +22,10 @@ public:
     QDateTime getDownloadDate() const { return m_downloadDate; }
     bool isFavorite() const { return m_isFavorite; }
 
+    // 预计算的排序键（见 SortKey），随歌曲写入数据库；为空表示尚未计算
+    QByteArray getTitleSortKey() const { return m_titleSortKey; }
+    QByteArray getArtistSortKey() const { return m_artistSortKey; }
+
     // Setters
     void setId(const QString& id) { m_id = id; }
     void setTitle(const QString& title) { m_title = title; }
@@ -31,6 +36,8 @@ public:
     void setDurationSeconds(qlonglong duration) { m_durationSeconds = duration; }
     void setDownloadDate(const QDateTime& date) { m_downloadDate = date; }
     void setFavorite(bool favorite) { m_isFavorite = favorite; }
+    void setTitleSortKey(const QByteArray& key) { m_titleSortKey = key; }
+    void setArtistSortKey(const QByteArray& key) { m_artistSortKey = key; }
 
     QString toString() const;
     bool operator==(const Song& other) const;
@@ -45,4 +52,6 @@ private:
     qlonglong m_durationSeconds = 0;
     QDateTime m_downloadDate;
     bool m_isFavorite = false;
+    QByteArray m_titleSortKey;
+    QByteArray m_artistSortKey;
 };
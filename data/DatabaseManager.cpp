@@ -5,6 +5,16 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QDebug>
+#include <QSet>
+#include <QElapsedTimer>
+#include "../common/SortKey.h"
+#include "../common/PinyinHelper.h"
+#include "../common/StallWatchdog.h"
+
+// 排序键算法版本：修改 SortKey::build 的规则时递增，启动时自动重算
+static const int kSortKeyVersion = 1;
+// 后台重算排序键时每批（每个事务）的行数
+static const int kSortKeyBatchSize = 2000;
 
 DatabaseManager& DatabaseManager::instance() {
     static DatabaseManager instance;
@@ -67,12 +77,23 @@ bool DatabaseManager::initialize(const QString& dbPath) {
         qDebug() << "✅ 外键约束已启用";
     }
 
+    // WAL 模式：UI 线程写入时，查询线程的读取不会被阻塞
+    if (!query.exec("PRAGMA journal_mode = WAL")) {
+        qWarning() << "⚠️ 无法启用 WAL 模式:" << query.lastError().text();
+    }
+
     // 创建表
     if (!createTablesIfNotExist()) {
         qCritical() << "❌ 创建数据库表失败";
         return false;
     }
 
+    // 旧库升级（补列、补排序键）
+    if (!migrateSchema()) {
+        qCritical() << "❌ 数据库升级失败";
+        return false;
+    }
+
     m_initialized = true;
     qDebug() << "✅ DatabaseManager 初始化完成";
     return true;
@@ -82,6 +103,96 @@ QSqlDatabase DatabaseManager::getConnection() {
     return QSqlDatabase::database();
 }
 
+QSqlDatabase DatabaseManager::openThreadConnection(const QString& connectionName) {
+    if (QSqlDatabase::contains(connectionName)) {
+        QSqlDatabase existing = QSqlDatabase::database(connectionName);
+        if (existing.isOpen()) {
+            return existing;
+        }
+    }
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(m_databasePath);
+
+    if (!db.open()) {
+        qWarning() << "❌ 无法打开线程连接" << connectionName << ":" << db.lastError().text();
+        return db;
+    }
+
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA foreign_keys = ON")) {
+        qWarning() << "⚠️ 线程连接无法启用外键约束:" << query.lastError().text();
+    }
+
+    qDebug() << "✅ 线程连接已打开:" << connectionName;
+    return db;
+}
+
+void DatabaseManager::closeThreadConnection(const QString& connectionName) {
+    if (!QSqlDatabase::contains(connectionName)) {
+        return;
+    }
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        if (db.isOpen()) {
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    qDebug() << "线程连接已关闭:" << connectionName;
+}
+
+bool DatabaseManager::beginTransaction() {
+    if (m_transactionDepth++ > 0) {
+        return true; // 已处于外层事务中
+    }
+
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.transaction()) {
+        qWarning() << "⚠️ 开启事务失败:" << db.lastError().text();
+        m_transactionDepth = 0;
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::commitTransaction() {
+    if (m_transactionDepth <= 0) {
+        qWarning() << "⚠️ commitTransaction: 当前没有活动事务";
+        return false;
+    }
+    if (--m_transactionDepth > 0) {
+        return true; // 由最外层统一提交
+    }
+
+    StallWatchdog::Scope stallScope("DatabaseManager::commitTransaction");
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.commit()) {
+        qWarning() << "⚠️ 提交事务失败:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::rollbackTransaction() {
+    if (m_transactionDepth <= 0) {
+        qWarning() << "⚠️ rollbackTransaction: 当前没有活动事务";
+        return false;
+    }
+    if (--m_transactionDepth > 0) {
+        // 内层回滚不影响外层：内层的批量方法只在“未写入任何数据”时回滚
+        return true;
+    }
+
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.rollback()) {
+        qWarning() << "⚠️ 回滚事务失败:" << db.lastError().text();
+        return false;
+    }
+    return true;
+}
+
 bool DatabaseManager::createTablesIfNotExist() {
     QSqlQuery query;
 
@@ -96,7 +207,9 @@ bool DatabaseManager::createTablesIfNotExist() {
             cover_url TEXT,
             duration_seconds INTEGER,
             download_date TEXT NOT NULL,
-            is_favorite INTEGER DEFAULT 0
+            is_favorite INTEGER DEFAULT 0,
+            title_sort_key BLOB,
+            artist_sort_key BLOB
         )
     )";
 
@@ -138,6 +251,197 @@ bool DatabaseManager::createTablesIfNotExist() {
     }
     qDebug() << "✅ playlist_songs 表已创建";
 
+    // 创建 app_meta 表（数据库级别的元信息，如排序键的生成方式）
+    QString createMetaTable = R"(
+        CREATE TABLE IF NOT EXISTS app_meta (
+            key TEXT PRIMARY KEY,
+            value TEXT
+        )
+    )";
+
+    if (!query.exec(createMetaTable)) {
+        qCritical() << "❌ 创建 app_meta 表失败:" << query.lastError().text();
+        return false;
+    }
+
     qDebug() << "✅ 所有数据库表已创建";
     return true;
 }
+
+bool DatabaseManager::migrateSchema() {
+    QSqlQuery query;
+
+    // 1) 旧库补充排序键列
+    QSet<QString> columns;
+    if (query.exec("PRAGMA table_info(songs)")) {
+        while (query.next()) columns.insert(query.value("name").toString());
+    }
+    for (const QString& column : { QStringLiteral("title_sort_key"), QStringLiteral("artist_sort_key") }) {
+        if (columns.contains(column)) continue;
+        if (!query.exec(QString("ALTER TABLE songs ADD COLUMN %1 BLOB").arg(column))) {
+            qCritical() << "❌ 添加列失败:" << column << query.lastError().text();
+            return false;
+        }
+        qDebug() << "✅ songs 表已添加列:" << column;
+    }
+
+    // BLOB 按字节比较，可直接用于 ORDER BY
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_songs_title_sort_key ON songs(title_sort_key)")) {
+        qWarning() << "⚠️ 创建排序键索引失败:" << query.lastError().text();
+    }
+
+    // 2) 排序方式或算法变化时全部重算，否则只补缺失的
+    const QString signature = sortKeySignature(SortKey::configuredMode());
+    const bool modeChanged = readMeta("sort_key_signature") != signature;
+    if (!refreshSortKeys(!modeChanged)) {
+        return false;
+    }
+    if (modeChanged) writeMeta("sort_key_signature", signature);
+    return true;
+}
+
+// 在调用线程用独立的命名连接重算：按 rowid 分批，每批一个短事务，UI 线程的写入不会被长时间挡住；
+// 重算期间新插入的行 rowid 更大，也会被扫到
+bool DatabaseManager::rebuildSortKeys(const QString& connectionName, SortKey::Mode mode, qint64* lastRowId) {
+    bool ok = true;
+    qint64 last = 0;
+    {
+        QSqlDatabase db = openThreadConnection(connectionName);
+        if (!db.isOpen()) return false;
+
+        QElapsedTimer timer;
+        timer.start();
+        int total = 0;
+        while (true) {
+            QSqlQuery select(db);
+            select.prepare("SELECT rowid, id, title, artist FROM songs WHERE rowid > ? ORDER BY rowid LIMIT ?");
+            select.addBindValue(last);
+            select.addBindValue(kSortKeyBatchSize);
+            if (!select.exec()) {
+                qWarning() << "⚠️ 读取歌曲失败:" << select.lastError().text();
+                ok = false;
+                break;
+            }
+            QList<SortKeyRow> rows;
+            while (select.next()) {
+                last = select.value(0).toLongLong();
+                rows.append({ select.value(1).toString(), select.value(2).toString(), select.value(3).toString() });
+            }
+            if (rows.isEmpty()) break;
+            if (!updateSortKeys(db, rows, mode)) {
+                ok = false;
+                break;
+            }
+            total += rows.size();
+        }
+        if (ok) {
+            writeMeta("sort_key_signature", sortKeySignature(mode), db);
+            qDebug() << "✅ 已重算排序键" << total << "首，耗时" << timer.elapsed() << "ms";
+        }
+    }
+    closeThreadConnection(connectionName);
+
+    if (lastRowId) *lastRowId = last;
+    return ok;
+}
+
+bool DatabaseManager::refreshSortKeysSince(qint64 afterRowId, const QStringList& ids) {
+    QString sql = "SELECT id, title, artist FROM songs WHERE rowid > ?";
+    if (!ids.isEmpty()) {
+        QStringList marks;
+        for (int i = 0; i < ids.size(); ++i) marks << "?";
+        sql += QString(" OR id IN (%1)").arg(marks.join(','));
+    }
+
+    QSqlQuery select;
+    select.prepare(sql);
+    select.addBindValue(afterRowId);
+    for (const QString& id : ids) select.addBindValue(id);
+    if (!select.exec()) {
+        qWarning() << "⚠️ 读取歌曲失败:" << select.lastError().text();
+        return false;
+    }
+    QList<SortKeyRow> rows;
+    while (select.next()) {
+        rows.append({ select.value(0).toString(), select.value(1).toString(), select.value(2).toString() });
+    }
+    return rows.isEmpty() || updateSortKeys(QSqlDatabase::database(), rows, SortKey::configuredMode());
+}
+
+bool DatabaseManager::refreshSortKeys(bool onlyMissing) {
+    QSqlQuery select;
+    const QString sql = onlyMissing
+        ? "SELECT id, title, artist FROM songs WHERE title_sort_key IS NULL OR artist_sort_key IS NULL"
+        : "SELECT id, title, artist FROM songs";
+    if (!select.exec(sql)) {
+        qWarning() << "⚠️ 读取歌曲失败:" << select.lastError().text();
+        return false;
+    }
+    QList<SortKeyRow> rows;
+    while (select.next()) {
+        rows.append({ select.value(0).toString(), select.value(1).toString(), select.value(2).toString() });
+    }
+    if (rows.isEmpty()) return true;
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!updateSortKeys(QSqlDatabase::database(), rows, SortKey::configuredMode())) return false;
+
+    qDebug() << "✅ 已计算排序键" << rows.size() << "首，耗时" << timer.elapsed() << "ms";
+    return true;
+}
+
+// 默认连接走可嵌套事务（可能处于上层批量作用域中），命名连接直接开事务
+bool DatabaseManager::updateSortKeys(QSqlDatabase db, const QList<SortKeyRow>& rows, SortKey::Mode mode) {
+    const bool defaultConnection = db.connectionName() == QLatin1String(QSqlDatabase::defaultConnection);
+    if (!(defaultConnection ? beginTransaction() : db.transaction())) return false;
+
+    QSqlQuery update(db);
+    update.prepare("UPDATE songs SET title_sort_key = ?, artist_sort_key = ? WHERE id = ?");
+    for (const SortKeyRow& row : rows) {
+        update.addBindValue(SortKey::build(row.title, mode));
+        update.addBindValue(SortKey::build(row.artist, mode));
+        update.addBindValue(row.id);
+        if (!update.exec()) {
+            qWarning() << "⚠️ 更新排序键失败:" << update.lastError().text();
+            if (defaultConnection) rollbackTransaction();
+            else db.rollback();
+            return false;
+        }
+    }
+    if (defaultConnection) return commitTransaction();
+    if (!db.commit()) {
+        qWarning() << "⚠️ 提交事务失败:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+    return true;
+}
+
+QString DatabaseManager::sortKeySignature(SortKey::Mode mode) const {
+    // 算法版本 : 排序方式 : 是否有完整拼音表（无表时只能按首字母分组）
+    return QString("%1:%2:%3")
+        .arg(kSortKeyVersion)
+        .arg(static_cast<int>(mode))
+        .arg(PinyinHelper::hasFullTable() ? "full" : "initials");
+}
+
+QString DatabaseManager::readMeta(const QString& key) {
+    QSqlQuery query;
+    query.prepare("SELECT value FROM app_meta WHERE key = ?");
+    query.addBindValue(key);
+    if (query.exec() && query.next()) {
+        return query.value(0).toString();
+    }
+    return QString();
+}
+
+void DatabaseManager::writeMeta(const QString& key, const QString& value, QSqlDatabase db) {
+    QSqlQuery query(db);
+    query.prepare("INSERT OR REPLACE INTO app_meta (key, value) VALUES (?, ?)");
+    query.addBindValue(key);
+    query.addBindValue(value);
+    if (!query.exec()) {
+        qWarning() << "⚠️ 写入 app_meta 失败:" << query.lastError().text();
+    }
+}
@@ -2,6 +2,8 @@
 #include <QObject>
 #include <QSqlDatabase>
 #include <QString>
+#include <QList>
+#include "../common/SortKey.h"
 
 class DatabaseManager : public QObject {
     Q_OBJECT
@@ -10,9 +12,28 @@ public:
 
     bool initialize(const QString& dbPath);
     QSqlDatabase getConnection();
+
+    // 为调用线程打开独立的命名连接（QSqlDatabase 连接不能跨线程使用）
+    QSqlDatabase openThreadConnection(const QString& connectionName);
+    void closeThreadConnection(const QString& connectionName);
     bool isInitialized() const { return m_initialized; }
     QString getDatabasePath() const { return m_databasePath; }
 
+    // ========== 可嵌套事务 ==========
+    // 仅最外层真正执行 BEGIN/COMMIT/ROLLBACK；内层调用只增减计数，
+    // 使仓储的批量方法可以安全地运行在上层（如 LibraryService 批量作用域）的事务中
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
+    bool inTransaction() const { return m_transactionDepth > 0; }
+
+    // ========== 排序键 ==========
+    // 按给定方式重新计算所有歌曲的排序键：可在任意线程调用，使用该线程的命名连接（用完关闭）；
+    // lastRowId 返回扫到的最大 rowid，供切换完成后补算之后插入的行
+    bool rebuildSortKeys(const QString& connectionName, SortKey::Mode mode, qint64* lastRowId = nullptr);
+    // 默认连接：按当前配置补算 rowid 大于 afterRowId 的行及 ids 指定的行
+    bool refreshSortKeysSince(qint64 afterRowId, const QStringList& ids);
+
 private:
     explicit DatabaseManager(QObject* parent = nullptr);
     ~DatabaseManager() override = default;
@@ -20,7 +41,16 @@ private:
     DatabaseManager& operator=(const DatabaseManager&) = delete;
 
     bool createTablesIfNotExist();
+    bool migrateSchema();
+    struct SortKeyRow { QString id, title, artist; };
+
+    bool refreshSortKeys(bool onlyMissing);
+    bool updateSortKeys(QSqlDatabase db, const QList<SortKeyRow>& rows, SortKey::Mode mode);
+    QString sortKeySignature(SortKey::Mode mode) const;
+    QString readMeta(const QString& key);
+    void writeMeta(const QString& key, const QString& value, QSqlDatabase db = QSqlDatabase::database());
 
     bool m_initialized = false;
     QString m_databasePath;
+    int m_transactionDepth = 0;
 };
@@ -7,8 +7,20 @@
 PlaylistRepository::PlaylistRepository(QObject* parent) : QObject(parent) {
 }
 
+PlaylistRepository::PlaylistRepository(const QString& connectionName, QObject* parent)
+    : QObject(parent)
+    , m_connectionName(connectionName)
+{
+}
+
+QSqlDatabase PlaylistRepository::database() const {
+    return m_connectionName.isEmpty()
+        ? QSqlDatabase::database()
+        : QSqlDatabase::database(m_connectionName);
+}
+
 bool PlaylistRepository::save(const Playlist& playlist) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare(R"(
         INSERT OR REPLACE INTO playlists (id, name, description) 
         VALUES (?, ?, ?)
@@ -32,7 +44,7 @@ bool PlaylistRepository::update(const Playlist& playlist) {
 }
 
 bool PlaylistRepository::deleteById(const QString& id) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("DELETE FROM playlists WHERE id = ?");
     query.addBindValue(id);
 
@@ -48,7 +60,7 @@ bool PlaylistRepository::deleteById(const QString& id) {
 
 QList<Playlist> PlaylistRepository::findAll() {
     QList<Playlist> playlists;
-    QSqlQuery query("SELECT * FROM playlists ORDER BY name");
+    QSqlQuery query("SELECT * FROM playlists ORDER BY name", database());
 
     while (query.next()) {
         playlists.append(playlistFromQuery(query));
@@ -59,7 +71,7 @@ QList<Playlist> PlaylistRepository::findAll() {
 }
 
 Playlist PlaylistRepository::findById(const QString& id) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("SELECT * FROM playlists WHERE id = ?");
     query.addBindValue(id);
 
@@ -71,7 +83,7 @@ Playlist PlaylistRepository::findById(const QString& id) {
 }
 
 Playlist PlaylistRepository::findByName(const QString& name) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("SELECT * FROM playlists WHERE name = ?");
     query.addBindValue(name);
 
@@ -83,7 +95,7 @@ Playlist PlaylistRepository::findByName(const QString& name) {
 }
 
 bool PlaylistRepository::addSongToPlaylist(const QString& playlistId, const QString& songId) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("INSERT OR IGNORE INTO playlist_songs (playlist_id, song_id) VALUES (?, ?)");
     query.addBindValue(playlistId);
     query.addBindValue(songId);
@@ -97,7 +109,7 @@ bool PlaylistRepository::addSongToPlaylist(const QString& playlistId, const QStr
 }
 
 bool PlaylistRepository::removeSongFromPlaylist(const QString& playlistId, const QString& songId) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("DELETE FROM playlist_songs WHERE playlist_id = ? AND song_id = ?");
     query.addBindValue(playlistId);
     query.addBindValue(songId);
@@ -107,12 +119,12 @@ bool PlaylistRepository::removeSongFromPlaylist(const QString& playlistId, const
 
 QList<Song> PlaylistRepository::getSongsInPlaylist(const QString& playlistId) {
     QList<Song> songs;
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare(R"(
         SELECT s.* FROM songs s
         INNER JOIN playlist_songs ps ON s.id = ps.song_id
         WHERE ps.playlist_id = ?
-        ORDER BY s.title
+        ORDER BY s.title_sort_key
     )");
     query.addBindValue(playlistId);
 
@@ -128,6 +140,8 @@ QList<Song> PlaylistRepository::getSongsInPlaylist(const QString& playlistId) {
             song.setDurationSeconds(query.value("duration_seconds").toLongLong());
             song.setDownloadDate(QDateTime::fromString(query.value("download_date").toString(), Qt::ISODate));
             song.setFavorite(query.value("is_favorite").toInt() == 1);
+            song.setTitleSortKey(query.value("title_sort_key").toByteArray());
+            song.setArtistSortKey(query.value("artist_sort_key").toByteArray());
 
             songs.append(song);
         }
@@ -137,7 +151,7 @@ QList<Song> PlaylistRepository::getSongsInPlaylist(const QString& playlistId) {
 }
 
 int PlaylistRepository::count() {
-    QSqlQuery query("SELECT COUNT(*) FROM playlists");
+    QSqlQuery query("SELECT COUNT(*) FROM playlists", database());
     if (query.exec() && query.next()) {
         return query.value(0).toInt();
     }
@@ -145,7 +159,7 @@ int PlaylistRepository::count() {
 }
 
 int PlaylistRepository::getSongCountInPlaylist(const QString& playlistId) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("SELECT COUNT(*) FROM playlist_songs WHERE playlist_id = ?");
     query.addBindValue(playlistId);
 
@@ -173,10 +187,10 @@ int PlaylistRepository::addSongsToPlaylist(const QString& playlistId, const QStr
     int successCount = 0;
 
     // 使用事务
-    QSqlDatabase db = QSqlDatabase::database();
-    db.transaction();
+    DatabaseManager& dbm = DatabaseManager::instance();
+    dbm.beginTransaction();
 
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("INSERT OR IGNORE INTO playlist_songs (playlist_id, song_id) VALUES (?, ?)");
 
     for (const QString& songId : songIds) {
@@ -196,11 +210,11 @@ int PlaylistRepository::addSongsToPlaylist(const QString& playlistId, const QStr
     }
 
     if (successCount > 0) {
-        db.commit();
+        dbm.commitTransaction();
         qDebug() << "✅ PlaylistRepository: 成功添加" << successCount << "首歌曲到歌单";
     }
     else {
-        db.rollback();
+        dbm.rollbackTransaction();
         qWarning() << "⚠️ PlaylistRepository: 批量添加失败，已回滚";
     }
 
@@ -212,7 +226,7 @@ bool PlaylistRepository::isSongInPlaylist(const QString& playlistId, const QStri
         return false;
     }
 
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("SELECT 1 FROM playlist_songs WHERE playlist_id = ? AND song_id = ? LIMIT 1");
     query.addBindValue(playlistId);
     query.addBindValue(songId);
@@ -224,6 +238,21 @@ bool PlaylistRepository::isSongInPlaylist(const QString& playlistId, const QStri
     return false;
 }
 
+QList<QPair<QString, QString>> PlaylistRepository::getAllMemberships() {
+    QList<QPair<QString, QString>> memberships;
+    QSqlQuery query(database());
+    query.setForwardOnly(true);
+
+    if (!query.exec("SELECT playlist_id, song_id FROM playlist_songs")) {
+        qWarning() << "读取歌单关联失败:" << query.lastError().text();
+        return memberships;
+    }
+    while (query.next()) {
+        memberships.append({ query.value(0).toString(), query.value(1).toString() });
+    }
+    return memberships;
+}
+
 int PlaylistRepository::removeSongsFromPlaylist(const QString& playlistId, const QStringList& songIds) {
     if (playlistId.isEmpty() || songIds.isEmpty()) {
         qWarning() << "PlaylistRepository: 批量移除失败 - 参数为空";
@@ -232,8 +261,8 @@ int PlaylistRepository::removeSongsFromPlaylist(const QString& playlistId, const
 
     int successCount = 0;
 
-    QSqlDatabase db = QSqlDatabase::database();
-    db.transaction();
+    DatabaseManager& dbm = DatabaseManager::instance();
+    dbm.beginTransaction();
 
     for (const QString& songId : songIds) {
         if (removeSongFromPlaylist(playlistId, songId)) {
@@ -242,11 +271,11 @@ int PlaylistRepository::removeSongsFromPlaylist(const QString& playlistId, const
     }
 
     if (successCount > 0) {
-        db.commit();
+        dbm.commitTransaction();
         qDebug() << "✅ PlaylistRepository: 成功从歌单移除" << successCount << "首歌曲";
     }
     else {
-        db.rollback();
+        dbm.rollbackTransaction();
     }
 
     return successCount;
@@ -258,7 +287,7 @@ bool PlaylistRepository::clearPlaylist(const QString& playlistId) {
         return false;
     }
 
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("DELETE FROM playlist_songs WHERE playlist_id = ?");
     query.addBindValue(playlistId);
 
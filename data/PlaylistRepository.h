@@ -2,8 +2,10 @@
 #include "../common/entities/Playlist.h"
 #include "../common/entities/Song.h"
 #include <QList>
+#include <QPair>
 #include <QString>
 #include <QObject>
+#include <QSqlDatabase>
 
 class PlaylistRepository : public QObject {
     Q_OBJECT
@@ -11,6 +13,9 @@ class PlaylistRepository : public QObject {
 public:
     explicit PlaylistRepository(QObject* parent = nullptr);
 
+    // 使用指定的命名连接（如查询线程的独立连接）；需在该连接所属线程中使用
+    explicit PlaylistRepository(const QString& connectionName, QObject* parent = nullptr);
+
     // Playlist CRUD
     bool save(const Playlist& playlist);
     bool update(const Playlist& playlist);
@@ -47,6 +52,12 @@ public:
      */
     bool isSongInPlaylist(const QString& playlistId, const QString& songId);
 
+    /**
+     * @brief 读取全部歌单-歌曲关联（用于构建内存中的歌单成员索引）
+     * @return (playlistId, songId) 列表
+     */
+    QList<QPair<QString, QString>> getAllMemberships();
+
     /**
      * @brief 从歌单中移除多首歌曲
      * @param playlistId 歌单ID
@@ -63,5 +74,8 @@ public:
     bool clearPlaylist(const QString& playlistId);
 
 private:
+    QSqlDatabase database() const;
     Playlist playlistFromQuery(const class QSqlQuery& query);
+
+    QString m_connectionName;
 };
@@ -1,5 +1,6 @@
 #include "SongRepository.h"
 #include "DatabaseManager.h"
+#include "../common/SortKey.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
@@ -9,15 +10,30 @@
 SongRepository::SongRepository(QObject* parent) : QObject(parent) {
 }
 
+SongRepository::SongRepository(const QString& connectionName, QObject* parent)
+    : QObject(parent)
+    , m_connectionName(connectionName)
+{
+}
+
+QSqlDatabase SongRepository::database() const {
+    return m_connectionName.isEmpty()
+        ? QSqlDatabase::database()
+        : QSqlDatabase::database(m_connectionName);
+}
+
 bool SongRepository::save(const Song& song) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare(R"(
         INSERT OR REPLACE INTO songs (
             id, title, artist, bilibili_url, local_file_path, 
-            cover_url, duration_seconds, download_date, is_favorite
-        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
+            cover_url, duration_seconds, download_date, is_favorite,
+            title_sort_key, artist_sort_key
+        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
     )");
 
+    const SortKey::Mode sortMode = SortKey::configuredMode();
+
     query.addBindValue(song.getId());
     query.addBindValue(song.getTitle());
     query.addBindValue(song.getArtist());
@@ -27,6 +43,8 @@ bool SongRepository::save(const Song& song) {
     query.addBindValue(static_cast<qlonglong>(song.getDurationSeconds())); // 修复：强制转换为 qlonglong
     query.addBindValue(song.getDownloadDate().toString(Qt::ISODate));
     query.addBindValue(song.isFavorite() ? 1 : 0);
+    query.addBindValue(SortKey::build(song.getTitle(), sortMode));
+    query.addBindValue(SortKey::build(song.getArtist(), sortMode));
 
     if (!query.exec()) {
         qWarning() << "保存歌曲失败:" << query.lastError().text();
@@ -42,7 +60,7 @@ bool SongRepository::update(const Song& song) {
 }
 
 bool SongRepository::deleteById(const QString& id) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("DELETE FROM songs WHERE id = ?");
     query.addBindValue(id);
 
@@ -58,7 +76,7 @@ bool SongRepository::deleteById(const QString& id) {
 
 QList<Song> SongRepository::findAll() {
     QList<Song> songs;
-    QSqlQuery query("SELECT * FROM songs ORDER BY download_date DESC");
+    QSqlQuery query("SELECT * FROM songs ORDER BY download_date DESC", database());
 
     while (query.next()) {
         songs.append(songFromQuery(query));
@@ -69,7 +87,7 @@ QList<Song> SongRepository::findAll() {
 }
 
 Song SongRepository::findById(const QString& id) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("SELECT * FROM songs WHERE id = ?");
     query.addBindValue(id);
 
@@ -80,10 +98,42 @@ Song SongRepository::findById(const QString& id) {
     return Song(); // 返回空对象
 }
 
+QList<Song> SongRepository::findByIds(const QStringList& ids) {
+    QList<Song> songs;
+    if (ids.isEmpty()) return songs;
+    songs.reserve(ids.size());
+
+    // SQLite 旧版本的绑定参数上限为 999，分批查询
+    constexpr int kBatchSize = 500;
+    for (int offset = 0; offset < ids.size(); offset += kBatchSize) {
+        const int n = qMin(kBatchSize, int(ids.size()) - offset);
+
+        QString placeholders;
+        placeholders.reserve(n * 2);
+        for (int i = 0; i < n; ++i) {
+            placeholders += (i == 0) ? QStringLiteral("?") : QStringLiteral(",?");
+        }
+
+        QSqlQuery query(database());
+        query.prepare(QString("SELECT * FROM songs WHERE id IN (%1)").arg(placeholders));
+        for (int i = 0; i < n; ++i) {
+            query.addBindValue(ids.at(offset + i));
+        }
+        if (!query.exec()) {
+            qWarning() << "批量查询歌曲失败:" << query.lastError().text();
+            continue;
+        }
+        while (query.next()) {
+            songs.append(songFromQuery(query));
+        }
+    }
+    return songs;
+}
+
 QList<Song> SongRepository::findByTitle(const QString& title) {
     QList<Song> songs;
-    QSqlQuery query;
-    query.prepare("SELECT * FROM songs WHERE title LIKE ? ORDER BY title");
+    QSqlQuery query(database());
+    query.prepare("SELECT * FROM songs WHERE title LIKE ? ORDER BY title_sort_key");
     query.addBindValue("%" + title + "%");
 
     if (query.exec()) {
@@ -97,7 +147,7 @@ QList<Song> SongRepository::findByTitle(const QString& title) {
 
 QList<Song> SongRepository::findFavorites() {
     QList<Song> songs;
-    QSqlQuery query("SELECT * FROM songs WHERE is_favorite = 1 ORDER BY title");
+    QSqlQuery query("SELECT * FROM songs WHERE is_favorite = 1 ORDER BY title_sort_key", database());
 
     while (query.next()) {
         songs.append(songFromQuery(query));
@@ -108,7 +158,7 @@ QList<Song> SongRepository::findFavorites() {
 }
 
 int SongRepository::count() {
-    QSqlQuery query("SELECT COUNT(*) FROM songs");
+    QSqlQuery query("SELECT COUNT(*) FROM songs", database());
     if (query.exec() && query.next()) {
         return query.value(0).toInt();
     }
@@ -116,7 +166,7 @@ int SongRepository::count() {
 }
 
 bool SongRepository::exists(const QString& id) {
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("SELECT 1 FROM songs WHERE id = ? LIMIT 1");
     query.addBindValue(id);
 
@@ -134,6 +184,8 @@ Song SongRepository::songFromQuery(const QSqlQuery& query) {
     song.setDurationSeconds(query.value("duration_seconds").toLongLong());
     song.setDownloadDate(QDateTime::fromString(query.value("download_date").toString(), Qt::ISODate));
     song.setFavorite(query.value("is_favorite").toInt() == 1);
+    song.setTitleSortKey(query.value("title_sort_key").toByteArray());
+    song.setArtistSortKey(query.value("artist_sort_key").toByteArray());
 
     return song;
 }
@@ -144,10 +196,13 @@ bool SongRepository::updateSongInfo(const QString& id, const QString& title, con
         return false;
     }
 
-    QSqlQuery query;
-    query.prepare("UPDATE songs SET title = ?, artist = ? WHERE id = ?");
+    QSqlQuery query(database());
+    const SortKey::Mode sortMode = SortKey::configuredMode();
+    query.prepare("UPDATE songs SET title = ?, artist = ?, title_sort_key = ?, artist_sort_key = ? WHERE id = ?");
     query.addBindValue(title);
     query.addBindValue(artist);
+    query.addBindValue(SortKey::build(title, sortMode));
+    query.addBindValue(SortKey::build(artist, sortMode));
     query.addBindValue(id);
 
     if (!query.exec()) {
@@ -169,6 +224,17 @@ bool SongRepository::updateSongInfo(const QString& id, const QString& title, con
 }
 
 bool SongRepository::deleteSongWithFile(const QString& id) {
+    QString filePath;
+    if (!deleteSongRecord(id, &filePath)) {
+        return false;
+    }
+
+    // 删除本地文件（即使文件删除失败，数据库记录已删除，仍返回 true）
+    removeLocalFile(filePath);
+    return true;
+}
+
+bool SongRepository::deleteSongRecord(const QString& id, QString* filePath) {
     if (id.isEmpty()) {
         qWarning() << "SongRepository: 删除失败 - ID 为空";
         return false;
@@ -187,25 +253,27 @@ bool SongRepository::deleteSongWithFile(const QString& id) {
         return false;
     }
 
-    // 删除本地文件
-    QString filePath = song.getLocalFilePath();
-    if (!filePath.isEmpty() && QFile::exists(filePath)) {
-        QFile file(filePath);
-        if (file.remove()) {
-            qDebug() << "✅ SongRepository: 成功删除本地文件:" << filePath;
-        }
-        else {
-            qWarning() << "⚠️ SongRepository: 删除本地文件失败:" << filePath;
-            qWarning() << "  错误:" << file.errorString();
-            // 注意：即使文件删除失败，数据库记录已删除，返回 true
-        }
+    if (filePath) {
+        *filePath = song.getLocalFilePath();
     }
-    else {
+    qDebug() << "✅ SongRepository: 歌曲记录已删除:" << song.getTitle();
+    return true;
+}
+
+void SongRepository::removeLocalFile(const QString& filePath) {
+    if (filePath.isEmpty() || !QFile::exists(filePath)) {
         qDebug() << "ℹ️ SongRepository: 本地文件不存在或路径为空:" << filePath;
+        return;
     }
 
-    qDebug() << "✅ SongRepository: 歌曲已完全删除:" << song.getTitle();
-    return true;
+    QFile file(filePath);
+    if (file.remove()) {
+        qDebug() << "✅ SongRepository: 成功删除本地文件:" << filePath;
+    }
+    else {
+        qWarning() << "⚠️ SongRepository: 删除本地文件失败:" << filePath;
+        qWarning() << "  错误:" << file.errorString();
+    }
 }
 
 bool SongRepository::toggleFavorite(const QString& id) {
@@ -224,7 +292,7 @@ bool SongRepository::toggleFavorite(const QString& id) {
     // 切换状态
     bool newFavoriteState = !song.isFavorite();
 
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare("UPDATE songs SET is_favorite = ? WHERE id = ?");
     query.addBindValue(newFavoriteState ? 1 : 0);
     query.addBindValue(id);
@@ -251,7 +319,7 @@ QList<Song> SongRepository::searchByKeyword(const QString& keyword) {
         return findAll();
     }
 
-    QSqlQuery query;
+    QSqlQuery query(database());
     query.prepare(R"(
         SELECT * FROM songs 
         WHERE title LIKE ? OR artist LIKE ? 
@@ -275,33 +343,42 @@ QList<Song> SongRepository::searchByKeyword(const QString& keyword) {
     return songs;
 }
 
-int SongRepository::deleteBatch(const QStringList& ids) {
+QStringList SongRepository::deleteBatch(const QStringList& ids, QStringList* filePaths) {
+    QStringList deletedIds;
     if (ids.isEmpty()) {
         qWarning() << "SongRepository: 批量删除失败 - ID 列表为空";
-        return 0;
+        return deletedIds;
     }
 
-    int successCount = 0;
+    QStringList paths;
 
-    // 使用事务提高性能
-    QSqlDatabase db = QSqlDatabase::database();
-    db.transaction();
+    // 使用事务提高性能；本地文件由调用方在事务提交成功后删除，回滚时文件仍在
+    DatabaseManager& dbm = DatabaseManager::instance();
+    dbm.beginTransaction();
 
     for (const QString& id : ids) {
-        if (deleteSongWithFile(id)) {
-            successCount++;
+        QString filePath;
+        if (deleteSongRecord(id, &filePath)) {
+            deletedIds << id;
+            paths << filePath;
         }
     }
 
-    if (successCount > 0) {
-        db.commit();
-        qDebug() << "✅ SongRepository: 批量删除成功，共删除" << successCount << "首歌曲";
-    }
-    else {
-        db.rollback();
+    if (deletedIds.isEmpty()) {
+        dbm.rollbackTransaction();
         qWarning() << "⚠️ SongRepository: 批量删除失败，已回滚";
+        return deletedIds;
+    }
+
+    if (!dbm.commitTransaction()) {
+        qWarning() << "⚠️ SongRepository: 批量删除提交失败";
+        return QStringList();
     }
 
-    return successCount;
+    qDebug() << "✅ SongRepository: 批量删除成功，共删除" << deletedIds.size() << "首歌曲";
+    if (filePaths) {
+        *filePaths << paths;
+    }
+    return deletedIds;
 }
 
@@ -2,7 +2,9 @@
 #include "../common/entities/Song.h"
 #include <QList>
 #include <QString>
+#include <QStringList>
 #include <QObject>
+#include <QSqlDatabase>
 
 class SongRepository : public QObject {
     Q_OBJECT
@@ -10,6 +12,9 @@ class SongRepository : public QObject {
 public:
     explicit SongRepository(QObject* parent = nullptr);
 
+    // 使用指定的命名连接（如查询线程的独立连接）；需在该连接所属线程中使用
+    explicit SongRepository(const QString& connectionName, QObject* parent = nullptr);
+
     // CRUD 操作
     bool save(const Song& song);
     bool update(const Song& song);
@@ -18,6 +23,8 @@ public:
     // 查询操作
     QList<Song> findAll();
     Song findById(const QString& id);
+    // 按 id 批量查询（WHERE id IN (...)，每批最多 500 个参数）；结果顺序不保证，找不到的 id 直接略过
+    QList<Song> findByIds(const QStringList& ids);
     QList<Song> findByTitle(const QString& title);
     QList<Song> findFavorites();
 
@@ -41,6 +48,21 @@ public:
      */
     bool deleteSongWithFile(const QString& id);
 
+    /**
+     * @brief 只删除歌曲记录，不动本地文件
+     * @param id 歌曲ID
+     * @param filePath 输出被删除歌曲的本地文件路径（可为 nullptr）
+     * @return 是否删除成功
+     * @note 在事务中调用时，应等事务提交成功后再用 removeLocalFile 删除文件
+     */
+    bool deleteSongRecord(const QString& id, QString* filePath = nullptr);
+
+    /**
+     * @brief 删除歌曲的本地文件（文件不存在或路径为空时忽略）
+     * @param filePath 本地文件路径
+     */
+    static void removeLocalFile(const QString& filePath);
+
     /**
      * @brief 切换歌曲的收藏状态
      * @param id 歌曲ID
@@ -56,12 +78,16 @@ public:
     QList<Song> searchByKeyword(const QString& keyword);
 
     /**
-     * @brief 批量删除歌曲
+     * @brief 批量删除歌曲记录（在一个事务中，不删除本地文件）
      * @param ids 歌曲ID列表
-     * @return 成功删除的数量
+     * @param filePaths 输出被删除歌曲的本地文件路径，供事务提交后删除（可为 nullptr）
+     * @return 实际删除的歌曲ID；事务提交失败时为空
      */
-    int deleteBatch(const QStringList& ids);
+    QStringList deleteBatch(const QStringList& ids, QStringList* filePaths = nullptr);
 
 private:
+    QSqlDatabase database() const;
     Song songFromQuery(const class QSqlQuery& query);
+
+    QString m_connectionName;
 };
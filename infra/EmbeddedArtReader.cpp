@@ -0,0 +1,386 @@
+#include "EmbeddedArtReader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+    // 单个元数据区最多读取的字节数（封面一般在几百 KB 以内）
+    constexpr qint64 kMaxMetadataBytes = 16 * 1024 * 1024;
+
+    // ID3v2 / FLAC 中的“封面（正面）”图片类型
+    constexpr int kFrontCoverType = 3;
+
+    quint32 readBE32(const char* p) {
+        const auto* u = reinterpret_cast<const uchar*>(p);
+        return (quint32(u[0]) << 24) | (quint32(u[1]) << 16) | (quint32(u[2]) << 8) | quint32(u[3]);
+    }
+
+    quint32 readBE24(const char* p) {
+        const auto* u = reinterpret_cast<const uchar*>(p);
+        return (quint32(u[0]) << 16) | (quint32(u[1]) << 8) | quint32(u[2]);
+    }
+
+    quint32 readLE32(const char* p) {
+        const auto* u = reinterpret_cast<const uchar*>(p);
+        return (quint32(u[3]) << 24) | (quint32(u[2]) << 16) | (quint32(u[1]) << 8) | quint32(u[0]);
+    }
+
+    quint32 readSynchsafe32(const char* p) {
+        const auto* u = reinterpret_cast<const uchar*>(p);
+        return (quint32(u[0] & 0x7f) << 21) | (quint32(u[1] & 0x7f) << 14)
+            | (quint32(u[2] & 0x7f) << 7) | quint32(u[3] & 0x7f);
+    }
+
+    // 去除 ID3 反同步（0xFF 0x00 -> 0xFF）
+    QByteArray removeUnsynchronisation(const QByteArray& in) {
+        QByteArray out;
+        out.reserve(in.size());
+        for (int i = 0; i < in.size(); ++i) {
+            out.append(in.at(i));
+            if (uchar(in.at(i)) == 0xFF && i + 1 < in.size() && in.at(i + 1) == 0) ++i;
+        }
+        return out;
+    }
+
+    // 跳过以 encoding 编码的 0 结尾字符串，返回其后的位置；失败返回 -1
+    int skipTerminatedString(const QByteArray& data, int pos, int encoding) {
+        const bool wide = (encoding == 1 || encoding == 2);
+        if (!wide) {
+            const int end = data.indexOf('\0', pos);
+            return end < 0 ? -1 : end + 1;
+        }
+        for (int i = pos; i + 1 < data.size(); i += 2) {
+            if (data.at(i) == 0 && data.at(i + 1) == 0) return i + 2;
+        }
+        return -1;
+    }
+
+    // 解析 APIC（v2.3/2.4）或 PIC（v2.2）帧体，返回图片字节与图片类型
+    QByteArray parsePictureFrame(const QByteArray& body, bool legacyPic, int* pictureType) {
+        if (body.size() < 4) return QByteArray();
+        const int encoding = uchar(body.at(0));
+        int pos = 1;
+        if (legacyPic) {
+            pos += 3; // 图片格式，如 "JPG"
+        }
+        else {
+            pos = body.indexOf('\0', pos); // MIME 类型
+            if (pos < 0) return QByteArray();
+            ++pos;
+        }
+        if (pos >= body.size()) return QByteArray();
+        *pictureType = uchar(body.at(pos++));
+        pos = skipTerminatedString(body, pos, encoding); // 描述
+        if (pos < 0 || pos >= body.size()) return QByteArray();
+        return body.mid(pos);
+    }
+
+    // 在 MP4 box 序列 [begin, end) 中查找指定类型的子 box，返回其内容范围
+    bool findMp4Box(const QByteArray& data, int begin, int end, const char* type, int* contentBegin, int* contentEnd) {
+        int pos = begin;
+        while (pos + 8 <= end) {
+            qint64 size = readBE32(data.constData() + pos);
+            int header = 8;
+            if (size == 1) {
+                if (pos + 16 > end) return false;
+                size = (qint64(readBE32(data.constData() + pos + 8)) << 32) | readBE32(data.constData() + pos + 12);
+                header = 16;
+            }
+            else if (size == 0) {
+                size = end - pos;
+            }
+            if (size < header || pos + size > end) return false;
+
+            if (memcmp(data.constData() + pos + 4, type, 4) == 0) {
+                *contentBegin = pos + header;
+                *contentEnd = int(pos + size);
+                return true;
+            }
+            pos += int(size);
+        }
+        return false;
+    }
+}
+
+QByteArray EmbeddedArtReader::read(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    const QByteArray magic = file.peek(12);
+    if (magic.size() < 12) return QByteArray();
+
+    if (magic.startsWith("ID3")) {
+        // MP3：可能在 ID3v2 之后还跟着 FLAC 流（少见），只读 ID3
+        return readId3v2(file);
+    }
+    if (magic.startsWith("fLaC")) {
+        return readFlac(file);
+    }
+    if (magic.mid(4, 4) == "ftyp") {
+        return readMp4(file);
+    }
+    if (magic.startsWith("OggS")) {
+        return readOgg(file);
+    }
+    if (magic.startsWith("RIFF") && magic.mid(8, 4) == "WAVE") {
+        // WAV：查找 "id3 " / "ID3 " 块
+        file.seek(12);
+        while (!file.atEnd()) {
+            const QByteArray chunk = file.read(8);
+            if (chunk.size() < 8) break;
+            const quint32 size = readLE32(chunk.constData() + 4);
+            if (chunk.startsWith("id3 ") || chunk.startsWith("ID3 ")) {
+                if (size > kMaxMetadataBytes) break;
+                return readId3v2(file);
+            }
+            if (!file.seek(file.pos() + size + (size & 1))) break;
+        }
+    }
+    return QByteArray();
+}
+
+QByteArray EmbeddedArtReader::readId3v2(QFile& file) {
+    const QByteArray header = file.read(10);
+    if (header.size() < 10 || !header.startsWith("ID3")) return QByteArray();
+
+    const int version = uchar(header.at(3));
+    const int flags = uchar(header.at(5));
+    const quint32 tagSize = readSynchsafe32(header.constData() + 6);
+    if (version < 2 || version > 4 || tagSize > kMaxMetadataBytes) return QByteArray();
+
+    QByteArray tag = file.read(tagSize);
+    if (version < 4 && (flags & 0x80)) {
+        tag = removeUnsynchronisation(tag);
+    }
+
+    int pos = 0;
+    if (version >= 3 && (flags & 0x40) && tag.size() >= 4) {
+        // 扩展头：v2.3 大小不含自身 4 字节，v2.4 为 synchsafe 且包含自身
+        const qint64 extLen = version == 3 ? qint64(readBE32(tag.constData())) + 4 : qint64(readSynchsafe32(tag.constData()));
+        if (extLen > tag.size()) return QByteArray(); // 长度越界（可能是恶意构造），放弃
+        pos = int(extLen);
+    }
+
+    const int idLen = version == 2 ? 3 : 4;
+    const int frameHeaderLen = version == 2 ? 6 : 10;
+    QByteArray fallback;
+
+    while (pos + frameHeaderLen <= tag.size()) {
+        const char* h = tag.constData() + pos;
+        if (h[0] == 0) break; // 填充区
+
+        const QByteArray id(h, idLen);
+        quint32 size = 0;
+        if (version == 2) size = readBE24(h + 3);
+        else if (version == 3) size = readBE32(h + 4);
+        else size = readSynchsafe32(h + 4);
+
+        const int bodyPos = pos + frameHeaderLen;
+        if (size == 0 || bodyPos + qint64(size) > tag.size()) break;
+
+        const bool isPicture = (version == 2) ? (id == "PIC") : (id == "APIC");
+        if (isPicture) {
+            QByteArray body = tag.mid(bodyPos, size);
+            if (version == 4) {
+                const int frameFlags = uchar(h[9]);
+                if (frameFlags & 0x01) body.remove(0, 4);                   // 数据长度指示
+                if (frameFlags & 0x02) body = removeUnsynchronisation(body); // 帧级反同步
+            }
+            int pictureType = -1;
+            const QByteArray image = parsePictureFrame(body, version == 2, &pictureType);
+            if (!image.isEmpty()) {
+                if (pictureType == kFrontCoverType) return image;
+                if (fallback.isEmpty()) fallback = image;
+            }
+        }
+        pos = bodyPos + int(size);
+    }
+    return fallback;
+}
+
+QByteArray EmbeddedArtReader::readFlac(QFile& file) {
+    file.seek(4);
+    QByteArray fallback;
+    bool last = false;
+    while (!last) {
+        const QByteArray header = file.read(4);
+        if (header.size() < 4) break;
+        last = uchar(header.at(0)) & 0x80;
+        const int type = uchar(header.at(0)) & 0x7f;
+        const quint32 length = readBE24(header.constData() + 1);
+
+        if (type == 6) { // PICTURE
+            const QByteArray block = file.read(length);
+            if (block.size() < 4) break;
+            const QByteArray image = parseFlacPictureBlock(block);
+            if (!image.isEmpty()) {
+                if (int(readBE32(block.constData())) == kFrontCoverType) return image;
+                if (fallback.isEmpty()) fallback = image;
+            }
+        }
+        else if (!file.seek(file.pos() + length)) {
+            break;
+        }
+    }
+    return fallback;
+}
+
+QByteArray EmbeddedArtReader::parseFlacPictureBlock(const QByteArray& block) {
+    // type(4) mimeLen(4) mime descLen(4) desc width(4) height(4) depth(4) colors(4) dataLen(4) data
+    qint64 pos = 4;
+    if (pos + 4 > block.size()) return QByteArray();
+    pos += 4 + readBE32(block.constData() + pos);
+    if (pos + 4 > block.size()) return QByteArray();
+    pos += 4 + readBE32(block.constData() + pos);
+    pos += 16;
+    if (pos + 4 > block.size()) return QByteArray();
+    const quint32 dataLen = readBE32(block.constData() + pos);
+    pos += 4;
+    if (pos + dataLen > block.size()) return QByteArray();
+    return block.mid(int(pos), int(dataLen));
+}
+
+QByteArray EmbeddedArtReader::readMp4(QFile& file) {
+    // 顶层 box 中找到 moov（可能在文件末尾），只读取 moov
+    file.seek(0);
+    QByteArray moov;
+    while (!file.atEnd()) {
+        const QByteArray header = file.read(8);
+        if (header.size() < 8) break;
+        qint64 size = readBE32(header.constData());
+        qint64 headerLen = 8;
+        if (size == 1) {
+            const QByteArray ext = file.read(8);
+            if (ext.size() < 8) break;
+            size = (qint64(readBE32(ext.constData())) << 32) | readBE32(ext.constData() + 4);
+            headerLen = 16;
+        }
+        else if (size == 0) {
+            size = file.size() - file.pos() + headerLen;
+        }
+        if (size < headerLen) break;
+
+        if (header.mid(4, 4) == "moov") {
+            if (size - headerLen > kMaxMetadataBytes) break;
+            moov = file.read(size - headerLen);
+            break;
+        }
+        if (!file.seek(file.pos() + size - headerLen)) break;
+    }
+    if (moov.isEmpty()) return QByteArray();
+
+    int b = 0, e = 0;
+    if (!findMp4Box(moov, 0, moov.size(), "udta", &b, &e)) return QByteArray();
+    if (!findMp4Box(moov, b, e, "meta", &b, &e)) return QByteArray();
+    // meta 通常是 FullBox（带 4 字节版本/标志），QuickTime 风格则没有
+    if (e - b >= 8 && memcmp(moov.constData() + b + 4, "hdlr", 4) != 0) b += 4;
+    if (!findMp4Box(moov, b, e, "ilst", &b, &e)) return QByteArray();
+    if (!findMp4Box(moov, b, e, "covr", &b, &e)) return QByteArray();
+    if (!findMp4Box(moov, b, e, "data", &b, &e)) return QByteArray();
+    if (e - b <= 8) return QByteArray();
+    return moov.mid(b + 8, e - b - 8); // 跳过类型指示与语言区域
+}
+
+QByteArray EmbeddedArtReader::readOgg(QFile& file) {
+    // 按页重组第一个逻辑流的前两个包：Opus 的 OpusTags / Vorbis 的注释头
+    file.seek(0);
+    QByteArray packet;
+    int packetIndex = 0;
+    quint32 serial = 0;
+    bool haveSerial = false;
+
+    while (packetIndex < 2 && file.pos() < kMaxMetadataBytes) {
+        const QByteArray header = file.read(27);
+        if (header.size() < 27 || !header.startsWith("OggS")) return QByteArray();
+        const quint32 pageSerial = readLE32(header.constData() + 14);
+        const int segments = uchar(header.at(26));
+        const QByteArray lacing = file.read(segments);
+        if (lacing.size() < segments) return QByteArray();
+
+        int bodySize = 0;
+        for (char l : lacing) bodySize += uchar(l);
+        const QByteArray body = file.read(bodySize);
+        if (body.size() < bodySize) return QByteArray();
+
+        if (!haveSerial) {
+            serial = pageSerial;
+            haveSerial = true;
+        }
+        if (pageSerial != serial) continue;
+
+        int offset = 0;
+        for (int i = 0; i < segments && packetIndex < 2; ++i) {
+            const int len = uchar(lacing.at(i));
+            if (packetIndex == 1) packet.append(body.constData() + offset, len);
+            offset += len;
+            if (len < 255) ++packetIndex; // 包结束
+        }
+    }
+
+    int pos = 0;
+    if (packet.startsWith("OpusTags")) pos = 8;
+    else if (packet.startsWith("\x03vorbis")) pos = 7;
+    else return QByteArray();
+
+    // 注释头：vendorLen vendor count { len "KEY=value" }
+    if (pos + 4 > packet.size()) return QByteArray();
+    const quint32 vendorLen = readLE32(packet.constData() + pos);
+    if (qint64(pos) + 4 + vendorLen + 4 > packet.size()) return QByteArray(); // 先在 64 位下检查，避免 int 溢出
+    pos += 4 + int(vendorLen);
+    const quint32 count = readLE32(packet.constData() + pos);
+    pos += 4;
+
+    QByteArray fallback;
+    for (quint32 i = 0; i < count && pos + 4 <= packet.size(); ++i) {
+        const quint32 len = readLE32(packet.constData() + pos);
+        pos += 4;
+        if (pos + qint64(len) > packet.size()) break;
+        const QByteArray comment = QByteArray::fromRawData(packet.constData() + pos, int(len));
+        pos += int(len);
+
+        const int eq = comment.indexOf('=');
+        if (eq <= 0) continue;
+        const QByteArray key = comment.left(eq).toUpper();
+        if (key == "METADATA_BLOCK_PICTURE") {
+            const QByteArray block = QByteArray::fromBase64(comment.mid(eq + 1));
+            const QByteArray image = parseFlacPictureBlock(block);
+            if (!image.isEmpty()) {
+                if (int(readBE32(block.constData())) == kFrontCoverType) return image;
+                if (fallback.isEmpty()) fallback = image;
+            }
+        }
+        else if (key == "COVERART" && fallback.isEmpty()) {
+            fallback = QByteArray::fromBase64(comment.mid(eq + 1));
+        }
+    }
+    return fallback;
+}
+
+QByteArray EmbeddedArtReader::readWithFfmpeg(const QString& filePath, const QString& ffmpegPath, int timeoutMs) {
+    if (ffmpegPath.isEmpty() || !QFileInfo::exists(ffmpegPath)) {
+        return QByteArray();
+    }
+
+    QProcess process;
+    process.start(ffmpegPath, QStringList()
+        << "-v" << "error"
+        << "-i" << filePath
+        << "-an" << "-map" << "0:v:0" << "-frames:v" << "1"
+        << "-c:v" << "copy"
+        << "-f" << "image2pipe" << "-");
+
+    if (!process.waitForFinished(timeoutMs)) {
+        process.kill();
+        process.waitForFinished(1000);
+        qWarning() << "EmbeddedArtReader: ffmpeg 抽取封面超时" << filePath;
+        return QByteArray();
+    }
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        return QByteArray();
+    }
+    return process.readAllStandardOutput();
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+
+class QFile;
+
+/**
+ * @brief 读取音频文件内嵌的封面图片（原始图片字节，JPEG/PNG 等）
+ *
+ * 直接解析容器元数据，无需启动外部进程：
+ * - MP3 / WAV：ID3v2 APIC / PIC 帧
+ * - FLAC：PICTURE 元数据块
+ * - M4A / MP4：moov/udta/meta/ilst/covr
+ * - Opus / Vorbis（Ogg）：METADATA_BLOCK_PICTURE 注释
+ * 以上均未找到时，可用 ffmpeg 抽取附图作为兜底。
+ *
+ * 阻塞 IO，只应在工作线程调用。
+ */
+class EmbeddedArtReader {
+public:
+    // 未找到封面时返回空
+    static QByteArray read(const QString& filePath);
+
+    // 使用 ffmpeg 抽取附图（ffmpegPath 为空或失败时返回空）
+    static QByteArray readWithFfmpeg(const QString& filePath, const QString& ffmpegPath, int timeoutMs = 5000);
+
+private:
+    static QByteArray readId3v2(QFile& file);
+    static QByteArray readFlac(QFile& file);
+    static QByteArray readMp4(QFile& file);
+    static QByteArray readOgg(QFile& file);
+    static QByteArray parseFlacPictureBlock(const QByteArray& block);
+};
@@ -1,5 +1,6 @@
 #include "FfmpegClient.h"
 #include "../common/AppConfig.h"
+#include "../common/StallWatchdog.h"
 #include <QProcess>
 #include <QDebug>
 
@@ -17,6 +18,7 @@ bool FfmpegClient::testFfmpegAvailable(const QString& ffmpegPath, QString* versi
         return false;
     }
 
+    StallWatchdog::Scope stallScope("FfmpegClient::testFfmpegAvailable");
     QProcess process;
     process.start(ffmpegPath, QStringList() << "-version");
 
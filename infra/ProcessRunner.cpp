@@ -1,4 +1,5 @@
 #include "ProcessRunner.h"
+#include "../common/StallWatchdog.h"
 #include <QDebug>
 #include <QRegularExpression>
 
@@ -53,6 +54,7 @@ bool ProcessRunner::start(const QString& program, const QStringList& arguments)
     env.insert("PYTHONIOENCODING", "utf-8");
     m_process->setProcessEnvironment(env);
 
+    StallWatchdog::Scope stallScope("ProcessRunner::start (waitForStarted)");
     m_process->start(program, arguments);
 
     if (!m_process->waitForStarted()) {
@@ -109,6 +111,7 @@ bool ProcessRunner::waitForFinished(int msecs) {
         return true; 
     }
 
+    StallWatchdog::Scope stallScope("ProcessRunner::waitForFinished");
     bool finished = m_process->waitForFinished(msecs);
 
     if (!finished) {
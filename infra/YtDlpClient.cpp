@@ -94,19 +94,22 @@ void YtDlpClient::startDownload(const QString& identifier, const QString& output
     }
 }
 
+ConfigSnapshot YtDlpClient::config() const {
+    return m_config ? m_config : AppConfig::instance().snapshot();
+}
+
 QStringList YtDlpClient::buildYtDlpArguments(const QString& identifier, const QString& outputTemplate, const DownloadOptions& options) {
     QStringList args;
+    const ConfigSnapshot cfg = config();
 
     // 添加 ffmpeg 路径
-    QString ffmpegPath = AppConfig::instance().getFfmpegPath();
-    if (!ffmpegPath.isEmpty()) {
-        args << "--ffmpeg-location" << ffmpegPath;
+    if (!cfg->ffmpegPath.isEmpty()) {
+        args << "--ffmpeg-location" << cfg->ffmpegPath;
     }
 
-    AppConfig& config = AppConfig::instance();
-    if (config.getProxyEnabled() && !config.getProxyUrl().isEmpty()) {
-        args << "--proxy" << config.getProxyUrl();
-        qDebug() << "✅ YtDlpClient: 使用代理:" << config.getProxyUrl();
+    if (cfg->proxyEnabled && !cfg->proxyUrl.isEmpty()) {
+        args << "--proxy" << cfg->proxyUrl;
+        qDebug() << "✅ YtDlpClient: 使用代理:" << cfg->proxyUrl;
     }
 
     // 添加下载配置选项
@@ -336,7 +339,7 @@ void YtDlpClient::parseOutputLine(const QString& line) {
 }
 
 QString YtDlpClient::getYtDlpPath() {
-    QString path = AppConfig::instance().getYtDlpPath();
+    QString path = config()->ytDlpPath;
     if (path.isEmpty() || !QFileInfo::exists(path)) {
         qWarning() << "YtDlpClient: yt-dlp 路径无效:" << path;
         return QString();
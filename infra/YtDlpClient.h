@@ -5,6 +5,7 @@
 #include "ProcessRunner.h"
 #include "DownloadConfig.h"
 #include "../common/entities/Song.h"
+#include "../common/AppConfig.h"
 
 class YtDlpClient : public QObject {
     Q_OBJECT
@@ -22,6 +23,9 @@ public:
     explicit YtDlpClient(QObject* parent = nullptr);
     ~YtDlpClient();
 
+    // 固定使用一份配置快照（工作线程中的任务在开始时捕获）；未设置时每次下载取当时的最新快照
+    void setConfigSnapshot(const ConfigSnapshot& config) { m_config = config; }
+
     // 保持向后兼容
     void downloadAudio(const QString& identifier, const QString& outputDir);
 
@@ -67,6 +71,9 @@ private:
     QString m_tempInfoJsonPath;
     QString m_tempAudioFilePath;
     DownloadOptions m_currentOptions;
+    ConfigSnapshot m_config;
+
+    ConfigSnapshot config() const;
 
     QStringList buildYtDlpArguments(const QString& identifier, const QString& outputTemplate, const DownloadOptions& options);
     QString extractVideoId(const QString& identifier);
@@ -1,34 +1,38 @@
 #include "AudioPlayer.h"
+#include "PcmRenderer.h"
 #include <QDebug>
 #include <QFileInfo>
 #include <QUrl>
+#include <utility>
 
 AudioPlayer::AudioPlayer(QObject* parent)
     : QObject(parent)
     , m_player(new QMediaPlayer(this))
     , m_audioOutput(new QAudioOutput(this))
+    , m_standbyPlayer(new QMediaPlayer(this))
+    , m_standbyOutput(new QAudioOutput(this))
     , m_currentState(PlaybackState::Stopped)
 {
-    // 设置音频输出
+    // 设置音频输出；待命播放器保持静音，直到接手播放
     m_player->setAudioOutput(m_audioOutput);
+    m_standbyPlayer->setAudioOutput(m_standbyOutput);
+    m_standbyOutput->setVolume(0.0f);
 
     // 连接基本信号
-    connect(m_player, &QMediaPlayer::playbackStateChanged,
-        this, &AudioPlayer::handlePlaybackStateChanged);
-    connect(m_player, &QMediaPlayer::positionChanged,
-        this, &AudioPlayer::positionChanged);
-    connect(m_player, &QMediaPlayer::durationChanged,
-        this, &AudioPlayer::durationChanged);
-    connect(m_player, &QMediaPlayer::mediaStatusChanged,
-        this, &AudioPlayer::handleMediaStatusChanged);
-
-    // 渐变定时器
+    connectPlayer(m_player);
+    connectPlayer(m_standbyPlayer);
+
+    // 渐变定时器：10ms 一步足够平滑，默认 0 间隔会在渐变期间空转事件循环
+    m_fadeTimer.setInterval(10);
+    m_fadeTimer.setTimerType(Qt::PreciseTimer);
     connect(&m_fadeTimer, &QTimer::timeout, this, [this]() {
         if (!m_isFading) return;
         qint64 elapsed = m_fadeClock.elapsed();
         float t = m_fadeDurationMs > 0 ? qMin(1.0f, float(elapsed) / float(m_fadeDurationMs)) : 1.0f;
         float v = m_fadeFrom + (m_fadeTo - m_fadeFrom) * t;
         setOutputVolumeRaw(v);
+        // 交叉淡化：上一首（已退到待命播放器）同步淡出
+        if (m_crossfading) m_standbyOutput->setVolume(m_outgoingFrom * (1.0f - t));
         if (t >= 1.0f) {
             auto cb = std::move(m_fadeDone);
             cancelFade();
@@ -55,6 +59,41 @@ void AudioPlayer::play(const QString& filePath) {
         << "outVol=" << m_audioOutput->volume();
 
     cancelFade();
+
+    if (m_renderPipelineEnabled || hasLoopRegion()) {
+        // 渲染管线：停掉 QMediaPlayer 一侧，淡入由 DSP 增益斜坡完成
+        if (!m_usingRenderer) {
+            m_player->stop();
+            clearPreload();
+        }
+        m_usingRenderer = true;
+        startLatencyProbe(false);
+        PcmRenderer* renderer = ensureRenderer();
+        renderer->setVolume(m_userVolume, 0);
+        renderer->play(filePath);
+        if (hasLoopRegion()) renderer->setLoopRegion(m_loopStartMs, m_loopEndMs);
+        return;
+    }
+    if (m_usingRenderer) {
+        m_usingRenderer = false;
+        m_renderer->stop(0);
+        setOutputVolumeRaw(m_userVolume);
+    }
+
+    if (!m_preloadedPath.isEmpty() && filePath == m_preloadedPath) {
+        // 目标正是已预加载的曲目：直接让待命播放器接手，省去加载
+        startLatencyProbe(true);
+        swapToStandby();
+        m_standbyPlayer->stop();
+        m_standbyOutput->setVolume(0.0f);
+        setOutputVolumeRaw(0.0f);
+        m_player->play();
+        emit durationChanged(m_player->duration());
+        startFade(0.0f, m_userVolume, 150);
+        return;
+    }
+
+    startLatencyProbe(false);
     // 先设为 0，再渐入到用户音量
     setOutputVolumeRaw(0.0f);
 
@@ -67,6 +106,10 @@ void AudioPlayer::play(const QString& filePath) {
 }
 
 void AudioPlayer::pause() {
+    if (m_usingRenderer) {
+        m_renderer->pause(120);
+        return;
+    }
     qDebug() << "AudioPlayer: pause() called."
         << "qstate(before)=" << int(m_player->playbackState())
         << "outVol=" << m_audioOutput->volume();
@@ -91,6 +134,10 @@ void AudioPlayer::pause() {
 }
 
 void AudioPlayer::resume() {
+    if (m_usingRenderer) {
+        m_renderer->resume(120);
+        return;
+    }
     qDebug() << "AudioPlayer: resume() called."
         << "qstate(before)=" << int(m_player->playbackState())
         << "outVol=" << m_audioOutput->volume()
@@ -111,6 +158,10 @@ void AudioPlayer::resume() {
 }
 
 void AudioPlayer::stop() {
+    if (m_usingRenderer) {
+        m_renderer->stop(120);
+        return;
+    }
     qDebug() << "AudioPlayer: stop() called."
         << "qstate(before)=" << int(m_player->playbackState())
         << "outVol=" << m_audioOutput->volume();
@@ -127,16 +178,17 @@ void AudioPlayer::stop() {
 }
 
 void AudioPlayer::setPosition(qint64 position) {
-    m_player->setPosition(position);
+    if (m_usingRenderer) m_renderer->setPosition(position);
+    else m_player->setPosition(position);
     qDebug() << "AudioPlayer: 设置播放位置:" << position;
 }
 
 qint64 AudioPlayer::position() const {
-    return m_player->position();
+    return m_usingRenderer ? m_renderer->position() : m_player->position();
 }
 
 qint64 AudioPlayer::duration() const {
-    return m_player->duration();
+    return m_usingRenderer ? m_renderer->duration() : m_player->duration();
 }
 
 void AudioPlayer::setVolume(int volume) {
@@ -146,7 +198,10 @@ void AudioPlayer::setVolume(int volume) {
     m_userVolume = normalizedVolume;
 
     // 若未在渐变中，直接设置并发出信号
-    if (!m_isFading) {
+    if (m_usingRenderer) {
+        m_renderer->setVolume(normalizedVolume, 30);
+    }
+    else if (!m_isFading) {
         setOutputVolumeRaw(normalizedVolume);
     }
     emit volumeChanged(clampedVolume);
@@ -168,6 +223,11 @@ void AudioPlayer::handleMediaStatusChanged(QMediaPlayer::MediaStatus status) {
 
     switch (status) {
     case QMediaPlayer::EndOfMedia:
+        if (!m_preloadedPath.isEmpty()) {
+            // 下一首已在待命播放器就绪：立即衔接，不经过 finished → setSource
+            beginHandoff(0);
+            break;
+        }
         emit finished();
         qDebug() << "AudioPlayer: 播放完成";
         break;
@@ -187,6 +247,222 @@ void AudioPlayer::handleMediaStatusChanged(QMediaPlayer::MediaStatus status) {
     }
 }
 
+// 两个播放器的信号都连接，只转发当前播放器的（走渲染管线时都不转发）
+void AudioPlayer::connectPlayer(QMediaPlayer* player) {
+    connect(player, &QMediaPlayer::playbackStateChanged, this, [this, player](QMediaPlayer::PlaybackState st) {
+        if (player == m_player && !m_usingRenderer) handlePlaybackStateChanged(st);
+        });
+    connect(player, &QMediaPlayer::positionChanged, this, [this, player](qint64 pos) {
+        if (player == m_player && !m_usingRenderer) handlePlayerPositionChanged(pos);
+        });
+    connect(player, &QMediaPlayer::durationChanged, this, [this, player](qint64 dur) {
+        if (player == m_player && !m_usingRenderer) emit durationChanged(dur);
+        });
+    connect(player, &QMediaPlayer::mediaStatusChanged, this, [this, player](QMediaPlayer::MediaStatus st) {
+        if (m_usingRenderer) return;
+        if (player == m_player) {
+            handleMediaStatusChanged(st);
+        }
+        else if (st == QMediaPlayer::InvalidMedia && !m_crossfading && !m_preloadedPath.isEmpty()) {
+            // 预加载失败：放弃衔接，结尾时走普通的 finished 流程
+            qWarning() << "AudioPlayer: 预加载失败:" << m_preloadedPath;
+            m_preloadedPath.clear();
+        }
+        });
+}
+
+void AudioPlayer::handlePlayerPositionChanged(qint64 position) {
+    if (m_latencyPending && position > 0) {
+        m_latencyPending = false;
+        const qint64 latency = m_latencyClock.elapsed();
+        qDebug() << "⏱ AudioPlayer: 换曲延迟" << latency << "ms"
+            << (m_latencyPreloaded ? "(预加载)" : "(冷加载)");
+        emit trackChangeLatency(latency, m_latencyPreloaded);
+    }
+
+    emit positionChanged(position);
+
+    // 进入交叉淡化区间：提前启动下一首（曲目过短时留到结尾直接衔接）
+    if (m_crossfadeMs > 0 && !m_crossfading && !m_preloadedPath.isEmpty()
+        && m_player->playbackState() == QMediaPlayer::PlayingState) {
+        const qint64 dur = m_player->duration();
+        if (dur > 2 * m_crossfadeMs && position >= dur - m_crossfadeMs) {
+            beginHandoff(m_crossfadeMs);
+        }
+    }
+}
+
+// ========== 预加载与衔接 ==========
+void AudioPlayer::preloadNext(const QString& filePath) {
+    if (m_renderPipelineEnabled || hasLoopRegion()) {
+        clearPreload();
+        return;
+    }
+    if (m_crossfading) {
+        // 待命播放器还在淡出上一首，等淡出结束再加载
+        m_deferredPreloadPath = filePath;
+        return;
+    }
+    if (filePath == m_preloadedPath) return;
+    if (filePath.isEmpty() || !QFileInfo::exists(filePath)) {
+        clearPreload();
+        return;
+    }
+
+    m_standbyPlayer->stop();
+    m_standbyOutput->setVolume(0.0f);
+    m_standbyPlayer->setSource(QUrl::fromLocalFile(filePath));
+    m_preloadedPath = filePath;
+    qDebug() << "AudioPlayer: 预加载下一首:" << filePath;
+}
+
+void AudioPlayer::clearPreload() {
+    m_deferredPreloadPath.clear();
+    if (m_crossfading || m_preloadedPath.isEmpty()) return;
+    m_preloadedPath.clear();
+    m_standbyPlayer->setSource(QUrl());
+}
+
+void AudioPlayer::setCrossfadeDuration(int ms) {
+    m_crossfadeMs = qBound(0, ms, 12000);
+}
+
+// ========== 渲染管线 ==========
+PcmRenderer* AudioPlayer::ensureRenderer() {
+    if (m_renderer) return m_renderer;
+
+    m_renderer = new PcmRenderer(this);
+    m_renderer->dsp().setEqBands(m_eqBands);
+    m_renderer->dsp().setLimiterEnabled(m_limiterEnabled);
+
+    // 只在当前曲目走渲染管线时转发
+    connect(m_renderer, &PcmRenderer::stateChanged, this, [this](PlaybackState st) {
+        if (!m_usingRenderer || m_currentState == st) return;
+        m_currentState = st;
+        emit stateChanged(st);
+        });
+    connect(m_renderer, &PcmRenderer::positionChanged, this, [this](qint64 pos) {
+        if (m_usingRenderer) handlePlayerPositionChanged(pos);
+        });
+    connect(m_renderer, &PcmRenderer::durationChanged, this, [this](qint64 dur) {
+        if (m_usingRenderer) emit durationChanged(dur);
+        });
+    connect(m_renderer, &PcmRenderer::finished, this, [this]() {
+        if (m_usingRenderer) emit finished();
+        });
+    connect(m_renderer, &PcmRenderer::error, this, [this](const QString& message) {
+        if (m_usingRenderer) emit error(message);
+        });
+    connect(m_renderer, &PcmRenderer::loopRegionChanged, this, [this](bool active) {
+        emit loopRegionChanged(active && m_usingRenderer);
+        });
+    return m_renderer;
+}
+
+void AudioPlayer::setRenderPipelineEnabled(bool enabled) {
+    if (m_renderPipelineEnabled == enabled) return;
+    m_renderPipelineEnabled = enabled;
+    if (enabled) clearPreload();
+    qDebug() << "AudioPlayer: 渲染管线" << (enabled ? "开启" : "关闭") << "（下一首生效）";
+}
+
+void AudioPlayer::setEqualizer(const QList<DspChain::EqBand>& bands) {
+    m_eqBands = bands;
+    if (m_renderer) m_renderer->dsp().setEqBands(bands);
+}
+
+void AudioPlayer::setLimiterEnabled(bool enabled) {
+    m_limiterEnabled = enabled;
+    if (m_renderer) m_renderer->dsp().setLimiterEnabled(enabled);
+}
+
+double AudioPlayer::dspMicrosPerSecond() const {
+    return m_renderer ? m_renderer->dsp().cpuMicrosPerSecond() : 0.0;
+}
+
+// ========== A-B 循环 ==========
+bool AudioPlayer::setLoopRegion(qint64 startMs, qint64 endMs) {
+    if (startMs < 0 || endMs <= startMs || endMs - startMs > PcmRenderer::kMaxLoopMs) return false;
+    m_loopStartMs = startMs;
+    m_loopEndMs = endMs;
+    clearPreload();
+
+    if (!m_usingRenderer && m_currentState != PlaybackState::Stopped && m_player->source().isLocalFile()) {
+        // 当前曲目还在 QMediaPlayer 上：在当前位置切到渲染管线（只在这里定位一次）
+        const QString path = m_player->source().toLocalFile();
+        const qint64 pos = m_player->position();
+        const bool paused = m_currentState == PlaybackState::Paused;
+        cancelFade();
+        m_usingRenderer = true;
+        m_player->stop();
+        PcmRenderer* renderer = ensureRenderer();
+        renderer->setVolume(m_userVolume, 0);
+        renderer->play(path, pos, paused);
+        qDebug() << "AudioPlayer: A-B 循环，切到渲染管线，位置" << pos << "ms";
+    }
+    if (m_usingRenderer) m_renderer->setLoopRegion(startMs, endMs);
+    return true;
+}
+
+void AudioPlayer::clearLoopRegion() {
+    m_loopStartMs = -1;
+    m_loopEndMs = -1;
+    // 本曲剩余部分继续走渲染管线，下一首按设置决定
+    if (m_renderer) m_renderer->clearLoopRegion();
+}
+
+void AudioPlayer::swapToStandby() {
+    std::swap(m_player, m_standbyPlayer);
+    std::swap(m_audioOutput, m_standbyOutput);
+    m_preloadedPath.clear();
+}
+
+void AudioPlayer::beginHandoff(int fadeMs) {
+    const QString path = m_preloadedPath;
+    const qint64 previousDuration = m_player->duration();
+    const float outgoingVolume = m_audioOutput->volume();
+    qDebug() << "AudioPlayer: 衔接到预加载曲目:" << path << "淡化" << fadeMs << "ms";
+
+    cancelFade();
+    startLatencyProbe(true);
+    swapToStandby();
+
+    if (fadeMs > 0) {
+        m_crossfading = true;
+        m_outgoingFrom = outgoingVolume;
+        setOutputVolumeRaw(0.0f);
+        m_player->play();
+        startFade(0.0f, m_userVolume, fadeMs, [this]() { finishCrossfade(); });
+    }
+    else {
+        m_standbyPlayer->stop();
+        m_standbyOutput->setVolume(0.0f);
+        setOutputVolumeRaw(m_userVolume);
+        m_player->play();
+    }
+
+    emit durationChanged(m_player->duration());
+    emit trackAdvanced(path, previousDuration);
+}
+
+void AudioPlayer::finishCrossfade() {
+    if (!m_crossfading) return;
+    m_crossfading = false;
+    m_standbyPlayer->stop();
+    m_standbyOutput->setVolume(0.0f);
+
+    if (!m_deferredPreloadPath.isEmpty()) {
+        const QString path = std::exchange(m_deferredPreloadPath, QString());
+        preloadNext(path);
+    }
+}
+
+void AudioPlayer::startLatencyProbe(bool preloaded) {
+    m_latencyClock.restart();
+    m_latencyPending = true;
+    m_latencyPreloaded = preloaded;
+}
+
 void AudioPlayer::handlePlaybackStateChanged(QMediaPlayer::PlaybackState state) {
     PlaybackState newState = convertState(state);
     if (m_currentState != newState) {
@@ -232,6 +508,8 @@ void AudioPlayer::cancelFade() {
     if (active) m_fadeTimer.stop();
     m_isFading = false;
     m_fadeDone = {};
+    // 交叉淡化被打断（暂停/停止/切歌）：上一首立即停掉
+    finishCrossfade();
     qDebug() << "AudioPlayer: cancelFade activeWas=" << active;
 }
 
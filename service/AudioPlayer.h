@@ -6,7 +6,23 @@
 #include <QElapsedTimer>
 #include <functional>
 #include "../common/PlaybackState.h"
+#include "DspChain.h"
 
+class PcmRenderer;
+
+/**
+ * @brief 音频播放器（双播放器：当前 + 待命）
+ *
+ * 除正在播放的 QMediaPlayer 外还有一个待命播放器，preloadNext() 让它提前加载下一首。
+ * 当前曲目播放到结尾（或进入交叉淡化区间）时直接启动待命播放器并交换角色，
+ * 不再等 EndOfMedia 之后才 setSource，此时发出 trackAdvanced 而不是 finished。
+ * 未预加载时行为与单播放器相同：播放结束发出 finished。
+ *
+ * 可选的自有渲染管线（PcmRenderer：解码 → DSP 均衡/限幅/增益斜坡 → QAudioSink）
+ * 在下一次 play 时生效；走渲染管线时不做预加载与交叉淡化。
+ * A-B 循环总是由渲染管线在采样边界回绕：设置循环时若当前曲目还在 QMediaPlayer 上，
+ * 会在当前位置切到渲染管线，循环存在期间后续曲目也走渲染管线。
+ */
 class AudioPlayer : public QObject {
     Q_OBJECT
 
@@ -31,6 +47,27 @@ public:
     // 状态查询
     PlaybackState state() const;
 
+    // 无缝衔接：提前加载下一首到待命播放器；空路径表示取消预加载
+    void preloadNext(const QString& filePath);
+    void clearPreload();
+    QString preloadedPath() const { return m_preloadedPath; }
+
+    // 交叉淡化时长，0 表示结尾直接衔接（不淡化）
+    void setCrossfadeDuration(int ms);
+    int crossfadeDuration() const { return m_crossfadeMs; }
+
+    // 自有渲染管线与 DSP
+    void setRenderPipelineEnabled(bool enabled);
+    bool renderPipelineEnabled() const { return m_renderPipelineEnabled; }
+    void setEqualizer(const QList<DspChain::EqBand>& bands);
+    void setLimiterEnabled(bool enabled);
+    double dspMicrosPerSecond() const;   // 渲染管线实测：每秒音频的 DSP 耗时，未使用时为 0
+
+    // A-B 循环（毫秒）；区间过长（见 PcmRenderer::kMaxLoopMs）时返回 false，由调用方自行处理
+    bool setLoopRegion(qint64 startMs, qint64 endMs);
+    void clearLoopRegion();
+    bool hasLoopRegion() const { return m_loopStartMs >= 0; }
+
 signals:
     void stateChanged(PlaybackState state);
     void positionChanged(qint64 position);
@@ -38,6 +75,12 @@ signals:
     void volumeChanged(int volume);
     void error(const QString& errorMessage);
     void finished();
+    // 已自动切换到预加载的曲目；previousDurationMs 为上一首的时长
+    void trackAdvanced(const QString& filePath, qint64 previousDurationMs);
+    // 换曲延迟：从请求切换到新曲目实际开始走时；preloaded 表示是否走了待命播放器
+    void trackChangeLatency(qint64 latencyMs, bool preloaded);
+    // 渲染层的 A-B 循环段已生效（采样级回绕）或已撤销；未生效期间由调用方按位置回跳
+    void loopRegionChanged(bool active);
 
 private slots:
     void handleMediaStatusChanged(QMediaPlayer::MediaStatus status);
@@ -45,16 +88,49 @@ private slots:
 
 private:
     PlaybackState convertState(QMediaPlayer::PlaybackState state) const;
+    void connectPlayer(QMediaPlayer* player);
+    void handlePlayerPositionChanged(qint64 position);
+
+    // 双播放器切换
+    void swapToStandby();
+    void beginHandoff(int fadeMs);
+    void finishCrossfade();
+    void startLatencyProbe(bool preloaded);
+
+    PcmRenderer* ensureRenderer();
 
     // 渐入/渐出
     void startFade(float from, float to, int durationMs, std::function<void()> done = {});
     void cancelFade();
     void setOutputVolumeRaw(float normalized); // 不触发 volumeChanged
 
-    QMediaPlayer* m_player;
+    QMediaPlayer* m_player;             // 当前播放器
     QAudioOutput* m_audioOutput;
+    QMediaPlayer* m_standbyPlayer;      // 待命播放器（预加载下一首 / 交叉淡化时的淡出方）
+    QAudioOutput* m_standbyOutput;
     PlaybackState m_currentState;
 
+    // 预加载与交叉淡化
+    QString m_preloadedPath;
+    QString m_deferredPreloadPath;      // 淡出未结束时收到的预加载请求
+    int m_crossfadeMs = 0;
+    bool m_crossfading = false;         // 待命播放器正在淡出上一首
+    float m_outgoingFrom = 0.0f;
+
+    // 渲染管线
+    PcmRenderer* m_renderer = nullptr;
+    bool m_renderPipelineEnabled = false;
+    bool m_usingRenderer = false;       // 当前曲目是否走渲染管线（play 时确定）
+    QList<DspChain::EqBand> m_eqBands;
+    bool m_limiterEnabled = true;
+    qint64 m_loopStartMs = -1;
+    qint64 m_loopEndMs = -1;
+
+    // 换曲延迟测量
+    QElapsedTimer m_latencyClock;
+    bool m_latencyPending = false;
+    bool m_latencyPreloaded = false;
+
     // 渐变相关
     QTimer m_fadeTimer;
     QElapsedTimer m_fadeClock;
@@ -13,6 +13,7 @@ ConcurrentDownloadManager::ConcurrentDownloadManager(QObject* parent)
     , m_timeoutTimer(new QTimer(this))
     , m_statisticsTimer(new QTimer(this))
     , m_songRepository(new SongRepository(this))
+    , m_changeNotifyTimer(new QTimer(this))
 {
     // 设置处理定时器
     m_processTimer->setSingleShot(true);
@@ -28,6 +29,13 @@ ConcurrentDownloadManager::ConcurrentDownloadManager(QObject* parent)
     connect(m_statisticsTimer, &QTimer::timeout, this, &ConcurrentDownloadManager::updateStatistics);
     m_statisticsTimer->start();
 
+    // 变更通知：同一事件循环内的多次变更合并为一次 changesAvailable
+    m_changeNotifyTimer->setSingleShot(true);
+    m_changeNotifyTimer->setInterval(0);
+    connect(m_changeNotifyTimer, &QTimer::timeout, this, [this]() {
+        emit changesAvailable(currentVersion());
+        });
+
     // 设置线程池
     QThreadPool::globalInstance()->setMaxThreadCount(m_config.maxConcurrentDownloads * 2); // 留一些余量
 
@@ -74,12 +82,11 @@ ConcurrentDownloadConfig ConcurrentDownloadManager::getConfig() const {
 QString ConcurrentDownloadManager::addTask(const QString& identifier, const DownloadOptions& options) {
     QMutexLocker locker(&m_tasksMutex);
 
-    // 检查是否已存在相同标识符的任务
-    for (const auto& task : m_tasks.values()) {
-        if (task.getIdentifier() == identifier && !task.isFinished()) {
-            qDebug() << "ConcurrentDownloadManager: 任务已存在:" << identifier;
-            return task.getTaskId(); // 返回现有任务ID
-        }
+    // 检查是否已存在相同标识符的任务（只有最近一个可能未结束）
+    const auto existing = m_tasks.constFind(m_taskByIdentifier.value(identifier));
+    if (existing != m_tasks.cend() && !existing->isFinished()) {
+        qDebug() << "ConcurrentDownloadManager: 任务已存在:" << identifier;
+        return existing->getTaskId(); // 返回现有任务ID
     }
 
     // 检查数据库中是否已存在
@@ -94,7 +101,10 @@ QString ConcurrentDownloadManager::addTask(const QString& identifier, const Down
     QString taskId = newTask.getTaskId();
 
     m_tasks.insert(taskId, newTask);
+    m_taskByIdentifier.insert(identifier, taskId);
     m_pendingTaskIds.enqueue(taskId);
+    ++m_statusCounts[static_cast<int>(DownloadTaskState::Status::Pending)];
+    markChanged(taskId);
 
     locker.unlock();
 
@@ -159,7 +169,7 @@ bool ConcurrentDownloadManager::cancelTask(const QString& taskId) {
     m_pendingTaskIds = newQueue;
 
     // 更新任务状态
-    task.setStatus(DownloadTaskState::Status::Cancelled);
+    setTaskStatus(task, DownloadTaskState::Status::Cancelled);
 
     locker.unlock();
 
@@ -188,7 +198,7 @@ void ConcurrentDownloadManager::cancelAllTasks() {
     QStringList cancelledTaskIds;
     for (auto& task : m_tasks) {
         if (!task.isFinished()) {
-            task.setStatus(DownloadTaskState::Status::Cancelled);
+            setTaskStatus(task, DownloadTaskState::Status::Cancelled);
             cancelledTaskIds.append(task.getTaskId());
         }
     }
@@ -243,11 +253,13 @@ int ConcurrentDownloadManager::getPendingTaskCount() const {
 }
 
 int ConcurrentDownloadManager::getCompletedTaskCount() const {
-    return getTasksByStatus(DownloadTaskState::Status::Completed).size();
+    QMutexLocker locker(&m_tasksMutex);
+    return m_statusCounts[static_cast<int>(DownloadTaskState::Status::Completed)];
 }
 
 int ConcurrentDownloadManager::getFailedTaskCount() const {
-    return getTasksByStatus(DownloadTaskState::Status::Failed).size();
+    QMutexLocker locker(&m_tasksMutex);
+    return m_statusCounts[static_cast<int>(DownloadTaskState::Status::Failed)];
 }
 
 QList<DownloadTaskState> ConcurrentDownloadManager::getAllTasks() const {
@@ -258,8 +270,9 @@ QList<DownloadTaskState> ConcurrentDownloadManager::getAllTasks() const {
 QList<DownloadTaskState> ConcurrentDownloadManager::getTasksByStatus(DownloadTaskState::Status status) const {
     QMutexLocker locker(&m_tasksMutex);
     QList<DownloadTaskState> result;
+    result.reserve(m_statusCounts[static_cast<int>(status)]);
 
-    for (const auto& task : m_tasks.values()) {
+    for (const auto& task : std::as_const(m_tasks)) {
         if (task.getStatus() == status) {
             result.append(task);
         }
@@ -273,11 +286,156 @@ DownloadTaskState ConcurrentDownloadManager::getTask(const QString& taskId) cons
     return m_tasks.value(taskId);
 }
 
+// ========== 按播放需要提前 ==========
+int ConcurrentDownloadManager::promoteTasks(const QStringList& identifiers) {
+    if (identifiers.isEmpty()) {
+        return 0;
+    }
+
+    QMutexLocker locker(&m_tasksMutex);
+    if (m_pendingTaskIds.isEmpty()) {
+        return 0;
+    }
+
+    // 倒序插入：重复的标识符以最靠前的为准
+    QHash<QString, int> rankOf;
+    rankOf.reserve(identifiers.size());
+    for (int i = identifiers.size() - 1; i >= 0; --i) {
+        rankOf.insert(identifiers[i], i);
+    }
+
+    // 一次扫描待处理队列：命中的按优先级归位，其余保持原有先后
+    QList<QString> promoted(identifiers.size());
+    QQueue<QString> rest;
+    int count = 0;
+    for (const QString& taskId : std::as_const(m_pendingTaskIds)) {
+        const auto task = m_tasks.constFind(taskId);
+        const auto rank = task != m_tasks.constEnd() ? rankOf.constFind(task->getIdentifier()) : rankOf.constEnd();
+        if (rank != rankOf.constEnd() && promoted[*rank].isEmpty()) {
+            promoted[*rank] = taskId;
+            ++count;
+        }
+        else {
+            rest.enqueue(taskId);
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    QQueue<QString> reordered;
+    for (const QString& taskId : std::as_const(promoted)) {
+        if (!taskId.isEmpty()) reordered.enqueue(taskId);
+    }
+    reordered.append(rest);
+    if (reordered == m_pendingTaskIds) {
+        return count;
+    }
+    m_pendingTaskIds = reordered;
+    markQueueReordered();
+
+    locker.unlock();
+
+    qDebug() << "ConcurrentDownloadManager: 按播放顺序提前" << count << "个待下载任务";
+    return count;
+}
+
+DownloadTaskState ConcurrentDownloadManager::activeTaskFor(const QString& identifier) const {
+    QMutexLocker locker(&m_tasksMutex);
+
+    // 正在运行的任务不超过并发上限，直接遍历
+    for (auto it = m_activeWorkers.constBegin(); it != m_activeWorkers.constEnd(); ++it) {
+        const auto task = m_tasks.constFind(it.key());
+        if (task != m_tasks.constEnd() && task->getIdentifier() == identifier) {
+            return task.value();
+        }
+    }
+    return DownloadTaskState();
+}
+
 ConcurrentDownloadManager::Statistics ConcurrentDownloadManager::getStatistics() const {
     QMutexLocker locker(&m_tasksMutex);
     return m_lastStatistics;
 }
 
+// ========== 变更订阅 ==========
+quint64 ConcurrentDownloadManager::currentVersion() const {
+    QMutexLocker locker(&m_tasksMutex);
+    return m_version;
+}
+
+ConcurrentDownloadManager::ChangeSet ConcurrentDownloadManager::changesSince(quint64 sinceVersion) const {
+    QMutexLocker locker(&m_tasksMutex);
+
+    ChangeSet changes;
+    changes.fromVersion = sinceVersion;
+    changes.toVersion = m_version;
+    if (sinceVersion >= m_version) {
+        return changes;
+    }
+
+    // 日志中每个任务只保留最新一条，因此只遍历真正变更过的任务
+    for (auto it = m_changeLog.upper_bound(sinceVersion); it != m_changeLog.end(); ++it) {
+        const auto task = m_tasks.constFind(it->second);
+        if (task != m_tasks.constEnd()) {
+            changes.changed.append(task.value());
+        }
+    }
+
+    if (m_queueOrderVersion > sinceVersion) {
+        changes.queueReordered = true;
+        changes.pendingOrder.reserve(m_pendingTaskIds.size());
+        for (const QString& taskId : m_pendingTaskIds) {
+            const auto task = m_tasks.constFind(taskId);
+            if (task != m_tasks.constEnd()) {
+                changes.pendingOrder.append(task->getIdentifier());
+            }
+        }
+    }
+    return changes;
+}
+
+void ConcurrentDownloadManager::markChanged(const QString& taskId) {
+    const quint64 version = ++m_version;
+
+    auto it = m_taskVersion.find(taskId);
+    if (it != m_taskVersion.end()) {
+        m_changeLog.erase(it.value());
+        it.value() = version;
+    }
+    else {
+        m_taskVersion.insert(taskId, version);
+    }
+    m_changeLog.emplace(version, taskId);
+
+    if (!m_changeNotifyTimer->isActive()) {
+        m_changeNotifyTimer->start();
+    }
+}
+
+void ConcurrentDownloadManager::markQueueReordered() {
+    // 顺序变化不属于任何单个任务：只记版本号，拉取时附带当前队列顺序
+    m_queueOrderVersion = ++m_version;
+
+    if (!m_changeNotifyTimer->isActive()) {
+        m_changeNotifyTimer->start();
+    }
+}
+
+void ConcurrentDownloadManager::setTaskStatus(DownloadTaskState& task, DownloadTaskState::Status status) {
+    const DownloadTaskState::Status old = task.getStatus();
+    task.setStatus(status);
+
+    if (old != status) {
+        --m_statusCounts[static_cast<int>(old)];
+        ++m_statusCounts[static_cast<int>(status)];
+        if (status == DownloadTaskState::Status::Completed) {
+            m_completedDownloadTimeMs += task.getElapsedMs();
+        }
+    }
+    markChanged(task.getTaskId());
+}
+
 void ConcurrentDownloadManager::processQueue() {
     if (m_isPaused) {
         return;
@@ -338,7 +496,7 @@ void ConcurrentDownloadManager::startTask(DownloadTaskState& task) {
 
     // 更新任务状态
     QMutexLocker locker(&m_tasksMutex);
-    task.setStatus(DownloadTaskState::Status::Running);
+    setTaskStatus(task, DownloadTaskState::Status::Running);
     m_activeWorkers.insert(taskId, worker);
     locker.unlock();
 
@@ -367,9 +525,9 @@ void ConcurrentDownloadManager::onTaskFinished(const QString& taskId, bool succe
     }
 
     if (success) {
-        task.setStatus(DownloadTaskState::Status::Completed);
         task.setResultSong(song);
         task.setProgress(1.0, "下载完成");
+        setTaskStatus(task, DownloadTaskState::Status::Completed);
 
         locker.unlock();
 
@@ -385,9 +543,9 @@ void ConcurrentDownloadManager::onTaskFinished(const QString& taskId, bool succe
     else {
         // 检查是否可以重试
         if (task.canRetry(m_config.maxRetryCount) && m_config.enableAutoRetry) {
-            task.setStatus(DownloadTaskState::Status::Retrying);
             task.incrementRetryCount();
             task.setErrorMessage(error);
+            setTaskStatus(task, DownloadTaskState::Status::Retrying);
 
             // 重新加入队列
             m_pendingTaskIds.enqueue(taskId);
@@ -403,8 +561,8 @@ void ConcurrentDownloadManager::onTaskFinished(const QString& taskId, bool succe
         }
         else {
             // 标记为最终失败
-            task.setStatus(DownloadTaskState::Status::Failed);
             task.setErrorMessage(error);
+            setTaskStatus(task, DownloadTaskState::Status::Failed);
 
             locker.unlock();
 
@@ -425,8 +583,10 @@ void ConcurrentDownloadManager::onTaskFinished(const QString& taskId, bool succe
 void ConcurrentDownloadManager::onTaskProgress(const QString& taskId, double progress, const QString& message) {
     QMutexLocker locker(&m_tasksMutex);
 
-    if (m_tasks.contains(taskId)) {
-        m_tasks[taskId].setProgress(progress, message);
+    auto it = m_tasks.find(taskId);
+    if (it != m_tasks.end()) {
+        it->setProgress(progress, message);
+        markChanged(taskId);
     }
 
     locker.unlock();
@@ -491,43 +651,19 @@ void ConcurrentDownloadManager::cleanupFinishedWorkers() {
 void ConcurrentDownloadManager::updateStatistics() {
     QMutexLocker locker(&m_tasksMutex);
 
+    // 各状态计数随状态变化增量维护，这里无需遍历任务表
     Statistics stats;
     stats.totalTasks = m_tasks.size();
     stats.activeTasks = m_activeWorkers.size();
     stats.pendingTasks = m_pendingTaskIds.size();
+    stats.completedTasks = m_statusCounts[static_cast<int>(DownloadTaskState::Status::Completed)];
+    stats.failedTasks = m_statusCounts[static_cast<int>(DownloadTaskState::Status::Failed)]
+        + m_statusCounts[static_cast<int>(DownloadTaskState::Status::Timeout)];
 
-    qint64 totalDownloadTime = 0;
-    int completedTasks = 0;
-    int failedTasks = 0;
-
-    for (const auto& task : m_tasks.values()) {
-        switch (task.getStatus()) {
-        case DownloadTaskState::Status::Completed:
-            stats.completedTasks++;
-            completedTasks++;
-            totalDownloadTime += task.getElapsedMs();
-            break;
-        case DownloadTaskState::Status::Failed:
-        case DownloadTaskState::Status::Timeout:
-            stats.failedTasks++;
-            failedTasks++;
-            break;
-        default:
-            break;
-        }
-    }
-
-    stats.totalDownloadTimeMs = totalDownloadTime;
-    stats.averageDownloadTimeMs = completedTasks > 0 ? totalDownloadTime / completedTasks : 0;
+    stats.totalDownloadTimeMs = m_completedDownloadTimeMs;
+    stats.averageDownloadTimeMs = stats.completedTasks > 0 ? m_completedDownloadTimeMs / stats.completedTasks : 0;
     stats.overallProgress = stats.totalTasks > 0 ? (double)stats.completedTasks / stats.totalTasks : 0.0;
 
-    // 确保统计数据的一致性
-    if (stats.completedTasks != completedTasks) {
-        qDebug() << "统计数据不一致，修正中...";
-        stats.completedTasks = completedTasks;
-        stats.failedTasks = failedTasks;
-    }
-
     m_lastStatistics = stats;
 
     locker.unlock();
@@ -7,6 +7,8 @@
 #include <QMutex>
 #include <QThreadPool>
 #include <QMutexLocker>
+#include <array>
+#include <map>
 #include "DownloadTaskState.h"
 #include "ConcurrentDownloadConfig.h"
 #include "../infra/YtDlpClient.h"
@@ -53,6 +55,12 @@ public:
     QList<DownloadTaskState> getTasksByStatus(DownloadTaskState::Status status) const;
     DownloadTaskState getTask(const QString& taskId) const;
 
+    // ========== 按播放需要提前 ==========
+    // identifiers 按优先级从高到低（离播放位置最近的在前）；仍在等待的任务按此顺序移到队首，返回提前的任务数
+    int promoteTasks(const QStringList& identifiers);
+    // 该标识符正在下载的任务；没有时返回的任务标识符为空
+    DownloadTaskState activeTaskFor(const QString& identifier) const;
+
     // 统计信息
     struct Statistics {
         int totalTasks = 0;
@@ -67,6 +75,21 @@ public:
 
     Statistics getStatistics() const;
 
+    // ========== 变更订阅（按版本号增量同步） ==========
+    // 每次任务新增或状态/进度变化，全局版本号 +1，并把该任务记为“在此版本变更”；待处理队列重新排序也占一个版本号。
+    // 订阅者保存上次同步到的版本号，之后只取这之后变更的任务，耗时与变更数成正比，与任务总数无关。
+    struct ChangeSet {
+        quint64 fromVersion = 0;              // 请求的起始版本（不含）
+        quint64 toVersion = 0;                // 当前版本；下次以此为起点
+        QList<DownloadTaskState> changed;     // 期间变更过的任务（最新状态，每个任务只出现一次，按变更先后排序）
+        bool queueReordered = false;          // 期间待处理队列被重新排序（promoteTasks）
+        QStringList pendingOrder;             // queueReordered 时为当前待处理队列的标识符，按下载先后排序
+    };
+
+    quint64 currentVersion() const;
+    // sinceVersion = 0 表示取全部任务（首次订阅/晚到的视图）
+    ChangeSet changesSince(quint64 sinceVersion) const;
+
 signals:
     void taskAdded(const QString& taskId, const DownloadTaskState& task);
     void taskStarted(const QString& taskId);
@@ -78,6 +101,8 @@ signals:
 
     void allTasksCompleted();
     void statisticsUpdated(const Statistics& stats);
+    // 有新的变更可供 changesSince 拉取（同一事件循环内的多次变更合并为一次）
+    void changesAvailable(quint64 version);
     void managerError(const QString& error);
 
 private slots:
@@ -93,8 +118,14 @@ private:
     void updateStatistics();
     bool canStartNewTask() const;
 
+    // 以下须在持有 m_tasksMutex 时调用
+    void setTaskStatus(DownloadTaskState& task, DownloadTaskState::Status status);
+    void markChanged(const QString& taskId);
+    void markQueueReordered();
+
     ConcurrentDownloadConfig m_config;
     QHash<QString, DownloadTaskState> m_tasks; // taskId -> task
+    QHash<QString, QString> m_taskByIdentifier; // identifier -> 最近一次添加的 taskId（查重用）
     QQueue<QString> m_pendingTaskIds;
     QHash<QString, DownloadWorker*> m_activeWorkers; // taskId -> worker
 
@@ -108,4 +139,16 @@ private:
     SongRepository* m_songRepository;
 
     Statistics m_lastStatistics;
+
+    // 变更日志：版本号 -> 任务ID（每个任务只保留最新一条），以及任务ID -> 其最新版本号
+    quint64 m_version = 0;
+    std::map<quint64, QString> m_changeLog;
+    QHash<QString, quint64> m_taskVersion;
+    quint64 m_queueOrderVersion = 0;       // 待处理队列最近一次重新排序时的版本号
+    QTimer* m_changeNotifyTimer;
+
+    // 各状态的任务数，随状态变化增量维护（计数查询不再遍历任务表）
+    static constexpr int kStatusCount = static_cast<int>(DownloadTaskState::Status::Timeout) + 1;
+    std::array<int, kStatusCount> m_statusCounts{};
+    qint64 m_completedDownloadTimeMs = 0;
 };
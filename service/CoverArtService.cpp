@@ -0,0 +1,222 @@
+// service/CoverArtService.cpp
+#include "CoverArtService.h"
+#include "../infra/EmbeddedArtReader.h"
+#include "../common/AppConfig.h"
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+    constexpr int kMemoryCacheKB = 32 * 1024;     // 内存缓存上限 32MB
+    constexpr int kMaxWorkerThreads = 2;
+    constexpr int kJpegQuality = 90;
+    const QList<int> kPresetSizes = { 64, 128 }; // 列表与播放栏常用尺寸（含 2x 屏），解码一次一并生成
+    const QString kNoCover = QStringLiteral("-");
+}
+
+CoverArtService& CoverArtService::instance() {
+    static CoverArtService instance;
+    return instance;
+}
+
+CoverArtService::CoverArtService(QObject* parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(kMaxWorkerThreads);
+    m_pool.setThreadPriority(QThread::LowPriority);
+    m_memoryCache.setMaxCost(kMemoryCacheKB);
+
+    const QString homeDir = QStandardPaths::writableLocation(QStandardPaths::HomeLocation);
+    m_cacheDir = homeDir + "/BiliMusicPlayer/covers";
+    QDir().mkpath(m_cacheDir);
+
+    qDebug() << "✅ CoverArtService 初始化完成，缓存目录:" << m_cacheDir;
+}
+
+CoverArtService::~CoverArtService() {
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QString CoverArtService::cacheKey(const QString& songId, int size) {
+    return songId + QLatin1Char('@') + QString::number(size);
+}
+
+QPixmap CoverArtService::cover(const Song& song, int size) {
+    return cover(song.getId(), song.getLocalFilePath(), size);
+}
+
+QPixmap CoverArtService::cover(const QString& songId, const QString& localFilePath, int size) {
+    if (songId.isEmpty() || localFilePath.isEmpty() || size <= 0) return QPixmap();
+
+    const QString key = cacheKey(songId, size);
+    if (const QPixmap* cached = m_memoryCache.object(key)) {
+        return *cached;
+    }
+    if (m_noCover.contains(songId) || m_inflight.contains(key)) {
+        return QPixmap();
+    }
+
+    m_inflight.insert(key);
+    const QString ffmpegPath = AppConfig::instance().getFfmpegPath();
+    m_pool.start([this, songId, localFilePath, size, ffmpegPath]() {
+        const QImage image = loadThumbnail(localFilePath, size, ffmpegPath);
+        QMetaObject::invokeMethod(this, [this, songId, size, image]() {
+            onThumbnailLoaded(songId, size, image);
+            }, Qt::QueuedConnection);
+        }, ++m_requestSerial);
+
+    return QPixmap();
+}
+
+QPixmap CoverArtService::cachedCover(const QString& songId, int size) const {
+    const QPixmap* cached = m_memoryCache.object(cacheKey(songId, size));
+    return cached ? *cached : QPixmap();
+}
+
+void CoverArtService::invalidate(const QString& songId) {
+    m_noCover.remove(songId);
+    const QString prefix = songId + QLatin1Char('@');
+    const QList<QString> keys = m_memoryCache.keys();
+    for (const QString& key : keys) {
+        if (key.startsWith(prefix)) m_memoryCache.remove(key);
+    }
+}
+
+void CoverArtService::onThumbnailLoaded(const QString& songId, int size, const QImage& image) {
+    m_inflight.remove(cacheKey(songId, size));
+    if (image.isNull()) {
+        m_noCover.insert(songId);
+        return;
+    }
+
+    // QPixmap 只能在 UI 线程创建
+    const QPixmap pixmap = QPixmap::fromImage(image);
+    const int costKB = std::max(1, int(qint64(pixmap.width()) * pixmap.height() * 4 / 1024));
+    m_memoryCache.insert(cacheKey(songId, size), new QPixmap(pixmap), costKB);
+    emit coverReady(songId, size, pixmap);
+}
+
+// ========== 工作线程 ==========
+
+QImage CoverArtService::loadThumbnail(const QString& localFilePath, int size, const QString& ffmpegPath) {
+    if (!QFileInfo::exists(localFilePath)) return QImage();
+
+    // 1) 磁盘缓存：文件未变化且已知内容哈希时直接读取预缩放的缩略图
+    const QString sourceKey = sourceKeyFor(localFilePath);
+    QString contentHash = lookupContentHash(sourceKey);
+    if (contentHash == kNoCover) return QImage();
+    if (!contentHash.isEmpty()) {
+        QImage cached(thumbnailPath(contentHash, size));
+        if (!cached.isNull()) return cached;
+    }
+
+    // 2) 抽取内嵌封面
+    QByteArray art = EmbeddedArtReader::read(localFilePath);
+    if (art.isEmpty()) {
+        art = EmbeddedArtReader::readWithFfmpeg(localFilePath, ffmpegPath);
+    }
+    if (art.isEmpty()) {
+        recordContentHash(sourceKey, kNoCover);
+        return QImage();
+    }
+    contentHash = QString::fromLatin1(QCryptographicHash::hash(art, QCryptographicHash::Sha1).toHex().left(24));
+
+    // 3) 解码：居中裁剪为正方形，并让解码器直接按需要的最大尺寸缩小（JPEG 可省去大部分解码开销）
+    QList<int> sizes = kPresetSizes;
+    if (!sizes.contains(size)) sizes.append(size);
+    const int maxSize = *std::max_element(sizes.begin(), sizes.end());
+
+    QBuffer buffer(&art);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    const QSize sourceSize = reader.size();
+    if (sourceSize.isValid()) {
+        const int side = std::min(sourceSize.width(), sourceSize.height());
+        reader.setClipRect(QRect((sourceSize.width() - side) / 2, (sourceSize.height() - side) / 2, side, side));
+        if (side > maxSize) reader.setScaledSize(QSize(maxSize, maxSize));
+    }
+    QImage full = reader.read();
+    if (full.isNull()) {
+        qWarning() << "CoverArtService: 封面解码失败" << localFilePath << reader.errorString();
+        recordContentHash(sourceKey, kNoCover);
+        return QImage();
+    }
+    if (full.width() != full.height()) {
+        const int side = std::min(full.width(), full.height());
+        full = full.copy((full.width() - side) / 2, (full.height() - side) / 2, side, side);
+    }
+    full = full.convertToFormat(QImage::Format_RGB32);
+
+    // 4) 写入各尺寸的磁盘缓存（同一封面内容只写一次）
+    QImage result;
+    for (int s : sizes) {
+        const QImage scaled = full.width() == s
+            ? full
+            : full.scaled(s, s, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        const QString path = thumbnailPath(contentHash, s);
+        if (!QFileInfo::exists(path)) {
+            // 原子写入：多首歌共享同一封面时，其他线程不会读到写了一半的文件
+            QSaveFile out(path);
+            if (out.open(QIODevice::WriteOnly) && scaled.save(&out, "JPG", kJpegQuality)) {
+                out.commit();
+            }
+        }
+        if (s == size) result = scaled;
+    }
+
+    recordContentHash(sourceKey, contentHash);
+    return result;
+}
+
+QString CoverArtService::sourceKeyFor(const QString& localFilePath) const {
+    const QFileInfo info(localFilePath);
+    const QByteArray identity = info.absoluteFilePath().toUtf8()
+        + '|' + QByteArray::number(info.size())
+        + '|' + QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+    return QString::fromLatin1(QCryptographicHash::hash(identity, QCryptographicHash::Sha1).toHex().left(24));
+}
+
+QString CoverArtService::thumbnailPath(const QString& contentHash, int size) const {
+    return QString("%1/%2_%3.jpg").arg(m_cacheDir, contentHash).arg(size);
+}
+
+QString CoverArtService::lookupContentHash(const QString& sourceKey) {
+    QMutexLocker locker(&m_indexMutex);
+    if (!m_indexLoaded) {
+        m_indexLoaded = true;
+        QFile file(m_cacheDir + "/index.txt");
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            QTextStream in(&file);
+            while (!in.atEnd()) {
+                const QStringList parts = in.readLine().split(' ', Qt::SkipEmptyParts);
+                if (parts.size() == 2) m_contentIndex.insert(parts.at(0), parts.at(1));
+            }
+        }
+    }
+    return m_contentIndex.value(sourceKey);
+}
+
+void CoverArtService::recordContentHash(const QString& sourceKey, const QString& contentHash) {
+    QMutexLocker locker(&m_indexMutex);
+    if (m_contentIndex.value(sourceKey) == contentHash) return;
+    m_contentIndex.insert(sourceKey, contentHash);
+
+    // 追加写入；同一 key 重复出现时以最后一行为准
+    QFile file(m_cacheDir + "/index.txt");
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        QTextStream out(&file);
+        out << sourceKey << ' ' << contentHash << '\n';
+    }
+}
@@ -0,0 +1,74 @@
+// service/CoverArtService.h
+#pragma once
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QPixmap>
+#include <QThreadPool>
+#include "../common/entities/Song.h"
+
+class QImage;
+
+/**
+ * @brief 封面缩略图服务
+ *
+ * 从本地音频文件中抽取内嵌封面，在工作线程中解码、裁剪为正方形并缩放，
+ * 结果进入两级缓存：
+ * - 内存：按 (歌曲ID, 像素尺寸) 的 LRU（QCache，按像素字节数计费）
+ * - 磁盘：<数据目录>/covers/<图片内容哈希>_<尺寸>.jpg，同一张封面的多首歌共享；
+ *         音频文件（路径+大小+修改时间）到内容哈希的映射追加记录在 covers/index.txt
+ *
+ * UI 调用 cover()：命中内存缓存立即返回；否则返回空 QPixmap 并在后台加载，
+ * 完成后发出 coverReady。只应在 UI 线程调用。
+ */
+class CoverArtService : public QObject {
+    Q_OBJECT
+
+public:
+    static CoverArtService& instance();
+    ~CoverArtService() override;
+
+    // size 为设备像素边长（调用方自行乘以 devicePixelRatio）
+    QPixmap cover(const Song& song, int size);
+    QPixmap cover(const QString& songId, const QString& localFilePath, int size);
+
+    // 仅查询内存缓存，不触发加载
+    QPixmap cachedCover(const QString& songId, int size) const;
+
+    // 丢弃某首歌的内存缓存与“无封面”标记（例如文件被替换）
+    void invalidate(const QString& songId);
+
+signals:
+    void coverReady(const QString& songId, int size, const QPixmap& pixmap);
+
+private:
+    explicit CoverArtService(QObject* parent = nullptr);
+
+    static QString cacheKey(const QString& songId, int size);
+
+    // ---- 以下在工作线程执行 ----
+    QImage loadThumbnail(const QString& localFilePath, int size, const QString& ffmpegPath);
+    QString sourceKeyFor(const QString& localFilePath) const;
+    QString lookupContentHash(const QString& sourceKey);
+    void recordContentHash(const QString& sourceKey, const QString& contentHash);
+    QString thumbnailPath(const QString& contentHash, int size) const;
+
+    // ---- 以下在 UI 线程执行 ----
+    void onThumbnailLoaded(const QString& songId, int size, const QImage& image);
+
+    QThreadPool m_pool;
+    QString m_cacheDir;
+
+    QCache<QString, QPixmap> m_memoryCache; // cost 单位：KB
+    QSet<QString> m_inflight;               // 正在加载的 cacheKey
+    QSet<QString> m_noCover;                // 确认没有封面的歌曲ID
+    int m_requestSerial = 0;                // 新请求优先（滚动时先加载当前可见行）
+
+    // 音频文件 -> 封面内容哈希（"-" 表示无封面），工作线程共享
+    QMutex m_indexMutex;
+    bool m_indexLoaded = false;
+    QHash<QString, QString> m_contentIndex;
+};
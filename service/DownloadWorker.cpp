@@ -19,7 +19,9 @@ DownloadWorker::DownloadWorker(const QString& taskId, const DownloadTaskState& t
 {
     setAutoDelete(false); // 手动管理内存
 
-    m_downloadDir = AppConfig::instance().getDownloadPath();
+    // 任务创建时捕获一份配置快照，之后设置页的修改只影响新任务
+    m_config = AppConfig::instance().snapshot();
+    m_downloadDir = m_config->downloadPath;
 
     // 设置超时定时器
     m_timeoutTimer->setSingleShot(true);
@@ -84,6 +86,7 @@ void DownloadWorker::run() {
 
 void DownloadWorker::setupYtDlpClient() {
     m_ytDlpClient = new YtDlpClient();
+    m_ytDlpClient->setConfigSnapshot(m_config);
     m_metadataParser = new MetadataParser();
 
     // 连接信号
@@ -48,6 +48,7 @@ private:
 
     QTimer* m_timeoutTimer;
     QString m_downloadDir;
+    ConfigSnapshot m_config;
 
     mutable QMutex m_stateMutex;
 };
@@ -0,0 +1,284 @@
+#include "DspChain.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define DSP_HAS_SSE2 1
+#endif
+
+namespace {
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kLookaheadMs = 5.0;
+    constexpr double kReleaseMs = 80.0;
+
+    qint64 nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+DspChain::DspChain(int sampleRate)
+    : m_sampleRate(sampleRate)
+{
+    m_eqBlocks.push_back(std::make_unique<const EqParams>());
+    m_pendingEq.store(m_eqBlocks.back().get());
+    configureLimiter();
+    m_gain = 1.0f;
+}
+
+void DspChain::setSampleRate(int sampleRate) {
+    if (sampleRate <= 0 || sampleRate == m_sampleRate) return;
+    m_sampleRate = sampleRate;
+    configureLimiter();
+    // 系数依赖采样率，按原频点重新计算
+    setEqBands(m_bands);
+}
+
+void DspChain::reset() {
+    for (auto& s : m_eqState) s.fill(0.0f);
+    std::fill(m_delay.begin(), m_delay.end(), 0.0f);
+    m_delayPos = 0;
+    m_minHead = 0;
+    m_minSize = 0;
+    m_envelope = 1.0f;
+    m_frameCounter = 0;
+    // 从静音开始，之前提交但尚未执行的斜坡作废，由调用方重新提交
+    m_gain = 0.0f;
+    m_gainRemaining = 0;
+    m_seenRampSeq = m_rampSeq.load(std::memory_order_acquire);
+}
+
+void DspChain::configureLimiter() {
+    m_lookahead = std::max(1, int(std::lround(m_sampleRate * kLookaheadMs / 1000.0)));
+    // 攻击时间取前瞻的 1/4：峰值到达时增益已走完约 98%
+    m_attackCoef = float(std::exp(-1.0 / (m_lookahead / 4.0)));
+    m_releaseCoef = float(std::exp(-1.0 / (m_sampleRate * kReleaseMs / 1000.0)));
+    m_delay.assign(size_t(m_lookahead) * kChannels, 0.0f);
+    m_minValues.assign(size_t(m_lookahead) + 1, 1.0f);
+    m_minIndex.assign(size_t(m_lookahead) + 1, 0);
+    reset();
+}
+
+// ========== 参数 ==========
+void DspChain::setEqBands(const QList<EqBand>& bands) {
+    m_bands = bands;
+
+    auto params = std::make_unique<EqParams>();
+    for (const EqBand& band : bands) {
+        if (int(params->sections.size()) >= kMaxBands) break;
+        if (std::abs(band.gainDb) < 0.05 || band.frequencyHz <= 0.0 || band.frequencyHz >= m_sampleRate / 2.0) continue;
+
+        // RBJ 峰值均衡
+        const double a = std::pow(10.0, band.gainDb / 40.0);
+        const double w0 = 2.0 * kPi * band.frequencyHz / m_sampleRate;
+        const double alpha = std::sin(w0) / (2.0 * std::max(0.1, band.q));
+        const double cosw = std::cos(w0);
+        const double a0 = 1.0 + alpha / a;
+
+        Biquad bq;
+        bq.b0 = float((1.0 + alpha * a) / a0);
+        bq.b1 = float((-2.0 * cosw) / a0);
+        bq.b2 = float((1.0 - alpha * a) / a0);
+        bq.a1 = float((-2.0 * cosw) / a0);
+        bq.a2 = float((1.0 - alpha / a) / a0);
+        params->sections.push_back(bq);
+    }
+    const EqParams* published = params.get();
+    m_eqBlocks.push_back(std::move(params));
+    m_pendingEq.store(published);
+
+    // 旧块只要不是回调登记在用的就可以释放（回调登记后会复查，不会再取到已淘汰的块）
+    const EqParams* inUse = m_eqInUse.load();
+    std::erase_if(m_eqBlocks, [published, inUse](const auto& block) {
+        return block.get() != published && block.get() != inUse;
+        });
+}
+
+QList<DspChain::EqBand> DspChain::graphicEqBands(const QList<int>& gainsDb) {
+    QList<EqBand> bands;
+    for (int i = 0; i < int(kGraphicEqFrequencies.size()) && i < gainsDb.size(); ++i) {
+        EqBand band;
+        band.frequencyHz = kGraphicEqFrequencies[i];
+        band.gainDb = gainsDb[i];
+        band.q = 1.0;
+        bands << band;
+    }
+    return bands;
+}
+
+quint32 DspChain::rampGainTo(float gain, int durationMs) {
+    m_rampTarget.store(std::clamp(gain, 0.0f, 1.0f), std::memory_order_relaxed);
+    m_rampFrames.store(std::max(0, int(qint64(durationMs) * m_sampleRate / 1000)), std::memory_order_relaxed);
+    return m_rampSeq.fetch_add(1, std::memory_order_release) + 1;
+}
+
+// ========== 处理 ==========
+void DspChain::process(float* interleaved, int frames) {
+    if (frames <= 0) return;
+    const qint64 startNs = nowNs();
+
+    processEq(interleaved, frames);
+    applyGain(interleaved, frames);
+    if (m_limiterEnabled.load(std::memory_order_relaxed)) processLimiter(interleaved, frames);
+
+    m_processNs.fetch_add(nowNs() - startNs, std::memory_order_relaxed);
+    m_processedFrames.fetch_add(frames, std::memory_order_relaxed);
+}
+
+void DspChain::processEq(float* interleaved, int frames) {
+    const EqParams* pending = m_pendingEq.load();
+    if (pending != m_activeEq) {
+        // 换登记之前读旧块：登记一变引擎线程就可能释放它
+        const size_t oldSections = m_activeEq ? m_activeEq->sections.size() : size_t(-1);
+        // 先登记再复查：复查仍是同一块说明登记时它还没被淘汰
+        for (;;) {
+            m_eqInUse.store(pending);
+            const EqParams* again = m_pendingEq.load();
+            if (again == pending) break;
+            pending = again;
+        }
+        // 段数变化时旧状态对不上，清零；只改增益时保留状态避免爆音
+        if (pending->sections.size() != oldSections) {
+            for (auto& s : m_eqState) s.fill(0.0f);
+        }
+        m_activeEq = pending;
+    }
+
+    const std::vector<Biquad>& sections = m_activeEq->sections;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const Biquad bq = sections[i];
+        std::array<float, 2 * kChannels>& st = m_eqState[i];
+        // 转置直接 II 型；两个声道在同一循环里并行推进（递归依赖只在时间方向）
+        float z1l = st[0], z2l = st[1], z1r = st[2], z2r = st[3];
+        for (int f = 0; f < frames; ++f) {
+            float* p = interleaved + f * kChannels;
+            const float xl = p[0];
+            const float xr = p[1];
+            const float yl = bq.b0 * xl + z1l;
+            const float yr = bq.b0 * xr + z1r;
+            z1l = bq.b1 * xl - bq.a1 * yl + z2l;
+            z1r = bq.b1 * xr - bq.a1 * yr + z2r;
+            z2l = bq.b2 * xl - bq.a2 * yl;
+            z2r = bq.b2 * xr - bq.a2 * yr;
+            p[0] = yl;
+            p[1] = yr;
+        }
+        st = { z1l, z2l, z1r, z2r };
+    }
+}
+
+void DspChain::applyGain(float* interleaved, int frames) {
+    const quint32 seq = m_rampSeq.load(std::memory_order_acquire);
+    if (seq != m_seenRampSeq) {
+        m_seenRampSeq = seq;
+        const float target = m_rampTarget.load(std::memory_order_relaxed);
+        const int rampFrames = m_rampFrames.load(std::memory_order_relaxed);
+        if (rampFrames <= 0) {
+            m_gain = target;
+            m_gainRemaining = 0;
+        }
+        else {
+            m_gainStep = (target - m_gain) / float(rampFrames);
+            m_gainRemaining = rampFrames;
+        }
+        if (m_gainRemaining == 0) m_completedRampSeq.store(seq, std::memory_order_release);
+    }
+
+    int f = 0;
+    // 斜坡段：逐帧变化
+    for (; f < frames && m_gainRemaining > 0; ++f, --m_gainRemaining) {
+        m_gain += m_gainStep;
+        interleaved[f * kChannels] *= m_gain;
+        interleaved[f * kChannels + 1] *= m_gain;
+        if (m_gainRemaining == 1) {
+            m_gain = m_rampTarget.load(std::memory_order_relaxed);
+            m_completedRampSeq.store(m_seenRampSeq, std::memory_order_release);
+        }
+    }
+    if (f >= frames || m_gain == 1.0f) return;
+
+    // 恒定增益段
+    float* p = interleaved + f * kChannels;
+    const int count = (frames - f) * kChannels;
+    int i = 0;
+#ifdef DSP_HAS_SSE2
+    const __m128 g = _mm_set1_ps(m_gain);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(p + i, _mm_mul_ps(_mm_loadu_ps(p + i), g));
+    }
+#endif
+    for (; i < count; ++i) p[i] *= m_gain;
+}
+
+void DspChain::processLimiter(float* interleaved, int frames) {
+    const int window = m_lookahead + 1;
+    for (int f = 0; f < frames; ++f) {
+        float* p = interleaved + f * kChannels;
+        const float peak = std::max(std::abs(p[0]), std::abs(p[1]));
+        const float target = peak > m_threshold ? m_threshold / peak : 1.0f;
+
+        // 单调队列维护前瞻窗口内的最小目标增益
+        while (m_minSize > 0) {
+            const int back = (m_minHead + m_minSize - 1) % window;
+            if (m_minValues[back] < target) break;
+            --m_minSize;
+        }
+        const int slot = (m_minHead + m_minSize) % window;
+        m_minValues[slot] = target;
+        m_minIndex[slot] = m_frameCounter;
+        ++m_minSize;
+        while (m_minIndex[m_minHead] <= m_frameCounter - window) {
+            m_minHead = (m_minHead + 1) % window;
+            --m_minSize;
+        }
+        const float windowMin = m_minValues[m_minHead];
+        ++m_frameCounter;
+
+        const float coef = windowMin < m_envelope ? m_attackCoef : m_releaseCoef;
+        m_envelope = windowMin + (m_envelope - windowMin) * coef;
+
+        // 输出延迟 m_lookahead 帧，让增益先于峰值落下
+        float* d = m_delay.data() + m_delayPos * kChannels;
+        const float outL = d[0] * m_envelope;
+        const float outR = d[1] * m_envelope;
+        d[0] = p[0];
+        d[1] = p[1];
+        m_delayPos = (m_delayPos + 1) % m_lookahead;
+
+        p[0] = std::clamp(outL, -1.0f, 1.0f);
+        p[1] = std::clamp(outR, -1.0f, 1.0f);
+    }
+}
+
+// ========== 开销 ==========
+double DspChain::cpuMicrosPerSecond() const {
+    const qint64 processed = m_processedFrames.load(std::memory_order_relaxed);
+    if (processed <= 0) return 0.0;
+    const double audioSeconds = double(processed) / m_sampleRate;
+    return double(m_processNs.load(std::memory_order_relaxed)) / 1000.0 / audioSeconds;
+}
+
+double DspChain::benchmark(int seconds, int sampleRate) {
+    DspChain chain(sampleRate);
+    QList<int> gains;
+    for (size_t i = 0; i < kGraphicEqFrequencies.size(); ++i) gains << (i % 2 ? -6 : 6);
+    chain.setEqBands(graphicEqBands(gains));
+    chain.setLimiterEnabled(true);
+
+    // 1024 帧一块，与常见的回调大小一致；信号幅度足以触发限幅
+    constexpr int kBlock = 1024;
+    std::vector<float> block(size_t(kBlock) * kChannels);
+    quint32 rng = 0x12345678u;
+    const qint64 totalFrames = qint64(seconds) * sampleRate;
+    for (qint64 done = 0; done < totalFrames; done += kBlock) {
+        for (float& s : block) {
+            rng = rng * 1664525u + 1013904223u;
+            s = (float(rng >> 8) / float(1u << 24)) * 2.4f - 1.2f;
+        }
+        if ((done / kBlock) % 50 == 0) chain.rampGainTo((done / kBlock) % 100 ? 0.3f : 1.0f, 200);
+        chain.process(block.data(), kBlock);
+    }
+    return chain.cpuMicrosPerSecond();
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <QList>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 渲染管线的 DSP 链（交错立体声 float，原地处理）
+ *
+ *   参数均衡（峰值型双二阶滤波器级联）→ 增益斜坡（逐采样）→ 前瞻限幅器
+ *
+ * process() 只在音频回调线程调用，不分配、不释放内存，不加锁。
+ * 均衡参数由渲染器所在的引擎线程提交：系数整体替换为新的只读参数块，经原子裸指针交给回调，
+ * 旧块由引擎线程在回调放手后释放；增益斜坡通过序号提交（任意线程）。
+ * 回调在每个块开头取用。斜坡走完后 completedRampSeq() 变为对应序号，调用方据此执行暂停/停止。
+ */
+class DspChain {
+public:
+    struct EqBand {
+        double frequencyHz = 1000.0;
+        double gainDb = 0.0;
+        double q = 1.0;
+    };
+
+    static constexpr int kChannels = 2;
+    static constexpr int kMaxBands = 10;
+    // 图示均衡的固定频点（设置页按这个顺序给出各段增益）
+    static constexpr std::array<int, 5> kGraphicEqFrequencies = { 60, 230, 910, 3600, 14000 };
+
+    explicit DspChain(int sampleRate = 48000);
+
+    // 只能在回调未运行时调用（打开输出之前）
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return m_sampleRate; }
+    // 清空滤波器与限幅器状态并把增益置 0（跳转后调用，回调未运行时）；随后用 rampGainTo 淡入
+    void reset();
+
+    // 只能在引擎线程调用；顺带释放回调已放手的旧参数块
+    void setEqBands(const QList<EqBand>& bands);
+    static QList<EqBand> graphicEqBands(const QList<int>& gainsDb);
+
+    // 在 durationMs 内把增益线性过渡到 gain；返回本次斜坡的序号
+    quint32 rampGainTo(float gain, int durationMs);
+    quint32 completedRampSeq() const { return m_completedRampSeq.load(std::memory_order_acquire); }
+
+    void setLimiterEnabled(bool enabled) { m_limiterEnabled.store(enabled, std::memory_order_relaxed); }
+    bool limiterEnabled() const { return m_limiterEnabled.load(std::memory_order_relaxed); }
+
+    void process(float* interleaved, int frames);
+
+    // 实测开销：累计处理耗时 / 累计处理的音频时长
+    double cpuMicrosPerSecond() const;
+    // 用合成信号离线跑 seconds 秒音频（全部功能开启），返回每秒音频的处理耗时（微秒）
+    static double benchmark(int seconds = 60, int sampleRate = 48000);
+
+private:
+    struct Biquad {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+    struct EqParams {
+        std::vector<Biquad> sections;
+    };
+
+    void processEq(float* interleaved, int frames);
+    void applyGain(float* interleaved, int frames);
+    void processLimiter(float* interleaved, int frames);
+    void configureLimiter();
+
+    int m_sampleRate;
+
+    // ===== 均衡：引擎线程发布参数块，回调读取 =====
+    // 回调把正在用的块登记在 m_eqInUse，引擎线程释放旧块前看登记（std::atomic<shared_ptr> 不是无锁的）
+    QList<EqBand> m_bands;
+    std::vector<std::unique_ptr<const EqParams>> m_eqBlocks;              // 仅引擎线程
+    std::atomic<const EqParams*> m_pendingEq{ nullptr };
+    std::atomic<const EqParams*> m_eqInUse{ nullptr };
+    const EqParams* m_activeEq = nullptr;                                  // 仅回调使用
+    std::array<std::array<float, 2 * kChannels>, kMaxBands> m_eqState{};   // 每段 z1/z2 × 声道
+
+    // ===== 增益斜坡 =====
+    std::atomic<float> m_rampTarget{ 1.0f };
+    std::atomic<int> m_rampFrames{ 0 };
+    std::atomic<quint32> m_rampSeq{ 0 };
+    std::atomic<quint32> m_completedRampSeq{ 0 };
+    quint32 m_seenRampSeq = 0;          // 以下仅回调使用
+    float m_gain = 1.0f;
+    float m_gainStep = 0.0f;
+    int m_gainRemaining = 0;
+
+    // ===== 前瞻限幅器 =====
+    std::atomic<bool> m_limiterEnabled{ true };
+    float m_threshold = 0.891f;         // -1 dBFS
+    int m_lookahead = 0;                // 帧
+    float m_attackCoef = 0.0f;
+    float m_releaseCoef = 0.0f;
+    float m_envelope = 1.0f;
+    std::vector<float> m_delay;         // 交错立体声延迟线
+    int m_delayPos = 0;
+    std::vector<float> m_minValues;     // 窗口最小值的单调队列（环形）
+    std::vector<qint64> m_minIndex;
+    int m_minHead = 0;
+    int m_minSize = 0;
+    qint64 m_frameCounter = 0;
+
+    // ===== 开销统计 =====
+    std::atomic<qint64> m_processNs{ 0 };
+    std::atomic<qint64> m_processedFrames{ 0 };
+};
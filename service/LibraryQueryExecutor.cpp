@@ -0,0 +1,119 @@
+// service/LibraryQueryExecutor.cpp
+#include "LibraryQueryExecutor.h"
+#include "../data/DatabaseManager.h"
+#include "../data/SongRepository.h"
+#include "../data/PlaylistRepository.h"
+#include <QPromise>
+#include <QSqlDatabase>
+#include <QDebug>
+#include <memory>
+
+static const char* kQueryConnectionName = "library_query";
+
+// 查询线程中的执行体：持有查询线程专用的数据库连接与仓储
+class LibraryQueryExecutor::Worker : public QObject {
+public:
+    bool ensureOpen() {
+        if (m_songRepository) {
+            return true;
+        }
+        DatabaseManager& dbm = DatabaseManager::instance();
+        if (!dbm.isInitialized()) {
+            qWarning() << "LibraryQueryExecutor: 数据库尚未初始化";
+            return false;
+        }
+        QSqlDatabase db = dbm.openThreadConnection(kQueryConnectionName);
+        if (!db.isOpen()) {
+            return false;
+        }
+        m_songRepository = new SongRepository(kQueryConnectionName, this);
+        m_playlistRepository = new PlaylistRepository(kQueryConnectionName, this);
+        return true;
+    }
+
+    void shutdown() {
+        delete m_songRepository;
+        delete m_playlistRepository;
+        m_songRepository = nullptr;
+        m_playlistRepository = nullptr;
+        DatabaseManager::instance().closeThreadConnection(kQueryConnectionName);
+    }
+
+    SongRepository* songRepository() const { return m_songRepository; }
+    PlaylistRepository* playlistRepository() const { return m_playlistRepository; }
+
+private:
+    SongRepository* m_songRepository = nullptr;
+    PlaylistRepository* m_playlistRepository = nullptr;
+};
+
+LibraryQueryExecutor::LibraryQueryExecutor(QObject* parent)
+    : QObject(parent)
+    , m_worker(new Worker)
+{
+    m_thread.setObjectName("LibraryQueryThread");
+    m_worker->moveToThread(&m_thread);
+    m_thread.start(QThread::LowPriority);
+
+    qDebug() << "✅ LibraryQueryExecutor 初始化完成";
+}
+
+LibraryQueryExecutor::~LibraryQueryExecutor() {
+    for (auto& future : m_latestByChannel) {
+        future.cancel();
+    }
+
+    if (m_thread.isRunning()) {
+        Worker* worker = m_worker;
+        QMetaObject::invokeMethod(m_worker, [worker]() { worker->shutdown(); },
+            Qt::BlockingQueuedConnection);
+        m_thread.quit();
+        m_thread.wait();
+    }
+    delete m_worker;
+}
+
+QFuture<QList<Song>> LibraryQueryExecutor::submit(const QString& channel, SongQuery query) {
+    auto promise = std::make_shared<QPromise<QList<Song>>>();
+    QFuture<QList<Song>> future = promise->future();
+
+    if (!channel.isEmpty()) {
+        // 取代同一 channel 上尚未完成的旧查询
+        auto it = m_latestByChannel.find(channel);
+        if (it != m_latestByChannel.end() && !it->isFinished()) {
+            it->cancel();
+        }
+        m_latestByChannel.insert(channel, future);
+    }
+
+    Worker* worker = m_worker;
+    QMetaObject::invokeMethod(m_worker, [worker, promise, query = std::move(query)]() {
+        promise->start();
+
+        // 排队期间已被取代：直接跳过，不触碰数据库
+        if (promise->isCanceled()) {
+            promise->finish();
+            return;
+        }
+
+        QList<Song> result;
+        if (worker->ensureOpen()) {
+            result = query(*worker->songRepository(), *worker->playlistRepository());
+        }
+
+        if (!promise->isCanceled()) {
+            promise->addResult(std::move(result));
+        }
+        promise->finish();
+        }, Qt::QueuedConnection);
+
+    return future;
+}
+
+void LibraryQueryExecutor::cancelChannel(const QString& channel) {
+    auto it = m_latestByChannel.find(channel);
+    if (it != m_latestByChannel.end()) {
+        it->cancel();
+        m_latestByChannel.erase(it);
+    }
+}
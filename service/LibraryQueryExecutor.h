@@ -0,0 +1,45 @@
+// service/LibraryQueryExecutor.h
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <functional>
+#include "../common/entities/Song.h"
+
+class SongRepository;
+class PlaylistRepository;
+
+/**
+ * @brief 音乐库查询执行器：在独立的查询线程（独立数据库连接）中执行只读查询
+ *
+ * - 每个查询返回 QFuture，结果通过 QFuture::then(context, ...) 回到调用方线程
+ * - 同一 channel 上新提交的查询会取消尚未完成的旧查询（如旧的搜索按键）
+ * - 查询线程按提交顺序串行执行，因此同一 channel 的结果按提交顺序交付
+ */
+class LibraryQueryExecutor : public QObject {
+    Q_OBJECT
+
+public:
+    using SongQuery = std::function<QList<Song>(SongRepository&, PlaylistRepository&)>;
+
+    explicit LibraryQueryExecutor(QObject* parent = nullptr);
+    ~LibraryQueryExecutor() override;
+
+    // 提交查询；channel 为空时不参与取代
+    QFuture<QList<Song>> submit(const QString& channel, SongQuery query);
+
+    // 取消 channel 上尚未完成的查询
+    void cancelChannel(const QString& channel);
+
+private:
+    class Worker;
+
+    QThread m_thread;
+    Worker* m_worker;
+
+    // 仅在所属线程（UI 线程）访问
+    QHash<QString, QFuture<QList<Song>>> m_latestByChannel;
+};
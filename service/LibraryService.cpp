@@ -9,8 +9,17 @@
 #include <QDebug>
 #include <QUuid>
 #include <QRegularExpression>
+#include <QElapsedTimer>
+#include <QThreadPool>
 #include "../common/AppConfig.h"     
 #include "ConcurrentDownloadManager.h" 
+#include "../data/DatabaseManager.h"
+#include "../common/SortKey.h"
+#include "LibraryQueryExecutor.h"
+#include "SongSearchIndex.h"
+#include "PlaylistMembershipIndex.h"
+
+static const char* kSortKeyConnectionName = "sort_key_rebuild";
 
 // 提取 BV/av 号（或从 URL 中提取）
 // 若传入已是 "BV..." 或 "av..." 则直接返回
@@ -31,6 +40,8 @@ LibraryService::LibraryService(QObject* parent)
     : QObject(parent)
     , m_songRepository(new SongRepository(this))
     , m_playlistRepository(new PlaylistRepository(this))
+    , m_queryExecutor(new LibraryQueryExecutor(this))
+    , m_membership(std::make_unique<PlaylistMembershipIndex>())
 {
     qDebug() << "✅ LibraryService 初始化完成";
 
@@ -38,17 +49,21 @@ LibraryService::LibraryService(QObject* parent)
     auto& cdm = ConcurrentDownloadManager::instance();
     connect(&cdm, &ConcurrentDownloadManager::taskCompleted,
         this, &LibraryService::onConcurrentTaskCompleted);
+
+    buildSearchIndex();
 }
 
+LibraryService::~LibraryService() = default;
+
 // ========== 歌曲管理 ==========
 bool LibraryService::updateSongInfo(const QString& id, const QString& title, const QString& artist) {
     if (!validateSongId(id)) {
-        emit operationFailed("更新歌曲", "无效的歌曲ID");
+        reportFailure("更新歌曲", "无效的歌曲ID");
         return false;
     }
 
     if (title.trimmed().isEmpty()) {
-        emit operationFailed("更新歌曲", "歌曲标题不能为空");
+        reportFailure("更新歌曲", "歌曲标题不能为空");
         return false;
     }
 
@@ -56,11 +71,13 @@ bool LibraryService::updateSongInfo(const QString& id, const QString& title, con
 
     if (success) {
         Song updatedSong = m_songRepository->findById(id);
-        emit songUpdated(updatedSong);
+        indexSong(updatedSong);
+        if (isInBatch()) m_batch.updatedSongIds << id;
+        else emit songUpdated(updatedSong);
         qDebug() << "✅ LibraryService: 歌曲信息已更新 -" << title;
     }
     else {
-        emit operationFailed("更新歌曲", "数据库更新失败");
+        reportFailure("更新歌曲", "数据库更新失败");
     }
 
     return success;
@@ -68,7 +85,7 @@ bool LibraryService::updateSongInfo(const QString& id, const QString& title, con
 
 bool LibraryService::deleteSong(const QString& id) {
     if (!validateSongId(id)) {
-        emit operationFailed("删除歌曲", "无效的歌曲ID");
+        reportFailure("删除歌曲", "无效的歌曲ID");
         return false;
     }
 
@@ -76,14 +93,26 @@ bool LibraryService::deleteSong(const QString& id) {
     Song song = m_songRepository->findById(id);
     QString songTitle = song.getId().isEmpty() ? id : song.getTitle();
 
-    bool success = m_songRepository->deleteSongWithFile(id);
+    // 批量作用域内只删除记录，文件等作用域提交成功后再删
+    bool success;
+    if (isInBatch()) {
+        QString filePath;
+        success = m_songRepository->deleteSongRecord(id, &filePath);
+        if (success) m_batchFileRemovals << filePath;
+    }
+    else {
+        success = m_songRepository->deleteSongWithFile(id);
+    }
 
     if (success) {
-        emit songDeleted(id);
+        unindexSong(id);
+        membership().removeSong(id);
+        if (isInBatch()) m_batch.deletedSongIds << id;
+        else emit songDeleted(id);
         qDebug() << "✅ LibraryService: 歌曲已删除 -" << songTitle;
     }
     else {
-        emit operationFailed("删除歌曲", "删除失败");
+        reportFailure("删除歌曲", "删除失败");
     }
 
     return success;
@@ -91,25 +120,44 @@ bool LibraryService::deleteSong(const QString& id) {
 
 int LibraryService::deleteSongs(const QStringList& ids) {
     if (ids.isEmpty()) {
-        emit operationFailed("批量删除", "歌曲列表为空");
+        reportFailure("批量删除", "歌曲列表为空");
         return 0;
     }
 
-    int successCount = m_songRepository->deleteBatch(ids);
+    // 只记录实际删除的歌曲；本地文件在事务提交成功后才删除
+    QStringList filePaths;
+    const QStringList deletedIds = m_songRepository->deleteBatch(ids, &filePaths);
 
-    if (successCount > 0) {
-        for (const QString& id : ids) {
-            emit songDeleted(id);
+    if (!deletedIds.isEmpty()) {
+        for (const QString& id : deletedIds) {
+            unindexSong(id);
+            membership().removeSong(id);
         }
-        qDebug() << "✅ LibraryService: 批量删除完成，共删除" << successCount << "首歌曲";
+        if (isInBatch()) {
+            m_batch.deletedSongIds << deletedIds;
+            m_batchFileRemovals << filePaths;
+        }
+        else {
+            for (const QString& path : filePaths) {
+                SongRepository::removeLocalFile(path);
+            }
+            for (const QString& id : deletedIds) {
+                emit songDeleted(id);
+            }
+        }
+        qDebug() << "✅ LibraryService: 批量删除完成，共删除" << deletedIds.size() << "首歌曲";
     }
 
-    return successCount;
+    if (deletedIds.size() < ids.size()) {
+        reportFailure("批量删除", QString("%1 首歌曲删除失败").arg(ids.size() - deletedIds.size()));
+    }
+
+    return deletedIds.size();
 }
 
 bool LibraryService::toggleFavorite(const QString& id) {
     if (!validateSongId(id)) {
-        emit operationFailed("切换收藏", "无效的歌曲ID");
+        reportFailure("切换收藏", "无效的歌曲ID");
         return false;
     }
 
@@ -117,11 +165,13 @@ bool LibraryService::toggleFavorite(const QString& id) {
 
     if (success) {
         Song song = m_songRepository->findById(id);
-        emit songFavoriteToggled(id, song.isFavorite());
+        indexSong(song);
+        if (isInBatch()) m_batch.favoriteToggledIds << id;
+        else emit songFavoriteToggled(id, song.isFavorite());
         qDebug() << "✅ LibraryService: 收藏状态已切换 -" << song.getTitle();
     }
     else {
-        emit operationFailed("切换收藏", "操作失败");
+        reportFailure("切换收藏", "操作失败");
     }
 
     return success;
@@ -154,19 +204,164 @@ int LibraryService::getSongCount() {
     return m_songRepository->count();
 }
 
+// ========== 异步查询 ==========
+QFuture<QList<Song>> LibraryService::getAllSongsAsync(const QString& channel) {
+    return m_queryExecutor->submit(channel, [](SongRepository& songs, PlaylistRepository&) {
+        return songs.findAll();
+        });
+}
+
+QFuture<QList<Song>> LibraryService::searchSongsAsync(const QString& keyword, const QString& channel) {
+    return m_queryExecutor->submit(channel, [keyword](SongRepository& songs, PlaylistRepository&) {
+        return songs.searchByKeyword(keyword);
+        });
+}
+
+QFuture<QList<Song>> LibraryService::getPlaylistSongsAsync(const QString& playlistId, const QString& channel) {
+    return m_queryExecutor->submit(channel, [playlistId](SongRepository&, PlaylistRepository& playlists) {
+        return playlists.getSongsInPlaylist(playlistId);
+        });
+}
+
+QFuture<QList<Song>> LibraryService::searchPlaylistSongsAsync(const QString& playlistId, const QString& keyword,
+    const QString& channel) {
+    return m_queryExecutor->submit(channel, [playlistId, keyword](SongRepository&, PlaylistRepository& playlists) {
+        QList<Song> filtered;
+        const QList<Song> base = playlists.getSongsInPlaylist(playlistId);
+        for (const Song& s : base) {
+            if (s.getTitle().contains(keyword, Qt::CaseInsensitive) ||
+                s.getArtist().contains(keyword, Qt::CaseInsensitive)) {
+                filtered.append(s);
+            }
+        }
+        return filtered;
+        });
+}
+
+// ========== 内存搜索索引 ==========
+QList<Song> LibraryService::searchIndexed(const QString& keyword, int topK) const {
+    if (!m_searchIndexReady) return {};
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<Song> songs = m_searchIndex->search(keyword, topK);
+    qDebug() << "🔍 LibraryService: 索引搜索'" << keyword << "'，找到" << songs.size()
+        << "首，耗时" << timer.nsecsElapsed() / 1000 << "µs";
+    return songs;
+}
+
+void LibraryService::notifySongAdded(const Song& song) {
+    if (song.getId().isEmpty()) return;
+    indexSong(song);
+}
+
+void LibraryService::buildSearchIndex() {
+    // 读取在查询线程，构建在线程池，装载回到本线程
+    getAllSongsAsync()
+        .then(QtFuture::Launch::Async, [](const QList<Song>& songs) {
+            QElapsedTimer timer;
+            timer.start();
+            auto index = std::make_shared<SongSearchIndex>();
+            index->build(songs);
+            qDebug() << "📇 LibraryService: 搜索索引构建完成，共" << index->size()
+                << "首，耗时" << timer.elapsed() << "ms";
+            return index;
+            })
+        .then(this, [this](std::shared_ptr<SongSearchIndex> index) {
+            m_searchIndex = std::make_unique<SongSearchIndex>(std::move(*index));
+
+            // 补上构建期间发生的变更
+            for (const QString& id : std::as_const(m_pendingIndexRemovals)) {
+                m_searchIndex->remove(id);
+            }
+            for (const Song& song : std::as_const(m_pendingIndexUpserts)) {
+                m_searchIndex->addOrUpdate(song);
+            }
+            m_pendingIndexRemovals.clear();
+            m_pendingIndexUpserts.clear();
+
+            m_searchIndexReady = true;
+            emit searchIndexReady();
+            });
+}
+
+void LibraryService::indexSong(const Song& song) {
+    if (song.getId().isEmpty()) return;
+    emit songUpserted(song);
+    if (m_sortKeyRebuilding) m_sortKeyTouched.insert(song.getId());
+    if (m_searchIndexReady) {
+        m_searchIndex->addOrUpdate(song);
+        return;
+    }
+    m_pendingIndexRemovals.remove(song.getId());
+    m_pendingIndexUpserts.insert(song.getId(), song);
+}
+
+void LibraryService::unindexSong(const QString& id) {
+    emit songRemoved(id);
+    if (m_searchIndexReady) {
+        m_searchIndex->remove(id);
+        return;
+    }
+    m_pendingIndexUpserts.remove(id);
+    m_pendingIndexRemovals.insert(id);
+}
+
+// ========== 排序方式 ==========
+bool LibraryService::setSortByPinyin(bool enabled) {
+    if (m_sortKeyRebuilding) return false;
+    if (AppConfig::instance().getSortByPinyin() == enabled) return true;
+
+    // 重算在线程池里用独立连接进行，完成后回到本线程切换配置；期间仍按旧方式排序
+    m_sortKeyRebuilding = true;
+    m_sortKeyTouched.clear();
+    const SortKey::Mode mode = enabled ? SortKey::Mode::Pinyin : SortKey::Mode::Standard;
+    QThreadPool::globalInstance()->start([this, enabled, mode]() {
+        qint64 lastRowId = 0;
+        const bool ok = DatabaseManager::instance().rebuildSortKeys(kSortKeyConnectionName, mode, &lastRowId);
+        QMetaObject::invokeMethod(this, [this, enabled, ok, lastRowId]() {
+            finishSortKeyRebuild(enabled, ok, lastRowId);
+            }, Qt::QueuedConnection);
+        });
+    qDebug() << "🔤 LibraryService: 开始按" << (enabled ? "拼音" : "标准") << "方式重算排序键";
+    return true;
+}
+
+void LibraryService::finishSortKeyRebuild(bool enabled, bool ok, qint64 lastRowId) {
+    m_sortKeyRebuilding = false;
+    const QStringList touched(m_sortKeyTouched.cbegin(), m_sortKeyTouched.cend());
+    m_sortKeyTouched.clear();
+
+    AppConfig& config = AppConfig::instance();
+    if (!ok) {
+        // 排序键仍以旧方式为准（签名未改写，下次启动也会按配置校正）
+        reportFailure("切换排序方式", "重算排序键失败");
+        emit sortByPinyinApplied(config.getSortByPinyin());
+        return;
+    }
+
+    config.setSortByPinyin(enabled);
+    // 重算期间新入库或改过信息的歌曲是按旧方式算的键：补算
+    if (!DatabaseManager::instance().refreshSortKeysSince(lastRowId, touched)) {
+        qWarning() << "⚠️ LibraryService: 补算排序键失败";
+    }
+    qDebug() << "✅ LibraryService: 排序方式已切换为" << (enabled ? "拼音" : "标准");
+    emit sortByPinyinApplied(enabled);
+}
+
 // ========== 歌单管理 ==========
 QString LibraryService::createPlaylist(const QString& name, const QString& description) {
     QString sanitizedName = sanitizePlaylistName(name);
 
     if (!validatePlaylistName(sanitizedName)) {
-        emit operationFailed("创建歌单", "歌单名称无效");
+        reportFailure("创建歌单", "歌单名称无效");
         return QString();
     }
 
     // 检查是否已存在同名歌单
     Playlist existing = m_playlistRepository->findByName(sanitizedName);
     if (!existing.getId().isEmpty()) {
-        emit operationFailed("创建歌单", QString("歌单'%1'已存在").arg(sanitizedName));
+        reportFailure("创建歌单", QString("歌单'%1'已存在").arg(sanitizedName));
         return QString();
     }
 
@@ -177,31 +372,33 @@ QString LibraryService::createPlaylist(const QString& name, const QString& descr
     bool success = m_playlistRepository->save(newPlaylist);
 
     if (success) {
-        emit playlistCreated(newPlaylist);
+        membership().addPlaylist(newPlaylist);
+        if (isInBatch()) m_batch.changedPlaylistIds.insert(newId);
+        else emit playlistCreated(newPlaylist);
         qDebug() << "✅ LibraryService: 歌单已创建 -" << sanitizedName;
         return newId;
     }
     else {
-        emit operationFailed("创建歌单", "保存失败");
+        reportFailure("创建歌单", "保存失败");
         return QString();
     }
 }
 
 bool LibraryService::updatePlaylist(const QString& id, const QString& name, const QString& description) {
     if (!validatePlaylistId(id)) {
-        emit operationFailed("更新歌单", "无效的歌单ID");
+        reportFailure("更新歌单", "无效的歌单ID");
         return false;
     }
 
     QString sanitizedName = sanitizePlaylistName(name);
     if (!validatePlaylistName(sanitizedName)) {
-        emit operationFailed("更新歌单", "歌单名称无效");
+        reportFailure("更新歌单", "歌单名称无效");
         return false;
     }
 
     Playlist playlist = m_playlistRepository->findById(id);
     if (playlist.getId().isEmpty()) {
-        emit operationFailed("更新歌单", "歌单不存在");
+        reportFailure("更新歌单", "歌单不存在");
         return false;
     }
 
@@ -211,11 +408,13 @@ bool LibraryService::updatePlaylist(const QString& id, const QString& name, cons
     bool success = m_playlistRepository->update(playlist);
 
     if (success) {
-        emit playlistUpdated(playlist);
+        membership().updatePlaylist(playlist);
+        if (isInBatch()) m_batch.changedPlaylistIds.insert(id);
+        else emit playlistUpdated(playlist);
         qDebug() << "✅ LibraryService: 歌单已更新 -" << sanitizedName;
     }
     else {
-        emit operationFailed("更新歌单", "更新失败");
+        reportFailure("更新歌单", "更新失败");
     }
 
     return success;
@@ -223,7 +422,7 @@ bool LibraryService::updatePlaylist(const QString& id, const QString& name, cons
 
 bool LibraryService::deletePlaylist(const QString& id) {
     if (!validatePlaylistId(id)) {
-        emit operationFailed("删除歌单", "无效的歌单ID");
+        reportFailure("删除歌单", "无效的歌单ID");
         return false;
     }
 
@@ -233,11 +432,13 @@ bool LibraryService::deletePlaylist(const QString& id) {
     bool success = m_playlistRepository->deleteById(id);
 
     if (success) {
-        emit playlistDeleted(id);
+        membership().removePlaylist(id);
+        if (isInBatch()) m_batch.changedPlaylistIds.insert(id);
+        else emit playlistDeleted(id);
         qDebug() << "✅ LibraryService: 歌单已删除 -" << playlistName;
     }
     else {
-        emit operationFailed("删除歌单", "删除失败");
+        reportFailure("删除歌单", "删除失败");
     }
 
     return success;
@@ -245,18 +446,20 @@ bool LibraryService::deletePlaylist(const QString& id) {
 
 bool LibraryService::clearPlaylist(const QString& id) {
     if (!validatePlaylistId(id)) {
-        emit operationFailed("清空歌单", "无效的歌单ID");
+        reportFailure("清空歌单", "无效的歌单ID");
         return false;
     }
 
     bool success = m_playlistRepository->clearPlaylist(id);
 
     if (success) {
-        emit playlistCleared(id);
+        membership().clearPlaylist(id);
+        if (isInBatch()) m_batch.changedPlaylistIds.insert(id);
+        else emit playlistCleared(id);
         qDebug() << "✅ LibraryService: 歌单已清空";
     }
     else {
-        emit operationFailed("清空歌单", "操作失败");
+        reportFailure("清空歌单", "操作失败");
     }
 
     return success;
@@ -265,19 +468,21 @@ bool LibraryService::clearPlaylist(const QString& id) {
 // ========== 歌单-歌曲关联 ==========
 int LibraryService::addSongsToPlaylist(const QString& playlistId, const QStringList& songIds) {
     if (!validatePlaylistId(playlistId)) {
-        emit operationFailed("添加歌曲到歌单", "无效的歌单ID");
+        reportFailure("添加歌曲到歌单", "无效的歌单ID");
         return 0;
     }
 
     if (songIds.isEmpty()) {
-        emit operationFailed("添加歌曲到歌单", "歌曲列表为空");
+        reportFailure("添加歌曲到歌单", "歌曲列表为空");
         return 0;
     }
 
     int successCount = m_playlistRepository->addSongsToPlaylist(playlistId, songIds);
 
     if (successCount > 0) {
-        emit songsAddedToPlaylist(playlistId, successCount);
+        membership().add(playlistId, songIds);
+        if (isInBatch()) m_batch.addedToPlaylist[playlistId] += successCount;
+        else emit songsAddedToPlaylist(playlistId, successCount);
         qDebug() << "✅ LibraryService: 已添加" << successCount << "首歌曲到歌单";
     }
 
@@ -286,18 +491,20 @@ int LibraryService::addSongsToPlaylist(const QString& playlistId, const QStringL
 
 bool LibraryService::removeSongFromPlaylist(const QString& playlistId, const QString& songId) {
     if (!validatePlaylistId(playlistId) || !validateSongId(songId)) {
-        emit operationFailed("从歌单移除歌曲", "无效的ID");
+        reportFailure("从歌单移除歌曲", "无效的ID");
         return false;
     }
 
     bool success = m_playlistRepository->removeSongFromPlaylist(playlistId, songId);
 
     if (success) {
-        emit songRemovedFromPlaylist(playlistId, songId);
+        membership().remove(playlistId, { songId });
+        if (isInBatch()) m_batch.removedFromPlaylist[playlistId] << songId;
+        else emit songRemovedFromPlaylist(playlistId, songId);
         qDebug() << "✅ LibraryService: 歌曲已从歌单移除";
     }
     else {
-        emit operationFailed("从歌单移除歌曲", "移除失败");
+        reportFailure("从歌单移除歌曲", "移除失败");
     }
 
     return success;
@@ -305,15 +512,21 @@ bool LibraryService::removeSongFromPlaylist(const QString& playlistId, const QSt
 
 int LibraryService::removeSongsFromPlaylist(const QString& playlistId, const QStringList& songIds) {
     if (!validatePlaylistId(playlistId)) {
-        emit operationFailed("批量移除", "无效的歌单ID");
+        reportFailure("批量移除", "无效的歌单ID");
         return 0;
     }
 
     int successCount = m_playlistRepository->removeSongsFromPlaylist(playlistId, songIds);
 
     if (successCount > 0) {
-        for (const QString& songId : songIds) {
-            emit songRemovedFromPlaylist(playlistId, songId);
+        membership().remove(playlistId, songIds);
+        if (isInBatch()) {
+            m_batch.removedFromPlaylist[playlistId] << songIds;
+        }
+        else {
+            for (const QString& songId : songIds) {
+                emit songRemovedFromPlaylist(playlistId, songId);
+            }
         }
         qDebug() << "✅ LibraryService: 已从歌单移除" << successCount << "首歌曲";
     }
@@ -323,13 +536,11 @@ int LibraryService::removeSongsFromPlaylist(const QString& playlistId, const QSt
 
 // ========== 歌单查询 ==========
 QList<Playlist> LibraryService::getAllPlaylists() {
-    QList<Playlist> playlists = m_playlistRepository->findAll();
-    qDebug() << "📋 LibraryService: 获取所有歌单，共" << playlists.size() << "个";
-    return playlists;
+    return membership().playlists();
 }
 
 Playlist LibraryService::getPlaylistById(const QString& id) {
-    return m_playlistRepository->findById(id);
+    return membership().playlist(id);
 }
 
 QList<Song> LibraryService::getPlaylistSongs(const QString& playlistId) {
@@ -337,11 +548,111 @@ QList<Song> LibraryService::getPlaylistSongs(const QString& playlistId) {
 }
 
 int LibraryService::getPlaylistSongCount(const QString& playlistId) {
-    return m_playlistRepository->getSongCountInPlaylist(playlistId);
+    return membership().songCount(playlistId);
 }
 
 bool LibraryService::isSongInPlaylist(const QString& playlistId, const QString& songId) {
-    return m_playlistRepository->isSongInPlaylist(playlistId, songId);
+    return membership().contains(playlistId, songId);
+}
+
+QHash<QString, int> LibraryService::getPlaylistMembershipCounts(const QStringList& songIds) {
+    return membership().membershipCounts(songIds);
+}
+
+PlaylistMembershipIndex& LibraryService::membership() {
+    if (!m_membershipLoaded) {
+        QElapsedTimer timer;
+        timer.start();
+        m_membership->load(m_playlistRepository->findAll(), m_playlistRepository->getAllMemberships());
+        m_membershipLoaded = true;
+        qDebug() << "📋 LibraryService: 歌单成员索引已装载，耗时" << timer.elapsed() << "ms";
+    }
+    return *m_membership;
+}
+
+// ========== 批量作用域 ==========
+void LibraryService::beginBatch() {
+    if (m_batchDepth++ > 0) {
+        return; // 嵌套：沿用外层作用域
+    }
+
+    m_batch = BatchChanges();
+    m_batchFileRemovals.clear();
+    if (!DatabaseManager::instance().beginTransaction()) {
+        qWarning() << "⚠️ LibraryService: 批量作用域开启事务失败，变更将逐条提交";
+    }
+    qDebug() << "LibraryService: 进入批量作用域";
+}
+
+bool LibraryService::commitBatch() {
+    if (m_batchDepth <= 0) {
+        qWarning() << "LibraryService: commitBatch 调用时不在批量作用域中";
+        return false;
+    }
+    if (--m_batchDepth > 0) {
+        return true; // 由最外层统一提交
+    }
+
+    DatabaseManager& dbm = DatabaseManager::instance();
+    bool ok = !dbm.inTransaction() || dbm.commitTransaction();
+
+    BatchChanges changes = m_batch;
+    m_batch = BatchChanges();
+    const QStringList fileRemovals = m_batchFileRemovals;
+    m_batchFileRemovals.clear();
+
+    if (!ok) {
+        // 与 rollbackBatch 相同：作用域内已增量更新的成员索引不再可信，下次使用时重新装载
+        m_membershipLoaded = false;
+        emit operationFailed("批量操作", "提交事务失败，变更已回滚");
+        return false;
+    }
+
+    // 记录删除已落盘，此时才删除对应的本地文件
+    for (const QString& path : fileRemovals) {
+        SongRepository::removeLocalFile(path);
+    }
+
+    if (!changes.errors.isEmpty()) {
+        emit operationFailed("批量操作",
+            QString("%1 项失败（%2）").arg(changes.errors.size()).arg(changes.errors.first()));
+    }
+
+    if (!changes.isEmpty()) {
+        emit batchCommitted(changes);
+    }
+
+    qDebug() << "✅ LibraryService: 批量作用域已提交 - 删除" << changes.deletedSongIds.size()
+        << "首，更新" << changes.updatedSongIds.size()
+        << "首，歌单关联变更" << changes.removedFromPlaylist.size() + changes.addedToPlaylist.size() << "个";
+    return true;
+}
+
+void LibraryService::rollbackBatch() {
+    if (m_batchDepth <= 0) {
+        qWarning() << "LibraryService: rollbackBatch 调用时不在批量作用域中";
+        return;
+    }
+    // 回滚总是作用于整个最外层作用域
+    m_batchDepth = 0;
+    m_batch = BatchChanges();
+    m_batchFileRemovals.clear(); // 记录已回滚，文件保留
+    // 作用域内已增量更新的成员索引不再可信，下次使用时重新装载
+    m_membershipLoaded = false;
+
+    DatabaseManager& dbm = DatabaseManager::instance();
+    while (dbm.inTransaction()) {
+        dbm.rollbackTransaction();
+    }
+    qDebug() << "LibraryService: 批量作用域已回滚";
+}
+
+void LibraryService::reportFailure(const QString& operation, const QString& error) {
+    if (isInBatch()) {
+        m_batch.errors << QString("%1: %2").arg(operation, error);
+        return;
+    }
+    emit operationFailed(operation, error);
 }
 
 // ========== 导出/导入功能 ==========
@@ -490,7 +801,7 @@ bool LibraryService::validateExportFile(const QString& filePath) {
 
 bool LibraryService::importAndDownloadMissingSongs(const QString& playlistId, const QList<Song>& songs) {
     if (!validatePlaylistId(playlistId)) {
-        emit operationFailed("导入并下载", "无效的歌单ID");
+        reportFailure("导入并下载", "无效的歌单ID");
         return false;
     }
     if (songs.isEmpty()) {
@@ -515,7 +826,9 @@ bool LibraryService::importAndDownloadMissingSongs(const QString& playlistId, co
     opt.audioFormat = app.getDefaultAudioFormat();
 
     QStringList toDownloadIds;
-    int addedExisting = 0;
+    QStringList existingIds;
+    int alreadyInPlaylist = 0;
+    PlaylistMembershipIndex& index = membership();
 
     for (const auto& s : songs) {
         const QString id = extractBvId(s.getBilibiliUrl().isEmpty() ? s.getId() : s.getBilibiliUrl());
@@ -524,18 +837,30 @@ bool LibraryService::importAndDownloadMissingSongs(const QString& playlistId, co
             continue;
         }
 
-        if (m_songRepository->exists(id)) {
-            // 已在本地，直接加入歌单（INSERT OR IGNORE）
-            if (m_playlistRepository->addSongToPlaylist(playlistId, id)) {
-                addedExisting++;
-            }
+        // 已在歌单中的直接跳过（内存判断，不访问数据库）
+        if (index.contains(playlistId, id)) {
+            alreadyInPlaylist++;
+            continue;
+        }
+
+        // 搜索索引就绪时它覆盖全部本地歌曲，可省去逐首 exists 查询
+        const bool local = m_searchIndexReady ? m_searchIndex->contains(id) : m_songRepository->exists(id);
+        if (local) {
+            existingIds << id;
         }
         else {
             toDownloadIds << id;
         }
     }
 
+    if (alreadyInPlaylist > 0) {
+        qDebug() << "LibraryService:" << alreadyInPlaylist << "首歌曲已在歌单中，跳过";
+    }
+
+    // 已在本地的一次性加入歌单（单个事务）
+    const int addedExisting = existingIds.isEmpty() ? 0 : m_playlistRepository->addSongsToPlaylist(playlistId, existingIds);
     if (addedExisting > 0) {
+        index.add(playlistId, existingIds);
         emit songsAddedToPlaylist(playlistId, addedExisting);
         qDebug() << "LibraryService: 已将" << addedExisting << "首本地已存在的歌曲加入歌单";
     }
@@ -555,6 +880,9 @@ bool LibraryService::importAndDownloadMissingSongs(const QString& playlistId, co
 }
 
 void LibraryService::onConcurrentTaskCompleted(const QString& taskId, const Song& song) {
+    // 新入库的歌曲进入搜索索引
+    indexSong(song);
+
     // 找到该任务对应的目标歌单
     const QString pid = m_taskToPlaylist.take(taskId);
     if (pid.isEmpty()) {
@@ -568,6 +896,7 @@ void LibraryService::onConcurrentTaskCompleted(const QString& taskId, const Song
 
     // 将完成的歌曲加入歌单
     if (m_playlistRepository->addSongToPlaylist(pid, song.getId())) {
+        membership().add(pid, { song.getId() });
         emit songsAddedToPlaylist(pid, 1);
         qDebug() << "LibraryService: 任务" << taskId << "完成，已将歌曲加入歌单";
     }
@@ -583,8 +912,7 @@ bool LibraryService::validatePlaylistId(const QString& id) {
     if (id.trimmed().isEmpty()) {
         return false;
     }
-    Playlist playlist = m_playlistRepository->findById(id);
-    return !playlist.getId().isEmpty();
+    return membership().hasPlaylist(id);
 }
 
 bool LibraryService::validatePlaylistName(const QString& name) {
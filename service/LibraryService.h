@@ -5,19 +5,25 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QHash>                 
+#include <QSet>
+#include <QFuture>
+#include <memory>
 #include "../data/SongRepository.h"
 #include "../data/PlaylistRepository.h"
 #include "../common/entities/Song.h"
 #include "../common/entities/Playlist.h"
 
 class ConcurrentDownloadManager;
+class LibraryQueryExecutor;
+class SongSearchIndex;
+class PlaylistMembershipIndex;
 
 class LibraryService : public QObject {
     Q_OBJECT
 
 public:
     explicit LibraryService(QObject* parent = nullptr);
-    ~LibraryService() override = default;
+    ~LibraryService() override;
 
     // ========== 歌曲管理 ==========
     bool updateSongInfo(const QString& id, const QString& title, const QString& artist);
@@ -32,6 +38,21 @@ public:
     Song getSongById(const QString& id);
     int getSongCount();
 
+    // ========== 异步查询（查询线程执行，不阻塞 UI 线程） ==========
+    // 同一 channel 上的新查询会取代尚未完成的旧查询；结果用 QFuture::then(context, ...) 接收
+    QFuture<QList<Song>> getAllSongsAsync(const QString& channel = QString());
+    QFuture<QList<Song>> searchSongsAsync(const QString& keyword, const QString& channel = QString());
+    QFuture<QList<Song>> getPlaylistSongsAsync(const QString& playlistId, const QString& channel = QString());
+    QFuture<QList<Song>> searchPlaylistSongsAsync(const QString& playlistId, const QString& keyword,
+        const QString& channel = QString());
+
+    // ========== 内存搜索索引（边输入边搜索） ==========
+    // 启动时在后台线程构建，之后随歌曲增删改增量更新；未就绪时调用方应回退到 SQL 搜索
+    bool isSearchIndexReady() const { return m_searchIndexReady; }
+    QList<Song> searchIndexed(const QString& keyword, int topK) const;
+    // 通知新入库的歌曲（非并行下载路径，例如单任务下载）
+    void notifySongAdded(const Song& song);
+
     // ========== 歌单管理 ==========
     QString createPlaylist(const QString& name, const QString& description = QString());
     bool updatePlaylist(const QString& id, const QString& name, const QString& description);
@@ -49,6 +70,8 @@ public:
     QList<Song> getPlaylistSongs(const QString& playlistId);
     int getPlaylistSongCount(const QString& playlistId);
     bool isSongInPlaylist(const QString& playlistId, const QString& songId);
+    // 每个歌单已包含 songIds 中的多少首（只含命中的歌单）；走内存索引，不访问数据库
+    QHash<QString, int> getPlaylistMembershipCounts(const QStringList& songIds);
 
     // ========== 导出功能 ==========
     struct ExportData {
@@ -65,6 +88,55 @@ public:
     ExportData parseImportFile(const QString& filePath);
     bool validateExportFile(const QString& filePath);
 
+    // ========== 批量作用域（合并通知） ==========
+    // beginBatch() 与 commitBatch() 之间的变更在同一事务中执行，
+    // 期间不再逐条发出 songDeleted / songRemovedFromPlaylist 等信号，
+    // 而是在 commitBatch() 时通过 batchCommitted 发出一次聚合通知。支持嵌套，仅最外层生效。
+    struct BatchChanges {
+        QStringList updatedSongIds;
+        QStringList deletedSongIds;
+        QStringList favoriteToggledIds;
+        QHash<QString, QStringList> removedFromPlaylist; // playlistId -> songIds
+        QHash<QString, int> addedToPlaylist;             // playlistId -> count
+        QSet<QString> changedPlaylistIds;                // 创建/更新/删除/清空的歌单
+        QStringList errors;
+
+        bool isEmpty() const {
+            return updatedSongIds.isEmpty() && deletedSongIds.isEmpty()
+                && favoriteToggledIds.isEmpty() && removedFromPlaylist.isEmpty()
+                && addedToPlaylist.isEmpty() && changedPlaylistIds.isEmpty();
+        }
+        bool songsChanged() const {
+            return !updatedSongIds.isEmpty() || !deletedSongIds.isEmpty()
+                || !favoriteToggledIds.isEmpty() || !removedFromPlaylist.isEmpty()
+                || !addedToPlaylist.isEmpty();
+        }
+    };
+
+    void beginBatch();
+    bool commitBatch();
+    void rollbackBatch();
+    bool isInBatch() const { return m_batchDepth > 0; }
+
+    // RAII 封装：析构时若未显式提交则自动提交
+    class BatchScope {
+    public:
+        explicit BatchScope(LibraryService* service) : m_service(service) { m_service->beginBatch(); }
+        ~BatchScope() { if (!m_done) m_service->commitBatch(); }
+        bool commit() { m_done = true; return m_service->commitBatch(); }
+        void rollback() { m_done = true; m_service->rollbackBatch(); }
+        BatchScope(const BatchScope&) = delete;
+        BatchScope& operator=(const BatchScope&) = delete;
+    private:
+        LibraryService* m_service;
+        bool m_done = false;
+    };
+
+    // ========== 排序方式 ==========
+    // 切换中文按拼音 / 标准排序：后台重算所有歌曲的排序键，完成后写入配置并发出 sortByPinyinApplied；
+    // 值未变化时直接返回 true（不发信号），上一次切换尚未完成时返回 false
+    bool setSortByPinyin(bool enabled);
+
     // ========== 导入并触发并行下载 ==========
     // 对导入的歌曲：本地存在 -> 直接加入歌单；本地不存在 -> 提交到并行下载队列
     bool importAndDownloadMissingSongs(const QString& playlistId, const QList<Song>& songs);
@@ -88,6 +160,19 @@ signals:
     // ========== 导出信号 ==========
     void exportCompleted(bool success, const QString& message);
 
+    // ========== 批量作用域信号 ==========
+    void batchCommitted(const LibraryService::BatchChanges& changes);
+
+    // ========== 搜索索引信号 ==========
+    void searchIndexReady();
+    // 曲库中一首歌入库 / 信息变化，或被删除（与搜索索引同步发出，供推荐候选等增量维护）
+    void songUpserted(const Song& song);
+    void songRemoved(const QString& id);
+
+    // ========== 排序方式信号 ==========
+    // 切换结束：enabled 为实际生效的方式（失败时为原来的方式）
+    void sortByPinyinApplied(bool enabled);
+
     // ========== 错误信号 ==========
     void operationFailed(const QString& operation, const QString& error);
 
@@ -100,9 +185,41 @@ private:
     SongRepository* m_songRepository;
     PlaylistRepository* m_playlistRepository;
 
+    // 只读查询执行器（独立线程 + 独立连接）
+    LibraryQueryExecutor* m_queryExecutor;
+
+    // 内存搜索索引；构建期间的增量变更先暂存，装载时补上
+    std::unique_ptr<SongSearchIndex> m_searchIndex;
+    bool m_searchIndexReady = false;
+    QHash<QString, Song> m_pendingIndexUpserts;
+    QSet<QString> m_pendingIndexRemovals;
+
+    void buildSearchIndex();
+    void indexSong(const Song& song);
+    void unindexSong(const QString& id);
+
+    // 排序键后台重算；期间变更过的歌曲完成后按新方式补算
+    bool m_sortKeyRebuilding = false;
+    QSet<QString> m_sortKeyTouched;
+    void finishSortKeyRebuild(bool enabled, bool ok, qint64 lastRowId);
+
+    // 歌单成员索引：首次使用时一次性装载，之后随歌单变更增量维护；批量回滚后重新装载
+    std::unique_ptr<PlaylistMembershipIndex> m_membership;
+    bool m_membershipLoaded = false;
+    PlaylistMembershipIndex& membership();
+
     // 用于追踪任务 -> 目标歌单
     QHash<QString, QString> m_taskToPlaylist;
 
+    // 批量作用域状态
+    int m_batchDepth = 0;
+    BatchChanges m_batch;
+    // 作用域内删除的歌曲文件：最外层提交成功后才删除，回滚时保留
+    QStringList m_batchFileRemovals;
+
+    // 批量作用域内记录错误，作用域外直接发信号
+    void reportFailure(const QString& operation, const QString& error);
+
     // 辅助方法
     bool validateSongId(const QString& id);
     bool validatePlaylistId(const QString& id);
@@ -0,0 +1,680 @@
+#include "PcmRenderer.h"
+#include <QAudioBuffer>
+#include <QAudioDevice>
+#include <QAudioFormat>
+#include <QAudioSink>
+#include <QIODevice>
+#include <QMediaDevices>
+#include <QUrl>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // 解码缓冲 → 交错立体声 float（单声道复制到两侧，多声道取前两路）
+    std::vector<float> toStereoFloat(const QAudioBuffer& buffer) {
+        const QAudioFormat fmt = buffer.format();
+        const int frames = int(buffer.frameCount());
+        const int channels = std::max(1, fmt.channelCount());
+        std::vector<float> out(size_t(frames) * 2);
+
+        auto convert = [&](auto data, auto scale) {
+            for (int f = 0; f < frames; ++f) {
+                const auto* frame = data + size_t(f) * channels;
+                out[size_t(f) * 2] = scale(frame[0]);
+                out[size_t(f) * 2 + 1] = scale(frame[channels > 1 ? 1 : 0]);
+            }
+        };
+
+        switch (fmt.sampleFormat()) {
+        case QAudioFormat::Float:
+            convert(buffer.constData<float>(), [](float v) { return v; });
+            break;
+        case QAudioFormat::Int16:
+            convert(buffer.constData<qint16>(), [](qint16 v) { return v / 32768.0f; });
+            break;
+        case QAudioFormat::Int32:
+            convert(buffer.constData<qint32>(), [](qint32 v) { return float(v / 2147483648.0); });
+            break;
+        case QAudioFormat::UInt8:
+            convert(buffer.constData<quint8>(), [](quint8 v) { return (int(v) - 128) / 128.0f; });
+            break;
+        default:
+            out.clear();
+            break;
+        }
+        return out;
+    }
+}
+
+// ========== 拉模式设备 ==========
+class PcmRenderer::PullDevice : public QIODevice {
+public:
+    explicit PullDevice(PcmRenderer* owner) : QIODevice(owner), m_owner(owner) {}
+
+    bool isSequential() const override { return true; }
+
+    qint64 bytesAvailable() const override {
+        const qint64 bytesPerSample = m_owner->m_sinkIsFloat ? 4 : 2;
+        const qint64 buffered = qint64(m_owner->m_ring.available()) * bytesPerSample;
+        // 未播完时总有数据可读（缓冲不足由回调补静音），避免输出提前进入 Idle
+        if (m_owner->m_endOfStream.load(std::memory_order_acquire)) return buffered;
+        return std::max<qint64>(buffered, 4096 * 2 * bytesPerSample);
+    }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override { return m_owner->render(data, maxSize); }
+    qint64 writeData(const char*, qint64) override { return -1; }
+
+private:
+    PcmRenderer* m_owner;
+};
+
+PcmRenderer::PcmRenderer(QObject* parent)
+    : QObject(parent)
+    , m_decoder(new QAudioDecoder(this))
+    , m_device(new PullDevice(this))
+    , m_ring(1 << 16)
+{
+    m_device->open(QIODevice::ReadOnly);
+
+    connect(m_decoder, &QAudioDecoder::bufferReady, this, &PcmRenderer::handleBufferReady);
+    connect(m_decoder, &QAudioDecoder::finished, this, &PcmRenderer::handleDecoderFinished);
+    connect(m_decoder, &QAudioDecoder::durationChanged, this, [this](qint64 ms) {
+        if (ms <= 0 || ms == m_durationMs) return;
+        m_durationMs = ms;
+        emit durationChanged(ms);
+        });
+    connect(m_decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), this, [this](QAudioDecoder::Error) {
+        qWarning() << "PcmRenderer: 解码失败:" << m_decoder->errorString();
+        emit error(QString("解码失败: %1").arg(m_decoder->errorString()));
+        });
+
+    m_feedTimer.setInterval(kFeedIntervalMs);
+    connect(&m_feedTimer, &QTimer::timeout, this, &PcmRenderer::feed);
+
+    qDebug() << "PcmRenderer initialized";
+}
+
+PcmRenderer::~PcmRenderer() {
+    stopPipeline();
+}
+
+// ========== 播放控制 ==========
+void PcmRenderer::play(const QString& filePath, qint64 startMs, bool startPaused) {
+    stopPipeline();
+    clearLoopRegion();
+    m_filePath = filePath;
+    m_durationMs = 0;
+
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    const int rate = device.preferredFormat().sampleRate();
+    openSink(rate > 0 ? rate : 48000);
+
+    m_baseMs = std::max<qint64>(0, startMs);
+    m_baseFrame = m_baseMs * m_sampleRate / 1000;
+    m_playheadFrame.store(m_baseFrame);
+
+    m_dsp.reset();
+    m_dsp.rampGainTo(m_volume, 150);
+    m_pendingAction = PendingAction::None;
+
+    startDecoder(m_baseMs * 1000);
+    m_sink->start(m_device);
+    if (startPaused) m_sink->suspend();
+    m_feedTimer.start();
+    setState(startPaused ? PlaybackState::Paused : PlaybackState::Playing);
+    qDebug() << "PcmRenderer: 播放" << filePath << "采样率" << m_sampleRate
+        << (m_sinkIsFloat ? "float" : "int16") << "起点" << m_baseMs << "ms";
+}
+
+void PcmRenderer::pause(int fadeMs) {
+    if (m_state != PlaybackState::Playing || !m_sink) return;
+    if (m_sink->state() == QAudio::IdleState || fadeMs <= 0) {
+        m_sink->suspend();
+        setState(PlaybackState::Paused);
+        return;
+    }
+    m_pendingAction = PendingAction::Pause;
+    m_pendingActionSeq = m_dsp.rampGainTo(0.0f, fadeMs);
+}
+
+void PcmRenderer::resume(int fadeMs) {
+    if (!m_sink) return;
+    if (m_state == PlaybackState::Playing) {
+        // 暂停的淡出还没走完：取消暂停，原地淡回
+        if (m_pendingAction == PendingAction::Pause) {
+            m_pendingAction = PendingAction::None;
+            m_dsp.rampGainTo(m_volume, fadeMs);
+        }
+        return;
+    }
+    if (m_state != PlaybackState::Paused) return;
+    m_dsp.rampGainTo(m_volume, fadeMs);
+    m_sink->resume();
+    setState(PlaybackState::Playing);
+}
+
+void PcmRenderer::stop(int fadeMs) {
+    if (m_state == PlaybackState::Stopped) return;
+    if (m_state == PlaybackState::Paused || fadeMs <= 0 || !m_sink || m_sink->state() == QAudio::IdleState) {
+        stopPipeline();
+        setState(PlaybackState::Stopped);
+        return;
+    }
+    m_pendingAction = PendingAction::Stop;
+    m_pendingActionSeq = m_dsp.rampGainTo(0.0f, fadeMs);
+}
+
+void PcmRenderer::setVolume(float volume, int rampMs) {
+    m_volume = std::clamp(volume, 0.0f, 1.0f);
+    if (m_state == PlaybackState::Playing && m_pendingAction == PendingAction::None) {
+        m_dsp.rampGainTo(m_volume, rampMs);
+    }
+}
+
+void PcmRenderer::setPosition(qint64 positionMs) {
+    if (m_filePath.isEmpty() || !m_sink || m_state == PlaybackState::Stopped) return;
+    if (m_durationMs > 0) positionMs = std::clamp<qint64>(positionMs, 0, m_durationMs);
+
+    // 输出停下后才能清空缓冲与 DSP 状态
+    const bool paused = m_state == PlaybackState::Paused;
+    m_sink->stop();
+    m_decoder->stop();
+    m_ring.clear();
+    m_pending.clear();
+    m_pendingOffset = 0;
+    m_pendingSamples = 0;
+    m_endOfStream.store(false);
+
+    m_dsp.reset();
+    if (m_pendingAction == PendingAction::None) m_dsp.rampGainTo(m_volume, 30);
+    else m_pendingActionSeq = m_dsp.rampGainTo(0.0f, 30);
+    m_baseMs = positionMs;
+    m_baseFrame = positionMs * m_sampleRate / 1000;
+    m_renderedFrames.store(0);
+    m_playheadFrame.store(m_baseFrame);
+    // 循环段保留：目标在 B 之前则播到 B 再回绕，在 B 之后则直接回到 A
+    m_activeLoop = m_loopHolder.get();
+    m_loopInUse.store(m_activeLoop);
+    m_loopEngaged = false;
+    m_loopExiting = false;
+    m_loopOffset = 0;
+
+    startDecoder(positionMs * 1000);
+    m_sink->start(m_device);
+    if (paused) m_sink->suspend();
+    emit positionChanged(positionMs);
+}
+
+qint64 PcmRenderer::position() const {
+    if (!m_sink || m_state == PlaybackState::Stopped) return m_baseMs;
+    const int bytesPerFrame = m_sinkIsFloat ? 8 : 4;
+    // 已交给输出但还在设备缓冲里的不算已播放
+    const qint64 queuedFrames = (m_sink->bufferSize() - m_sink->bytesFree()) / bytesPerFrame;
+    const qint64 playhead = m_playheadFrame.load(std::memory_order_relaxed);
+    qint64 frame = playhead - queuedFrames;
+    // 刚回绕到 A：设备缓冲里还是 B 之前的数据
+    if (m_loopHolder && playhead >= m_loopHolder->startFrame && playhead < m_loopHolder->endFrame
+        && frame < m_loopHolder->startFrame) {
+        frame += m_loopHolder->frameCount();
+    }
+    return std::max<qint64>(0, frame) * 1000 / m_sampleRate;
+}
+
+// ========== A-B 循环 ==========
+bool PcmRenderer::setLoopRegion(qint64 startMs, qint64 endMs) {
+    if (m_filePath.isEmpty() || startMs < 0 || endMs <= startMs || endMs - startMs > kMaxLoopMs) return false;
+    if (startMs == m_loopStartMs && endMs == m_loopEndMs) return true;
+    m_loopStartMs = startMs;
+    m_loopEndMs = endMs;
+    // 旧段作废：新段就绪前由上层按位置回跳兜底
+    publishLoopRegion(nullptr);
+    buildLoopRegion();
+    return true;
+}
+
+void PcmRenderer::clearLoopRegion() {
+    m_loopStartMs = -1;
+    m_loopEndMs = -1;
+    m_loopBuilding.reset();
+    if (m_loopDecoder) m_loopDecoder->stop();
+    if (m_loopHolder) qDebug() << "🔁 PcmRenderer: A-B 循环撤销";
+    publishLoopRegion(nullptr);
+}
+
+void PcmRenderer::buildLoopRegion() {
+    auto region = std::make_shared<LoopRegion>();
+    region->startFrame = m_loopStartMs * m_sampleRate / 1000;
+    region->endFrame = m_loopEndMs * m_sampleRate / 1000;
+    const qint64 tailFrames = qint64(kLoopCrossfadeMs) * m_sampleRate / 1000;
+    region->samples.reserve(size_t(region->frameCount() + tailFrames) * 2);
+    m_loopBuilding = std::move(region);
+    m_loopBuildRate = m_sampleRate;
+    beginLoopCapture();
+}
+
+// 播放解码器还没解到 A：直接从它的输出里截取，不另外解码；
+// 已经过了 A 才另起解码器（QAudioDecoder 不能跳转，只能从头解到 A）
+void PcmRenderer::beginLoopCapture() {
+    m_loopBuilding->samples.clear();
+    m_loopDecodedFrames = 0;
+    if (m_loopDecoder) m_loopDecoder->stop();
+
+    m_loopCaptureLive = !m_decodeFinished && m_liveNextFrame <= m_loopBuilding->startFrame;
+    if (m_loopCaptureLive) {
+        qDebug() << "🔁 PcmRenderer: 从播放解码流截取 A-B 循环段";
+        return;
+    }
+
+    if (!m_loopDecoder) {
+        m_loopDecoder = new QAudioDecoder(this);
+        connect(m_loopDecoder, &QAudioDecoder::bufferReady, this, &PcmRenderer::handleLoopBufferReady);
+        connect(m_loopDecoder, &QAudioDecoder::finished, this, [this]() {
+            if (m_loopBuilding && !m_loopCaptureLive) finishLoopRegion();   // B 超出曲目结尾：用已解码的部分
+            });
+        connect(m_loopDecoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), this, [this](QAudioDecoder::Error) {
+            if (m_loopCaptureLive) return;
+            qWarning() << "PcmRenderer: 循环段解码失败:" << m_loopDecoder->errorString();
+            m_loopBuilding.reset();
+            });
+    }
+
+    QAudioFormat format;
+    format.setSampleRate(m_loopBuildRate);
+    format.setChannelCount(2);
+    format.setSampleFormat(QAudioFormat::Float);
+    m_loopDecoder->setAudioFormat(format);
+    m_loopDecoder->setSource(QUrl::fromLocalFile(m_filePath));
+    m_loopDecoder->start();
+}
+
+void PcmRenderer::handleLoopBufferReady() {
+    const QAudioBuffer buffer = m_loopDecoder->read();
+    if (!buffer.isValid() || !m_loopBuilding || m_loopCaptureLive) return;
+    if (buffer.format().sampleRate() != m_loopBuildRate) {
+        qWarning() << "PcmRenderer: 循环段解码采样率不符，放弃";
+        m_loopBuilding.reset();
+        m_loopDecoder->stop();
+        return;
+    }
+
+    // 按解码出的帧数计位置（不用 startTime 换算），保证与 A 对齐到采样
+    const std::vector<float> samples = toStereoFloat(buffer);
+    const qint64 first = m_loopDecodedFrames;
+    m_loopDecodedFrames += qint64(samples.size() / 2);
+    appendLoopSamples(samples.data(), first, qint64(samples.size() / 2));
+}
+
+// samples 为从曲目第 first 帧开始的 count 帧；截下落在 [A, B + 交叉淡化) 内的部分，够了即完成
+void PcmRenderer::appendLoopSamples(const float* samples, qint64 first, qint64 count) {
+    LoopRegion& region = *m_loopBuilding;
+    const qint64 wantEnd = region.endFrame + qint64(kLoopCrossfadeMs) * m_loopBuildRate / 1000;
+    const qint64 from = std::max(first, region.startFrame);
+    const qint64 to = std::min(first + count, wantEnd);
+    if (to > from) {
+        region.samples.insert(region.samples.end(),
+            samples + (from - first) * 2, samples + (to - first) * 2);
+    }
+    if (first + count >= wantEnd) finishLoopRegion();
+}
+
+void PcmRenderer::finishLoopRegion() {
+    std::shared_ptr<LoopRegion> region = std::move(m_loopBuilding);
+    if (m_loopDecoder) m_loopDecoder->stop();
+
+    const qint64 decoded = qint64(region->samples.size() / 2);
+    if (decoded < region->frameCount()) region->endFrame = region->startFrame + decoded;
+    const int loopFrames = region->frameCount();
+    if (loopFrames <= 0) {
+        qWarning() << "PcmRenderer: 循环段为空（A 超出曲目结尾）";
+        return;
+    }
+
+    // 开头 n 帧与 B 之后的 n 帧等功率交叉淡化：从 B 回绕到 A 时波形连续，无咔哒声
+    float* s = region->samples.data();
+    const int n = int(std::min<qint64>(decoded - loopFrames, loopFrames / 2));
+    for (int i = 0; i < n; ++i) {
+        const float t = (i + 0.5f) / n;
+        const float gainIn = std::sin(t * 1.5707963f);
+        const float gainOut = std::cos(t * 1.5707963f);
+        for (int c = 0; c < 2; ++c) {
+            float& head = s[size_t(i) * 2 + c];
+            head = head * gainIn + s[(size_t(loopFrames) + i) * 2 + c] * gainOut;
+        }
+    }
+    region->samples.resize(size_t(loopFrames) * 2);
+    region->samples.shrink_to_fit();
+
+    qDebug() << "🔁 PcmRenderer: A-B 循环已载入内存" << m_loopStartMs << "-" << m_loopEndMs << "ms,"
+        << loopFrames << "帧," << (region->samples.size() * sizeof(float)) / 1024 << "KB";
+    publishLoopRegion(std::move(region));
+}
+
+void PcmRenderer::publishLoopRegion(std::shared_ptr<const LoopRegion> region) {
+    const bool wasActive = m_loopHolder != nullptr;
+    if (m_loopHolder) m_retiredLoops.push_back(std::move(m_loopHolder));
+    m_pendingLoop.store(region.get());
+    m_loopHolder = std::move(region);
+    if (wasActive || m_loopHolder) emit loopRegionChanged(m_loopHolder != nullptr);
+}
+
+// ========== 内部 ==========
+void PcmRenderer::openSink(int sampleRate) {
+    if (m_sink) {
+        m_sink->stop();
+        delete m_sink;
+        m_sink = nullptr;
+    }
+
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    QAudioFormat format;
+    format.setSampleRate(sampleRate);
+    format.setChannelCount(2);
+    format.setSampleFormat(QAudioFormat::Float);
+    m_sinkIsFloat = device.isFormatSupported(format);
+    if (!m_sinkIsFloat) format.setSampleFormat(QAudioFormat::Int16);
+
+    m_sampleRate = sampleRate;
+    m_baseFrame = m_baseMs * sampleRate / 1000;
+    m_playheadFrame.store(m_baseFrame);
+    m_dsp.setSampleRate(sampleRate);
+    m_scratch.assign(size_t(sampleRate) * 2, 0.0f);
+
+    m_sink = new QAudioSink(device, format, this);
+    connect(m_sink, &QAudioSink::stateChanged, this, &PcmRenderer::handleSinkStateChanged);
+}
+
+void PcmRenderer::startDecoder(qint64 skipToUs) {
+    QAudioFormat format;
+    format.setSampleRate(m_sampleRate);
+    format.setChannelCount(2);
+    format.setSampleFormat(QAudioFormat::Float);
+
+    m_decodeSkipUs = skipToUs;
+    m_decodeThrottled = false;
+    m_decodeFinished = false;
+    m_liveNextFrame = skipToUs * m_sampleRate / 1000000;
+    m_decoder->setAudioFormat(format);
+    if (m_decoder->source() != QUrl::fromLocalFile(m_filePath)) {
+        m_decoder->setSource(QUrl::fromLocalFile(m_filePath));
+    }
+    m_decoder->start();
+    // 跳转后播放解码流的起点变了：循环段还没建好的话重新决定从哪里截取
+    if (m_loopBuilding) beginLoopCapture();
+}
+
+void PcmRenderer::stopPipeline() {
+    m_feedTimer.stop();
+    if (m_sink) m_sink->stop();
+    m_decoder->stop();
+    m_ring.clear();
+    m_pending.clear();
+    m_pendingOffset = 0;
+    m_pendingSamples = 0;
+    m_decodeThrottled = false;
+    m_decodeFinished = false;
+    m_endOfStream.store(false);
+    m_renderedFrames.store(0);
+    m_pendingAction = PendingAction::None;
+    m_activeLoop = nullptr;
+    m_loopInUse.store(nullptr);
+    m_loopEngaged = false;
+    m_loopExiting = false;
+    m_loopOffset = 0;
+}
+
+void PcmRenderer::setState(PlaybackState state) {
+    if (m_state == state) return;
+    m_state = state;
+    emit stateChanged(state);
+}
+
+qint64 PcmRenderer::pendingMs() const {
+    return m_pendingSamples / 2 * 1000 / m_sampleRate;
+}
+
+void PcmRenderer::handleBufferReady() {
+    // 不取缓冲解码器就不会往下解（取走一个才解下一个），由 feed 在队列消耗后接着取
+    if (m_decodeThrottled) return;
+    const QAudioBuffer buffer = m_decoder->read();
+    if (!buffer.isValid()) return;
+
+    const qint64 startUs = buffer.startTime();
+    if (m_decodeSkipUs > 0 && startUs + buffer.duration() <= m_decodeSkipUs) return;
+
+    const int bufferRate = buffer.format().sampleRate();
+    if (bufferRate != m_sampleRate) {
+        // 解码器没按要求重采样：还没出声时改用解码器的采样率重新打开输出
+        if (m_renderedFrames.load() == 0 && m_ring.available() == 0 && m_pending.empty()) {
+            qDebug() << "PcmRenderer: 解码采样率" << bufferRate << "与输出不一致，重新打开输出";
+            const bool paused = m_state == PlaybackState::Paused;
+            openSink(bufferRate);
+            m_liveNextFrame = m_baseFrame;
+            // 循环段按旧采样率解码，作废重建
+            if (m_loopStartMs >= 0) {
+                m_activeLoop = nullptr;
+                m_loopInUse.store(nullptr);
+                publishLoopRegion(nullptr);
+                buildLoopRegion();
+            }
+            m_dsp.reset();
+            m_dsp.rampGainTo(m_volume, 150);
+            m_sink->start(m_device);
+            if (paused) m_sink->suspend();
+        }
+        else {
+            qWarning() << "PcmRenderer: 播放中解码采样率变化，忽略该缓冲";
+            return;
+        }
+    }
+
+    std::vector<float> samples = toStereoFloat(buffer);
+    if (samples.empty()) {
+        emit error("不支持的解码采样格式");
+        return;
+    }
+    if (m_decodeSkipUs > 0) {
+        if (startUs < m_decodeSkipUs) {
+            const qint64 dropFrames = (m_decodeSkipUs - startUs) * m_sampleRate / 1000000;
+            const size_t drop = std::min(samples.size(), size_t(dropFrames) * 2);
+            samples.erase(samples.begin(), samples.begin() + drop);
+        }
+        m_decodeSkipUs = 0;
+    }
+    if (samples.empty()) return;
+
+    const qint64 frames = qint64(samples.size() / 2);
+    if (m_loopBuilding && m_loopCaptureLive) appendLoopSamples(samples.data(), m_liveNextFrame, frames);
+    m_liveNextFrame += frames;
+
+    m_pendingSamples += qint64(samples.size());
+    m_pending.push_back(std::move(samples));
+
+    // 解码远快于播放：攒够后暂不取下一个缓冲，解码器停在原处等待，不用重解
+    if (pendingMs() > kMaxPendingMs) m_decodeThrottled = true;
+}
+
+void PcmRenderer::handleDecoderFinished() {
+    m_decodeFinished = true;
+}
+
+void PcmRenderer::feed() {
+    // 待写队列 → 环形缓冲
+    while (!m_pending.empty()) {
+        std::vector<float>& front = m_pending.front();
+        const int remain = int(front.size() - m_pendingOffset);
+        const int written = m_ring.write(front.data() + m_pendingOffset, remain);
+        m_pendingOffset += size_t(written);
+        m_pendingSamples -= written;
+        if (m_pendingOffset >= front.size()) {
+            m_pending.pop_front();
+            m_pendingOffset = 0;
+        }
+        if (written < remain) break;
+    }
+
+    if (m_decodeThrottled && pendingMs() < kResumePendingMs) {
+        // 接着取积压的那个缓冲，之后的由 bufferReady 继续
+        m_decodeThrottled = false;
+        if (m_decoder->bufferAvailable()) handleBufferReady();
+    }
+    if (m_decodeFinished && !m_decoder->bufferAvailable()) {
+        // B 超出曲目结尾：用已截取的部分
+        if (m_loopBuilding && m_loopCaptureLive) finishLoopRegion();
+        if (m_pending.empty()) m_endOfStream.store(true, std::memory_order_release);
+    }
+
+    // 回调没在读的旧循环段在这里释放（回调登记后会复查，不会再取到已淘汰的段）
+    if (!m_retiredLoops.empty()) {
+        const LoopRegion* inUse = m_loopInUse.load();
+        std::erase_if(m_retiredLoops, [inUse](const auto& region) { return region.get() != inUse; });
+    }
+
+    if (m_state == PlaybackState::Playing && ++m_feedTicks % 5 == 0) {
+        emit positionChanged(position());
+    }
+    // 每约 30 秒报告一次 DSP 实测开销
+    if (m_feedTicks % (30000 / kFeedIntervalMs) == 0 && m_feedTicks > 0) {
+        const double us = m_dsp.cpuMicrosPerSecond();
+        qDebug() << "🎛 PcmRenderer: DSP 每秒音频耗时" << QString::number(us, 'f', 1) << "µs"
+            << QString("(%1%)").arg(us / 10000.0, 0, 'f', 3);
+    }
+}
+
+void PcmRenderer::handleSinkStateChanged(QAudio::State state) {
+    if (state == QAudio::IdleState && m_endOfStream.load() && m_ring.available() == 0
+        && m_state == PlaybackState::Playing) {
+        qDebug() << "PcmRenderer: 播放完成";
+        stopPipeline();
+        setState(PlaybackState::Stopped);
+        emit finished();
+        return;
+    }
+    if (state == QAudio::StoppedState && m_sink && m_sink->error() != QAudio::NoError) {
+        qWarning() << "PcmRenderer: 音频输出错误:" << int(m_sink->error());
+        emit error("音频输出设备错误");
+    }
+}
+
+void PcmRenderer::handleRampCompleted(quint32 seq) {
+    if (m_pendingAction == PendingAction::None || seq != m_pendingActionSeq) return;
+    const PendingAction action = m_pendingAction;
+    m_pendingAction = PendingAction::None;
+
+    if (action == PendingAction::Pause) {
+        if (m_sink) m_sink->suspend();
+        setState(PlaybackState::Paused);
+    }
+    else {
+        stopPipeline();
+        setState(PlaybackState::Stopped);
+    }
+}
+
+// ========== 音频回调 ==========
+qint64 PcmRenderer::render(char* data, qint64 maxBytes) {
+    const int bytesPerFrame = m_sinkIsFloat ? 8 : 4;
+    int frames = int(std::min<qint64>(maxBytes / bytesPerFrame, qint64(m_scratch.size() / 2)));
+    if (frames <= 0) return 0;
+
+    const int got = pull(m_scratch.data(), frames);
+    if (got < frames) {
+        if (m_endOfStream.load(std::memory_order_acquire)) {
+            frames = got;   // 播完：只交出剩余数据，让输出进入 Idle
+        }
+        else {
+            // 欠载：补静音，保持输出运行
+            std::fill(m_scratch.begin() + size_t(got) * 2, m_scratch.begin() + size_t(frames) * 2, 0.0f);
+        }
+    }
+    if (frames == 0) return 0;
+
+    m_dsp.process(m_scratch.data(), frames);
+
+    const quint32 done = m_dsp.completedRampSeq();
+    if (done != m_notifiedRampSeq.load(std::memory_order_relaxed)) {
+        m_notifiedRampSeq.store(done, std::memory_order_relaxed);
+        QMetaObject::invokeMethod(this, [this, done]() { handleRampCompleted(done); }, Qt::QueuedConnection);
+    }
+
+    if (m_sinkIsFloat) {
+        std::memcpy(data, m_scratch.data(), size_t(frames) * bytesPerFrame);
+    }
+    else {
+        qint16* out = reinterpret_cast<qint16*>(data);
+        for (int i = 0; i < frames * 2; ++i) {
+            out[i] = qint16(std::clamp(m_scratch[size_t(i)], -1.0f, 1.0f) * 32767.0f);
+        }
+    }
+    return qint64(frames) * bytesPerFrame;
+}
+
+int PcmRenderer::pull(float* out, int frames) {
+    syncLoopRegion();
+
+    int done = 0;
+    while (done < frames) {
+        if (m_loopEngaged) {
+            // 循环中：只读内存里的循环段，到尾部回绕
+            const LoopRegion& loop = *m_activeLoop;
+            const int n = std::min(frames - done, loop.frameCount() - m_loopOffset);
+            std::memcpy(out + size_t(done) * 2, loop.samples.data() + size_t(m_loopOffset) * 2,
+                size_t(n) * 2 * sizeof(float));
+            done += n;
+            m_loopOffset += n;
+            if (m_loopOffset >= loop.frameCount()) {
+                m_loopOffset = 0;
+                if (m_loopExiting) {
+                    // 循环已撤销或更换：走完这一遍，从 B 接回环形缓冲
+                    m_loopEngaged = false;
+                    m_loopExiting = false;
+                    adoptPendingLoop();
+                }
+            }
+            continue;
+        }
+
+        int want = frames - done;
+        if (m_activeLoop) {
+            const qint64 ringFrame = m_baseFrame + m_renderedFrames.load(std::memory_order_relaxed);
+            if (ringFrame >= m_activeLoop->endFrame) {
+                m_loopEngaged = true;
+                m_loopOffset = 0;
+                continue;
+            }
+            // 只读到 B 为止
+            want = int(std::min<qint64>(want, m_activeLoop->endFrame - ringFrame));
+        }
+        const int got = m_ring.read(out + size_t(done) * 2, want * 2) / 2;
+        m_renderedFrames.fetch_add(got, std::memory_order_relaxed);
+        done += got;
+        if (got < want) break;
+    }
+
+    m_playheadFrame.store(m_loopEngaged
+        ? m_activeLoop->startFrame + m_loopOffset
+        : m_baseFrame + m_renderedFrames.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return done;
+}
+
+void PcmRenderer::syncLoopRegion() {
+    if (m_loopExiting) return;
+    if (m_pendingLoop.load() == m_activeLoop) return;
+    if (m_loopEngaged) m_loopExiting = true;    // 正在循环：先走完当前这一遍
+    else adoptPendingLoop();
+}
+
+void PcmRenderer::adoptPendingLoop() {
+    // 先登记再复查：复查仍是同一段说明登记时它还没被淘汰，引擎线程之后也不会释放它
+    const LoopRegion* region = m_pendingLoop.load();
+    for (;;) {
+        m_loopInUse.store(region);
+        const LoopRegion* again = m_pendingLoop.load();
+        if (again == region) break;
+        region = again;
+    }
+    m_activeLoop = region;
+}
\ No newline at end of file
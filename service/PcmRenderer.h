@@ -0,0 +1,164 @@
+#pragma once
+#include <QObject>
+#include <QAudioDecoder>
+#include <QAudio>
+#include <QTimer>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "DspChain.h"
+#include "PcmRingBuffer.h"
+#include "../common/PlaybackState.h"
+
+class QAudioSink;
+
+/**
+ * @brief 自有 PCM 渲染管线（可选，替代 QMediaPlayer 输出）
+ *
+ *   QAudioDecoder（引擎线程，解码为 float 立体声）
+ *     → 待写队列（超过 kMaxPendingMs 时暂不取解码缓冲，解码器随之停在原处；消耗到 kResumePendingMs 以下再接着取）
+ *     → PcmRingBuffer（无锁，约 0.7 秒）
+ *     → 音频回调：DspChain（均衡 / 增益斜坡 / 前瞻限幅）→ QAudioSink（拉模式）
+ *
+ * 淡入淡出都是回调里的逐采样增益斜坡，不再用定时器轮询音量；
+ * 斜坡走完后再在引擎线程执行真正的暂停/停止。
+ * QAudioDecoder 不支持跳转：setPosition 会重新解码并丢弃目标位置之前的数据。
+ *
+ * A-B 循环：把 [A, B) 整段截进内存（末尾多截 kLoopCrossfadeMs 与开头做交叉淡化）。播放解码器还没解到 A 时
+ * 直接从它的输出里截取；已经过了 A 才另起一个解码器从头解（跳转回 A 后又改为从播放解码流截取）。
+ * 回调读到 B 对应的采样时直接改读这段内存并循环，回绕在采样边界上完成，不跳转、不读盘。
+ * 循环期间环形缓冲原地不动，撤销循环后走完当前这一遍即从 B 之后无缝接回。
+ * 循环段经原子裸指针交给回调，回调把正在读的段登记在 m_loopInUse，引擎线程据此释放旧段。
+ * 循环段生效/撤销时发出 loopRegionChanged，生效之前由上层按位置回跳兜底。
+ */
+class PcmRenderer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PcmRenderer(QObject* parent = nullptr);
+    ~PcmRenderer() override;
+
+    void play(const QString& filePath, qint64 startMs = 0, bool startPaused = false);
+    void pause(int fadeMs);
+    void resume(int fadeMs);
+    void stop(int fadeMs);
+
+    void setPosition(qint64 positionMs);
+    qint64 position() const;
+    qint64 duration() const { return m_durationMs; }
+
+    void setVolume(float volume, int rampMs);   // 0.0-1.0
+
+    // A-B 循环（毫秒）；区间无效或超过 kMaxLoopMs 时返回 false。换曲时自动撤销
+    bool setLoopRegion(qint64 startMs, qint64 endMs);
+    void clearLoopRegion();
+    static constexpr qint64 kMaxLoopMs = 120000;
+    PlaybackState state() const { return m_state; }
+
+    DspChain& dsp() { return m_dsp; }
+
+signals:
+    void stateChanged(PlaybackState state);
+    void positionChanged(qint64 position);
+    void durationChanged(qint64 duration);
+    void finished();
+    void error(const QString& errorMessage);
+    void loopRegionChanged(bool active);   // 循环段已生效（true）或已撤销（false）
+
+private:
+    class PullDevice;
+
+    enum class PendingAction { None, Pause, Stop };
+
+    // 已解码进内存的循环段：samples 覆盖 [startFrame, endFrame)，开头已与 B 之后的数据交叉淡化
+    struct LoopRegion {
+        qint64 startFrame = 0;
+        qint64 endFrame = 0;
+        std::vector<float> samples;
+        int frameCount() const { return int(endFrame - startFrame); }
+    };
+
+    static constexpr qint64 kMaxPendingMs = 30000;
+    static constexpr qint64 kResumePendingMs = 10000;
+    static constexpr int kFeedIntervalMs = 20;
+    static constexpr int kLoopCrossfadeMs = 5;
+
+    void openSink(int sampleRate);
+    void startDecoder(qint64 skipToUs);
+    void stopPipeline();
+    void setState(PlaybackState state);
+    qint64 pendingMs() const;
+
+    void handleBufferReady();
+    void handleDecoderFinished();
+    void handleSinkStateChanged(QAudio::State state);
+    void handleRampCompleted(quint32 seq);
+    void feed();
+
+    // A-B 循环段的解码（引擎线程）
+    void buildLoopRegion();
+    void beginLoopCapture();
+    void handleLoopBufferReady();
+    void appendLoopSamples(const float* samples, qint64 first, qint64 count);
+    void finishLoopRegion();
+    void publishLoopRegion(std::shared_ptr<const LoopRegion> region);
+
+    // 音频回调（可能在音频线程）
+    qint64 render(char* data, qint64 maxBytes);
+    int pull(float* out, int frames);   // 从环形缓冲或循环段取数据，返回实际帧数
+    void syncLoopRegion();
+    void adoptPendingLoop();
+
+    QAudioDecoder* m_decoder;
+    QAudioSink* m_sink = nullptr;
+    PullDevice* m_device;
+    QTimer m_feedTimer;
+    int m_sampleRate = 48000;
+    bool m_sinkIsFloat = true;
+
+    DspChain m_dsp;
+    PcmRingBuffer m_ring;
+    std::vector<float> m_scratch;       // 回调用，打开输出时按 1 秒分配
+
+    // ===== 解码侧（引擎线程） =====
+    QString m_filePath;
+    std::deque<std::vector<float>> m_pending;
+    size_t m_pendingOffset = 0;
+    qint64 m_pendingSamples = 0;
+    qint64 m_decodeSkipUs = 0;          // 丢弃此时间点之前的解码数据（跳转）
+    bool m_decodeThrottled = false;     // 待写队列已满，暂不从解码器取缓冲
+    bool m_decodeFinished = false;
+    qint64 m_liveNextFrame = 0;         // 播放解码流下一帧对应的曲目帧号
+    std::atomic<bool> m_endOfStream{ false };   // 解码完且待写队列已清空
+
+    // ===== 位置与状态 =====
+    qint64 m_baseMs = 0;
+    qint64 m_baseFrame = 0;                     // m_baseMs 对应的帧号，环形缓冲第一帧
+    std::atomic<qint64> m_renderedFrames{ 0 };  // 从环形缓冲取出的帧数
+    std::atomic<qint64> m_playheadFrame{ 0 };   // 下一帧交给输出的曲目帧号（循环中会回绕）
+    qint64 m_durationMs = 0;
+    float m_volume = 1.0f;
+    PlaybackState m_state = PlaybackState::Stopped;
+    PendingAction m_pendingAction = PendingAction::None;
+    quint32 m_pendingActionSeq = 0;
+    std::atomic<quint32> m_notifiedRampSeq{ 0 };
+    int m_feedTicks = 0;
+
+    // ===== A-B 循环 =====
+    QAudioDecoder* m_loopDecoder = nullptr;
+    qint64 m_loopStartMs = -1;
+    qint64 m_loopEndMs = -1;
+    std::shared_ptr<LoopRegion> m_loopBuilding;           // 正在截取的循环段
+    bool m_loopCaptureLive = false;                       // 从播放解码流截取（否则由 m_loopDecoder 从头解）
+    qint64 m_loopDecodedFrames = 0;
+    int m_loopBuildRate = 0;
+    std::shared_ptr<const LoopRegion> m_loopHolder;       // 引擎线程持有的当前循环段
+    std::vector<std::shared_ptr<const LoopRegion>> m_retiredLoops;  // 等回调放手后再释放，避免在音频线程里释放内存
+    std::atomic<const LoopRegion*> m_pendingLoop{ nullptr };
+    std::atomic<const LoopRegion*> m_loopInUse{ nullptr };         // 回调正在读的循环段
+    const LoopRegion* m_activeLoop = nullptr;             // 以下仅回调使用（输出停止时引擎线程可重置）
+    bool m_loopEngaged = false;
+    bool m_loopExiting = false;
+    int m_loopOffset = 0;
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <QtGlobal>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief 单生产者 / 单消费者无锁环形缓冲（float 采样）
+ *
+ * 解码侧（引擎线程）写入，音频回调读取；读写位置各自单调递增，只由一方修改。
+ * clear() 要求两侧都已停止。
+ */
+class PcmRingBuffer {
+public:
+    explicit PcmRingBuffer(int minCapacity = 1 << 16) {
+        int capacity = 1;
+        while (capacity < minCapacity) capacity <<= 1;
+        m_data.assign(size_t(capacity), 0.0f);
+        m_mask = quint64(capacity - 1);
+    }
+
+    int capacity() const { return int(m_data.size()); }
+
+    int available() const {
+        return int(m_writePos.load(std::memory_order_acquire) - m_readPos.load(std::memory_order_acquire));
+    }
+
+    int freeSpace() const { return capacity() - available(); }
+
+    // 生产者：返回实际写入的采样数
+    int write(const float* samples, int count) {
+        const quint64 w = m_writePos.load(std::memory_order_relaxed);
+        const quint64 r = m_readPos.load(std::memory_order_acquire);
+        const int n = std::min(count, capacity() - int(w - r));
+        copyIn(w, samples, n);
+        m_writePos.store(w + quint64(n), std::memory_order_release);
+        return n;
+    }
+
+    // 消费者：返回实际读出的采样数
+    int read(float* out, int count) {
+        const quint64 r = m_readPos.load(std::memory_order_relaxed);
+        const quint64 w = m_writePos.load(std::memory_order_acquire);
+        const int n = std::min(count, int(w - r));
+        copyOut(r, out, n);
+        m_readPos.store(r + quint64(n), std::memory_order_release);
+        return n;
+    }
+
+    void clear() {
+        m_readPos.store(m_writePos.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    void copyIn(quint64 pos, const float* src, int n) {
+        const int start = int(pos & m_mask);
+        const int first = std::min(n, capacity() - start);
+        std::memcpy(m_data.data() + start, src, size_t(first) * sizeof(float));
+        std::memcpy(m_data.data(), src + first, size_t(n - first) * sizeof(float));
+    }
+
+    void copyOut(quint64 pos, float* dst, int n) const {
+        const int start = int(pos & m_mask);
+        const int first = std::min(n, capacity() - start);
+        std::memcpy(dst, m_data.data() + start, size_t(first) * sizeof(float));
+        std::memcpy(dst + first, m_data.data(), size_t(n - first) * sizeof(float));
+    }
+
+    std::vector<float> m_data;
+    quint64 m_mask = 0;
+    std::atomic<quint64> m_writePos{ 0 };
+    std::atomic<quint64> m_readPos{ 0 };
+};
@@ -17,15 +17,14 @@ void PlaybackHistory::addRecord(const Song& song) {
         return;
     }
 
-    // 完成当前记录（如果有）
-    if (m_currentRecord) {
-        m_currentRecord->completed = false; // 新歌曲开始，之前的未完成
-    }
+    // 上一条还没收尾（中途换歌）：按未完成结束；已完整播放的保持不变
+    closeCurrentRecord(-1);
 
     // 创建新记录
     PlaybackRecord newRecord(song, QDateTime::currentDateTime());
     m_records.append(newRecord);
     m_currentRecord = &m_records.last();
+    m_currentOpen = true;
 
     // 限制历史记录大小
     limitHistorySize();
@@ -47,12 +46,28 @@ void PlaybackHistory::updateCurrentRecord(qint64 duration, bool completed) {
     if (completed) {
         qDebug() << "PlaybackHistory: 歌曲播放完成:" << m_currentRecord->song.getTitle()
             << "时长:" << duration << "ms";
+        if (m_currentOpen) {
+            m_currentOpen = false;
+            emit recordFinished(*m_currentRecord);
+        }
     }
 }
 
+void PlaybackHistory::closeCurrentRecord(qint64 playedMs) {
+    if (!m_currentRecord || !m_currentOpen) {
+        return;
+    }
+
+    if (playedMs >= 0) m_currentRecord->playDuration = playedMs;
+    m_currentRecord->completed = false;
+    m_currentOpen = false;
+    emit recordFinished(*m_currentRecord);
+}
+
 void PlaybackHistory::clearHistory() {
     m_records.clear();
     m_currentRecord = nullptr;
+    m_currentOpen = false;
     emit historyChanged();
     qDebug() << "PlaybackHistory: 清空播放历史";
 }
@@ -124,14 +139,14 @@ QList<Song> PlaybackHistory::getFrequentlyPlayedSongs(int count) const {
         songMap[id] = record.song;
     }
 
-    // 转换为向量并排序
+    // 只需前 count 名：部分排序
     std::vector<std::pair<QString, int>> sortedSongs(playCount.begin(), playCount.end());
-    std::sort(sortedSongs.begin(), sortedSongs.end(),
+    int resultCount = qMax(0, qMin(count, static_cast<int>(sortedSongs.size())));
+    std::partial_sort(sortedSongs.begin(), sortedSongs.begin() + resultCount, sortedSongs.end(),
         [](const auto& a, const auto& b) { return a.second > b.second; });
 
     // 转换为 QList<Song>
     QList<Song> result;
-    int resultCount = qMin(count, static_cast<int>(sortedSongs.size()));
     for (int i = 0; i < resultCount; ++i) {
         result.append(songMap[sortedSongs[i].first]);
     }
@@ -26,6 +26,7 @@ public:
     // 历史记录管理
     void addRecord(const Song& song);
     void updateCurrentRecord(qint64 duration, bool completed);
+    void closeCurrentRecord(qint64 playedMs);   // 中途换歌：按未完成收尾，playedMs 为已播放时长
     void clearHistory();
 
     // 查询功能
@@ -41,6 +42,7 @@ public:
 
 signals:
     void recordAdded(const PlaybackRecord& record);
+    void recordFinished(const PlaybackRecord& record);  // 每条记录收尾时发一次（完整播放或中途换歌）
     void historyChanged();
 
 private:
@@ -49,4 +51,5 @@ private:
 
     QList<PlaybackRecord> m_records;
     PlaybackRecord* m_currentRecord;
+    bool m_currentOpen = false;     // 当前记录尚未收尾
 };
@@ -1,6 +1,8 @@
 // service/PlaybackQueue.cpp
 #include "PlaybackQueue.h"
+#include "SongStore.h"
 #include <QDebug>
+#include <algorithm>
 
 PlaybackQueue::PlaybackQueue(QObject* parent)
     : QObject(parent)
@@ -8,17 +10,27 @@ PlaybackQueue::PlaybackQueue(QObject* parent)
     qDebug() << "PlaybackQueue initialized";
 }
 
+PlaybackQueue::~PlaybackQueue() {
+    SongStore::instance().release(ids());
+}
+
+// ========== 内部 ==========
+void PlaybackQueue::touch() {
+    ++m_revision;
+    m_cacheValid = false;
+}
+
+// ========== 入队 ==========
 void PlaybackQueue::enqueue(const Song& song) {
     if (song.getId().isEmpty()) {
         qWarning() << "PlaybackQueue: 尝试添加空歌曲到队列";
         return;
     }
 
-    m_queue.enqueue(song);
+    insertSongs(int(m_ids.size()), { song });
     emit songEnqueued(song);
-    emit queueChanged(getQueue());
 
-    qDebug() << "PlaybackQueue: 歌曲入队:" << song.getTitle() << "队列大小:" << m_queue.size();
+    qDebug() << "PlaybackQueue: 歌曲入队:" << song.getTitle() << "队列大小:" << m_ids.size();
 }
 
 void PlaybackQueue::enqueueNext(const Song& song) {
@@ -27,101 +39,135 @@ void PlaybackQueue::enqueueNext(const Song& song) {
         return;
     }
 
-    // 在 Qt 的 QQueue 中，我们需要将所有元素取出，插入新歌曲，然后放回
-    QList<Song> tempList;
-    while (!m_queue.isEmpty()) {
-        tempList.append(m_queue.dequeue());
-    }
-
-    // 新歌曲放在最前面
-    m_queue.enqueue(song);
-    for (const Song& s : tempList) {
-        m_queue.enqueue(s);
-    }
-
+    insertSongs(0, { song });
     emit songEnqueued(song);
-    emit queueChanged(getQueue());
 
     qDebug() << "PlaybackQueue: 歌曲插入队列头部:" << song.getTitle();
 }
 
 void PlaybackQueue::enqueueList(const QList<Song>& songs) {
+    insertSongs(int(m_ids.size()), songs);
+    qDebug() << "PlaybackQueue: 批量入队" << songs.size() << "首歌曲，队列大小:" << m_ids.size();
+}
+
+void PlaybackQueue::insertSongs(int index, const QList<Song>& songs) {
+    QList<Song> valid;
+    valid.reserve(songs.size());
     for (const Song& song : songs) {
-        if (!song.getId().isEmpty()) {
-            m_queue.enqueue(song);
-        }
+        if (!song.getId().isEmpty()) valid << song;
+    }
+    if (valid.isEmpty()) return;
+
+    if (index < 0 || index > int(m_ids.size())) index = int(m_ids.size());
+
+    if (index == 0) {
+        // 头部：逆序 push_front，每首 O(1)
+        for (auto it = valid.crbegin(); it != valid.crend(); ++it) m_ids.push_front(it->getId());
+    }
+    else if (index == int(m_ids.size())) {
+        for (const Song& song : valid) m_ids.push_back(song.getId());
     }
+    else {
+        QStringList ids;
+        ids.reserve(valid.size());
+        for (const Song& song : valid) ids << song.getId();
+        m_ids.insert(m_ids.begin() + index, ids.cbegin(), ids.cend());
+    }
+    // 同一首歌再次入队时以最新的信息为准
+    SongStore::instance().retain(valid);
 
-    emit queueChanged(getQueue());
-    qDebug() << "PlaybackQueue: 批量入队" << songs.size() << "首歌曲，队列大小:" << m_queue.size();
+    touch();
+    emit songsInserted(index, valid, m_revision);
 }
 
 Song PlaybackQueue::dequeue() {
-    if (m_queue.isEmpty()) {
+    if (m_ids.empty()) {
         return Song();
     }
 
-    Song song = m_queue.dequeue();
+    Song song = peek();
+    removeRange(0, 1);
     emit songDequeued(song);
-    emit queueChanged(getQueue());
 
-    qDebug() << "PlaybackQueue: 歌曲出队:" << song.getTitle() << "剩余队列大小:" << m_queue.size();
+    qDebug() << "PlaybackQueue: 歌曲出队:" << song.getTitle() << "剩余队列大小:" << m_ids.size();
     return song;
 }
 
 void PlaybackQueue::clear() {
-    m_queue.clear();
-    emit queueChanged(getQueue());
+    if (m_ids.empty()) return;
+    removeRange(0, int(m_ids.size()));
     qDebug() << "PlaybackQueue: 清空队列";
 }
 
+// ========== 查询 ==========
 QList<Song> PlaybackQueue::getQueue() const {
-    QList<Song> result;
-    QQueue<Song> tempQueue = m_queue;  // 复制队列
-    while (!tempQueue.isEmpty()) {
-        result.append(tempQueue.dequeue());
+    if (!m_cacheValid) {
+        m_cache = SongStore::instance().songs(ids());
+        m_cacheValid = true;
     }
-    return result;
+    return m_cache;
+}
+
+QStringList PlaybackQueue::ids() const {
+    return QStringList(m_ids.cbegin(), m_ids.cend());
 }
 
 int PlaybackQueue::size() const {
-    return m_queue.size();
+    return int(m_ids.size());
 }
 
 bool PlaybackQueue::isEmpty() const {
-    return m_queue.isEmpty();
+    return m_ids.empty();
 }
 
 Song PlaybackQueue::peek() const {
-    if (m_queue.isEmpty()) {
+    if (m_ids.empty()) {
         return Song();
     }
-    return m_queue.head();
+    return SongStore::instance().song(m_ids.front());
+}
+
+Song PlaybackQueue::songAt(int index) const {
+    if (index < 0 || index >= int(m_ids.size())) return Song();
+    return SongStore::instance().song(m_ids[index]);
+}
+
+bool PlaybackQueue::contains(const Song& song) const {
+    return std::find(m_ids.cbegin(), m_ids.cend(), song.getId()) != m_ids.cend();
 }
 
+// ========== 删除与移动 ==========
 void PlaybackQueue::removeSong(int index) {
-    QList<Song> songList = getQueue();
-    if (index < 0 || index >= songList.size()) {
+    if (index < 0 || index >= int(m_ids.size())) {
         qWarning() << "PlaybackQueue: 无效的移除索引:" << index;
         return;
     }
 
-    QString title = songList[index].getTitle();
-    songList.removeAt(index);
+    const QString title = songAt(index).getTitle();
+    removeRange(index, 1);
+    qDebug() << "PlaybackQueue: 移除歌曲:" << title;
+}
 
-    // 重建队列
-    m_queue.clear();
-    for (const Song& song : songList) {
-        m_queue.enqueue(song);
+void PlaybackQueue::removeRange(int index, int count) {
+    const int size = int(m_ids.size());
+    if (index < 0 || index >= size || count <= 0) {
+        qWarning() << "PlaybackQueue: 无效的移除范围:" << index << count;
+        return;
     }
+    count = qMin(count, size - index);
 
-    emit queueChanged(getQueue());
-    qDebug() << "PlaybackQueue: 移除歌曲:" << title;
+    const auto first = m_ids.begin() + index;
+    const auto last = first + count;
+    SongStore::instance().release(QStringList(first, last));
+    m_ids.erase(first, last);
+
+    touch();
+    emit songsRemoved(index, count, m_revision);
 }
 
 void PlaybackQueue::moveSong(int from, int to) {
-    QList<Song> songList = getQueue();
-    if (from < 0 || from >= songList.size() || to < 0 || to >= songList.size()) {
+    const int size = int(m_ids.size());
+    if (from < 0 || from >= size || to < 0 || to >= size) {
         qWarning() << "PlaybackQueue: 无效的移动索引:" << from << "to" << to;
         return;
     }
@@ -130,20 +176,11 @@ void PlaybackQueue::moveSong(int from, int to) {
         return;
     }
 
-    Song song = songList.takeAt(from);
-    songList.insert(to, song);
-
-    // 重建队列
-    m_queue.clear();
-    for (const Song& s : songList) {
-        m_queue.enqueue(s);
-    }
-
-    emit queueChanged(getQueue());
-    qDebug() << "PlaybackQueue: 歌曲移动:" << song.getTitle() << "从" << from << "到" << to;
-}
+    QString id = std::move(m_ids[from]);
+    m_ids.erase(m_ids.begin() + from);
+    m_ids.insert(m_ids.begin() + to, std::move(id));
 
-bool PlaybackQueue::contains(const Song& song) const {
-    QList<Song> songList = getQueue();
-    return songList.contains(song);
+    touch();
+    emit songMoved(from, to, m_revision);
+    qDebug() << "PlaybackQueue: 歌曲移动:" << songAt(to).getTitle() << "从" << from << "到" << to;
 }
@@ -1,38 +1,60 @@
 // service/PlaybackQueue.h
 #pragma once
 #include <QObject>
-#include <QQueue>
+#include <QStringList>
+#include <deque>
 #include "../common/entities/Song.h"
 
+/**
+ * @brief 播放队列（按歌曲 ID 存放的双端队列）
+ *
+ * 顺序只保存 ID（std::deque，两端插入 / 删除 O(1)，中间区间插删 O(区间 + 较近一端)），
+ * 歌曲信息与播放列表共用 SongStore（按 ID 引用计数），同一首歌可以排多次。
+ * 每次变化只发出描述增量的信号（插入 / 删除 / 移动一段），批量入队只发一次；
+ * revision 每次变化加一，接收方据此发现漏掉或重复的增量。
+ */
 class PlaybackQueue : public QObject {
     Q_OBJECT
 
 public:
     explicit PlaybackQueue(QObject* parent = nullptr);
+    ~PlaybackQueue() override;
 
     // 队列管理
-    void enqueue(const Song& song);
-    void enqueueNext(const Song& song);  // 添加到队列头部
-    void enqueueList(const QList<Song>& songs);
+    void enqueue(const Song& song);                          // 末尾
+    void enqueueNext(const Song& song);                      // 添加到队列头部
+    void enqueueList(const QList<Song>& songs);              // 末尾，保持顺序
+    void insertSongs(int index, const QList<Song>& songs);   // index 越界时追加到末尾
     Song dequeue();
     void clear();
 
     // 队列查询
-    QList<Song> getQueue() const;
+    QList<Song> getQueue() const;    // 变化后首次调用时重建，之后共享同一份
+    QStringList ids() const;
     int size() const;
     bool isEmpty() const;
     Song peek() const;  // 查看下一首歌但不移除
+    Song songAt(int index) const;
+    quint64 revision() const { return m_revision; }
 
     // 队列操作
     void removeSong(int index);
+    void removeRange(int index, int count);
     void moveSong(int from, int to);
     bool contains(const Song& song) const;
 
 signals:
-    void queueChanged(const QList<Song>& queue);
+    void songsInserted(int index, const QList<Song>& songs, quint64 revision);
+    void songsRemoved(int index, int count, quint64 revision);
+    void songMoved(int from, int to, quint64 revision);
     void songEnqueued(const Song& song);
     void songDequeued(const Song& song);
 
 private:
-    QQueue<Song> m_queue;
+    void touch();
+
+    std::deque<QString> m_ids;
+    quint64 m_revision = 0;
+    mutable QList<Song> m_cache;
+    mutable bool m_cacheValid = true;
 };
@@ -3,16 +3,43 @@
 #include "PlaylistManager.h"
 #include "PlaybackHistory.h"
 #include "PlaybackQueue.h"
+#include "TrackPrefetcher.h"
+#include "ConcurrentDownloadManager.h"
 #include "../data/SongRepository.h"
+#include "../data/DatabaseManager.h"
 #include "../common/AppConfig.h"
+#include "../common/SessionJournal.h"
 
 #include <QTimer>
 #include <QDebug>
 #include <QHash>
+#include <QSet>
 #include <QFileInfo>
+#include <QFuture>
+#include <QPromise>
+#include <QSqlDatabase>
+#include <QThread>
+#include <QThreadPool>
+#include <QCoreApplication>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <utility>
 #include <QtGlobal>
 
 namespace {
+    // 会话补全在线程池中执行，使用独立的数据库连接
+    const char* const kRestoreConnectionName = "session_restore";
+    // 播放引擎线程自己的数据库连接（连接只能在创建它的线程使用）
+    const char* const kEngineConnectionName = "playback_engine";
+    // 智能推荐的候选曲库在线程池中装载
+    const char* const kCatalogConnectionName = "recommendation_catalog";
+
+    inline qint64 steadyNowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
     inline PlaybackMode modeFromInt(int v) {
         switch (v) {
         case 1: return PlaybackMode::Shuffle;
@@ -33,85 +60,432 @@ namespace {
     }
 }
 
+/**
+ * 播放引擎：运行在独立的 PlaybackEngine 线程上，拥有播放器、列表、队列与历史。
+ * 界面线程卡顿（重建大表格、同步写库）不会推迟淡入淡出、结尾处理与换曲。
+ *
+ * 与界面的接口：
+ *  - 命令：PlaybackService 的修改类方法经 post() 投递到引擎线程，按提交顺序执行；
+ *  - 事件：引擎直接 emit q 的信号，界面线程的接收者自动走排队连接；
+ *  - 状态：引擎在每次变化后发布只读快照（Snapshot），界面的查询方法只读快照，不等待引擎；
+ *  - 统计类查询（历史、智能列表）用 call() 阻塞等待引擎执行，引擎从不反过来阻塞等待界面线程。
+ * 构造在引擎线程上执行，期间界面线程阻塞等待，因此可以安全读取 AppConfig 与 SessionJournal；
+ * 之后对 AppConfig 的写入回到界面线程完成，SessionJournal 只由引擎线程写。
+ */
 class PlaybackService::Impl : public QObject {
     Q_OBJECT
 
 public:
-    explicit Impl(PlaybackService* parent)
-        : QObject(parent)
-        , q(parent)
+    // 界面查询用的只读快照；QList 隐式共享，发布只是复制引用
+    struct Snapshot {
+        PlaybackState state = PlaybackState::Stopped;
+        Song currentSong;
+        int currentIndex = -1;
+        // 播放列表与队列不进快照（列表共享后每次编辑都会分离复制，队列每次变化要重建），
+        // 由 getCurrentPlaylist / getPlaybackQueue 按需向引擎取
+        PlaybackMode mode = PlaybackMode::Normal;
+        int volume = 0;
+        qint64 durationMs = 0;
+    };
+
+    Impl(PlaybackService* owner, QThread* thread, ConcurrentDownloadManager* downloadManager)
+        : QObject(nullptr)
+        , q(owner)
+        , engineThread(thread)
         , audioPlayer(new AudioPlayer(this))
         , playlistManager(new PlaylistManager(this))
         , playbackHistory(new PlaybackHistory(this))
         , playbackQueue(new PlaybackQueue(this))
-        , songRepository(new SongRepository(this))
+        , songRepository(nullptr)
         , positionTimer(new QTimer(this))
         , currentState(PlaybackState::Stopped)
         , loopA(-1)
         , loopB(-1)
-        , saveDebounce(new QTimer(this))
+        , saveDebounce(nullptr)
         , restoringSession(false)
         , pendingSave(false)
         , lastSavedPositionMs(-1)
         , lastUserVolume(70)
     {
+        DatabaseManager::instance().openThreadConnection(kEngineConnectionName);
+        songRepository = new SongRepository(kEngineConnectionName, this);
+
+        // 等待快下载完的歌曲：超时仍未完成就跳过
+        downloadWaitTimer = new QTimer(this);
+        downloadWaitTimer->setInterval(kDownloadWaitMs);
+        downloadWaitTimer->setSingleShot(true);
+        connect(downloadWaitTimer, &QTimer::timeout, this, [this]() {
+            skipAwaitedSong("下载未能及时完成");
+            });
+
         setupConnections();
         setupTimer();
         setupSmartFeatures();
+        setupDownloadCoordination(downloadManager);
 
-        // 启动时恢复音量与播放模式
+        // 启动时恢复音量（会话日志）与播放模式（配置）
         AppConfig& cfg = AppConfig::instance();
-        audioPlayer->setVolume(cfg.getPlayerVolume());
+        const int journalVolume = SessionJournal::instance().volume();
+        const int startVolume = journalVolume >= 0 ? journalVolume : cfg.getPlayerVolume();
+        audioPlayer->setVolume(startVolume);
+        // 列表此时还是空的：洗出的空排列不能覆盖日志里上次的排列，留给会话恢复
+        restoringSession = true;
+        playlistManager->setWeightedShuffle(cfg.getWeightedShuffle());
         playlistManager->setPlaybackMode(modeFromInt(cfg.getPlayerPlaybackMode()));
-        lastUserVolume = cfg.getPlayerVolume();
+        restoringSession = false;
+        lastUserVolume = startVolume;
+
+        // 无缝衔接 / 交叉淡化
+        gaplessEnabled = cfg.getGaplessPlayback();
+        audioPlayer->setCrossfadeDuration(cfg.getCrossfadeMs());
+        crossfadeMs = audioPlayer->crossfadeDuration();
 
-        // 防抖保存定时器
+        // 预读接下来的曲目到页缓存
+        prefetchTrackCount = cfg.getPrefetchTrackCount();
+        prefetcher.setBudgetBytes(qint64(cfg.getPrefetchBudgetMb()) * 1024 * 1024);
+
+        // 自有渲染管线与 DSP
+        audioPlayer->setEqualizer(DspChain::graphicEqBands(cfg.getEqGainsDb()));
+        audioPlayer->setLimiterEnabled(cfg.getLimiterEnabled());
+        audioPlayer->setRenderPipelineEnabled(cfg.getRenderPipelineEnabled());
+        renderPipelineEnabled = cfg.getRenderPipelineEnabled();
+
+        publishSnapshot();
+
+        // 会话恢复改为事件循环启动后执行，降低构造期时序风险
+        if (cfg.getResumeOnStartup()) {
+            QTimer::singleShot(0, this, &Impl::restoreSession);
+        }
+    }
+
+    // 防抖保存定时器属于界面线程（AppConfig 只在界面线程写），由 PlaybackService 构造时调用
+    void setupConfigSave() {
+        saveDebounce = new QTimer(q);
         saveDebounce->setInterval(700);
         saveDebounce->setSingleShot(true);
-        connect(saveDebounce, &QTimer::timeout, this, [this]() {
-            if (!pendingSave || restoringSession) return;
+        connect(saveDebounce, &QTimer::timeout, q, [this]() {
+            if (!pendingSave) return;
             pendingSave = false;
             AppConfig::instance().save();
             });
+    }
 
-        // 会话恢复改为事件循环启动后执行，降低构造期时序风险
-        if (cfg.getResumeOnStartup()) {
-            QTimer::singleShot(0, this, &Impl::restoreSession);
-        }
+    // 下载管理器属于界面线程（由 PlaybackService 在界面线程取得后传入）；
+    // 引擎线程只调用它加锁的查询，调整下载队列转交界面线程执行
+    void setupDownloadCoordination(ConcurrentDownloadManager* downloadManager) {
+        downloads = downloadManager;
+        if (!downloads) return;
+        connect(downloads, &ConcurrentDownloadManager::taskCompleted, this, &Impl::handleDownloadCompleted);
+        connect(downloads, &ConcurrentDownloadManager::taskFailed, this, [this](const QString& taskId) {
+            if (taskId == awaitedDownloadTaskId) skipAwaitedSong("下载失败");
+            });
+        connect(downloads, &ConcurrentDownloadManager::taskRetrying, this, [this](const QString& taskId) {
+            if (taskId == awaitedDownloadTaskId) skipAwaitedSong("下载失败");
+            });
+        connect(downloads, &ConcurrentDownloadManager::taskCancelled, this, [this](const QString& taskId) {
+            if (taskId == awaitedDownloadTaskId) skipAwaitedSong("下载已取消");
+            });
+        // 新任务（例如导入歌单）入队后，按当前播放位置重排一次
+        connect(downloads, &ConcurrentDownloadManager::taskAdded, this, [this]() {
+            scheduleDownloadPromotion();
+            });
     }
 
-    // 合并保存（防抖）
-    void scheduleConfigSave() {
+    // 合并保存（防抖）：只用于真正的设置项（播放模式），会话状态直接追加到 SessionJournal。
+    // 引擎线程调用：把写配置转交界面线程
+    void persistPlaybackMode(PlaybackMode mode) {
         if (restoringSession) return;
-        pendingSave = true;
-        if (!saveDebounce->isActive()) saveDebounce->start();
+        QMetaObject::invokeMethod(q, [this, mode]() {
+            AppConfig::instance().setPlayerPlaybackMode(intFromMode(mode));
+            pendingSave = true;
+            if (!saveDebounce->isActive()) saveDebounce->start();
+            }, Qt::QueuedConnection);
     }
 
-    // 播放前校验本地文件是否存在；若静音则恢复到上次用户音量
+    // ========== 命令与查询 ==========
+    // 命令：投递到引擎线程按提交顺序执行；已在引擎线程上（引擎内部调用）时直接执行
+    template <typename Fn>
+    void post(Fn&& fn) {
+        if (QThread::currentThread() == thread()) fn();
+        else QMetaObject::invokeMethod(this, std::forward<Fn>(fn), Qt::QueuedConnection);
+    }
+
+    // 查询：阻塞等待引擎执行完；引擎已停止时直接在调用线程执行
+    template <typename Fn>
+    auto call(Fn&& fn) -> decltype(fn()) {
+        if (QThread::currentThread() == thread() || !engineThread->isRunning()) return fn();
+        decltype(fn()) result{};
+        QMetaObject::invokeMethod(this, [&result, &fn]() { result = fn(); }, Qt::BlockingQueuedConnection);
+        return result;
+    }
+
+    // 状态变化后、发出对应信号前调用，保证界面收到信号时查到的是新状态
+    void publishSnapshot() {
+        auto snap = std::make_shared<Snapshot>();
+        snap->state = currentState;
+        snap->currentSong = playlistManager->getCurrentSong();
+        snap->currentIndex = playlistManager->getCurrentIndex();
+        snap->mode = playlistManager->getPlaybackMode();
+        snap->volume = audioPlayer->volume();
+        snap->durationMs = audioPlayer->duration();
+        snapshot.store(std::move(snap), std::memory_order_release);
+    }
+
+    std::shared_ptr<const Snapshot> currentSnapshot() const {
+        return snapshot.load(std::memory_order_acquire);
+    }
+
+    // 记录位置与时间戳；界面查询时按经过的时间外推，不必等引擎
+    void notePosition(qint64 position) {
+        positionMs.store(position, std::memory_order_relaxed);
+        positionStampMs.store(steadyNowMs(), std::memory_order_release);
+    }
+
+    qint64 estimatedPosition() const {
+        const std::shared_ptr<const Snapshot> snap = currentSnapshot();
+        qint64 pos = positionMs.load(std::memory_order_relaxed);
+        if (snap->state == PlaybackState::Playing) {
+            pos += steadyNowMs() - positionStampMs.load(std::memory_order_acquire);
+            if (snap->durationMs > 0) pos = qMin(pos, snap->durationMs);
+        }
+        return pos;
+    }
+
+    // 退出前在引擎线程执行：停掉定时与预读，释放本线程的数据库连接，
+    // 并安排 Impl 连同播放器、列表、定时器在本线程析构（事件循环退出时处理，已排队的命令随之丢弃）
+    void shutdownEngine() {
+        positionTimer->stop();
+        prefetcher.setTargets({});
+        delete songRepository;
+        songRepository = nullptr;
+        DatabaseManager::instance().closeThreadConnection(kEngineConnectionName);
+        deleteLater();
+    }
+
+    // 播放前校验本地文件是否存在；若静音则恢复到上次用户音量。
+    // 文件还在下载且快完成时转为等待（返回 true），完成后自动开始
     bool safeStartSong(const Song& song) {
-        const QString path = song.getLocalFilePath();
+        cancelDownloadWait();
+
+        QString path = song.getLocalFilePath();
         if (path.isEmpty() || !QFileInfo::exists(path)) {
-            emit q->error(QString("音频文件不存在，已跳过：%1").arg(song.getTitle()));
-            qWarning() << "PlaybackService: 文件不存在，跳过:" << path;
-            return false;
+            // 列表 / 队列里可能还是下载完成前的信息：按 ID 重新查一次曲库
+            const Song stored = songRepository ? songRepository->findById(song.getId()) : Song();
+            const QString storedPath = stored.getLocalFilePath();
+            if (!storedPath.isEmpty() && QFileInfo::exists(storedPath)) {
+                path = storedPath;
+            }
+            else if (awaitDownload(song)) {
+                return true;
+            }
+            else {
+                emit q->error(QString("音频文件不存在，已跳过：%1").arg(song.getTitle()));
+                qWarning() << "PlaybackService: 文件不存在，跳过:" << path;
+                return false;
+            }
         }
         if (audioPlayer->volume() == 0 && lastUserVolume > 0) {
             qDebug() << "[Service] safeStartSong: restore vol to" << lastUserVolume;
             audioPlayer->setVolume(lastUserVolume);
         }
         qDebug() << "[Service] safeStartSong: play path=" << path;
+        prefetcher.noteTrackStarted(path);
         audioPlayer->play(path);
+        scheduleArmNext();
+        return true;
+    }
+
+    // ========== 预加载下一首 / 预读 ==========
+    // 多个变化（入队、换列表、切模式）在同一轮事件里合并为一次
+    void scheduleArmNext() {
+        if (armScheduled) return;
+        armScheduled = true;
+        QTimer::singleShot(0, this, [this]() {
+            armScheduled = false;
+            armNextTrack();
+            prefetcher.setTargets(upcomingPaths(prefetchTrackCount));
+            promoteUpcomingDownloads();
+            });
+    }
+
+    // 按预计播放顺序逐首访问：预加载的下一首、队列、再按列表顺序（随机模式按预排顺序），
+    // 列表部分至多 listLimit 首；visit 返回 false 时停止
+    template <typename Visit>
+    void forEachUpcoming(int listLimit, Visit&& visit) const {
+        if (!armedSong.getId().isEmpty() && !visit(armedSong)) return;
+        for (int i = 0; i < playbackQueue->size(); ++i) {
+            if (!visit(playbackQueue->songAt(i))) return;
+        }
+
+        const PlaybackMode mode = playlistManager->getPlaybackMode();
+        if (mode == PlaybackMode::RepeatOne) return;
+
+        if (mode == PlaybackMode::Shuffle) {
+            // 随机顺序已预排，接下来几首同样可预测
+            for (int i : playlistManager->upcomingShuffleIndices(listLimit)) {
+                if (!visit(playlistManager->songAt(i))) return;
+            }
+            return;
+        }
+
+        const int size = playlistManager->getPlaylistSize();
+        const int idx = playlistManager->getCurrentIndex();
+        for (int step = 1; step < size && step <= listLimit; ++step) {
+            int i = idx + step;
+            if (i >= size) {
+                if (mode != PlaybackMode::RepeatAll) return;
+                i %= size;
+            }
+            if (!visit(playlistManager->songAt(i))) return;
+        }
+    }
+
+    // 接下来大概率会播放的文件
+    QStringList upcomingPaths(int count) const {
+        QStringList paths;
+        if (count <= 0) return paths;
+
+        const Song cur = playlistManager->getCurrentSong();
+        forEachUpcoming(count, [&](const Song& s) {
+            const QString p = s.getLocalFilePath();
+            if (!p.isEmpty() && p != cur.getLocalFilePath() && !paths.contains(p)) paths << p;
+            return paths.size() < count;
+            });
+        return paths;
+    }
+
+    // ========== 与下载协同 ==========
+    // 当前及接下来几首里还没有本地文件的，按离播放位置的远近提前到下载队列最前面
+    void promoteUpcomingDownloads() {
+        if (!downloads || downloads->getPendingTaskCount() == 0) return;
+
+        QStringList missing;
+        auto note = [&missing](const Song& s) {
+            const QString p = s.getLocalFilePath();
+            if (!s.getId().isEmpty() && (p.isEmpty() || !QFileInfo::exists(p)) && !missing.contains(s.getId())) {
+                missing << s.getId();
+            }
+        };
+        if (!awaitedSong.getId().isEmpty()) note(awaitedSong);
+        note(playlistManager->getCurrentSong());
+        int seen = 0;
+        forEachUpcoming(kDownloadLookahead, [&](const Song& s) {
+            note(s);
+            return ++seen < kDownloadLookahead;
+            });
+        if (missing.isEmpty()) return;
+
+        // 下载队列只在界面线程调整
+        ConcurrentDownloadManager* manager = downloads;
+        QMetaObject::invokeMethod(manager, [manager, missing]() {
+            manager->promoteTasks(missing);
+            }, Qt::QueuedConnection);
+    }
+
+    // 导入等批量入队时合并成一次
+    void scheduleDownloadPromotion() {
+        if (promotionScheduled) return;
+        promotionScheduled = true;
+        QTimer::singleShot(kDownloadPromotionDelayMs, this, [this]() {
+            promotionScheduled = false;
+            promoteUpcomingDownloads();
+            });
+    }
+
+    // 正在下载且接近完成的歌曲：停下当前播放等它完成，超时则跳过
+    bool awaitDownload(const Song& song) {
+        if (!downloads) return false;
+        const DownloadTaskState task = downloads->activeTaskFor(song.getId());
+        if (task.getIdentifier().isEmpty() || task.getProgress() < kDownloadWaitMinProgress) return false;
+
+        awaitedDownloadTaskId = task.getTaskId();
+        awaitedSong = song;
+        audioPlayer->stop();
+        handlePlaybackStateChanged(PlaybackState::Loading);
+        downloadWaitTimer->start();
+        qDebug() << "PlaybackService: ⏳ 等待下载完成:" << song.getTitle()
+            << "进度" << qRound(task.getProgress() * 100) << "%";
         return true;
     }
 
+    void cancelDownloadWait() {
+        downloadWaitTimer->stop();
+        awaitedDownloadTaskId.clear();
+        awaitedSong = Song();
+    }
+
+    void skipAwaitedSong(const QString& reason) {
+        if (awaitedDownloadTaskId.isEmpty()) return;
+        const Song song = awaitedSong;
+        cancelDownloadWait();
+        emit q->error(QString("%1，已跳过：%2").arg(reason, song.getTitle()));
+        qWarning() << "PlaybackService:" << reason << "，跳过:" << song.getTitle();
+        playNext();
+    }
+
+    // 自然播完后会播放的下一首：规则与 handleSongFinished 一致，但不出队、不改当前索引
+    Song peekAutoNext(bool& fromQueue) {
+        fromQueue = false;
+        if (!playbackQueue->isEmpty()) {
+            fromQueue = true;
+            return playbackQueue->peek();
+        }
+
+        const PlaybackMode mode = playlistManager->getPlaybackMode();
+        if (mode == PlaybackMode::RepeatOne) return playlistManager->getCurrentSong();
+
+        if (mode == PlaybackMode::Shuffle) {
+            // 预排的随机顺序：查看下一首不改变状态，结果与真正推进时一致
+            return playlistManager->getSmartNextSong();
+        }
+
+        const int size = playlistManager->getPlaylistSize();
+        if (size <= 0) return Song();
+        int nextIndex = playlistManager->getCurrentIndex() + 1;
+        if (nextIndex >= size) {
+            if (mode != PlaybackMode::RepeatAll) return Song();
+            nextIndex = 0;
+        }
+        return playlistManager->songAt(nextIndex);
+    }
+
+    void armNextTrack() {
+        // A-B 循环中不衔接；关闭无缝播放时结尾走 finished 流程
+        if (!gaplessEnabled || loopA >= 0 || loopB >= 0) {
+            disarmNextTrack();
+            return;
+        }
+
+        bool fromQueue = false;
+        const Song next = peekAutoNext(fromQueue);
+        if (next.getId().isEmpty() || next.getLocalFilePath().isEmpty()) {
+            disarmNextTrack();
+            return;
+        }
+        armedSong = next;
+        armedFromQueue = fromQueue;
+        audioPlayer->preloadNext(next.getLocalFilePath());
+    }
+
+    void disarmNextTrack() {
+        armedSong = Song();
+        armedFromQueue = false;
+        audioPlayer->clearPreload();
+    }
+
 private slots:
     void handlePlaybackStateChanged(PlaybackState state) {
         if (currentState != state) {
             currentState = state;
+            notePosition(audioPlayer->position());
+            publishSnapshot();
             emit q->playbackStateChanged(state);
 
-            if (state == PlaybackState::Playing) positionTimer->start();
-            else positionTimer->stop();
+            updatePositionTimer();
+            // 暂停/停止时补发一次最终位置
+            if (state != PlaybackState::Playing && !positionSuspended) {
+                publishPosition(audioPlayer->position());
+            }
 
             qDebug() << "[Service] stateChanged ->" << (int)state
                 << "vol=" << audioPlayer->volume()
@@ -120,49 +494,52 @@ private slots:
     }
 
     void handleCurrentIndexChanged(int index) {
+        publishSnapshot();
         emit q->currentSongIndexChanged(index);
 
         Song cur = playlistManager->getCurrentSong();
         if (!cur.getId().isEmpty()) {
+            if (suppressSongAnnounce) return;
             emit q->currentSongChanged(cur);
             if (!restoringSession) {
-                AppConfig& cfg = AppConfig::instance();
-                cfg.setLastSongId(cur.getId());
-                scheduleConfigSave();
+                SessionJournal::instance().setLastSongId(cur.getId());
+                // 换歌对排列的改动已由增量记录写入，这里只追加游标
+                SessionJournal::instance().setShuffleCursor(playlistManager->shuffleCursor());
             }
             qDebug() << "PlaybackService: 当前歌曲变化:" << cur.getTitle();
         }
     }
 
     void handlePositionChanged(qint64 position) {
-        emit q->positionChanged(position);
+        // 播放器自身的位置通知只用于 A-B 回跳（窗口隐藏、定时器停掉时也要生效）和持久化；
+        // 对外的 positionChanged 统一由 positionTimer 发出，仅在定时器未运行（暂停中拖动）时直接补发
+        notePosition(position);
+        if (applyLoopAB(position)) return;
+        if (!positionTimer->isActive() && !positionSuspended) {
+            publishPosition(position);
+        }
 
         if (restoringSession) return;
 
-        // 至少每5秒记录一次位置，减少写盘
-        if (lastSavedPositionMs < 0 || qAbs(position - lastSavedPositionMs) >= 5000) {
-            qDebug() << "[Service] positionTick 5s"
-                << "state=" << (int)currentState
-                << "vol=" << audioPlayer->volume()
-                << "posMs=" << position;
-
+        // 每秒追加一条进度记录（约 20 字节，不重写配置文件）
+        if (lastSavedPositionMs < 0 || qAbs(position - lastSavedPositionMs) >= 1000) {
             lastSavedPositionMs = position;
-            AppConfig& cfg = AppConfig::instance();
-            cfg.setLastPositionMs(position);
+            SessionJournal& journal = SessionJournal::instance();
 
-            // 同步当前歌曲ID，保障恢复场景一致
+            // 同步当前歌曲ID，保障恢复场景一致（未变化时不会写入）
             Song cur = playlistManager->getCurrentSong();
-            if (!cur.getId().isEmpty()) cfg.setLastSongId(cur.getId());
-
-            scheduleConfigSave();
+            if (!cur.getId().isEmpty()) journal.setLastSongId(cur.getId());
+            journal.setLastPositionMs(position);
         }
     }
 
     void handleDurationChanged(qint64 duration) {
+        publishSnapshot();
         emit q->durationChanged(duration);
     }
 
     void handleVolumeChanged(int volume) {
+        publishSnapshot();
         emit q->volumeChanged(volume);
         if (volume > 0) lastUserVolume = volume;
         qDebug() << "[Service] volumeChanged ->" << volume
@@ -170,35 +547,97 @@ private slots:
             << "state=" << (int)currentState;
 
         if (restoringSession) return;
-        AppConfig& cfg = AppConfig::instance();
-        cfg.setPlayerVolume(volume);
-        scheduleConfigSave();
+        SessionJournal::instance().setVolume(volume);
     }
 
     void handlePlaybackModeChanged(PlaybackMode mode) {
+        publishSnapshot();
         emit q->playbackModeChanged(mode);
+        scheduleArmNext();
+        persistPlaybackMode(mode);
+    }
+
+    // 随机排列：整体重洗才写完整排列（10 万首约 400KB，一轮一次）；增删与点选只追加增量
+    void handleShuffleOrderChanged() {
+        scheduleArmNext();
         if (restoringSession) return;
+        persistShuffleOrder();
+    }
 
-        AppConfig& cfg = AppConfig::instance();
-        cfg.setPlayerPlaybackMode(intFromMode(mode));
-        scheduleConfigSave();
+    void handleShuffleSongInserted(int position) {
+        scheduleArmNext();
+        if (restoringSession) return;
+        SessionJournal::instance().insertShuffleAppended(position);
+        SessionJournal::instance().setShuffleCursor(playlistManager->shuffleCursor());
     }
 
-    void handlePlaylistChanged(const QList<Song>& playlist) {
-        emit q->playlistChanged(playlist);
+    void handleShuffleSongRemoved(int index) {
+        scheduleArmNext();
         if (restoringSession) return;
+        SessionJournal::instance().removeShuffleIndex(index);
+        SessionJournal::instance().setShuffleCursor(playlistManager->shuffleCursor());
+    }
 
-        QStringList plIds; for (const Song& s : playlist) plIds << s.getId();
-        AppConfig& cfg = AppConfig::instance();
-        cfg.setLastPlaylistIds(plIds);
-        scheduleConfigSave();
+    void handleShufflePositionsSwapped(int from, int to) {
+        scheduleArmNext();
+        if (restoringSession) return;
+        SessionJournal::instance().swapShufflePositions(from, to);
+        SessionJournal::instance().setShuffleCursor(playlistManager->shuffleCursor());
+    }
+
+    void handleShufflePositionMoved(int from, int to) {
+        scheduleArmNext();
+        if (restoringSession) return;
+        SessionJournal::instance().moveShufflePosition(from, to);
+        SessionJournal::instance().setShuffleCursor(playlistManager->shuffleCursor());
+    }
+
+    void persistShuffleOrder() {
+        SessionJournal& journal = SessionJournal::instance();
+        journal.setShuffleOrder(playlistManager->shuffleOrder());
+        journal.setShuffleCursor(playlistManager->shuffleCursor());
+    }
+
+    // 播放列表变化：ID 列表隐式共享，转发与写日志都不逐首复制歌曲
+    // 整体替换只转发版本号，界面需要时再经 getCurrentPlaylist 取；增量编辑带上插入的歌曲
+    void handlePlaylistReset(const QStringList& ids, quint64 revision) {
+        publishSnapshot();
+        emit q->playlistReset(revision);
+        scheduleArmNext();
+        if (restoringSession) return;
+        SessionJournal::instance().setPlaylistIds(ids);
+    }
+
+    void handlePlaylistSongsInserted(int index, const QStringList& ids, quint64 revision) {
+        publishSnapshot();
+        QList<Song> songs;
+        songs.reserve(ids.size());
+        for (int i = 0; i < ids.size(); ++i) songs << playlistManager->songAt(index + i);
+        emit q->playlistSongsInserted(index, songs, revision);
+        scheduleArmNext();
+        if (restoringSession) return;
+        SessionJournal::instance().insertPlaylistIds(index, ids);
+    }
+
+    void handlePlaylistSongsRemoved(int index, int count, quint64 revision) {
+        publishSnapshot();
+        emit q->playlistSongsRemoved(index, count, revision);
+        scheduleArmNext();
+        if (restoringSession) return;
+        SessionJournal::instance().removePlaylistIds(index, count);
+    }
+
+    void handleDownloadCompleted(const QString& taskId, const Song& song) {
+        if (taskId != awaitedDownloadTaskId) return;
+        qDebug() << "PlaybackService: 等待的下载已完成，开始播放:" << song.getTitle();
+        if (!safeStartSong(song)) playNext();
     }
 
     void handleAudioError(const QString& error) {
         emit q->error(error);
         qWarning() << "PlaybackService: 音频播放错误:" << error;
         // 自动跳过损坏/不存在的文件
-        q->playNext();
+        playNext();
     }
 
     void handleSongFinished() {
@@ -208,11 +647,8 @@ private slots:
         playbackHistory->updateCurrentRecord(duration, true);
 
         // 1) 播放队列优先
-        const QList<Song> queue = playbackQueue ? playbackQueue->getQueue() : QList<Song>{};
-        if (!queue.isEmpty()) {
-            Song head = queue.first();
-            playbackQueue->dequeue();
-            q->playSong(head);
+        if (!playbackQueue->isEmpty()) {
+            playSong(playbackQueue->dequeue());
             return;
         }
 
@@ -222,7 +658,7 @@ private slots:
         if (mode == PlaybackMode::RepeatOne) {
             Song cur = playlistManager->getCurrentSong();
             if (!cur.getId().isEmpty()) {
-                q->playSong(cur);
+                playSong(cur);
                 return;
             }
         }
@@ -230,14 +666,13 @@ private slots:
         if (mode == PlaybackMode::Shuffle) {
             Song s = playlistManager->getSmartNextSong();
             if (!s.getId().isEmpty()) {
-                q->playSong(s);
+                playSong(s);
                 return;
             }
         }
 
         // Normal / RepeatAll：顺序推进
-        const QList<Song> pl = playlistManager->getPlaylist();
-        const int size = pl.size();
+        const int size = playlistManager->getPlaylistSize();
         if (size <= 0) {
             qDebug() << "PlaybackService: 播放列表为空";
             return;
@@ -251,12 +686,46 @@ private slots:
             }
             else {
                 qDebug() << "PlaybackService: 顺序播放到末尾，停止";
-                q->stop();
+                stop();
                 return;
             }
         }
 
-        q->playSong(pl[nextIndex]);
+        playSong(playlistManager->songAt(nextIndex));
+    }
+
+    // 播放器已在结尾切到预加载的曲目：补上 playSong 的簿记（出队、历史、当前索引），不再重新加载
+    void handleTrackAdvanced(const QString& filePath, qint64 previousDurationMs) {
+        playbackHistory->updateCurrentRecord(previousDurationMs, true);
+
+        const Song next = armedSong;
+        const bool fromQueue = armedFromQueue;
+        armedSong = Song();
+        armedFromQueue = false;
+        if (next.getId().isEmpty() || next.getLocalFilePath() != filePath) {
+            qWarning() << "PlaybackService: 衔接的曲目与预加载记录不一致:" << filePath;
+            return;
+        }
+        qDebug() << "PlaybackService: 无缝衔接到:" << next.getTitle();
+        prefetcher.noteTrackStarted(filePath);
+
+        if (fromQueue && !playbackQueue->isEmpty() && playbackQueue->peek().getId() == next.getId()) {
+            playbackQueue->dequeue();
+        }
+        playbackHistory->addRecord(next);
+
+        int songIndex = playlistManager->findSongIndex(next);
+        if (songIndex == -1) {
+            playlistManager->addSong(next);
+            songIndex = playlistManager->getPlaylistSize() - 1;
+        }
+        playlistManager->setCurrentIndex(songIndex);
+        scheduleArmNext();
+    }
+
+    void handleTrackChangeLatency(qint64 latencyMs, bool preloaded) {
+        lastTrackChangeLatencyMs = latencyMs;
+        emit q->trackChangeLatencyMeasured(latencyMs, preloaded);
     }
 
     void handleHistoryRecordAdded(const PlaybackRecord& record) {
@@ -264,14 +733,32 @@ private slots:
         qDebug() << "PlaybackService: 播放记录已添加:" << record.song.getTitle();
     }
 
-    void handleQueueChanged(const QList<Song>& queue) {
-        emit q->playbackQueueChanged(queue);
+    // 队列变化：界面与会话日志都只接收增量
+    void handleQueueSongsInserted(int index, const QList<Song>& songs, quint64 revision) {
+        publishSnapshot();
+        emit q->queueSongsInserted(index, songs, revision);
+        scheduleArmNext();
         if (restoringSession) return;
 
-        QStringList qIds; for (const Song& s : queue) qIds << s.getId();
-        AppConfig& cfg = AppConfig::instance();
-        cfg.setLastQueueIds(qIds);
-        scheduleConfigSave();
+        QStringList ids; ids.reserve(songs.size());
+        for (const Song& s : songs) ids << s.getId();
+        SessionJournal::instance().insertQueueIds(index, ids);
+    }
+
+    void handleQueueSongsRemoved(int index, int count, quint64 revision) {
+        publishSnapshot();
+        emit q->queueSongsRemoved(index, count, revision);
+        scheduleArmNext();
+        if (restoringSession) return;
+        SessionJournal::instance().removeQueueIds(index, count);
+    }
+
+    void handleQueueSongMoved(int from, int to, quint64 revision) {
+        publishSnapshot();
+        emit q->queueSongMoved(from, to, revision);
+        scheduleArmNext();
+        if (restoringSession) return;
+        SessionJournal::instance().moveQueueId(from, to);
     }
 
     void handleSmartPlaylistGenerated(const QList<Song>& playlist) {
@@ -281,15 +768,52 @@ private slots:
     void updatePosition() {
         if (currentState == PlaybackState::Playing) {
             qint64 position = audioPlayer->position();
+            notePosition(position);
+            if (applyLoopAB(position)) return;
+            publishPosition(position);
+        }
+    }
 
-            // A-B 循环：超过 B 时回跳 A
-            if (loopA >= 0 && loopB > loopA && position >= loopB) {
-                audioPlayer->setPosition(loopA);
-                return;
-            }
+public:
+    // ========== 位置推送 ==========
+    // 唯一的对外位置出口：与上次发出的值相同则不再发
+    void publishPosition(qint64 position) {
+        if (position == lastPublishedPositionMs) return;
+        lastPublishedPositionMs = position;
+        emit q->positionChanged(position);
+    }
+
+    // A-B 循环交给渲染层在采样边界回绕；区间过长时退回到按位置回跳
+    // 渲染层的循环段要解码后才生效（loopRegionChanged），在那之前仍按位置回跳
+    void syncLoopRegion() {
+        if (loopA >= 0 && loopB > loopA) {
+            if (audioPlayer->setLoopRegion(loopA, loopB)) return;
+            qDebug() << "PlaybackService: A-B 区间过长，使用位置回跳";
+        }
+        audioPlayer->clearLoopRegion();
+        loopInRenderer = false;
+    }
+
+    void handleLoopRegionChanged(bool active) {
+        loopInRenderer = active && loopA >= 0 && loopB > loopA;
+        qDebug() << "PlaybackService: A-B 回绕" << (loopInRenderer ? "由渲染层接管" : "改为位置回跳");
+    }
 
-            emit q->positionChanged(position);
+    // 位置回跳（仅在渲染层未接管时）：超过 B 时回跳 A
+    bool applyLoopAB(qint64 position) {
+        if (loopInRenderer) return false;
+        if (loopA >= 0 && loopB > loopA && position >= loopB) {
+            audioPlayer->setPosition(loopA);
+            return true;
         }
+        return false;
+    }
+
+    // 只在“正在播放且界面可见”时运行定时器，其余时间不产生任何唤醒
+    void updatePositionTimer() {
+        const bool shouldRun = currentState == PlaybackState::Playing && !positionSuspended;
+        if (shouldRun && !positionTimer->isActive()) positionTimer->start();
+        else if (!shouldRun && positionTimer->isActive()) positionTimer->stop();
     }
 
 private:
@@ -307,16 +831,36 @@ private:
             this, &Impl::handleAudioError);
         connect(audioPlayer, &AudioPlayer::finished,
             this, &Impl::handleSongFinished);
+        connect(audioPlayer, &AudioPlayer::loopRegionChanged,
+            this, &Impl::handleLoopRegionChanged);
+        connect(audioPlayer, &AudioPlayer::trackAdvanced,
+            this, &Impl::handleTrackAdvanced);
+        connect(audioPlayer, &AudioPlayer::trackChangeLatency,
+            this, &Impl::handleTrackChangeLatency);
 
         // PlaylistManager 信号连接
-        connect(playlistManager, &PlaylistManager::playlistChanged,
-            this, &Impl::handlePlaylistChanged);
+        connect(playlistManager, &PlaylistManager::playlistReset,
+            this, &Impl::handlePlaylistReset);
+        connect(playlistManager, &PlaylistManager::songsInserted,
+            this, &Impl::handlePlaylistSongsInserted);
+        connect(playlistManager, &PlaylistManager::songsRemoved,
+            this, &Impl::handlePlaylistSongsRemoved);
         connect(playlistManager, &PlaylistManager::currentIndexChanged,
             this, &Impl::handleCurrentIndexChanged);
         connect(playlistManager, &PlaylistManager::playbackModeChanged,
             this, &Impl::handlePlaybackModeChanged);
         connect(playlistManager, &PlaylistManager::smartPlaylistGenerated,
             this, &Impl::handleSmartPlaylistGenerated);
+        connect(playlistManager, &PlaylistManager::shuffleOrderChanged,
+            this, &Impl::handleShuffleOrderChanged);
+        connect(playlistManager, &PlaylistManager::shuffleSongInserted,
+            this, &Impl::handleShuffleSongInserted);
+        connect(playlistManager, &PlaylistManager::shuffleSongRemoved,
+            this, &Impl::handleShuffleSongRemoved);
+        connect(playlistManager, &PlaylistManager::shufflePositionsSwapped,
+            this, &Impl::handleShufflePositionsSwapped);
+        connect(playlistManager, &PlaylistManager::shufflePositionMoved,
+            this, &Impl::handleShufflePositionMoved);
 
         // PlaybackHistory 信号连接
         connect(playbackHistory, &PlaybackHistory::recordAdded,
@@ -325,12 +869,18 @@ private:
             q, &PlaybackService::playbackHistoryChanged);
 
         // PlaybackQueue 信号连接
-        connect(playbackQueue, &PlaybackQueue::queueChanged,
-            this, &Impl::handleQueueChanged);
+        connect(playbackQueue, &PlaybackQueue::songsInserted,
+            this, &Impl::handleQueueSongsInserted);
+        connect(playbackQueue, &PlaybackQueue::songsRemoved,
+            this, &Impl::handleQueueSongsRemoved);
+        connect(playbackQueue, &PlaybackQueue::songMoved,
+            this, &Impl::handleQueueSongMoved);
     }
 
     void setupTimer() {
-        positionTimer->setInterval(100);
+        // 粗粒度定时器允许系统把唤醒与其他定时器合并；间隔可由界面按显示刷新率调整
+        positionTimer->setTimerType(Qt::CoarseTimer);
+        positionTimer->setInterval(positionIntervalMs);
         connect(positionTimer, &QTimer::timeout,
             this, &Impl::updatePosition);
     }
@@ -338,98 +888,477 @@ private:
     void setupSmartFeatures() {
         playlistManager->setPlaybackQueue(playbackQueue);
         playlistManager->setPlaybackHistory(playbackHistory);
+        QTimer::singleShot(kCatalogLoadDelayMs, this, &Impl::loadRecommendationCatalog);
 
         qDebug() << "PlaybackService: 智能播放功能已启用";
     }
 
-    // 会话恢复：从 AppConfig 恢复 列表/队列/当前歌曲/进度
-    void restoreSession() {
-        AppConfig& cfg = AppConfig::instance();
-        restoringSession = true;
+    // 整库读一次作为推荐候选；之后的增删改由 noteLibrarySong* 增量补上。
+    // 装载期间的增删改先记下，合并快照之后再重放，快照里已删除的歌曲不会被补回来
+    void loadRecommendationCatalog() {
+        catalogLoading = true;
+        auto promise = std::make_shared<QPromise<QList<Song>>>();
+        QFuture<QList<Song>> future = promise->future();
+        promise->start();
+
+        QThreadPool::globalInstance()->start([promise]() {
+            QList<Song> songs;
+            DatabaseManager& dbm = DatabaseManager::instance();
+            {
+                QSqlDatabase db = dbm.openThreadConnection(kCatalogConnectionName);
+                if (db.isOpen()) {
+                    SongRepository repo(kCatalogConnectionName);
+                    songs = repo.findAll();
+                }
+            }
+            dbm.closeThreadConnection(kCatalogConnectionName);
+            promise->addResult(songs);
+            promise->finish();
+            });
 
-        // 建立 id->Song 快速映射
-        QList<Song> allSongs = songRepository->findAll();
-        QHash<QString, Song> byId;
-        byId.reserve(allSongs.size());
-        for (const Song& s : allSongs) {
-            if (!s.getId().isEmpty()) byId.insert(s.getId(), s);
-        }
+        future.then(this, [this](const QList<Song>& songs) {
+            RecommendationEngine& recommender = playlistManager->recommender();
+            recommender.loadCatalog(songs);
+            for (const QString& id : std::as_const(pendingCatalogRemovals)) recommender.removeSong(id);
+            for (const Song& song : std::as_const(pendingCatalogUpserts)) recommender.upsertSong(song);
+            pendingCatalogRemovals.clear();
+            pendingCatalogUpserts.clear();
+            catalogLoading = false;
+            qDebug() << "PlaybackService: 推荐候选已装载，共" << playlistManager->recommender().size() << "首";
+            });
+    }
 
-        // 恢复播放列表
-        QList<Song> restoredPlaylist;
-        const QStringList plIds = cfg.getLastPlaylistIds();
-        for (const QString& id : plIds) {
-            auto it = byId.constFind(id);
-            if (it != byId.constEnd()) restoredPlaylist << it.value();
+    void noteLibrarySongChanged(const Song& song) {
+        if (catalogLoading) {
+            pendingCatalogRemovals.remove(song.getId());
+            pendingCatalogUpserts.insert(song.getId(), song);
+            return;
         }
+        playlistManager->recommender().upsertSong(song);
+    }
 
-        if (!restoredPlaylist.isEmpty()) {
-            playlistManager->setPlaylist(restoredPlaylist);
+    void noteLibrarySongRemoved(const QString& id) {
+        if (catalogLoading) {
+            pendingCatalogUpserts.remove(id);
+            pendingCatalogRemovals.insert(id);
+            return;
+        }
+        playlistManager->recommender().removeSong(id);
+    }
 
-            // 恢复队列
-            const QStringList qIds = cfg.getLastQueueIds();
-            for (const QString& id : qIds) {
-                auto it = byId.constFind(id);
-                if (it != byId.constEnd()) playbackQueue->enqueue(it.value());
-            }
+    // 会话恢复：从 SessionJournal 恢复 列表/队列/当前歌曲/进度
+    // 1) 主线程只按 id 查出上次播放的那一首，立即开始播放并恢复进度；
+    // 2) 播放列表与队列里其余歌曲在后台线程（独立连接）用一条 WHERE id IN (...) 批量查询，完成后再补全
+    void restoreSession() {
+        const SessionJournal& journal = SessionJournal::instance();
+        const QStringList plIds = journal.playlistIds();
+        if (plIds.isEmpty()) return;
 
-            // 当前歌曲索引
-            int idx = 0;
-            const QString lastId = cfg.getLastSongId();
-            if (!lastId.isEmpty()) {
-                for (int i = 0; i < restoredPlaylist.size(); ++i) {
-                    if (restoredPlaylist[i].getId() == lastId) { idx = i; break; }
-                }
-            }
-            playlistManager->setCurrentIndex(idx);
+        QString lastId = journal.lastSongId();
+        if (lastId.isEmpty() || !plIds.contains(lastId)) lastId = plIds.first();
 
-            // 自动播放并恢复进度
-            const Song cur = restoredPlaylist[idx];
-            if (safeStartSong(cur)) {
-                const qint64 resumePos = cfg.getLastPositionMs();
+        const Song cur = songRepository->findById(lastId);
+        bool startedEarly = false;
+        if (!cur.getId().isEmpty()) {
+            restoringSession = true;
+            playlistManager->setPlaylist({ cur });
+            startedEarly = safeStartSong(cur);
+            if (startedEarly) {
+                const qint64 resumePos = journal.lastPositionMs();
                 if (resumePos > 0) {
                     QTimer::singleShot(200, audioPlayer, [this, resumePos]() {
                         audioPlayer->setPosition(resumePos);
                         });
                 }
             }
-            else {
-                // 若当前歌无效，尝试下一首
-                q->playNext();
+            restoringSession = false;
+        }
+
+        hydrateSession(plIds, journal.queueIds(), lastId, startedEarly);
+    }
+
+    void hydrateSession(const QStringList& plIds, const QStringList& qIds, const QString& lastId, bool startedEarly) {
+        QStringList ids = plIds;
+        ids += qIds;
+        ids.removeDuplicates();
+        const quint64 revision = playlistManager->playlistRevision();
+
+        auto promise = std::make_shared<QPromise<QList<Song>>>();
+        QFuture<QList<Song>> future = promise->future();
+        promise->start();
+
+        QThreadPool::globalInstance()->start([promise, ids]() {
+            QList<Song> songs;
+            DatabaseManager& dbm = DatabaseManager::instance();
+            {
+                QSqlDatabase db = dbm.openThreadConnection(kRestoreConnectionName);
+                if (db.isOpen()) {
+                    SongRepository repo(kRestoreConnectionName);
+                    songs = repo.findByIds(ids);
+                }
             }
+            dbm.closeThreadConnection(kRestoreConnectionName);
+            promise->addResult(songs);
+            promise->finish();
+            });
+
+        future.then(this, [this, plIds, qIds, lastId, startedEarly, revision](const QList<Song>& songs) {
+            finishHydration(songs, plIds, qIds, lastId, startedEarly, revision);
+            });
+    }
+
+    void finishHydration(const QList<Song>& songs, const QStringList& plIds, const QStringList& qIds,
+        const QString& lastId, bool startedEarly, quint64 revision) {
+
+        // 补全前用户已经换过或改过播放列表（无论上一首是否已提前开播）：以用户的为准，不再覆盖
+        if (playlistManager->playlistRevision() != revision
+            || (startedEarly && playlistManager->getCurrentSong().getId() != lastId)) {
+            qDebug() << "PlaybackService: 会话补全前播放列表已变化，放弃补全";
+            // 日志里还是上次的完整列表，改记实际列表，之后的增量记录才能对上下标
+            SessionJournal::instance().setPlaylistIds(playlistManager->playlistIds());
+            return;
         }
 
+        QHash<QString, Song> byId;
+        byId.reserve(songs.size());
+        for (const Song& s : songs) byId.insert(s.getId(), s);
+
+        QList<Song> restoredPlaylist;
+        restoredPlaylist.reserve(plIds.size());
+        QList<int> restoredIndexOf(plIds.size(), -1);   // 日志中的列表下标 → 补全后的下标（查不到的歌曲为 -1）
+        int idx = 0;
+        for (int i = 0; i < plIds.size(); ++i) {
+            auto it = byId.constFind(plIds[i]);
+            if (it == byId.constEnd()) continue;
+            if (plIds[i] == lastId) idx = restoredPlaylist.size();
+            restoredIndexOf[i] = restoredPlaylist.size();
+            restoredPlaylist << it.value();
+        }
+        if (restoredPlaylist.isEmpty()) return;
+
+        // 随机排列按补全后的下标重新编号，跳过已不存在的歌曲
+        const SessionJournal& journal = SessionJournal::instance();
+        QList<int> shuffleOrder;
+        int shuffleCursor = -1;
+        const QList<int> savedOrder = journal.shuffleOrder();
+        if (savedOrder.size() == plIds.size()) {
+            shuffleOrder.reserve(restoredPlaylist.size());
+            for (int pos = 0; pos < savedOrder.size(); ++pos) {
+                const int saved = savedOrder[pos];
+                const int mapped = (saved >= 0 && saved < plIds.size()) ? restoredIndexOf[saved] : -1;
+                if (mapped < 0) continue;
+                if (pos <= journal.shuffleCursor()) shuffleCursor = shuffleOrder.size();
+                shuffleOrder << mapped;
+            }
+        }
+
+        QList<Song> restoredQueue;
+        for (const QString& id : qIds) {
+            auto it = byId.constFind(id);
+            if (it != byId.constEnd()) restoredQueue << it.value();
+        }
+
+        restoringSession = true;
+        // 正在播放的就是 idx 这一首：只替换列表，setPlaylist 复位到 0 的中间状态不通知界面
+        suppressSongAnnounce = startedEarly;
+        playlistManager->setPlaylist(restoredPlaylist);
+        if (!shuffleOrder.isEmpty()) playlistManager->restoreShuffleOrder(shuffleOrder, shuffleCursor);
+        playlistManager->setCurrentIndex(idx);
+        suppressSongAnnounce = false;
+        if (!restoredQueue.isEmpty()) playbackQueue->enqueueList(restoredQueue);
         restoringSession = false;
+        // 数据库里查不到的歌曲已被跳过：以实际列表与队列为准，之后的增量记录才能对上下标
+        SessionJournal::instance().setPlaylistIds(playlistManager->playlistIds());
+        SessionJournal::instance().setQueueIds(playbackQueue->ids());
+        persistShuffleOrder();
+
+        qDebug() << "PlaybackService: 会话已补全，列表" << restoredPlaylist.size()
+            << "首，队列" << restoredQueue.size() << "首";
+
+        if (!startedEarly) {
+            // 上次的歌曲无效：从补全后的列表继续
+            if (!safeStartSong(restoredPlaylist[idx])) playNext();
+        }
+    }
+
+public:
+    // ========== 命令（引擎线程） ==========
+    void playSong(const Song& song) {
+        if (song.getId().isEmpty()) {
+            qWarning() << "PlaybackService::playSong: 歌曲 ID 为空";
+            return;
+        }
+
+        qDebug() << "PlaybackService: 播放歌曲:" << song.getTitle();
+
+        // 上一首若是中途切走，记下听了多久（用于跳过率）
+        playbackHistory->closeCurrentRecord(audioPlayer->position());
+        playbackHistory->addRecord(song);
+
+        int songIndex = playlistManager->findSongIndex(song);
+        if (songIndex == -1) {
+            playlistManager->addSong(song);
+            songIndex = playlistManager->getPlaylistSize() - 1;
+        }
+
+        playlistManager->setCurrentIndex(songIndex);
+
+        // 播放前校验文件，静音兜底
+        if (!safeStartSong(song)) {
+            // 跳到下一首（将触发自动错误跳过路径）
+            playNext();
+        }
+    }
+
+    void playPlaylist(const QList<Song>& playlist, int startIndex) {
+        if (playlist.isEmpty()) {
+            qWarning() << "PlaybackService::playPlaylist: 播放列表为空";
+            return;
+        }
+
+        if (startIndex < 0 || startIndex >= playlist.size()) {
+            startIndex = 0;
+        }
+
+        qDebug() << "PlaybackService: 播放播放列表，起始歌曲:"
+            << playlist[startIndex].getTitle();
+
+        playlistManager->setPlaylist(playlist);
+        playlistManager->setCurrentIndex(startIndex);
+
+        playSong(playlist[startIndex]);
+    }
+
+    void togglePlayPause() {
+        qDebug() << "[Service] togglePlayPause() enter."
+            << "state=" << (int)currentState
+            << "vol=" << audioPlayer->volume()
+            << "posMs=" << audioPlayer->position();
+
+        switch (currentState) {
+        case PlaybackState::Playing:
+            qDebug() << "[Service] request: pause()";
+            audioPlayer->pause();
+            break;
+        case PlaybackState::Paused:
+            if (audioPlayer->volume() == 0 && lastUserVolume > 0) {
+                qDebug() << "[Service] paused->resume with vol restore to" << lastUserVolume;
+                audioPlayer->setVolume(lastUserVolume);
+            }
+            else {
+                qDebug() << "[Service] paused->resume keep vol=" << audioPlayer->volume();
+            }
+            audioPlayer->resume();
+            break;
+        case PlaybackState::Stopped:
+            if (playlistManager->hasCurrentSong()) {
+                qDebug() << "[Service] stopped->play currentSong";
+                playSong(playlistManager->getCurrentSong());
+            }
+            else {
+                qDebug() << "[Service] stopped AND no currentSong";
+            }
+            break;
+        }
+
+        QTimer::singleShot(80, this, [this]() {
+            qDebug() << "[Service] togglePlayPause() post."
+                << "state=" << (int)currentState
+                << "vol=" << audioPlayer->volume()
+                << "posMs=" << audioPlayer->position();
+            });
+    }
+
+    void stop() {
+        cancelDownloadWait();
+        audioPlayer->stop();
+    }
+
+    void playNext() {
+        // 1) 播放队列优先
+        if (!playbackQueue->isEmpty()) {
+            playSong(playbackQueue->dequeue());
+            return;
+        }
+
+        // 2) 模式分支
+        PlaybackMode mode = playlistManager->getPlaybackMode();
+
+        if (mode == PlaybackMode::Shuffle) {
+            Song s = playlistManager->getSmartNextSong();
+            if (!s.getId().isEmpty()) playSong(s);
+            return;
+        }
+
+        // 手动“下一首”：RepeatOne 也按顺序推进
+        const int size = playlistManager->getPlaylistSize();
+        if (size <= 0) return;
+
+        int idx = playlistManager->getCurrentIndex();
+        int nextIndex = idx + 1;
+
+        if (nextIndex >= size) {
+            // 手动下一首：Normal/RepeatAll 都从头开始
+            nextIndex = 0;
+        }
+
+        playSong(playlistManager->songAt(nextIndex));
+    }
+
+    void playPrevious() {
+        // 2 秒规则：>2s 回到本曲开头
+        if (audioPlayer->position() > 2000) {
+            seek(0);
+            return;
+        }
+
+        PlaybackMode mode = playlistManager->getPlaybackMode();
+
+        if (mode == PlaybackMode::Shuffle) {
+            Song s = playlistManager->getSmartPreviousSong();
+            if (!s.getId().isEmpty()) playSong(s);
+            return;
+        }
+
+        const int size = playlistManager->getPlaylistSize();
+        if (size <= 0) return;
+
+        int idx = playlistManager->getCurrentIndex();
+        int prevIndex = idx - 1;
+
+        if (prevIndex < 0) {
+            // 手动上一首：Normal/RepeatAll 跳到最后
+            prevIndex = size - 1;
+        }
+
+        playSong(playlistManager->songAt(prevIndex));
+    }
+
+    void seek(qint64 position) {
+        audioPlayer->setPosition(position);
+        notePosition(position);
+    }
+
+    void setVolume(int volume) {
+        audioPlayer->setVolume(volume);
+        if (volume > 0) lastUserVolume = volume;
+        SessionJournal::instance().setVolume(volume);
+    }
+
+    void setPositionUpdatesSuspended(bool suspended) {
+        if (positionSuspended == suspended) return;
+        positionSuspended = suspended;
+        updatePositionTimer();
+        // 恢复显示时立即补发当前位置，不等下一次定时
+        if (!suspended) {
+            lastPublishedPositionMs = -1;
+            publishPosition(audioPlayer->position());
+        }
+        qDebug() << "[Service] 位置推送" << (suspended ? "已暂停（界面不可见）" : "已恢复");
+    }
+
+    void setLoopPoints(qint64 a, qint64 b) {
+        loopA = a;
+        loopB = b;
+        syncLoopRegion();
+        scheduleArmNext();
+        emit q->loopABChanged(loopA, loopB);
     }
 
 public:
     PlaybackService* q;
+    QThread* engineThread;              // 属于界面线程（PlaybackService 创建并负责停止）
     AudioPlayer* audioPlayer;
     PlaylistManager* playlistManager;
     PlaybackHistory* playbackHistory;
     PlaybackQueue* playbackQueue;
     SongRepository* songRepository;
     QTimer* positionTimer;
+    std::atomic<int> positionIntervalMs{ 250 };
+    bool positionSuspended = false;       // 窗口隐藏/最小化时暂停推送
+    qint64 lastPublishedPositionMs = -1;
 
     PlaybackState currentState;
 
+    // 界面查询读取的状态（引擎写，任意线程读）
+    std::atomic<std::shared_ptr<const Snapshot>> snapshot;
+    std::atomic<qint64> positionMs{ 0 };
+    std::atomic<qint64> positionStampMs{ 0 };
+
     // A-B 循环点
     qint64 loopA;
     qint64 loopB;
+    bool loopInRenderer = false;        // 当前 A-B 区间由渲染层采样级回绕
 
-    // 配置持久化合并
+    // 配置持久化合并（saveDebounce / pendingSave 只在界面线程使用）
     QTimer* saveDebounce;
     bool restoringSession;
+    bool suppressSongAnnounce = false;   // 补全替换列表时，正在播放的歌曲不变，不再发出“当前歌曲变化”
     bool pendingSave;
     qint64 lastSavedPositionMs;
     int lastUserVolume;
+
+    // 预加载的下一首
+    std::atomic<bool> gaplessEnabled{ true };
+    bool armScheduled = false;
+    Song armedSong;
+    bool armedFromQueue = false;
+    std::atomic<qint64> lastTrackChangeLatencyMs{ -1 };
+    std::atomic<int> crossfadeMs{ 0 };
+    std::atomic<bool> renderPipelineEnabled{ false };
+
+    static constexpr int kCatalogLoadDelayMs = 3000;   // 错开启动时的会话恢复
+    bool catalogLoading = false;
+    QHash<QString, Song> pendingCatalogUpserts;
+    QSet<QString> pendingCatalogRemovals;
+
+    // 预读
+    TrackPrefetcher prefetcher;
+    std::atomic<int> prefetchTrackCount{ 3 };
+
+    // 与下载协同
+    static constexpr int kDownloadLookahead = 10;           // 当前之后看多少首
+    static constexpr int kDownloadPromotionDelayMs = 200;
+    static constexpr int kDownloadWaitMs = 10000;
+    static constexpr double kDownloadWaitMinProgress = 0.8; // 进度达到此值才值得等
+    ConcurrentDownloadManager* downloads = nullptr;
+    bool promotionScheduled = false;
+    QTimer* downloadWaitTimer = nullptr;
+    QString awaitedDownloadTaskId;
+    Song awaitedSong;
 };
 
 // PlaybackService 主类实现
 PlaybackService::PlaybackService(QObject* parent)
     : QObject(parent)
-    , d(new Impl(this))
+    , d(nullptr)
 {
+    // 跨线程信号的参数类型
+    qRegisterMetaType<Song>();
+    qRegisterMetaType<QList<Song>>();
+    qRegisterMetaType<PlaybackState>();
+    qRegisterMetaType<PlaybackMode>();
+    qRegisterMetaType<PlaybackRecord>();
+
+    QThread* thread = new QThread(this);
+    thread->setObjectName("PlaybackEngine");
+    thread->start(QThread::HighestPriority);
+
+    // 引擎对象（含 QMediaPlayer / 音频输出 / 定时器）在引擎线程上创建
+    // 下载管理器单例须在界面线程创建，引擎只持有指针
+    ConcurrentDownloadManager* downloads = &ConcurrentDownloadManager::instance();
+
+    QObject anchor;
+    anchor.moveToThread(thread);
+    QMetaObject::invokeMethod(&anchor, [this, thread, downloads]() {
+        d = new Impl(this, thread, downloads);
+        }, Qt::BlockingQueuedConnection);
+    d->setupConfigSave();
+
+    if (QCoreApplication* app = QCoreApplication::instance()) {
+        connect(app, &QCoreApplication::aboutToQuit, this, &PlaybackService::shutdown);
+    }
+    qDebug() << "[Service] 播放引擎线程已启动";
 }
 
 PlaybackService& PlaybackService::instance() {
@@ -437,317 +1366,370 @@ PlaybackService& PlaybackService::instance() {
     return instance;
 }
 
-// 基础播放控制
-void PlaybackService::playSong(const Song& song) {
-    if (song.getId().isEmpty()) {
-        qWarning() << "PlaybackService::playSong: 歌曲 ID 为空";
-        return;
-    }
+void PlaybackService::shutdown() {
+    if (!d) return;
 
-    qDebug() << "PlaybackService: 播放歌曲:" << song.getTitle();
-
-    d->playbackHistory->addRecord(song);
-
-    int songIndex = d->playlistManager->findSongIndex(song);
-    if (songIndex == -1) {
-        d->playlistManager->addSong(song);
-        songIndex = d->playlistManager->getPlaylistSize() - 1;
-    }
+    // 配置保存的合并定时器在界面线程、回调引用 Impl：先落盘再删掉
+    d->saveDebounce->stop();
+    delete d->saveDebounce;
+    if (d->pendingSave) AppConfig::instance().save();
 
-    d->playlistManager->setCurrentIndex(songIndex);
+    QThread* thread = d->engineThread;
+    QMetaObject::invokeMethod(d, [this]() { d->shutdownEngine(); }, Qt::BlockingQueuedConnection);
+    thread->quit();
+    thread->wait();     // 线程结束前处理完延迟删除，Impl 此时已在引擎线程析构
+    d = nullptr;
+    qDebug() << "[Service] 播放引擎线程已停止";
+}
 
-    // 播放前校验文件，静音兜底
-    if (!d->safeStartSong(song)) {
-        // 跳到下一首（将触发自动错误跳过路径）
-        playNext();
-    }
+// 基础播放控制
+void PlaybackService::playSong(const Song& song) {
+    if (!d) return;
+    d->post([this, song]() { d->playSong(song); });
 }
 
 void PlaybackService::playPlaylist(const QList<Song>& playlist, int startIndex) {
-    if (playlist.isEmpty()) {
-        qWarning() << "PlaybackService::playPlaylist: 播放列表为空";
-        return;
-    }
-
-    if (startIndex < 0 || startIndex >= playlist.size()) {
-        startIndex = 0;
-    }
-
-    qDebug() << "PlaybackService: 播放播放列表，起始歌曲:"
-        << playlist[startIndex].getTitle();
-
-    d->playlistManager->setPlaylist(playlist);
-    d->playlistManager->setCurrentIndex(startIndex);
-
-    playSong(playlist[startIndex]);
+    if (!d) return;
+    d->post([this, playlist, startIndex]() { d->playPlaylist(playlist, startIndex); });
 }
 
 void PlaybackService::togglePlayPause() {
-    qDebug() << "[Service] togglePlayPause() enter."
-        << "state=" << (int)d->currentState
-        << "vol=" << d->audioPlayer->volume()
-        << "posMs=" << d->audioPlayer->position();
-
-    switch (d->currentState) {
-    case PlaybackState::Playing:
-        qDebug() << "[Service] request: pause()";
-        d->audioPlayer->pause();
-        break;
-    case PlaybackState::Paused:
-        if (d->audioPlayer->volume() == 0 && d->lastUserVolume > 0) {
-            qDebug() << "[Service] paused->resume with vol restore to" << d->lastUserVolume;
-            d->audioPlayer->setVolume(d->lastUserVolume);
-        }
-        else {
-            qDebug() << "[Service] paused->resume keep vol=" << d->audioPlayer->volume();
-        }
-        d->audioPlayer->resume();
-        break;
-    case PlaybackState::Stopped:
-        if (d->playlistManager->hasCurrentSong()) {
-            qDebug() << "[Service] stopped->play currentSong";
-            playSong(d->playlistManager->getCurrentSong());
-        }
-        else {
-            qDebug() << "[Service] stopped AND no currentSong";
-        }
-        break;
-    }
-
-    QTimer::singleShot(80, d, [this]() {
-        qDebug() << "[Service] togglePlayPause() post."
-            << "state=" << (int)d->currentState
-            << "vol=" << d->audioPlayer->volume()
-            << "posMs=" << d->audioPlayer->position();
-        });
+    if (!d) return;
+    d->post([this]() { d->togglePlayPause(); });
 }
 
 void PlaybackService::stop() {
-    d->audioPlayer->stop();
+    if (!d) return;
+    d->post([this]() { d->stop(); });
 }
 
 void PlaybackService::playNext() {
-    // 1) 播放队列优先
-    const QList<Song> queue = d->playbackQueue->getQueue();
-    if (!queue.isEmpty()) {
-        Song head = queue.first();
-        d->playbackQueue->dequeue();
-        playSong(head);
-        return;
-    }
-
-    // 2) 模式分支
-    PlaybackMode mode = d->playlistManager->getPlaybackMode();
-
-    if (mode == PlaybackMode::Shuffle) {
-        Song s = d->playlistManager->getSmartNextSong();
-        if (!s.getId().isEmpty()) playSong(s);
-        return;
-    }
-
-    // 手动“下一首”：RepeatOne 也按顺序推进
-    const QList<Song> pl = d->playlistManager->getPlaylist();
-    const int size = pl.size();
-    if (size <= 0) return;
-
-    int idx = d->playlistManager->getCurrentIndex();
-    int nextIndex = idx + 1;
-
-    if (nextIndex >= size) {
-        // 手动下一首：Normal/RepeatAll 都从头开始
-        nextIndex = 0;
-    }
-
-    playSong(pl[nextIndex]);
+    if (!d) return;
+    d->post([this]() { d->playNext(); });
 }
 
 void PlaybackService::playPrevious() {
-    // 2 秒规则：>2s 回到本曲开头
-    if (d->audioPlayer->position() > 2000) {
-        d->audioPlayer->setPosition(0);
-        return;
-    }
-
-    PlaybackMode mode = d->playlistManager->getPlaybackMode();
-
-    if (mode == PlaybackMode::Shuffle) {
-        Song s = d->playlistManager->getSmartPreviousSong();
-        if (!s.getId().isEmpty()) playSong(s);
-        return;
-    }
-
-    const QList<Song> pl = d->playlistManager->getPlaylist();
-    const int size = pl.size();
-    if (size <= 0) return;
-
-    int idx = d->playlistManager->getCurrentIndex();
-    int prevIndex = idx - 1;
-
-    if (prevIndex < 0) {
-        // 手动上一首：Normal/RepeatAll 跳到最后
-        prevIndex = size - 1;
-    }
-
-    playSong(pl[prevIndex]);
+    if (!d) return;
+    d->post([this]() { d->playPrevious(); });
 }
 
 void PlaybackService::seek(qint64 position) {
-    d->audioPlayer->setPosition(position);
+    if (!d) return;
+    d->post([this, position]() { d->seek(position); });
 }
 
-// 状态查询
+// 状态查询（读快照，不等待引擎）
 PlaybackState PlaybackService::getPlaybackState() const {
-    return d->currentState;
+    if (!d) return PlaybackState::Stopped;
+    return d->currentSnapshot()->state;
 }
 
 bool PlaybackService::isPlaying() const {
-    return d->currentState == PlaybackState::Playing;
+    return getPlaybackState() == PlaybackState::Playing;
 }
 
 bool PlaybackService::isPaused() const {
-    return d->currentState == PlaybackState::Paused;
+    return getPlaybackState() == PlaybackState::Paused;
 }
 
 Song PlaybackService::getCurrentSong() const {
-    return d->playlistManager->getCurrentSong();
+    if (!d) return Song();
+    return d->currentSnapshot()->currentSong;
 }
 
 qint64 PlaybackService::getCurrentPosition() const {
-    return d->audioPlayer->position();
+    if (!d) return 0;
+    return d->estimatedPosition();
 }
 
 qint64 PlaybackService::getDuration() const {
-    return d->audioPlayer->duration();
+    if (!d) return 0;
+    return d->currentSnapshot()->durationMs;
 }
 
 PlaybackMode PlaybackService::getPlaybackMode() const {
-    return d->playlistManager->getPlaybackMode();
+    if (!d) return PlaybackMode::Normal;
+    return d->currentSnapshot()->mode;
 }
 
 void PlaybackService::setPlaybackMode(PlaybackMode mode) {
-    d->playlistManager->setPlaybackMode(mode);
-    // 持久化（防抖）
-    AppConfig& cfg = AppConfig::instance();
-    cfg.setPlayerPlaybackMode(intFromMode(mode));
-    d->scheduleConfigSave();
+    if (!d) return;
+    // 持久化在模式变化的回调里完成（防抖）
+    d->post([this, mode]() { d->playlistManager->setPlaybackMode(mode); });
 }
 
 int PlaybackService::getVolume() const {
-    return d->audioPlayer->volume();
+    if (!d) return 0;
+    return d->currentSnapshot()->volume;
 }
 
 void PlaybackService::setVolume(int volume) {
-    d->audioPlayer->setVolume(volume);
-    if (volume > 0) d->lastUserVolume = volume;
-    // 持久化（防抖）
-    AppConfig& cfg = AppConfig::instance();
-    cfg.setPlayerVolume(volume);
-    d->scheduleConfigSave();
+    if (!d) return;
+    d->post([this, volume]() { d->setVolume(volume); });
 }
 
-QList<Song> PlaybackService::getCurrentPlaylist() const {
-    return d->playlistManager->getPlaylist();
+QList<Song> PlaybackService::getCurrentPlaylist(quint64* revision) const {
+    if (!d) return {};
+    // 在引擎上取：歌曲与版本号一致，且不会查到已释放的 ID
+    const auto result = d->call([this]() {
+        return std::make_pair(d->playlistManager->getPlaylist(), d->playlistManager->playlistRevision());
+        });
+    if (revision) *revision = result.second;
+    return result.first;
 }
 
 int PlaybackService::getCurrentSongIndex() const {
-    return d->playlistManager->getCurrentIndex();
+    if (!d) return 0;
+    return d->currentSnapshot()->currentIndex;
 }
 
 void PlaybackService::addToQueue(const Song& song) {
-    d->playbackQueue->enqueue(song);
+    if (!d) return;
+    d->post([this, song]() { d->playbackQueue->enqueue(song); });
 }
 
 void PlaybackService::addNextToQueue(const Song& song) {
-    d->playbackQueue->enqueueNext(song);
+    if (!d) return;
+    d->post([this, song]() { d->playbackQueue->enqueueNext(song); });
+}
+
+void PlaybackService::insertIntoQueue(int index, const QList<Song>& songs) {
+    if (!d) return;
+    if (songs.isEmpty()) return;
+    d->post([this, index, songs]() { d->playbackQueue->insertSongs(index, songs); });
 }
 
-QList<Song> PlaybackService::getPlaybackQueue() const {
-    return d->playbackQueue->getQueue();
+QList<Song> PlaybackService::getPlaybackQueue(quint64* revision) const {
+    if (!d) return {};
+    // 只在首次填充与版本不接续时调用：在引擎上取，歌曲与版本号一致
+    const auto result = d->call([this]() {
+        return std::make_pair(d->playbackQueue->getQueue(), d->playbackQueue->revision());
+        });
+    if (revision) *revision = result.second;
+    return result.first;
 }
 
 void PlaybackService::clearPlaybackQueue() {
-    d->playbackQueue->clear();
+    if (!d) return;
+    d->post([this]() { d->playbackQueue->clear(); });
 }
 
-void PlaybackService::removeFromQueue(int index) {
-    d->playbackQueue->removeSong(index);
+void PlaybackService::removeFromQueue(int index, int count) {
+    if (!d) return;
+    d->post([this, index, count]() { d->playbackQueue->removeRange(index, count); });
 }
 
 void PlaybackService::moveInQueue(int from, int to) {
-    d->playbackQueue->moveSong(from, to);
+    if (!d) return;
+    d->post([this, from, to]() { d->playbackQueue->moveSong(from, to); });
 }
 
+// 历史与统计：阻塞查询引擎
 QList<PlaybackRecord> PlaybackService::getPlaybackHistory(int count) const {
-    return d->playbackHistory->getRecentRecords(count);
+    if (!d) return {};
+    return d->call([this, count]() { return d->playbackHistory->getRecentRecords(count); });
 }
 
 Song PlaybackService::getMostPlayedSong() const {
-    return d->playbackHistory->getMostPlayedSong();
+    if (!d) return Song();
+    return d->call([this]() { return d->playbackHistory->getMostPlayedSong(); });
 }
 
 QList<Song> PlaybackService::getFrequentlyPlayedSongs(int count) const {
-    return d->playbackHistory->getFrequentlyPlayedSongs(count);
+    if (!d) return {};
+    return d->call([this, count]() { return d->playbackHistory->getFrequentlyPlayedSongs(count); });
 }
 
 qint64 PlaybackService::getTotalListeningTime() const {
-    return d->playbackHistory->getTotalListeningTime();
+    if (!d) return 0;
+    return d->call([this]() { return d->playbackHistory->getTotalListeningTime(); });
 }
 
 int PlaybackService::getPlayCount(const Song& song) const {
-    return d->playbackHistory->getTotalPlayCount(song);
+    if (!d) return 0;
+    return d->call([this, song]() { return d->playbackHistory->getTotalPlayCount(song); });
 }
 
 qint64 PlaybackService::getTotalPlayDuration(const Song& song) const {
-    return d->playbackHistory->getTotalPlayDuration(song);
+    if (!d) return 0;
+    return d->call([this, song]() { return d->playbackHistory->getTotalPlayDuration(song); });
 }
 
 void PlaybackService::clearPlaybackHistory() {
-    d->playbackHistory->clearHistory();
-    emit playbackHistoryChanged();
+    if (!d) return;
+    d->post([this]() {
+        d->playbackHistory->clearHistory();
+        d->playlistManager->recommender().clearHistory();
+        emit playbackHistoryChanged();
+        });
 }
 
 QList<Song> PlaybackService::generateSmartPlaylist(int maxSongs) const {
-    return d->playlistManager->generateSmartPlaylist(maxSongs);
+    if (!d) return {};
+    return d->call([this, maxSongs]() { return d->playlistManager->generateSmartPlaylist(maxSongs); });
 }
 
 void PlaybackService::createSmartPlaylist(int maxSongs) {
-    QList<Song> smartPlaylist = d->playlistManager->createAndNotifySmartPlaylist(maxSongs);
-    if (!smartPlaylist.isEmpty()) {
-        playPlaylist(smartPlaylist);
-    }
+    if (!d) return;
+    d->post([this, maxSongs]() {
+        QList<Song> smartPlaylist = d->playlistManager->createAndNotifySmartPlaylist(maxSongs);
+        if (!smartPlaylist.isEmpty()) {
+            d->playPlaylist(smartPlaylist, 0);
+        }
+        });
+}
+
+void PlaybackService::noteLibrarySongChanged(const Song& song) {
+    if (!d) return;
+    d->post([this, song]() { d->noteLibrarySongChanged(song); });
+}
+
+void PlaybackService::noteLibrarySongRemoved(const QString& id) {
+    if (!d) return;
+    d->post([this, id]() { d->noteLibrarySongRemoved(id); });
 }
 
 void PlaybackService::resetShuffleHistory() {
-    d->playlistManager->resetShuffleHistory();
+    if (!d) return;
+    d->post([this]() { d->playlistManager->resetShuffleHistory(); });
 }
 
 void PlaybackService::playSmartNext() {
-    Song nextSong = d->playlistManager->getSmartNextSong();
-    if (!nextSong.getId().isEmpty()) {
-        playSong(nextSong);
-    }
+    if (!d) return;
+    d->post([this]() {
+        Song nextSong = d->playlistManager->getSmartNextSong();
+        if (!nextSong.getId().isEmpty()) {
+            d->playSong(nextSong);
+        }
+        });
 }
 
 void PlaybackService::playSmartPrevious() {
-    Song prevSong = d->playlistManager->getSmartPreviousSong();
-    if (!prevSong.getId().isEmpty()) {
-        playSong(prevSong);
-    }
+    if (!d) return;
+    d->post([this]() {
+        Song prevSong = d->playlistManager->getSmartPreviousSong();
+        if (!prevSong.getId().isEmpty()) {
+            d->playSong(prevSong);
+        }
+        });
+}
+
+// ========== 位置推送 ==========
+void PlaybackService::setPositionUpdateInterval(int ms) {
+    if (!d) return;
+    d->positionIntervalMs = qBound(10, ms, 1000);
+    d->post([this]() { d->positionTimer->setInterval(d->positionIntervalMs); });
+}
+
+int PlaybackService::positionUpdateInterval() const {
+    if (!d) return 0;
+    return d->positionIntervalMs;
+}
+
+void PlaybackService::setPositionUpdatesSuspended(bool suspended) {
+    if (!d) return;
+    d->post([this, suspended]() { d->setPositionUpdatesSuspended(suspended); });
 }
 
 // A-B 循环
 void PlaybackService::setLoopA(qint64 ms) {
-    d->loopA = ms < 0 ? -1 : ms;
-    emit loopABChanged(d->loopA, d->loopB);
+    if (!d) return;
+    d->post([this, ms]() { d->setLoopPoints(ms < 0 ? -1 : ms, d->loopB); });
 }
 void PlaybackService::setLoopB(qint64 ms) {
-    d->loopB = ms < 0 ? -1 : ms;
-    emit loopABChanged(d->loopA, d->loopB);
+    if (!d) return;
+    d->post([this, ms]() { d->setLoopPoints(d->loopA, ms < 0 ? -1 : ms); });
 }
 void PlaybackService::clearLoopAB() {
-    d->loopA = -1;
-    d->loopB = -1;
-    emit loopABChanged(d->loopA, d->loopB);
+    if (!d) return;
+    d->post([this]() { d->setLoopPoints(-1, -1); });
+}
+
+// ========== 无缝衔接 ==========
+void PlaybackService::setGaplessPlayback(bool enabled) {
+    if (!d) return;
+    if (d->gaplessEnabled == enabled) return;
+    d->gaplessEnabled = enabled;
+    d->post([this]() { d->scheduleArmNext(); });
+}
+
+bool PlaybackService::gaplessPlayback() const {
+    if (!d) return false;
+    return d->gaplessEnabled;
+}
+
+// ========== 随机播放 ==========
+void PlaybackService::setWeightedShuffle(bool enabled) {
+    if (!d) return;
+    d->post([this, enabled]() { d->playlistManager->setWeightedShuffle(enabled); });
+}
+
+void PlaybackService::setCrossfadeDuration(int ms) {
+    if (!d) return;
+    d->crossfadeMs = qBound(0, ms, 12000);
+    d->post([this, ms]() { d->audioPlayer->setCrossfadeDuration(ms); });
+}
+
+int PlaybackService::crossfadeDuration() const {
+    if (!d) return 0;
+    return d->crossfadeMs;
+}
+
+qint64 PlaybackService::lastTrackChangeLatency() const {
+    if (!d) return 0;
+    return d->lastTrackChangeLatencyMs;
+}
+
+// ========== 预读 ==========
+void PlaybackService::setPrefetchTrackCount(int count) {
+    if (!d) return;
+    d->prefetchTrackCount = qBound(0, count, 20);
+    d->post([this]() { d->scheduleArmNext(); });
+}
+
+int PlaybackService::prefetchTrackCount() const {
+    if (!d) return 0;
+    return d->prefetchTrackCount;
+}
+
+void PlaybackService::setPrefetchBudgetMb(int mb) {
+    if (!d) return;
+    d->prefetcher.setBudgetBytes(qint64(qMax(0, mb)) * 1024 * 1024);
+}
+
+TrackPrefetcher::Stats PlaybackService::prefetchStats() const {
+    if (!d) return {};
+    return d->prefetcher.stats();
+}
+
+// ========== 渲染管线与 DSP ==========
+void PlaybackService::setRenderPipelineEnabled(bool enabled) {
+    if (!d) return;
+    d->renderPipelineEnabled = enabled;
+    d->post([this, enabled]() {
+        d->audioPlayer->setRenderPipelineEnabled(enabled);
+        d->scheduleArmNext();
+        });
+}
+
+bool PlaybackService::renderPipelineEnabled() const {
+    if (!d) return false;
+    return d->renderPipelineEnabled;
+}
+
+void PlaybackService::setEqualizerGains(const QList<int>& gainsDb) {
+    if (!d) return;
+    d->post([this, gainsDb]() { d->audioPlayer->setEqualizer(DspChain::graphicEqBands(gainsDb)); });
+}
+
+void PlaybackService::setLimiterEnabled(bool enabled) {
+    if (!d) return;
+    d->post([this, enabled]() { d->audioPlayer->setLimiterEnabled(enabled); });
+}
+
+double PlaybackService::dspMicrosPerSecond() const {
+    if (!d) return 0.0;
+    return d->call([this]() { return d->audioPlayer->dspMicrosPerSecond(); });
 }
 
 #include "PlaybackService.moc"
@@ -4,9 +4,18 @@
 #include "../common/entities/Song.h"
 #include "../common/PlaybackMode.h"
 #include "../common/PlaybackState.h"
+#include "TrackPrefetcher.h"
 
 struct PlaybackRecord;
 
+/**
+ * @brief 播放服务（界面线程的门面）
+ *
+ * 播放引擎（播放器、列表/队列推进、历史）运行在独立的 PlaybackEngine 线程上：
+ * 修改类方法只是投递命令，立即返回；查询方法读取引擎发布的状态快照；
+ * 信号由引擎线程发出，界面线程的接收者按排队连接收到。
+ * 历史统计类查询会阻塞等待引擎执行，不要在高频路径上调用。
+ */
 class PlaybackService : public QObject {
     Q_OBJECT
 
@@ -14,6 +23,9 @@ public:
     explicit PlaybackService(QObject* parent = nullptr);
     static PlaybackService& instance();
 
+    // 停止引擎线程并释放引擎对象（应用退出时自动调用）；之后的调用均为空操作，查询返回默认值
+    void shutdown();
+
     // 基础播放控制
     void playSong(const Song& song);
     void playPlaylist(const QList<Song>& playlist, int startIndex = 0);
@@ -40,14 +52,15 @@ public:
     void setVolume(int volume);
 
     // 播放列表管理
-    QList<Song> getCurrentPlaylist() const;
+    QList<Song> getCurrentPlaylist(quint64* revision = nullptr) const;   // 阻塞等待引擎，O(n)；平时靠增量信号
     int getCurrentSongIndex() const;
 
     void addToQueue(const Song& song);
     void addNextToQueue(const Song& song);
-    QList<Song> getPlaybackQueue() const;
+    void insertIntoQueue(int index, const QList<Song>& songs);   // 一次插入一段；index < 0 或越界时追加到末尾
+    QList<Song> getPlaybackQueue(quint64* revision = nullptr) const;   // 阻塞等待引擎，O(n)；平时靠增量信号
     void clearPlaybackQueue();
-    void removeFromQueue(int index);
+    void removeFromQueue(int index, int count = 1);
     void moveInQueue(int from, int to);
 
     QList<PlaybackRecord> getPlaybackHistory(int count = 50) const;
@@ -58,13 +71,44 @@ public:
     qint64 getTotalPlayDuration(const Song& song) const;
     void clearPlaybackHistory();
 
+    // 智能播放列表：按播放特征（近期播放、完播 / 跳过率、收藏、歌手偏好）打分取前 maxSongs 首
     QList<Song> generateSmartPlaylist(int maxSongs = 20) const;
     void createSmartPlaylist(int maxSongs = 20);  // 生成并应用智能播放列表
-    void resetShuffleHistory();
+    // 曲库变化（入库 / 修改 / 收藏 / 删除），维护推荐候选
+    void noteLibrarySongChanged(const Song& song);
+    void noteLibrarySongRemoved(const QString& id);
+    void resetShuffleHistory();                 // 随机模式下以当前歌曲为首重新洗牌
+    void setWeightedShuffle(bool enabled);      // 加权随机：收藏的歌曲更可能排在前面
 
     void playSmartNext();      // 使用智能逻辑播放下一首
     void playSmartPrevious();  // 使用智能逻辑播放上一首
 
+    // 位置推送：positionChanged 由单一定时器按间隔合并发出（默认 250ms，范围 10~1000ms）；
+    // 界面不可见时可暂停推送，恢复时立即补发一次
+    void setPositionUpdateInterval(int ms);
+    int positionUpdateInterval() const;
+    void setPositionUpdatesSuspended(bool suspended);
+
+    // 无缝衔接：提前把下一首加载到待命播放器，结尾直接切换；交叉淡化 0 表示不淡化（最长 12000ms）
+    void setGaplessPlayback(bool enabled);
+    bool gaplessPlayback() const;
+    void setCrossfadeDuration(int ms);
+    int crossfadeDuration() const;
+    qint64 lastTrackChangeLatency() const;   // 最近一次换曲延迟（毫秒），-1 表示尚未测量
+
+    // 预读：接下来 N 首（0 关闭，最多 20）在低优先级线程读入页缓存，总量受预算限制
+    void setPrefetchTrackCount(int count);
+    int prefetchTrackCount() const;
+    void setPrefetchBudgetMb(int mb);
+    TrackPrefetcher::Stats prefetchStats() const;
+
+    // 自有渲染管线（QAudioDecoder → 均衡/限幅/增益斜坡 → QAudioSink），下一首生效；开启后不做无缝预加载
+    void setRenderPipelineEnabled(bool enabled);
+    bool renderPipelineEnabled() const;
+    void setEqualizerGains(const QList<int>& gainsDb);   // 对应 DspChain::kGraphicEqFrequencies
+    void setLimiterEnabled(bool enabled);
+    double dspMicrosPerSecond() const;                   // 实测每秒音频的 DSP 耗时（微秒）
+
     // A-B 循环
     void setLoopA(qint64 ms);
     void setLoopB(qint64 ms);
@@ -78,14 +122,21 @@ signals:
     void durationChanged(qint64 duration);
     void volumeChanged(int volume);
     void playbackModeChanged(PlaybackMode mode);
-    void playlistChanged(const QList<Song>& playlist);
+    // 播放列表：整体替换时只给出版本号（需要时经 getCurrentPlaylist 重取），编辑时只给增量；
+    // revision 每次变化加一，与 getCurrentPlaylist 返回的版本对照，不连续时应整体重取
+    void playlistReset(quint64 revision);
+    void playlistSongsInserted(int index, const QList<Song>& songs, quint64 revision);
+    void playlistSongsRemoved(int index, int count, quint64 revision);
     void currentSongIndexChanged(int index);
 
     // 错误信号
     void error(const QString& errorMessage);
 
     // 扩展信号
-    void playbackQueueChanged(const QList<Song>& queue);
+    // 播放队列增量：revision 每次变化加一，与 getPlaybackQueue 返回的版本对照，不连续时应整体重取
+    void queueSongsInserted(int index, const QList<Song>& songs, quint64 revision);
+    void queueSongsRemoved(int index, int count, quint64 revision);
+    void queueSongMoved(int from, int to, quint64 revision);
     void smartPlaylistGenerated(const QList<Song>& playlist);
     void playbackHistoryChanged();
     void playbackRecordAdded(const PlaybackRecord& record);
@@ -93,6 +144,9 @@ signals:
     // A-B 循环点变化
     void loopABChanged(qint64 a, qint64 b);
 
+    // 换曲延迟：从切换请求到新曲目开始走时；preloaded 表示走了预加载
+    void trackChangeLatencyMeasured(qint64 latencyMs, bool preloaded);
+
 private:
     class Impl;
     Impl* d;
@@ -2,7 +2,9 @@
 #include "PlaylistManager.h"
 #include "PlaybackQueue.h"
 #include "PlaybackHistory.h"
+#include "SongStore.h"
 #include <QDebug>
+#include <QElapsedTimer>
 
 PlaylistManager::PlaylistManager(QObject* parent)
     : QObject(parent)
@@ -15,6 +17,10 @@ PlaylistManager::PlaylistManager(QObject* parent)
     qDebug() << "PlaylistManager initialized with smart features";
 }
 
+PlaylistManager::~PlaylistManager() {
+    SongStore::instance().release(m_ids);
+}
+
 // 🆕 智能播放功能
 void PlaylistManager::setPlaybackQueue(PlaybackQueue* queue) {
     m_playbackQueue = queue;
@@ -23,6 +29,12 @@ void PlaylistManager::setPlaybackQueue(PlaybackQueue* queue) {
 
 void PlaylistManager::setPlaybackHistory(PlaybackHistory* history) {
     m_playbackHistory = history;
+    if (m_playbackHistory) {
+        // 每条播放记录收尾时更新推荐特征，不回扫历史
+        connect(m_playbackHistory, &PlaybackHistory::recordFinished, this, [this](const PlaybackRecord& record) {
+            m_recommender.recordPlay(record.song, record.playTime, record.playDuration, record.completed);
+            });
+    }
     qDebug() << "PlaylistManager: 设置播放历史";
 }
 
@@ -36,8 +48,8 @@ Song PlaylistManager::getSmartNextSong() const {
 
     // 2. 使用常规的播放列表逻辑
     int nextIndex = getNextIndex();
-    if (nextIndex >= 0 && nextIndex < m_playlist.size()) {
-        return m_playlist[nextIndex];
+    if (nextIndex >= 0 && nextIndex < m_ids.size()) {
+        return songAt(nextIndex);
     }
 
     // 3. 如果常规列表结束，尝试生成智能播放列表
@@ -66,97 +78,93 @@ Song PlaylistManager::getSmartPreviousSong() const {
 
     // 回退到常规上一首逻辑
     int prevIndex = getPreviousIndex();
-    if (prevIndex >= 0 && prevIndex < m_playlist.size()) {
-        return m_playlist[prevIndex];
+    if (prevIndex >= 0 && prevIndex < m_ids.size()) {
+        return songAt(prevIndex);
     }
 
     return Song();
 }
 
 void PlaylistManager::resetShuffleHistory() {
-    m_recentShuffleIndices.clear();
-    qDebug() << "PlaylistManager: 重置随机播放历史";
+    if (m_playbackMode != PlaybackMode::Shuffle) return;
+    rebuildShuffleOrder(m_currentIndex);
+    qDebug() << "PlaylistManager: 重新洗牌，歌曲数量:" << m_ids.size();
 }
 
-int PlaylistManager::getSmartShuffleIndex() const {
-    if (m_playlist.size() <= MAX_SHUFFLE_MEMORY) {
-        // 如果播放列表很短，使用普通随机
-        return getRandomIndex(m_currentIndex);
-    }
-
-    // 智能随机：避开最近播放的歌曲
-    QSet<int> availableIndices;
-    for (int i = 0; i < m_playlist.size(); ++i) {
-        if (i != m_currentIndex && !m_recentShuffleIndices.contains(i)) {
-            availableIndices.insert(i);
-        }
-    }
+void PlaylistManager::setWeightedShuffle(bool enabled) {
+    if (m_weightedShuffle == enabled) return;
+    m_weightedShuffle = enabled;
+    // 已播的部分不变意义不大，直接以当前歌曲为首按新规则重洗
+    if (m_playbackMode == PlaybackMode::Shuffle) rebuildShuffleOrder(m_currentIndex);
+    qDebug() << "PlaylistManager: 加权随机" << (enabled ? "开启" : "关闭");
+}
 
-    if (availableIndices.isEmpty()) {
-        // 如果没有可用的索引，清空历史记录重新开始
-        m_recentShuffleIndices.clear();
-        return getRandomIndex(m_currentIndex);
-    }
+QList<int> PlaylistManager::shuffleOrder() const {
+    return m_shuffle.isValid() ? m_shuffle.order() : QList<int>();
+}
 
-    // 从可用索引中随机选择
-    QList<int> availableList = availableIndices.values();
-    int randomChoice = m_randomGenerator.bounded(availableList.size());
-    int selectedIndex = availableList[randomChoice];
+int PlaylistManager::shuffleCursor() const {
+    return m_shuffle.isValid() ? m_shuffle.cursor() : -1;
+}
 
-    // 记录这次选择
-    m_recentShuffleIndices.insert(selectedIndex);
+bool PlaylistManager::restoreShuffleOrder(const QList<int>& order, int cursor) {
+    if (m_playbackMode != PlaybackMode::Shuffle) return false;
+    if (!m_shuffle.restore(order, cursor, m_ids.size())) {
+        qWarning() << "PlaylistManager: 持久化的随机排列与播放列表不一致，忽略";
+        return false;
+    }
+    m_shuffleFresh = false;
+    emit shuffleOrderChanged();
+    qDebug() << "PlaylistManager: 恢复随机排列，位置" << cursor << "/" << order.size();
+    return true;
+}
 
-    // 限制历史记录大小
-    while (m_recentShuffleIndices.size() > MAX_SHUFFLE_MEMORY) {
-        // 移除一个随机的旧记录
-        auto it = m_recentShuffleIndices.begin();
-        m_recentShuffleIndices.erase(it);
+void PlaylistManager::rebuildShuffleOrder(int current) {
+    std::vector<double> weights;
+    if (m_weightedShuffle) {
+        weights.reserve(m_ids.size());
+        for (const Song& song : SongStore::instance().songs(m_ids)) {
+            weights.push_back(song.isFavorite() ? kFavoriteShuffleWeight : 1.0);
+        }
     }
+    m_shuffle.build(m_ids.size(), current, weights);
+    m_shuffleFresh = false;
+    emit shuffleOrderChanged();
+}
 
-    qDebug() << "PlaylistManager: 智能随机选择索引:" << selectedIndex
-        << "历史大小:" << m_recentShuffleIndices.size();
+void PlaylistManager::emitShuffleChange(const ShuffleOrder::Change& change) {
+    if (change.kind == ShuffleOrder::Change::Swap) emit shufflePositionsSwapped(change.from, change.to);
+    else if (change.kind == ShuffleOrder::Change::Move) emit shufflePositionMoved(change.from, change.to);
+}
 
-    return selectedIndex;
+void PlaylistManager::rebuildSongIndex() {
+    m_indexById.clear();
+    m_indexById.reserve(m_ids.size());
+    // 倒序插入：重复的歌曲以第一次出现为准，与逐个比较时一致
+    for (int i = m_ids.size() - 1; i >= 0; --i) {
+        m_indexById.insert(m_ids[i], i);
+    }
 }
 
 // 🔧 修复：const 版本 - 不发射信号
 QList<Song> PlaylistManager::generateSmartPlaylist(int maxSongs) const {
-    QList<Song> smartPlaylist;
-
-    if (!m_playbackHistory) {
-        qDebug() << "PlaylistManager: 没有播放历史，无法生成智能播放列表";
-        return smartPlaylist;
+    if (m_recommender.size() == 0) {
+        qDebug() << "PlaylistManager: 没有候选歌曲，无法生成智能播放列表";
+        return QList<Song>();
     }
 
-    // 1. 获取经常播放的歌曲
-    QList<Song> frequentSongs = m_playbackHistory->getFrequentlyPlayedSongs(maxSongs / 2);
-    for (const Song& song : frequentSongs) {
-        if (!smartPlaylist.contains(song)) {
-            smartPlaylist.append(song);
-        }
-    }
-
-    // 2. 从当前播放列表中随机添加一些歌曲
-    if (smartPlaylist.size() < maxSongs && !m_playlist.isEmpty()) {
-        int remainingSlots = maxSongs - smartPlaylist.size();
-        QSet<int> usedIndices;
-
-        for (int i = 0; i < remainingSlots && usedIndices.size() < m_playlist.size(); ++i) {
-            int randomIndex;
-            do {
-                randomIndex = m_randomGenerator.bounded(m_playlist.size());
-            } while (usedIndices.contains(randomIndex));
+    QElapsedTimer timer;
+    timer.start();
 
-            usedIndices.insert(randomIndex);
-            Song randomSong = m_playlist[randomIndex];
+    // 正在播放的歌曲不进推荐
+    QSet<QString> exclude;
+    const Song current = getCurrentSong();
+    if (!current.getId().isEmpty()) exclude.insert(current.getId());
 
-            if (!smartPlaylist.contains(randomSong)) {
-                smartPlaylist.append(randomSong);
-            }
-        }
-    }
+    const QList<Song> smartPlaylist = m_recommender.topK(maxSongs, exclude);
 
-    qDebug() << "PlaylistManager: 生成智能播放列表，包含" << smartPlaylist.size() << "首歌曲";
+    qDebug() << "PlaylistManager: 生成智能播放列表，包含" << smartPlaylist.size() << "首歌曲，候选"
+        << m_recommender.size() << "首，耗时" << timer.nsecsElapsed() / 1000 << "µs";
 
     return smartPlaylist;
 }
@@ -175,42 +183,77 @@ QList<Song> PlaylistManager::createAndNotifySmartPlaylist(int maxSongs) {
 
 // 现有方法保持不变
 void PlaylistManager::setPlaylist(const QList<Song>& playlist) {
-    m_playlist = playlist;
-    m_currentIndex = playlist.isEmpty() ? -1 : 0;
+    // 只建一份 ID 向量；歌曲信息进中央歌曲表，旧列表的引用随之释放
+    QStringList ids;
+    ids.reserve(playlist.size());
+    for (const Song& song : playlist) ids << song.getId();
+
+    SongStore& store = SongStore::instance();
+    store.retain(playlist);
+    store.release(m_ids);
+    m_recommender.upsertSongs(playlist);
+    m_ids = ids;
+    m_currentIndex = m_ids.isEmpty() ? -1 : 0;
+    ++m_revision;
+    rebuildSongIndex();
+
+    if (m_playbackMode == PlaybackMode::Shuffle) {
+        rebuildShuffleOrder(m_currentIndex);
+        // 调用方通常随后用 setCurrentIndex 指定起始歌曲，届时再以它为首重洗
+        m_shuffleFresh = true;
+    }
 
-    emit playlistChanged(m_playlist);
+    emit playlistReset(m_ids, m_revision);
     emit currentIndexChanged(m_currentIndex);
 
-    qDebug() << "PlaylistManager: 设置播放列表，歌曲数量:" << playlist.size();
+    qDebug() << "PlaylistManager: 设置播放列表，歌曲数量:" << m_ids.size();
 }
 
 void PlaylistManager::addSong(const Song& song) {
-    m_playlist.append(song);
+    SongStore::instance().retain(song);
+    m_recommender.upsertSong(song);
+    m_ids.append(song.getId());
+    const int index = m_ids.size() - 1;
+    if (!m_indexById.contains(song.getId())) m_indexById.insert(song.getId(), index);
+    ++m_revision;
+
+    if (m_shuffle.isValid()) {
+        const int position = m_shuffle.insertAppended(index);
+        if (position >= 0) emit shuffleSongInserted(position);
+        else emit shuffleOrderChanged();
+    }
 
-    if (m_playlist.size() == 1 && m_currentIndex == -1) {
+    if (m_ids.size() == 1 && m_currentIndex == -1) {
         m_currentIndex = 0;
         emit currentIndexChanged(m_currentIndex);
     }
 
-    emit playlistChanged(m_playlist);
+    emit songsInserted(index, { song.getId() }, m_revision);
     qDebug() << "PlaylistManager: 添加歌曲:" << song.getTitle();
 }
 
 void PlaylistManager::removeSong(int index) {
-    if (index < 0 || index >= m_playlist.size()) {
+    if (index < 0 || index >= m_ids.size()) {
         qWarning() << "PlaylistManager: 无效的歌曲索引:" << index;
         return;
     }
 
-    QString title = m_playlist[index].getTitle();
-    m_playlist.removeAt(index);
+    const QString id = m_ids.takeAt(index);
+    const QString title = SongStore::instance().song(id).getTitle();
+    SongStore::instance().release(id);
+    ++m_revision;
+    rebuildSongIndex();
+    if (m_shuffle.isValid()) {
+        m_shuffle.remove(index);
+        emit shuffleSongRemoved(index);
+    }
 
     if (m_currentIndex == index) {
-        if (m_playlist.isEmpty()) {
+        if (m_ids.isEmpty()) {
             m_currentIndex = -1;
         }
-        else if (m_currentIndex >= m_playlist.size()) {
-            m_currentIndex = m_playlist.size() - 1;
+        else if (m_currentIndex >= m_ids.size()) {
+            m_currentIndex = m_ids.size() - 1;
         }
         emit currentIndexChanged(m_currentIndex);
     }
@@ -219,43 +262,82 @@ void PlaylistManager::removeSong(int index) {
         emit currentIndexChanged(m_currentIndex);
     }
 
-    emit playlistChanged(m_playlist);
+    if (m_shuffle.isValid()) {
+        // 删掉的是当前歌曲时，顶替它的那首也算本轮已播
+        if (m_currentIndex >= 0) emitShuffleChange(m_shuffle.moveTo(m_currentIndex));
+    }
+
+    emit songsRemoved(index, 1, m_revision);
     qDebug() << "PlaylistManager: 移除歌曲:" << title;
 }
 
 void PlaylistManager::clearPlaylist() {
-    m_playlist.clear();
+    SongStore::instance().release(m_ids);
+    m_ids.clear();
+    m_indexById.clear();
     m_currentIndex = -1;
+    ++m_revision;
+    if (m_shuffle.isValid()) {
+        m_shuffle.invalidate();
+        emit shuffleOrderChanged();
+    }
 
-    emit playlistChanged(m_playlist);
+    emit playlistReset(m_ids, m_revision);
     emit currentIndexChanged(m_currentIndex);
 
     qDebug() << "PlaylistManager: 清空播放列表";
 }
 
 QList<Song> PlaylistManager::getPlaylist() const {
-    return m_playlist;
+    return SongStore::instance().songs(m_ids);
+}
+
+Song PlaylistManager::songAt(int index) const {
+    if (index < 0 || index >= m_ids.size()) return Song();
+    return SongStore::instance().song(m_ids[index]);
 }
 
 int PlaylistManager::getPlaylistSize() const {
-    return m_playlist.size();
+    return m_ids.size();
 }
 
 bool PlaylistManager::isEmpty() const {
-    return m_playlist.isEmpty();
+    return m_ids.isEmpty();
 }
 
 void PlaylistManager::setCurrentIndex(int index) {
-    if (index < -1 || index >= m_playlist.size()) {
+    if (index < -1 || index >= m_ids.size()) {
         qWarning() << "PlaylistManager: 无效的当前索引:" << index;
         return;
     }
 
-    if (m_currentIndex != index) {
-        m_currentIndex = index;
-        emit currentIndexChanged(m_currentIndex);
-        qDebug() << "PlaylistManager: 设置当前歌曲索引:" << index;
+    if (m_currentIndex == index) {
+        // 新列表从第一首开始播：洗好的排列本来就以它为首
+        m_shuffleFresh = false;
+        return;
+    }
+
+    m_currentIndex = index;
+
+    if (m_playbackMode == PlaybackMode::Shuffle && index >= 0) {
+        if (!m_shuffle.isValid() || (m_shuffleFresh && index != m_shuffle.peekNext())) {
+            rebuildShuffleOrder(index);
+        }
+        else {
+            m_shuffleFresh = false;
+            const ShuffleOrder::Change change = m_shuffle.moveTo(index);
+            if (m_shuffle.atCycleEnd() && m_ids.size() > 1) {
+                // 本轮播完：以当前歌曲为首开始新一轮，下一首不会与它重复
+                rebuildShuffleOrder(index);
+            }
+            else {
+                emitShuffleChange(change);
+            }
+        }
     }
+
+    emit currentIndexChanged(m_currentIndex);
+    qDebug() << "PlaylistManager: 设置当前歌曲索引:" << index;
 }
 
 int PlaylistManager::getCurrentIndex() const {
@@ -264,18 +346,25 @@ int PlaylistManager::getCurrentIndex() const {
 
 Song PlaylistManager::getCurrentSong() const {
     if (hasCurrentSong()) {
-        return m_playlist[m_currentIndex];
+        return songAt(m_currentIndex);
     }
     return Song();
 }
 
 bool PlaylistManager::hasCurrentSong() const {
-    return m_currentIndex >= 0 && m_currentIndex < m_playlist.size();
+    return m_currentIndex >= 0 && m_currentIndex < m_ids.size();
 }
 
 void PlaylistManager::setPlaybackMode(PlaybackMode mode) {
     if (m_playbackMode != mode) {
         m_playbackMode = mode;
+        if (mode == PlaybackMode::Shuffle) {
+            rebuildShuffleOrder(m_currentIndex);
+        }
+        else if (m_shuffle.isValid()) {
+            m_shuffle.invalidate();
+            emit shuffleOrderChanged();
+        }
         emit playbackModeChanged(mode);
         qDebug() << "PlaylistManager: 设置播放模式:" << (int)mode;
     }
@@ -285,7 +374,7 @@ PlaybackMode PlaylistManager::getPlaybackMode() const {
     return m_playbackMode;
 }
 
-// 🔄 更新：使用智能随机
+// 🔄 更新：随机模式按预排的排列走
 int PlaylistManager::getNextIndex() const {
     if (isEmpty() || m_currentIndex < 0) {
         return -1;
@@ -296,14 +385,17 @@ int PlaylistManager::getNextIndex() const {
         return m_currentIndex;
 
     case PlaybackMode::RepeatAll:
-        return (m_currentIndex + 1) % m_playlist.size();
+        return (m_currentIndex + 1) % m_ids.size();
 
-    case PlaybackMode::Shuffle:
-        return getSmartShuffleIndex();  // ✅ 使用智能随机
+    case PlaybackMode::Shuffle: {
+        const int next = m_shuffle.peekNext();   // ✅ O(1)
+        if (next >= 0) return next;
+        return m_shuffle.isValid() ? m_currentIndex : getRandomIndex(m_currentIndex);
+    }
 
     case PlaybackMode::Normal:
     default:
-        return (m_currentIndex + 1 < m_playlist.size()) ?
+        return (m_currentIndex + 1 < m_ids.size()) ?
             (m_currentIndex + 1) : -1;
     }
 }
@@ -318,10 +410,13 @@ int PlaylistManager::getPreviousIndex() const {
         return m_currentIndex;
 
     case PlaybackMode::RepeatAll:
-        return (m_currentIndex - 1 + m_playlist.size()) % m_playlist.size();
+        return (m_currentIndex - 1 + m_ids.size()) % m_ids.size();
 
-    case PlaybackMode::Shuffle:
-        return getRandomIndex(m_currentIndex);
+    case PlaybackMode::Shuffle: {
+        const int prev = m_shuffle.peekPrevious();
+        if (prev >= 0) return prev;
+        return m_shuffle.isValid() ? m_currentIndex : getRandomIndex(m_currentIndex);
+    }
 
     case PlaybackMode::Normal:
     default:
@@ -331,27 +426,22 @@ int PlaylistManager::getPreviousIndex() const {
 
 Song PlaylistManager::getNextSong() const {
     int nextIndex = getNextIndex();
-    if (nextIndex >= 0 && nextIndex < m_playlist.size()) {
-        return m_playlist[nextIndex];
+    if (nextIndex >= 0 && nextIndex < m_ids.size()) {
+        return songAt(nextIndex);
     }
     return Song();
 }
 
 Song PlaylistManager::getPreviousSong() const {
     int prevIndex = getPreviousIndex();
-    if (prevIndex >= 0 && prevIndex < m_playlist.size()) {
-        return m_playlist[prevIndex];
+    if (prevIndex >= 0 && prevIndex < m_ids.size()) {
+        return songAt(prevIndex);
     }
     return Song();
 }
 
 int PlaylistManager::findSongIndex(const Song& song) const {
-    for (int i = 0; i < m_playlist.size(); ++i) {
-        if (m_playlist[i] == song) {
-            return i;
-        }
-    }
-    return -1;
+    return m_indexById.value(song.getId(), -1);
 }
 
 bool PlaylistManager::containsSong(const Song& song) const {
@@ -359,14 +449,14 @@ bool PlaylistManager::containsSong(const Song& song) const {
 }
 
 int PlaylistManager::getRandomIndex(int excludeIndex) const {
-    if (m_playlist.size() <= 1) {
+    if (m_ids.size() <= 1) {
         return m_currentIndex;
     }
 
     int randomIndex;
     do {
-        randomIndex = m_randomGenerator.bounded(m_playlist.size());
-    } while (randomIndex == excludeIndex && m_playlist.size() > 1);
+        randomIndex = m_randomGenerator.bounded(m_ids.size());
+    } while (randomIndex == excludeIndex && m_ids.size() > 1);
 
     return randomIndex;
 }
@@ -2,19 +2,31 @@
 #pragma once
 #include <QObject>
 #include <QList>
+#include <QHash>
 #include <QRandomGenerator>
 #include <QSet>
+#include <QStringList>
+#include "ShuffleOrder.h"
+#include "RecommendationEngine.h"
 #include "../common/entities/Song.h"
 #include "../common/PlaybackMode.h"
 
 class PlaybackQueue;
 class PlaybackHistory;
 
+/**
+ * @brief 当前播放列表与播放模式
+ *
+ * 列表只保存歌曲 ID 向量（QStringList，隐式共享），歌曲信息放在 SongStore。
+ * 每次变化 revision 加一并只发出增量（整体替换 / 插入 / 删除），
+ * 接收方拿到的 ID 列表与内部共享同一份数据，不逐首复制歌曲。
+ */
 class PlaylistManager : public QObject {
     Q_OBJECT
 
 public:
     explicit PlaylistManager(QObject* parent = nullptr);
+    ~PlaylistManager() override;
 
     // 播放列表管理
     void setPlaylist(const QList<Song>& playlist);
@@ -22,7 +34,10 @@ public:
     void removeSong(int index);
     void clearPlaylist();
 
-    QList<Song> getPlaylist() const;
+    QList<Song> getPlaylist() const;                 // 逐首从 SongStore 取出，O(n)
+    QStringList playlistIds() const { return m_ids; }
+    quint64 playlistRevision() const { return m_revision; }
+    Song songAt(int index) const;
     int getPlaylistSize() const;
     bool isEmpty() const;
 
@@ -54,24 +69,45 @@ public:
     Song getSmartNextSong() const;
     Song getSmartPreviousSong() const;
 
-    // 随机播放优化（避免重复）
-    void resetShuffleHistory();
-
-    // 🔧 智能播放列表生成 - 两个版本
+    // 随机播放：整轮预排的排列，一轮内每首只播一次；下一首 / 上一首 O(1)
+    void resetShuffleHistory();                 // 以当前歌曲为首重新洗牌
+    void setWeightedShuffle(bool enabled);      // 收藏的歌曲更可能排在前面
+    bool isWeightedShuffle() const { return m_weightedShuffle; }
+    QList<int> shuffleOrder() const;            // 列表下标的排列（非随机模式时为空）
+    int shuffleCursor() const;
+    QList<int> upcomingShuffleIndices(int count) const { return m_shuffle.peekAhead(count); }
+    // 恢复持久化的排列；与当前列表对不上时返回 false，保留现有排列
+    bool restoreShuffleOrder(const QList<int>& order, int cursor);
+
+    // 🔧 智能播放列表生成 - 两个版本（按 RecommendationEngine 打分取前 maxSongs 首）
     QList<Song> generateSmartPlaylist(int maxSongs = 20) const;           // 静默生成
     QList<Song> createAndNotifySmartPlaylist(int maxSongs = 20);          // 生成并发射信号
+    // 推荐候选与特征：播放列表里的歌曲自动加入，曲库由调用方装载并随变化维护
+    RecommendationEngine& recommender() { return m_recommender; }
 
 signals:
-    void playlistChanged(const QList<Song>& playlist);
+    void playlistReset(const QStringList& ids, quint64 revision);
+    void songsInserted(int index, const QStringList& ids, quint64 revision);
+    void songsRemoved(int index, int count, quint64 revision);
     void currentIndexChanged(int index);
     void playbackModeChanged(PlaybackMode mode);
     void smartPlaylistGenerated(const QList<Song>& playlist);
+    // 随机排列的变化：整体重建 / 失效发 shuffleOrderChanged，增删与点选只发对应的增量；单纯前后移动不发
+    void shuffleOrderChanged();
+    void shuffleSongInserted(int position);         // 末尾追加的歌曲放到 position，原处的挪到排列末尾
+    void shuffleSongRemoved(int index);             // 列表下标 index 移出排列，之后的下标前移
+    void shufflePositionsSwapped(int from, int to);
+    void shufflePositionMoved(int from, int to);    // from 处的挪到 to，其间的依次前移
 
 private:
     int getRandomIndex(int excludeIndex = -1) const;
-    int getSmartShuffleIndex() const;  // 智能随机，避免最近播放的歌曲
+    void rebuildShuffleOrder(int current);
+    void emitShuffleChange(const ShuffleOrder::Change& change);
+    void rebuildSongIndex();
 
-    QList<Song> m_playlist;
+    QStringList m_ids;
+    quint64 m_revision = 0;
+    QHash<QString, int> m_indexById;    // 歌曲 ID → 列表下标，findSongIndex 用
     int m_currentIndex;
     PlaybackMode m_playbackMode;
     mutable QRandomGenerator m_randomGenerator;
@@ -79,6 +115,12 @@ private:
     // 🆕 智能播放成员
     PlaybackQueue* m_playbackQueue;
     PlaybackHistory* m_playbackHistory;
-    mutable QSet<int> m_recentShuffleIndices;  // 最近随机播放过的索引
-    static const int MAX_SHUFFLE_MEMORY = 5;   // 记住最近5首随机歌曲
+
+    // 随机播放排列（仅随机模式下维护）
+    ShuffleOrder m_shuffle;
+    bool m_shuffleFresh = false;    // 刚按新列表洗好、还没真正换过歌：首次选歌时以选中的歌重洗
+    bool m_weightedShuffle = false;
+    static constexpr double kFavoriteShuffleWeight = 3.0;
+
+    RecommendationEngine m_recommender;
 };
@@ -0,0 +1,223 @@
+// service/PlaylistMembershipIndex.cpp
+#include "PlaylistMembershipIndex.h"
+#include <algorithm>
+#include <bit>
+
+// ========== 位图操作 ==========
+bool PlaylistMembershipIndex::testBit(const Bits& bits, int ordinal) {
+    const int word = ordinal >> 6;
+    return word < bits.size() && (bits.at(word) & (quint64(1) << (ordinal & 63)));
+}
+
+bool PlaylistMembershipIndex::setBit(Bits& bits, int ordinal) {
+    const int word = ordinal >> 6;
+    if (word >= bits.size()) bits.resize(word + 1);
+    const quint64 mask = quint64(1) << (ordinal & 63);
+    if (bits[word] & mask) return false;
+    bits[word] |= mask;
+    return true;
+}
+
+bool PlaylistMembershipIndex::clearBit(Bits& bits, int ordinal) {
+    const int word = ordinal >> 6;
+    if (word >= bits.size()) return false;
+    const quint64 mask = quint64(1) << (ordinal & 63);
+    if (!(bits[word] & mask)) return false;
+    bits[word] &= ~mask;
+    // 去掉末尾的空字，便于判断“不在任何歌单中”
+    while (!bits.isEmpty() && bits.last() == 0) bits.removeLast();
+    return true;
+}
+
+// ========== 装载 ==========
+void PlaylistMembershipIndex::load(const QList<Playlist>& playlists,
+    const QList<QPair<QString, QString>>& memberships) {
+    clear();
+    for (const Playlist& pl : playlists) {
+        addPlaylist(pl);
+    }
+
+    m_songBits.reserve(memberships.size());
+    for (const auto& m : memberships) {
+        const auto it = m_ordinalOf.constFind(m.first);
+        if (it == m_ordinalOf.constEnd()) continue;
+        if (setBit(m_songBits[m.second], it.value())) {
+            ++m_slots[it.value()].songCount;
+        }
+    }
+}
+
+void PlaylistMembershipIndex::clear() {
+    m_slots.clear();
+    m_freeOrdinals.clear();
+    m_ordinalOf.clear();
+    m_songBits.clear();
+}
+
+// ========== 歌单 ==========
+void PlaylistMembershipIndex::addPlaylist(const Playlist& playlist) {
+    if (playlist.getId().isEmpty()) return;
+    if (m_ordinalOf.contains(playlist.getId())) {
+        updatePlaylist(playlist);
+        return;
+    }
+
+    int ordinal;
+    if (!m_freeOrdinals.isEmpty()) {
+        ordinal = m_freeOrdinals.takeLast();
+    }
+    else {
+        ordinal = m_slots.size();
+        m_slots.append(Slot());
+    }
+    Slot& slot = m_slots[ordinal];
+    slot.playlist = playlist;
+    slot.songCount = 0;
+    slot.alive = true;
+    m_ordinalOf.insert(playlist.getId(), ordinal);
+}
+
+void PlaylistMembershipIndex::updatePlaylist(const Playlist& playlist) {
+    const auto it = m_ordinalOf.constFind(playlist.getId());
+    if (it == m_ordinalOf.constEnd()) return;
+    m_slots[it.value()].playlist = playlist;
+}
+
+void PlaylistMembershipIndex::removePlaylist(const QString& playlistId) {
+    const auto it = m_ordinalOf.constFind(playlistId);
+    if (it == m_ordinalOf.constEnd()) return;
+    const int ordinal = it.value();
+    m_ordinalOf.erase(it);
+
+    // 序号复用前必须清掉所有歌曲上的对应位
+    clearOrdinal(ordinal);
+    m_slots[ordinal] = Slot();
+    m_freeOrdinals.append(ordinal);
+}
+
+void PlaylistMembershipIndex::clearPlaylist(const QString& playlistId) {
+    const auto it = m_ordinalOf.constFind(playlistId);
+    if (it == m_ordinalOf.constEnd()) return;
+    clearOrdinal(it.value());
+    m_slots[it.value()].songCount = 0;
+}
+
+void PlaylistMembershipIndex::clearOrdinal(int ordinal) {
+    if (m_slots.at(ordinal).songCount == 0) return;
+    for (auto it = m_songBits.begin(); it != m_songBits.end();) {
+        clearBit(it.value(), ordinal);
+        if (it.value().isEmpty()) it = m_songBits.erase(it);
+        else ++it;
+    }
+}
+
+QList<Playlist> PlaylistMembershipIndex::playlists() const {
+    QList<Playlist> result;
+    result.reserve(m_ordinalOf.size());
+    for (const Slot& slot : m_slots) {
+        if (slot.alive) result.append(slot.playlist);
+    }
+    std::sort(result.begin(), result.end(), [](const Playlist& a, const Playlist& b) {
+        return a.getName() < b.getName();
+    });
+    return result;
+}
+
+Playlist PlaylistMembershipIndex::playlist(const QString& playlistId) const {
+    const auto it = m_ordinalOf.constFind(playlistId);
+    return it == m_ordinalOf.constEnd() ? Playlist() : m_slots.at(it.value()).playlist;
+}
+
+// ========== 关联 ==========
+int PlaylistMembershipIndex::add(const QString& playlistId, const QStringList& songIds) {
+    const auto it = m_ordinalOf.constFind(playlistId);
+    if (it == m_ordinalOf.constEnd()) return 0;
+    const int ordinal = it.value();
+
+    int added = 0;
+    for (const QString& songId : songIds) {
+        if (songId.isEmpty()) continue;
+        if (setBit(m_songBits[songId], ordinal)) ++added;
+    }
+    m_slots[ordinal].songCount += added;
+    return added;
+}
+
+int PlaylistMembershipIndex::remove(const QString& playlistId, const QStringList& songIds) {
+    const auto it = m_ordinalOf.constFind(playlistId);
+    if (it == m_ordinalOf.constEnd()) return 0;
+    const int ordinal = it.value();
+
+    int removed = 0;
+    for (const QString& songId : songIds) {
+        auto bits = m_songBits.find(songId);
+        if (bits == m_songBits.end()) continue;
+        if (clearBit(bits.value(), ordinal)) ++removed;
+        if (bits.value().isEmpty()) m_songBits.erase(bits);
+    }
+    m_slots[ordinal].songCount -= removed;
+    return removed;
+}
+
+void PlaylistMembershipIndex::removeSong(const QString& songId) {
+    const Bits bits = m_songBits.take(songId);
+    for (int word = 0; word < bits.size(); ++word) {
+        quint64 w = bits.at(word);
+        while (w) {
+            const int ordinal = (word << 6) + std::countr_zero(w);
+            w &= w - 1;
+            --m_slots[ordinal].songCount;
+        }
+    }
+}
+
+bool PlaylistMembershipIndex::contains(const QString& playlistId, const QString& songId) const {
+    const auto it = m_ordinalOf.constFind(playlistId);
+    if (it == m_ordinalOf.constEnd()) return false;
+    const auto bits = m_songBits.constFind(songId);
+    return bits != m_songBits.constEnd() && testBit(bits.value(), it.value());
+}
+
+int PlaylistMembershipIndex::songCount(const QString& playlistId) const {
+    const auto it = m_ordinalOf.constFind(playlistId);
+    return it == m_ordinalOf.constEnd() ? 0 : m_slots.at(it.value()).songCount;
+}
+
+QHash<QString, int> PlaylistMembershipIndex::membershipCounts(const QStringList& songIds) const {
+    // 先按序号累加，最后再映射回歌单ID
+    QVector<int> counts(m_slots.size(), 0);
+    for (const QString& songId : songIds) {
+        const auto bits = m_songBits.constFind(songId);
+        if (bits == m_songBits.constEnd()) continue;
+        for (int word = 0; word < bits->size(); ++word) {
+            quint64 w = bits->at(word);
+            while (w) {
+                ++counts[(word << 6) + std::countr_zero(w)];
+                w &= w - 1;
+            }
+        }
+    }
+
+    QHash<QString, int> result;
+    for (int ordinal = 0; ordinal < counts.size(); ++ordinal) {
+        if (counts.at(ordinal) > 0 && m_slots.at(ordinal).alive) {
+            result.insert(m_slots.at(ordinal).playlist.getId(), counts.at(ordinal));
+        }
+    }
+    return result;
+}
+
+QStringList PlaylistMembershipIndex::playlistsOf(const QString& songId) const {
+    QStringList result;
+    const auto bits = m_songBits.constFind(songId);
+    if (bits == m_songBits.constEnd()) return result;
+    for (int word = 0; word < bits->size(); ++word) {
+        quint64 w = bits->at(word);
+        while (w) {
+            const int ordinal = (word << 6) + std::countr_zero(w);
+            w &= w - 1;
+            if (m_slots.at(ordinal).alive) result << m_slots.at(ordinal).playlist.getId();
+        }
+    }
+    return result;
+}
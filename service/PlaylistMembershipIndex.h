@@ -0,0 +1,69 @@
+// service/PlaylistMembershipIndex.h
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "../common/entities/Playlist.h"
+
+/**
+ * @brief 歌曲 -> 所属歌单 的内存索引
+ *
+ * 每个歌单分配一个序号，每首歌保存一个按序号置位的位图（QVector<quint64>），
+ * 同时缓存歌单列表与各歌单歌曲数。右键菜单、导入去重等“是否已在歌单中”的判断
+ * 全部在内存中完成，不再逐对查询数据库。
+ *
+ * 由 LibraryService 一次性装载并随歌单变更增量维护；只在 UI 线程使用。
+ */
+class PlaylistMembershipIndex {
+public:
+    // 全量装载：playlists 为歌单列表（保持其顺序），memberships 为 (playlistId, songId)
+    void load(const QList<Playlist>& playlists, const QList<QPair<QString, QString>>& memberships);
+    void clear();
+
+    // ---- 歌单 ----
+    void addPlaylist(const Playlist& playlist);
+    void updatePlaylist(const Playlist& playlist);
+    void removePlaylist(const QString& playlistId);
+    void clearPlaylist(const QString& playlistId);
+    QList<Playlist> playlists() const;   // 按名称排序（与 PlaylistRepository::findAll 一致）
+    Playlist playlist(const QString& playlistId) const;
+    bool hasPlaylist(const QString& playlistId) const { return m_ordinalOf.contains(playlistId); }
+
+    // ---- 关联 ----
+    // 返回实际新增/移除的数量（已存在/不存在的忽略）
+    int add(const QString& playlistId, const QStringList& songIds);
+    int remove(const QString& playlistId, const QStringList& songIds);
+    void removeSong(const QString& songId);   // 歌曲被删除：从所有歌单中移除
+
+    bool contains(const QString& playlistId, const QString& songId) const;
+    int songCount(const QString& playlistId) const;
+
+    // 统计每个歌单包含了 songIds 中的多少首（不含的歌单不出现在结果中）
+    QHash<QString, int> membershipCounts(const QStringList& songIds) const;
+    // 某首歌所属的全部歌单ID
+    QStringList playlistsOf(const QString& songId) const;
+
+private:
+    using Bits = QVector<quint64>;
+
+    static bool testBit(const Bits& bits, int ordinal);
+    static bool setBit(Bits& bits, int ordinal);     // 返回是否由 0 变 1
+    static bool clearBit(Bits& bits, int ordinal);   // 返回是否由 1 变 0
+    void clearOrdinal(int ordinal);
+
+    struct Slot {
+        Playlist playlist;
+        int songCount = 0;
+        bool alive = false;
+    };
+
+    QVector<Slot> m_slots;              // 序号 -> 歌单
+    QVector<int> m_freeOrdinals;        // 已删除歌单留下的空位，优先复用
+    QHash<QString, int> m_ordinalOf;    // 歌单ID -> 序号
+    QHash<QString, Bits> m_songBits;    // 歌曲ID -> 所属歌单位图
+};
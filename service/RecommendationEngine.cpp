@@ -0,0 +1,233 @@
+#include "RecommendationEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace {
+    constexpr double kHalfLifeMs = 14.0 * 24 * 3600 * 1000;     // 播放次数半衰期
+    constexpr double kMaxExponent = 512.0;                      // 超过后换基准，避免 double 溢出
+    constexpr qint64 kSkipThresholdMs = 30 * 1000;              // 不足 30 秒（或半首）即视为跳过
+    constexpr double kPartialPlayWeight = 0.5;                  // 中途换歌但听了一阵：记半次
+    constexpr double kCooldownMs = 60.0 * 60 * 1000;            // 刚听过的歌曲降权，约一小时减半
+
+    // 各特征的权重
+    constexpr double kPlaysWeight = 1.0;
+    constexpr double kCompletionWeight = 0.8;
+    constexpr double kSkipWeight = 1.5;
+    constexpr double kFavoriteWeight = 0.7;
+    constexpr double kArtistWeight = 0.5;
+    constexpr double kCooldownWeight = 2.0;
+    constexpr double kExplorationWeight = 0.25;   // 少量随机，同分的歌曲每次不总是同一批
+
+    QString artistKey(const Song& song) {
+        return song.getArtist().trimmed().toLower();
+    }
+}
+
+RecommendationEngine::RecommendationEngine()
+    : m_epochMs(QDateTime::currentMSecsSinceEpoch())
+    , m_rng(QRandomGenerator::securelySeeded())
+{
+}
+
+// ========== 候选歌曲 ==========
+void RecommendationEngine::loadCatalog(const QList<Song>& songs) {
+    m_entries.reserve(m_entries.size() + songs.size());
+    m_slotById.reserve(m_slotById.size() + songs.size());
+    upsertSongs(songs);
+    m_catalogLoaded = true;
+}
+
+void RecommendationEngine::upsertSongs(const QList<Song>& songs) {
+    for (const Song& song : songs) upsertSong(song);
+}
+
+void RecommendationEngine::upsertSong(const Song& song) {
+    if (song.getId().isEmpty()) return;
+
+    auto it = m_slotById.constFind(song.getId());
+    if (it == m_slotById.cend()) {
+        Entry e;
+        e.song = song;
+        e.artist = artistSlot(artistKey(song));
+        m_slotById.insert(song.getId(), int(m_entries.size()));
+        m_entries.push_back(std::move(e));
+        return;
+    }
+
+    Entry& e = m_entries[*it];
+    const int artist = artistSlot(artistKey(song));
+    if (artist != e.artist) {
+        // 改了歌手：播放量随歌曲转到新歌手名下
+        if (artist >= 0) m_artists[artist].scaledPlays += e.scaledPlays;
+        if (e.artist >= 0) {
+            m_artists[e.artist].scaledPlays -= e.scaledPlays;
+            releaseArtist(e.artist);
+        }
+        e.artist = artist;
+    }
+    else if (artist >= 0) {
+        releaseArtist(artist);  // artistSlot 多计了一次
+    }
+    e.song = song;
+}
+
+void RecommendationEngine::removeSong(const QString& id) {
+    auto it = m_slotById.find(id);
+    if (it == m_slotById.end()) return;
+    const int slot = *it;
+    m_slotById.erase(it);
+
+    Entry& e = m_entries[slot];
+    if (e.artist >= 0) {
+        m_artists[e.artist].scaledPlays -= e.scaledPlays;
+        releaseArtist(e.artist);
+    }
+
+    const int last = int(m_entries.size()) - 1;
+    if (slot != last) {
+        e = std::move(m_entries[last]);
+        m_slotById[e.song.getId()] = slot;
+    }
+    m_entries.pop_back();
+}
+
+int RecommendationEngine::artistSlot(const QString& artist) {
+    if (artist.isEmpty()) return -1;
+
+    auto it = m_artistSlotByKey.constFind(artist);
+    int slot;
+    if (it != m_artistSlotByKey.cend()) {
+        slot = *it;
+    }
+    else if (!m_freeArtistSlots.empty()) {
+        slot = m_freeArtistSlots.back();
+        m_freeArtistSlots.pop_back();
+        m_artists[slot] = Artist{ artist };
+        m_artistSlotByKey.insert(artist, slot);
+    }
+    else {
+        slot = int(m_artists.size());
+        m_artists.push_back(Artist{ artist });
+        m_artistSlotByKey.insert(artist, slot);
+    }
+    ++m_artists[slot].songs;
+    return slot;
+}
+
+void RecommendationEngine::releaseArtist(int slot) {
+    Artist& a = m_artists[slot];
+    if (--a.songs > 0) return;
+    m_artistSlotByKey.remove(a.key);
+    a = Artist();
+    m_freeArtistSlots.push_back(slot);
+}
+
+// ========== 播放特征 ==========
+double RecommendationEngine::scaledWeight(qint64 atMs) {
+    if (double(atMs - m_epochMs) / kHalfLifeMs > kMaxExponent) rebase(atMs);
+    return std::exp2(double(atMs - m_epochMs) / kHalfLifeMs);
+}
+
+void RecommendationEngine::rebase(qint64 epochMs) {
+    const double factor = std::exp2(double(m_epochMs - epochMs) / kHalfLifeMs);
+    for (Entry& e : m_entries) e.scaledPlays *= factor;
+    for (Artist& a : m_artists) a.scaledPlays *= factor;
+    m_epochMs = epochMs;
+}
+
+void RecommendationEngine::recordPlay(const Song& song, const QDateTime& startedAt, qint64 playedMs, bool completed) {
+    if (song.getId().isEmpty()) return;
+    if (!m_slotById.contains(song.getId())) upsertSong(song);
+    Entry& e = m_entries[m_slotById.value(song.getId())];
+
+    const qint64 atMs = startedAt.isValid() ? startedAt.toMSecsSinceEpoch() : QDateTime::currentMSecsSinceEpoch();
+    e.lastPlayedMs = std::max(e.lastPlayedMs, atMs);
+    ++e.finishes;
+
+    double plays = 0.0;
+    if (completed) {
+        ++e.completions;
+        plays = 1.0;
+    }
+    else {
+        const qint64 durationMs = e.song.getDurationSeconds() * 1000;
+        const qint64 threshold = durationMs > 0 ? std::min(kSkipThresholdMs, durationMs / 2) : kSkipThresholdMs;
+        if (playedMs < threshold) ++e.skips;
+        else plays = kPartialPlayWeight;
+    }
+    if (plays <= 0.0) return;
+
+    const double w = plays * scaledWeight(atMs);
+    e.scaledPlays += w;
+    if (e.artist >= 0) m_artists[e.artist].scaledPlays += w;
+}
+
+void RecommendationEngine::clearHistory() {
+    for (Entry& e : m_entries) {
+        e.scaledPlays = 0.0;
+        e.lastPlayedMs = 0;
+        e.finishes = e.completions = e.skips = 0;
+    }
+    for (Artist& a : m_artists) a.scaledPlays = 0.0;
+}
+
+// ========== 打分 ==========
+double RecommendationEngine::score(const Entry& e, double decay, qint64 nowMs) const {
+    const double plays = e.scaledPlays * decay;
+    const double completionRate = (e.completions + 1.0) / (e.finishes + 2.0);
+    const double skipRate = e.skips / (e.finishes + 2.0);
+    // 歌手偏好只算同一歌手其他歌曲的播放，没听过的歌也能因此被推上来
+    const double artistPlays = e.artist >= 0
+        ? std::max(0.0, m_artists[e.artist].scaledPlays - e.scaledPlays) * decay : 0.0;
+    const double cooldown = e.lastPlayedMs > 0
+        ? std::exp2(-double(std::max<qint64>(0, nowMs - e.lastPlayedMs)) / kCooldownMs) : 0.0;
+
+    return kPlaysWeight * std::log2(1.0 + plays)
+        + kCompletionWeight * (completionRate - 0.5)
+        - kSkipWeight * skipRate
+        + (e.song.isFavorite() ? kFavoriteWeight : 0.0)
+        + kArtistWeight * std::log2(1.0 + artistPlays)
+        - kCooldownWeight * cooldown
+        + kExplorationWeight * m_rng.generateDouble();
+}
+
+QList<Song> RecommendationEngine::topK(int k, const QSet<QString>& exclude) const {
+    QList<Song> out;
+    if (k <= 0 || m_entries.empty()) return out;
+
+    std::vector<char> excluded(m_entries.size(), 0);
+    for (const QString& id : exclude) {
+        auto it = m_slotById.constFind(id);
+        if (it != m_slotById.cend()) excluded[*it] = 1;
+    }
+
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    const double decay = std::exp2(double(m_epochMs - nowMs) / kHalfLifeMs);
+
+    // 小顶堆只留 k 个：堆顶是目前入选里最低的分数
+    using Scored = std::pair<double, int>;
+    std::vector<Scored> storage;
+    storage.reserve(size_t(k) + 1);
+    std::priority_queue<Scored, std::vector<Scored>, std::greater<Scored>> heap(std::greater<Scored>(), std::move(storage));
+
+    for (int slot = 0; slot < int(m_entries.size()); ++slot) {
+        if (excluded[slot]) continue;
+        const double s = score(m_entries[slot], decay, nowMs);
+        if (int(heap.size()) < k) {
+            heap.emplace(s, slot);
+        }
+        else if (s > heap.top().first) {
+            heap.pop();
+            heap.emplace(s, slot);
+        }
+    }
+
+    out.resize(heap.size());
+    for (qsizetype i = out.size() - 1; i >= 0; --i) {
+        out[i] = m_entries[heap.top().second].song;
+        heap.pop();
+    }
+    return out;
+}
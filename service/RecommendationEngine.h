@@ -0,0 +1,71 @@
+#pragma once
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QString>
+#include <vector>
+#include "../common/entities/Song.h"
+
+/**
+ * @brief 智能播放列表的打分推荐
+ *
+ * 每首候选歌曲维护一组特征，播放结束时增量更新，不回扫历史：
+ * 近期加权播放次数（半衰期 14 天）、完整播放率与跳过率（拉普拉斯平滑）、是否收藏、
+ * 所属歌手的近期播放量（歌手偏好）、最近一次播放时间（刚听过的暂时降权）。
+ *
+ * 时间衰减用固定基准时刻：一次播放记作 2^((t - epoch) / H)，查询时统一乘 2^(-(now - epoch) / H)，
+ * 新增播放 O(1)，不需要定期给所有歌曲衰减；指数过大时整体换一次基准。
+ * 取前 k 首用大小为 k 的小顶堆扫一遍候选，O(N log k)。
+ */
+class RecommendationEngine {
+public:
+    RecommendationEngine();
+
+    // 候选歌曲：整库装载时合并（已有的特征保留），之后随曲库变化增量维护
+    void loadCatalog(const QList<Song>& songs);
+    void upsertSong(const Song& song);
+    void upsertSongs(const QList<Song>& songs);
+    void removeSong(const QString& id);
+    bool isCatalogLoaded() const { return m_catalogLoaded; }
+    int size() const { return int(m_entries.size()); }
+
+    // 一次播放结束：completed 为完整播放；未完成且播放不足阈值记作跳过
+    void recordPlay(const Song& song, const QDateTime& startedAt, qint64 playedMs, bool completed);
+    void clearHistory();    // 清空播放特征，保留候选
+
+    // 得分最高的 k 首（降序），exclude 中的歌曲不参与
+    QList<Song> topK(int k, const QSet<QString>& exclude = {}) const;
+
+private:
+    struct Entry {
+        Song song;
+        int artist = -1;            // m_artists 下标，-1 表示未知歌手
+        double scaledPlays = 0.0;   // Σ 2^((t - epoch) / H)
+        qint64 lastPlayedMs = 0;
+        int finishes = 0;           // 有结果的播放次数（完整 + 中途 + 跳过）
+        int completions = 0;
+        int skips = 0;
+    };
+    struct Artist {
+        QString key;
+        double scaledPlays = 0.0;
+        int songs = 0;
+    };
+
+    int artistSlot(const QString& artist);
+    void releaseArtist(int slot);
+    double scaledWeight(qint64 atMs);
+    void rebase(qint64 epochMs);
+    double score(const Entry& e, double decay, qint64 nowMs) const;
+
+    std::vector<Entry> m_entries;       // 连续存放便于顺序扫描；删除时与末尾对换
+    QHash<QString, int> m_slotById;
+    std::vector<Artist> m_artists;
+    QHash<QString, int> m_artistSlotByKey;
+    std::vector<int> m_freeArtistSlots;
+    qint64 m_epochMs;
+    bool m_catalogLoaded = false;
+    mutable QRandomGenerator m_rng;
+};
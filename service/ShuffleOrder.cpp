@@ -0,0 +1,162 @@
+#include "ShuffleOrder.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+ShuffleOrder::ShuffleOrder()
+    : m_rng(QRandomGenerator::securelySeeded())
+{
+}
+
+void ShuffleOrder::invalidate() {
+    m_order.clear();
+    m_positionOf.clear();
+    m_cursor = -1;
+    m_valid = false;
+}
+
+void ShuffleOrder::place(int position, int index) {
+    m_order[position] = index;
+    m_positionOf[index] = position;
+}
+
+// ========== 洗牌 ==========
+void ShuffleOrder::build(int size, int current, const std::vector<double>& weights) {
+    size = std::max(0, size);
+    m_order.resize(size);
+    m_positionOf.resize(size);
+    std::iota(m_order.begin(), m_order.end(), 0);
+
+    if (int(weights.size()) == size) {
+        // 指数键：u ∈ (0,1]，key = -ln(u) / w，升序即为按权重的无放回抽样顺序
+        std::vector<double> keys(size);
+        for (int i = 0; i < size; ++i) {
+            const double u = 1.0 - m_rng.generateDouble();
+            keys[i] = -std::log(u) / std::max(1e-6, weights[i]);
+        }
+        std::sort(m_order.begin(), m_order.end(),
+            [&keys](int a, int b) { return keys[a] < keys[b]; });
+    }
+    else {
+        // Fisher–Yates
+        for (int i = size - 1; i > 0; --i) {
+            const int j = int(m_rng.bounded(i + 1));
+            std::swap(m_order[i], m_order[j]);
+        }
+    }
+
+    m_cursor = -1;
+    if (current >= 0 && current < size) {
+        // 当前曲目挪到最前面，其余保持洗好的相对顺序
+        const auto it = std::find(m_order.begin(), m_order.end(), current);
+        std::rotate(m_order.begin(), it, it + 1);
+        m_cursor = 0;
+    }
+    for (int pos = 0; pos < size; ++pos) m_positionOf[m_order[pos]] = pos;
+    m_valid = true;
+}
+
+bool ShuffleOrder::restore(const QList<int>& order, int cursor, int size) {
+    if (order.size() != size || cursor < -1 || cursor >= size) return false;
+
+    std::vector<int> positionOf(size, -1);
+    for (int pos = 0; pos < size; ++pos) {
+        const int index = order[pos];
+        if (index < 0 || index >= size || positionOf[index] >= 0) return false;
+        positionOf[index] = pos;
+    }
+
+    m_order.assign(order.cbegin(), order.cend());
+    m_positionOf = std::move(positionOf);
+    m_cursor = cursor;
+    m_valid = true;
+    return true;
+}
+
+// ========== 导航 ==========
+int ShuffleOrder::peekNext() const {
+    if (!m_valid || m_cursor + 1 >= size()) return -1;
+    return m_order[m_cursor + 1];
+}
+
+int ShuffleOrder::peekPrevious() const {
+    if (!m_valid || m_cursor < 1) return -1;
+    return m_order[m_cursor - 1];
+}
+
+QList<int> ShuffleOrder::peekAhead(int count) const {
+    QList<int> out;
+    if (!m_valid) return out;
+    const int end = std::min(size(), m_cursor + 1 + std::max(0, count));
+    for (int pos = m_cursor + 1; pos < end; ++pos) out << m_order[pos];
+    return out;
+}
+
+ShuffleOrder::Change ShuffleOrder::moveTo(int index) {
+    if (!m_valid || index < 0 || index >= size()) return {};
+    const int pos = m_positionOf[index];
+
+    if (pos == m_cursor) return {};
+    if (pos == m_cursor + 1) {
+        ++m_cursor;
+        return {};
+    }
+    if (pos == m_cursor - 1) {
+        --m_cursor;
+        return {};
+    }
+
+    if (pos > m_cursor) {
+        // 跳着点选了待播的歌曲：与紧接 cursor 的那首对换，被换走的仍留在待播区
+        ++m_cursor;
+        const int displaced = m_order[m_cursor];
+        place(m_cursor, index);
+        place(pos, displaced);
+        return { Change::Swap, pos, m_cursor };
+    }
+
+    // 重听本轮已播的歌曲：挪到已播区末尾，其后的已播歌曲前移一位
+    std::rotate(m_order.begin() + pos, m_order.begin() + pos + 1, m_order.begin() + m_cursor + 1);
+    for (int p = pos; p <= m_cursor; ++p) m_positionOf[m_order[p]] = p;
+    return { Change::Move, pos, m_cursor };
+}
+
+// ========== 列表增删 ==========
+int ShuffleOrder::insertAppended(int index) {
+    if (!m_valid || index != size()) {
+        invalidate();
+        return -1;
+    }
+    m_order.push_back(index);
+    m_positionOf.push_back(index);
+
+    // 新歌随机落在本轮的待播区
+    const int first = m_cursor + 1;
+    const int last = size() - 1;
+    const int pos = first + int(m_rng.bounded(last - first + 1));
+    if (pos != last) {
+        const int displaced = m_order[pos];
+        place(pos, index);
+        place(last, displaced);
+    }
+    return pos;
+}
+
+void ShuffleOrder::remove(int index) {
+    if (!m_valid || index < 0 || index >= size()) return;
+    const int pos = m_positionOf[index];
+
+    m_order.erase(m_order.begin() + pos);
+    if (pos <= m_cursor) --m_cursor;
+
+    // 列表里 index 之后的下标都前移了一位
+    m_positionOf.resize(m_order.size());
+    for (int p = 0; p < size(); ++p) {
+        if (m_order[p] > index) --m_order[p];
+        m_positionOf[m_order[p]] = p;
+    }
+}
+
+QList<int> ShuffleOrder::order() const {
+    return QList<int>(m_order.cbegin(), m_order.cend());
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <QList>
+#include <QRandomGenerator>
+#include <vector>
+
+/**
+ * @brief 随机播放的预排顺序（一轮一个排列）
+ *
+ * 整个播放列表预先洗成一个排列 order，cursor 指向本轮最近播放的位置：
+ * order[0..cursor] 是本轮已播，之后是待播。下一首 / 上一首只是 cursor ± 1，O(1)。
+ * 播到本轮最后一首时由调用方重新洗牌开始新一轮（当前曲目排在新一轮第一位，不会紧接着重复）。
+ *
+ * 列表增删时就地修正：追加的歌曲随机插进待播区（O(1)），删除只平移下标（O(n)，与列表删除本身同阶）。
+ * 就地修正与点选都返回对排列的具体改动，调用方据此增量持久化，不必每次写出整个排列。
+ * 带权重洗牌用指数键（key = -ln(u) / w，升序）：权重大的更可能排在前面，但每轮仍然每首只出现一次。
+ */
+class ShuffleOrder {
+public:
+    // moveTo 对排列的改动：Swap 为 from、to 两个位置对换；Move 为 from 处的下标挪到 to，其间的依次前移
+    struct Change {
+        enum Kind { None, Swap, Move } kind = None;
+        int from = -1;
+        int to = -1;
+        explicit operator bool() const { return kind != None; }
+    };
+
+    ShuffleOrder();
+
+    bool isValid() const { return m_valid; }
+    void invalidate();
+    int size() const { return int(m_order.size()); }
+
+    // 重新洗牌：current 排第一位并视为已播（-1 表示没有当前曲目）；weights 为空时等概率
+    void build(int size, int current, const std::vector<double>& weights = {});
+    // 从持久化数据恢复；order 不是 0..size-1 的排列时返回 false 并保持原状
+    bool restore(const QList<int>& order, int cursor, int size);
+
+    int peekNext() const;       // 本轮下一首的列表下标，本轮已播完时为 -1
+    int peekPrevious() const;   // 本轮上一首的列表下标，没有时为 -1
+    QList<int> peekAhead(int count) const;   // 本轮接下来至多 count 首
+    bool atCycleEnd() const { return m_valid && m_cursor >= size() - 1; }
+
+    // 当前曲目变成 index：顺序前后移动 O(1)；手动点选的待播歌曲换到 cursor 之后；
+    // 点选本轮已播的歌曲时把它挪到已播区末尾。返回排列本身的改动（只移动 cursor 时为 None）
+    Change moveTo(int index);
+
+    // 列表末尾追加了 index（== 新的 size - 1）：放到返回的位置，原来在那里的挪到末尾；
+    // index 对不上时整个排列失效，返回 -1
+    int insertAppended(int index);
+    // 列表删除了 index，之后的下标前移
+    void remove(int index);
+
+    QList<int> order() const;
+    int cursor() const { return m_cursor; }
+
+private:
+    void place(int position, int index);
+
+    std::vector<int> m_order;       // 位置 → 列表下标
+    std::vector<int> m_positionOf;  // 列表下标 → 位置
+    int m_cursor = -1;
+    bool m_valid = false;
+    QRandomGenerator m_rng;
+};
@@ -0,0 +1,264 @@
+// service/SongSearchIndex.cpp
+#include "SongSearchIndex.h"
+#include "../common/PinyinHelper.h"
+#include <algorithm>
+
+namespace {
+    // 词边界符：补在每个词左侧，使 "^^a" / "^ab" 这类三元组代表词首前缀
+    const QChar kBoundary(0x0001);
+
+    // 墓碑数量超过该值且超过文档数的 1/4 时压缩
+    constexpr int kCompactMinDead = 1024;
+
+    bool containsCjk(const QString& text) {
+        for (const QChar c : text) {
+            if (PinyinHelper::isHan(c) || PinyinHelper::isKana(c)) return true;
+        }
+        return false;
+    }
+
+    bool containsHan(const QString& text) {
+        for (const QChar c : text) {
+            if (PinyinHelper::isHan(c)) return true;
+        }
+        return false;
+    }
+}
+
+SongSearchIndex::Gram SongSearchIndex::makeGram(QChar a, QChar b, QChar c) {
+    return (Gram(3) << 48) | (Gram(a.unicode()) << 32) | (Gram(b.unicode()) << 16) | Gram(c.unicode());
+}
+
+SongSearchIndex::Gram SongSearchIndex::makeUnigram(QChar c) {
+    return (Gram(1) << 48) | Gram(c.unicode());
+}
+
+QStringList SongSearchIndex::searchKeysFor(const Song& song) {
+    QStringList keys;
+    const QString title = PinyinHelper::normalize(song.getTitle());
+    const QString artist = PinyinHelper::normalize(song.getArtist());
+    keys << title << artist;
+
+    for (const QString& text : { title, artist }) {
+        if (containsHan(text)) {
+            QString pinyin = PinyinHelper::toPinyin(text);
+            pinyin.remove(' '); // "qing tian" -> "qingtian"，连续输入全拼也能命中
+            if (pinyin != text) keys << pinyin;
+            keys << PinyinHelper::toInitials(text);
+        }
+        if (containsCjk(text)) {
+            const QString romaji = PinyinHelper::toRomaji(text);
+            if (romaji != text) keys << romaji;
+        }
+    }
+
+    keys.removeAll(QString());
+    keys.removeDuplicates();
+    return keys;
+}
+
+void SongSearchIndex::collectGrams(const QString& text, QVector<Gram>& out) {
+    const QStringList tokens = text.split(' ', Qt::SkipEmptyParts);
+    for (const QString& token : tokens) {
+        const QString padded = QString(2, kBoundary) + token;
+        for (int i = 0; i + 2 < padded.size(); ++i) {
+            out.append(makeGram(padded.at(i), padded.at(i + 1), padded.at(i + 2)));
+        }
+        for (const QChar c : token) {
+            if (PinyinHelper::isHan(c) || PinyinHelper::isKana(c)) {
+                out.append(makeUnigram(c));
+            }
+        }
+    }
+}
+
+SongSearchIndex::QueryPlan SongSearchIndex::planQuery(const QString& normalizedQuery) {
+    QueryPlan plan;
+    const QStringList tokens = normalizedQuery.split(' ', Qt::SkipEmptyParts);
+
+    for (const QString& token : tokens) {
+        // 一两个字的中文 / 日文：按单字匹配（子串语义）
+        if (token.size() <= 2 && containsCjk(token)) {
+            for (const QChar c : token) plan.grams.append(makeUnigram(c));
+            plan.minHits += token.size();
+            continue;
+        }
+
+        // 一两个字符的拉丁字母：只做词首前缀匹配
+        const QString padded = QString(2, kBoundary) + token;
+        if (token.size() <= 2) {
+            for (int i = 0; i < token.size(); ++i) {
+                plan.grams.append(makeGram(padded.at(i), padded.at(i + 1), padded.at(i + 2)));
+            }
+            plan.minHits += token.size();
+            continue;
+        }
+
+        // 三个字符以上：子串三元组；较短时要求全部命中
+        const int core = token.size() - 2;
+        for (int i = 0; i < core; ++i) {
+            plan.grams.append(makeGram(token.at(i), token.at(i + 1), token.at(i + 2)));
+        }
+        if (core < 3) {
+            plan.minHits += core;
+            continue;
+        }
+
+        // 较长的词再加上两个词首三元组，允许缺失若干个（每处拼写错误最多破坏三个三元组）
+        plan.grams.append(makeGram(padded.at(0), padded.at(1), padded.at(2)));
+        plan.grams.append(makeGram(padded.at(1), padded.at(2), padded.at(3)));
+        plan.minHits += core - (core - 3) / 3;
+    }
+
+    std::sort(plan.grams.begin(), plan.grams.end());
+    plan.grams.erase(std::unique(plan.grams.begin(), plan.grams.end()), plan.grams.end());
+    plan.minHits = std::clamp(plan.minHits, 1, int(plan.grams.size()));
+    return plan;
+}
+
+// ========== 构建与增量更新 ==========
+
+void SongSearchIndex::build(const QList<Song>& songs) {
+    clear();
+    m_docs.reserve(songs.size());
+    m_ordinalById.reserve(songs.size());
+    for (const Song& song : songs) {
+        if (song.getId().isEmpty() || m_ordinalById.contains(song.getId())) continue;
+        insertDocument(song);
+    }
+}
+
+void SongSearchIndex::addOrUpdate(const Song& song) {
+    if (song.getId().isEmpty()) return;
+
+    auto it = m_ordinalById.constFind(song.getId());
+    if (it != m_ordinalById.constEnd()) {
+        // Song::operator== 只比较 ID：这里按检索用到的文本比较。
+        // 文本没变（例如只切换了收藏）只替换结果里的歌曲信息，不重建倒排
+        Document& doc = m_docs[it.value()];
+        if (searchKeysFor(song).join('\n') == doc.keys) {
+            doc.song = song;
+            return;
+        }
+        remove(song.getId());
+    }
+    insertDocument(song);
+}
+
+void SongSearchIndex::remove(const QString& songId) {
+    auto it = m_ordinalById.find(songId);
+    if (it == m_ordinalById.end()) return;
+
+    Document& doc = m_docs[it.value()];
+    doc.alive = false;
+    doc.song = Song();
+    doc.title.clear();
+    doc.keys.clear();
+    m_ordinalById.erase(it);
+    ++m_deadCount;
+
+    if (m_deadCount > kCompactMinDead && m_deadCount * 4 > m_docs.size()) {
+        compact();
+    }
+}
+
+void SongSearchIndex::clear() {
+    m_docs.clear();
+    m_ordinalById.clear();
+    m_postings.clear();
+    m_hitCounts.clear();
+    m_touched.clear();
+    m_deadCount = 0;
+}
+
+void SongSearchIndex::insertDocument(const Song& song) {
+    const quint32 ordinal = quint32(m_docs.size());
+    const QStringList keys = searchKeysFor(song);
+
+    Document doc;
+    doc.song = song;
+    doc.title = keys.value(0);
+    doc.keys = keys.join('\n');
+    m_docs.append(doc);
+    m_ordinalById.insert(song.getId(), ordinal);
+
+    QVector<Gram> grams;
+    for (const QString& key : keys) collectGrams(key, grams);
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    for (Gram g : grams) {
+        m_postings[g].append(ordinal);
+    }
+}
+
+void SongSearchIndex::compact() {
+    QList<Song> alive;
+    alive.reserve(m_ordinalById.size());
+    for (const Document& doc : std::as_const(m_docs)) {
+        if (doc.alive) alive.append(doc.song);
+    }
+    build(alive);
+}
+
+// ========== 查询 ==========
+
+QList<Song> SongSearchIndex::search(const QString& keyword, int topK) const {
+    QList<Song> result;
+    const QString query = PinyinHelper::normalize(keyword);
+    if (query.isEmpty() || topK <= 0 || m_ordinalById.isEmpty()) return result;
+
+    const QueryPlan plan = planQuery(query);
+    if (plan.grams.isEmpty()) return result;
+
+    // 1) 累加每个文档命中的三元组数
+    if (m_hitCounts.size() < m_docs.size()) m_hitCounts.resize(m_docs.size());
+    m_touched.clear();
+    for (Gram g : plan.grams) {
+        auto it = m_postings.constFind(g);
+        if (it == m_postings.constEnd()) continue;
+        for (quint32 ordinal : it.value()) {
+            if (m_hitCounts[ordinal]++ == 0) m_touched.append(ordinal);
+        }
+    }
+
+    // 2) 过滤并打分：命中率为基础分，标题前缀 / 子串 / 其他字段子串依次加分
+    struct Scored {
+        quint32 ordinal;
+        int score;
+    };
+    QVector<Scored> scored;
+    scored.reserve(m_touched.size());
+    const int total = plan.grams.size();
+
+    for (quint32 ordinal : std::as_const(m_touched)) {
+        const int hits = m_hitCounts[ordinal];
+        m_hitCounts[ordinal] = 0;
+
+        const Document& doc = m_docs.at(ordinal);
+        if (!doc.alive || hits < plan.minHits) continue;
+
+        int score = hits * 100 / total;
+        if (doc.title.startsWith(query)) score += 300;
+        else if (doc.title.contains(query)) score += 200;
+        else if (doc.keys.contains(query)) score += 150;
+        scored.append({ ordinal, score });
+    }
+
+    // 3) 只对前 topK 部分排序；同分时标题短的优先
+    const int k = std::min<int>(topK, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + k, scored.end(),
+        [this](const Scored& a, const Scored& b) {
+            if (a.score != b.score) return a.score > b.score;
+            const int la = m_docs.at(a.ordinal).title.size();
+            const int lb = m_docs.at(b.ordinal).title.size();
+            if (la != lb) return la < lb;
+            return a.ordinal < b.ordinal;
+        });
+
+    result.reserve(k);
+    for (int i = 0; i < k; ++i) {
+        result.append(m_docs.at(scored.at(i).ordinal).song);
+    }
+    return result;
+}
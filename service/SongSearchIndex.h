@@ -0,0 +1,68 @@
+// service/SongSearchIndex.h
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+#include "../common/entities/Song.h"
+
+/**
+ * @brief 歌曲内存搜索索引（三元组倒排索引）
+ *
+ * - 索引字段：标题、艺术家，以及二者的拼音全拼、拼音首字母、假名罗马字
+ * - 每个词左侧补两个边界符后切三元组，因此既支持词首前缀匹配，也支持子串匹配；
+ *   汉字 / 假名额外建立单字索引，支持一两个字的中文查询
+ * - 容错：较长的查询允许部分三元组缺失（拼写错误），按命中率与精确匹配加分排序
+ * - 增量更新：addOrUpdate / remove 使用墓碑标记，墓碑过多时自动压缩
+ *
+ * 非线程安全：可在任意线程构建，之后只在所属线程（UI 线程）使用。
+ */
+class SongSearchIndex {
+public:
+    SongSearchIndex() = default;
+
+    void build(const QList<Song>& songs);
+    void addOrUpdate(const Song& song);
+    void remove(const QString& songId);
+    void clear();
+
+    // 返回按相关度排序的前 topK 首歌曲
+    QList<Song> search(const QString& keyword, int topK) const;
+
+    int size() const { return m_ordinalById.size(); }
+    bool contains(const QString& songId) const { return m_ordinalById.contains(songId); }
+
+private:
+    using Gram = quint64;
+
+    struct Document {
+        Song song;
+        QString title;  // 规范化后的标题
+        QString keys;   // 所有可检索文本（规范化），用于精确匹配加分
+        bool alive = true;
+    };
+
+    struct QueryPlan {
+        QVector<Gram> grams;
+        int minHits = 0;
+    };
+
+    static Gram makeGram(QChar a, QChar b, QChar c);
+    static Gram makeUnigram(QChar c);
+    static QStringList searchKeysFor(const Song& song);
+    static void collectGrams(const QString& text, QVector<Gram>& out);
+    static QueryPlan planQuery(const QString& normalizedQuery);
+
+    void insertDocument(const Song& song);
+    void compact();
+
+    QVector<Document> m_docs;
+    QHash<QString, quint32> m_ordinalById;
+    QHash<Gram, QVector<quint32>> m_postings;
+    int m_deadCount = 0;
+
+    // 查询用的临时计数器，按文档序号复用，避免每次查询分配
+    mutable QVector<quint16> m_hitCounts;
+    mutable QVector<quint32> m_touched;
+};
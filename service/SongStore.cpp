@@ -0,0 +1,50 @@
+// service/SongStore.cpp
+#include "SongStore.h"
+
+SongStore& SongStore::instance() {
+    static SongStore instance;
+    return instance;
+}
+
+// ========== 引用 ==========
+void SongStore::retain(const Song& song) {
+    if (song.getId().isEmpty()) return;
+    Entry& e = m_entries[song.getId()];
+    e.song = song;
+    ++e.refs;
+}
+
+void SongStore::retain(const QList<Song>& songs) {
+    m_entries.reserve(m_entries.size() + songs.size());
+    for (const Song& song : songs) retain(song);
+}
+
+void SongStore::release(const QString& id) {
+    auto it = m_entries.find(id);
+    if (it == m_entries.end()) return;
+    if (--it->refs <= 0) m_entries.erase(it);
+}
+
+void SongStore::release(const QStringList& ids) {
+    for (const QString& id : ids) release(id);
+}
+
+// ========== 查询 ==========
+Song SongStore::song(const QString& id) const {
+    auto it = m_entries.constFind(id);
+    return it == m_entries.constEnd() ? Song() : it->song;
+}
+
+QList<Song> SongStore::songs(const QStringList& ids) const {
+    QList<Song> out;
+    out.reserve(ids.size());
+    for (const QString& id : ids) {
+        auto it = m_entries.constFind(id);
+        out << (it == m_entries.constEnd() ? Song() : it->song);
+    }
+    return out;
+}
+
+int SongStore::size() const {
+    return m_entries.size();
+}
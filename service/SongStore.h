@@ -0,0 +1,40 @@
+// service/SongStore.h
+#pragma once
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include "../common/entities/Song.h"
+
+/**
+ * @brief 播放相关的中央歌曲表（ID → Song）
+ *
+ * 播放列表与播放队列只保存歌曲 ID，歌曲信息在这里按 ID 存一份，按引用计数保留：
+ * 列表换掉或出队时 release 旧 ID，没有任何列表引用的歌曲随之移除。
+ * 只在引擎线程读写（不加锁）；界面需要歌曲时经 PlaybackService::getCurrentPlaylist / getPlaybackQueue 到引擎线程取。
+ */
+class SongStore {
+public:
+    static SongStore& instance();
+
+    // 保留歌曲（已存在时引用加一并以新的信息为准）
+    void retain(const Song& song);
+    void retain(const QList<Song>& songs);
+    void release(const QString& id);
+    void release(const QStringList& ids);
+
+    Song song(const QString& id) const;          // 不存在时返回空 Song
+    QList<Song> songs(const QStringList& ids) const;
+    int size() const;
+
+private:
+    SongStore() = default;
+    SongStore(const SongStore&) = delete;
+    SongStore& operator=(const SongStore&) = delete;
+
+    struct Entry {
+        Song song;
+        int refs = 0;
+    };
+
+    QHash<QString, Entry> m_entries;
+};
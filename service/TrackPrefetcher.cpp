@@ -0,0 +1,179 @@
+#include "TrackPrefetcher.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+#include <QDebug>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#endif
+
+TrackPrefetcher::TrackPrefetcher() {
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName("TrackPrefetcher");
+    m_thread->start(QThread::LowestPriority);
+}
+
+TrackPrefetcher::~TrackPrefetcher() {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopRequested = true;
+        m_generation.fetch_add(1);
+        m_wake.wakeAll();
+    }
+    m_thread->wait();
+    delete m_thread;
+}
+
+// ========== 对外接口 ==========
+void TrackPrefetcher::setTargets(const QStringList& filePaths) {
+    QMutexLocker locker(&m_mutex);
+    if (filePaths == m_targets) return;
+    m_targets = filePaths;
+
+    // 只保留仍在目标里的记录，刚开始播放的那首已在 noteTrackStarted 里统计过
+    for (auto it = m_warmedBytes.begin(); it != m_warmedBytes.end();) {
+        if (filePaths.contains(it.key())) ++it;
+        else it = m_warmedBytes.erase(it);
+    }
+
+    m_generation.fetch_add(1);
+    m_wake.wakeAll();
+}
+
+void TrackPrefetcher::setBudgetBytes(qint64 bytes) {
+    QMutexLocker locker(&m_mutex);
+    m_budgetBytes = qMax<qint64>(0, bytes);
+    m_generation.fetch_add(1);
+    m_wake.wakeAll();
+}
+
+void TrackPrefetcher::noteTrackStarted(const QString& filePath) {
+    if (filePath.isEmpty()) return;
+    const qint64 head = qMin(QFileInfo(filePath).size(), kHeadBytes);
+
+    QMutexLocker locker(&m_mutex);
+    const bool hit = head > 0 && m_warmedBytes.value(filePath) >= head;
+    if (hit) ++m_stats.hits;
+    else ++m_stats.misses;
+
+    const int total = m_stats.hits + m_stats.misses;
+    qDebug() << (hit ? "📀 预读命中:" : "📀 预读未命中:") << QFileInfo(filePath).fileName()
+        << QString("（%1/%2，%3%）").arg(m_stats.hits).arg(total)
+        .arg(total > 0 ? m_stats.hits * 100 / total : 0);
+}
+
+TrackPrefetcher::Stats TrackPrefetcher::stats() const {
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+bool TrackPrefetcher::isStale(quint64 generation) const {
+    return m_generation.load(std::memory_order_relaxed) != generation;
+}
+
+// ========== 预读线程 ==========
+void TrackPrefetcher::run() {
+    lowerIoPriority();
+    quint64 seenGeneration = 0;
+
+    for (;;) {
+        QStringList targets;
+        qint64 budget = 0;
+        quint64 generation = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_stopRequested && m_generation.load() == seenGeneration) {
+                m_wake.wait(&m_mutex);
+            }
+            if (m_stopRequested) return;
+            generation = seenGeneration = m_generation.load();
+            targets = m_targets;
+            budget = m_budgetBytes;
+        }
+
+        // 第一轮只读开头，保证每首都能快速起播；第二轮在预算内读完整文件
+        QHash<QString, qint64> planned;
+        qint64 used = 0;
+        for (int pass = 0; pass < 2 && !isStale(generation); ++pass) {
+            for (const QString& path : targets) {
+                if (isStale(generation) || used >= budget) break;
+
+                const qint64 size = QFileInfo(path).size();
+                if (size <= 0) continue;
+                const qint64 want = pass == 0 ? qMin(size, kHeadBytes) : size;
+                const qint64 from = planned.value(path);
+                const qint64 length = qMin(want - from, budget - used);
+                if (length <= 0) continue;
+
+                qint64 warmed = 0;
+                {
+                    QMutexLocker locker(&m_mutex);
+                    warmed = m_warmedBytes.value(path);
+                }
+                // 已经读过的部分不重复读取
+                const qint64 start = qMax(from, warmed);
+                const qint64 end = from + length;
+                if (start < end && !warmRange(path, start, end - start, generation)) break;
+
+                planned[path] = end;
+                used += length;
+                if (start < end) {
+                    QMutexLocker locker(&m_mutex);
+                    m_warmedBytes[path] = qMax(m_warmedBytes.value(path), end);
+                    m_stats.bytesPrefetched += end - start;
+                }
+            }
+        }
+    }
+}
+
+bool TrackPrefetcher::warmRange(const QString& filePath, qint64 offset, qint64 length, quint64 generation) {
+    const qint64 end = offset + length;
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    const int fd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return true;   // 打不开就跳过这首，不影响其余目标
+    bool completed = true;
+    // 分块提交，目标变化时能及时放弃
+    for (qint64 pos = offset; pos < end; pos += kChunkBytes) {
+        if (isStale(generation)) { completed = false; break; }
+        const qint64 chunk = qMin(kChunkBytes, end - pos);
+#ifdef Q_OS_LINUX
+        ::posix_fadvise(fd, off_t(pos), off_t(chunk), POSIX_FADV_WILLNEED);
+#else
+        struct radvisory advice;
+        advice.ra_offset = off_t(pos);
+        advice.ra_count = int(chunk);
+        ::fcntl(fd, F_RDADVISE, &advice);
+#endif
+    }
+    ::close(fd);
+    return completed;
+#else
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(offset)) return true;
+    QByteArray buffer(int(kChunkBytes), Qt::Uninitialized);
+    for (qint64 pos = offset; pos < end; pos += kChunkBytes) {
+        if (isStale(generation)) return false;
+        const qint64 chunk = qMin(kChunkBytes, end - pos);
+        if (file.read(buffer.data(), chunk) <= 0) break;
+    }
+    return true;
+#endif
+}
+
+void TrackPrefetcher::lowerIoPriority() {
+#ifdef Q_OS_LINUX
+    // ioprio_set(IOPRIO_WHO_PROCESS, 当前线程, IOPRIO_CLASS_IDLE)：只在磁盘空闲时读取，不抢播放的 I/O
+    constexpr int kIoprioWhoProcess = 1;
+    constexpr int kIoprioClassIdle = 3;
+    constexpr int kIoprioClassShift = 13;
+    ::syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, kIoprioClassIdle << kIoprioClassShift);
+#endif
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QWaitCondition>
+#include <atomic>
+
+class QThread;
+
+/**
+ * @brief 即将播放曲目的预读器
+ *
+ * 播放服务把接下来要播的 N 首（队列优先，其次播放列表顺序）的文件路径交给 setTargets，
+ * 后台低优先级线程按顺序把文件读入系统页缓存：先读每首的开头 kHeadBytes，
+ * 预算有剩余再读完整文件，总量不超过 budgetBytes。
+ *
+ *   Linux   posix_fadvise(WILLNEED)，线程 I/O 优先级设为 idle
+ *   macOS   fcntl(F_RDADVISE)
+ *   其他    分块顺序读取（数据丢弃，只为留在缓存里）
+ *
+ * 曲目开始播放时调用 noteTrackStarted 统计命中：开头已预读即算命中。
+ */
+class TrackPrefetcher {
+public:
+    struct Stats {
+        int hits = 0;
+        int misses = 0;
+        qint64 bytesPrefetched = 0;
+    };
+
+    TrackPrefetcher();
+    ~TrackPrefetcher();
+    TrackPrefetcher(const TrackPrefetcher&) = delete;
+    TrackPrefetcher& operator=(const TrackPrefetcher&) = delete;
+
+    // 新的目标列表会打断正在进行的预读；空列表表示停止
+    void setTargets(const QStringList& filePaths);
+    void setBudgetBytes(qint64 bytes);
+
+    void noteTrackStarted(const QString& filePath);
+    Stats stats() const;
+
+    static constexpr qint64 kHeadBytes = 2 * 1024 * 1024;
+
+private:
+    void run();
+    // 预读 [offset, offset + length)；目标列表变化时提前返回 false
+    bool warmRange(const QString& filePath, qint64 offset, qint64 length, quint64 generation);
+    bool isStale(quint64 generation) const;
+    static void lowerIoPriority();
+
+    static constexpr qint64 kChunkBytes = 1024 * 1024;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    QStringList m_targets;
+    qint64 m_budgetBytes = 256 * 1024 * 1024;
+    QHash<QString, qint64> m_warmedBytes;   // 路径 → 已从文件头连续预读的字节数
+    Stats m_stats;
+    bool m_stopRequested = false;
+
+    std::atomic<quint64> m_generation{ 0 };  // 每次 setTargets +1
+    QThread* m_thread = nullptr;
+};
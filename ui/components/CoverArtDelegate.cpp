@@ -0,0 +1,83 @@
+// ui/components/CoverArtDelegate.cpp
+#include "CoverArtDelegate.h"
+#include "../../service/CoverArtService.h"
+#include <QAbstractItemView>
+#include <QApplication>
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyle>
+
+namespace {
+    constexpr int kCoverMargin = 6;   // 封面上下留白
+    constexpr int kMaxCoverSide = 32; // 封面最大边长（逻辑像素）
+}
+
+CoverArtDelegate::CoverArtDelegate(QAbstractItemView* view)
+    : QStyledItemDelegate(view)
+    , m_view(view)
+{
+    // 任意封面就绪即刷新可见区域（多次 update 会被合并为一次重绘）
+    connect(&CoverArtService::instance(), &CoverArtService::coverReady, this,
+        [this](const QString&, int, const QPixmap&) {
+            if (m_view) m_view->viewport()->update();
+        });
+}
+
+void CoverArtDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    QStyleOptionViewItem opt(option);
+    initStyleOption(&opt, index);
+
+    const int side = qMin(kMaxCoverSide, opt.rect.height() - 2 * kCoverMargin);
+    const qreal dpr = m_view ? m_view->devicePixelRatioF() : 1.0;
+
+    QPixmap pixmap;
+    if (side > 0) {
+        const QString songId = index.data(SongIdRole).toString();
+        const QString filePath = index.data(FilePathRole).toString();
+        pixmap = CoverArtService::instance().cover(songId, filePath, qRound(side * dpr));
+        if (pixmap.isNull()) {
+            pixmap = placeholder(side, dpr);
+        }
+        else {
+            pixmap.setDevicePixelRatio(dpr);
+        }
+    }
+
+    // 作为装饰图交给样式绘制，选中/悬停背景与文字布局保持原样
+    if (!pixmap.isNull()) {
+        opt.features |= QStyleOptionViewItem::HasDecoration;
+        opt.icon = QIcon(pixmap);
+        opt.decorationSize = QSize(side, side);
+        opt.decorationAlignment = Qt::AlignCenter;
+    }
+
+    const QWidget* widget = opt.widget;
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+}
+
+QPixmap CoverArtDelegate::placeholder(int side, qreal dpr) const {
+    const int pixelSide = qRound(side * dpr);
+    if (m_placeholder.width() == pixelSide) return m_placeholder;
+
+    QPixmap pm(pixelSide, pixelSide);
+    pm.fill(Qt::transparent);
+    pm.setDevicePixelRatio(dpr);
+
+    QPainter p(&pm);
+    p.setRenderHint(QPainter::Antialiasing);
+    QPainterPath path;
+    path.addRoundedRect(QRectF(0, 0, side, side), 4, 4);
+    QColor fill = m_view ? m_view->palette().color(QPalette::Mid) : QColor(Qt::gray);
+    fill.setAlpha(80);
+    p.fillPath(path, fill);
+    p.setPen(QColor(0xFB, 0x72, 0x99));
+    QFont font = p.font();
+    font.setPixelSize(qMax(8, side / 2));
+    p.setFont(font);
+    p.drawText(QRectF(0, 0, side, side), Qt::AlignCenter, QStringLiteral("♪"));
+    p.end();
+
+    m_placeholder = pm;
+    return m_placeholder;
+}
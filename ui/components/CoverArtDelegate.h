@@ -0,0 +1,30 @@
+// ui/components/CoverArtDelegate.h
+#pragma once
+#include <QStyledItemDelegate>
+#include <QPixmap>
+
+class QAbstractItemView;
+
+/**
+ * @brief 在单元格左侧绘制封面缩略图的委托（用于歌曲表的标题列）
+ *
+ * 封面通过 CoverArtService 异步加载：只有实际绘制（可见）的行才会发起请求，
+ * 未就绪时绘制占位图，加载完成后刷新视图。
+ */
+class CoverArtDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+public:
+    // 单元格中歌曲ID / 本地文件路径所在的数据角色
+    static constexpr int SongIdRole = Qt::UserRole + 1;
+    static constexpr int FilePathRole = Qt::UserRole + 2;
+
+    explicit CoverArtDelegate(QAbstractItemView* view);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    QPixmap placeholder(int side, qreal dpr) const;
+
+    QAbstractItemView* m_view;
+    mutable QPixmap m_placeholder;
+};
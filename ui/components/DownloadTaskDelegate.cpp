@@ -0,0 +1,96 @@
+// ui/components/DownloadTaskDelegate.cpp
+#include "DownloadTaskDelegate.h"
+#include "DownloadTaskModel.h"
+#include <QApplication>
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyle>
+
+namespace {
+    constexpr int kRowHeight = 72;
+    constexpr int kHMargin = 15;
+    constexpr int kVMargin = 10;
+    constexpr int kBarHeight = 8;
+    constexpr int kPercentWidth = 44;
+    const QColor kAccent(0xFB, 0x72, 0x99);
+    const QColor kFailed(0xE5, 0x39, 0x35);
+    const QColor kDone(0x43, 0xA0, 0x47);
+}
+
+DownloadTaskDelegate::DownloadTaskDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+QSize DownloadTaskDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    Q_UNUSED(index);
+    return QSize(option.rect.width(), kRowHeight);
+}
+
+void DownloadTaskDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    // 背景（悬停/选中）仍交给样式绘制，文字由下面自行绘制
+    QStyleOptionViewItem bg(option);
+    initStyleOption(&bg, index);
+    bg.text.clear();
+    bg.icon = QIcon();
+    const QWidget* widget = bg.widget;
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &bg, painter, widget);
+
+    const QString title = index.data(DownloadTaskModel::TitleRole).toString();
+    const QString status = index.data(DownloadTaskModel::StatusTextRole).toString();
+    const double progress = qBound(0.0, index.data(DownloadTaskModel::ProgressRole).toDouble(), 1.0);
+    const auto state = static_cast<DownloadTaskModel::State>(index.data(DownloadTaskModel::StateRole).toInt());
+
+    const QRect content = option.rect.adjusted(kHMargin, kVMargin, -kHMargin, -kVMargin);
+    const QColor textColor = option.palette.color(QPalette::Text);
+    QColor subColor = textColor;
+    subColor.setAlphaF(0.6);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // 第一行：标题
+    QFont titleFont = option.font;
+    titleFont.setBold(true);
+    painter->setFont(titleFont);
+    painter->setPen(textColor);
+    const QFontMetrics titleFm(titleFont);
+    const QRect titleRect(content.left(), content.top(), content.width(), titleFm.height());
+    painter->drawText(titleRect, Qt::AlignLeft | Qt::AlignVCenter,
+        titleFm.elidedText(title, Qt::ElideRight, titleRect.width()));
+
+    // 第二行：进度条 + 百分比
+    const int barTop = titleRect.bottom() + 8;
+    const QRectF barRect(content.left(), barTop, content.width() - kPercentWidth, kBarHeight);
+    QColor track = textColor;
+    track.setAlphaF(0.12);
+    QPainterPath trackPath;
+    trackPath.addRoundedRect(barRect, kBarHeight / 2.0, kBarHeight / 2.0);
+    painter->fillPath(trackPath, track);
+
+    const QColor barColor = state == DownloadTaskModel::State::Failed ? kFailed
+        : state == DownloadTaskModel::State::Completed ? kDone : kAccent;
+    if (progress > 0.0) {
+        QPainterPath chunk;
+        chunk.addRoundedRect(QRectF(barRect.left(), barRect.top(), barRect.width() * progress, barRect.height()),
+            kBarHeight / 2.0, kBarHeight / 2.0);
+        painter->fillPath(chunk, barColor);
+    }
+
+    QFont smallFont = option.font;
+    smallFont.setPointSizeF(qMax(7.0, option.font.pointSizeF() - 1));
+    painter->setFont(smallFont);
+    painter->setPen(subColor);
+    const QRect percentRect(int(barRect.right()) + 6, barTop - 4, kPercentWidth - 6, kBarHeight + 8);
+    painter->drawText(percentRect, Qt::AlignRight | Qt::AlignVCenter,
+        QString::number(int(progress * 100)) + QLatin1Char('%'));
+
+    // 第三行：状态文字
+    const QFontMetrics smallFm(smallFont);
+    const QRect statusRect(content.left(), barTop + kBarHeight + 6, content.width(), smallFm.height());
+    painter->drawText(statusRect, Qt::AlignLeft | Qt::AlignVCenter,
+        smallFm.elidedText(status, Qt::ElideRight, statusRect.width()));
+
+    painter->restore();
+}
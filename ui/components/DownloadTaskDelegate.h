@@ -0,0 +1,18 @@
+// ui/components/DownloadTaskDelegate.h
+#pragma once
+#include <QStyledItemDelegate>
+
+/**
+ * @brief 下载队列的行委托：标题、进度条、状态文字全部直接绘制
+ *
+ * 配合 DownloadTaskModel 使用，队列中的任务不再各自创建控件。
+ * 行高固定，视图可开启 uniformItemSizes 跳过逐行测量。
+ */
+class DownloadTaskDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+public:
+    explicit DownloadTaskDelegate(QObject* parent = nullptr);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+};
@@ -0,0 +1,170 @@
+// ui/components/DownloadTaskModel.cpp
+#include "DownloadTaskModel.h"
+#include <algorithm>
+
+DownloadTaskModel::DownloadTaskModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int DownloadTaskModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_tasks.size();
+}
+
+int DownloadTaskModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant DownloadTaskModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_tasks.size()) return QVariant();
+    const Task& t = m_tasks.at(index.row());
+
+    switch (role) {
+    case IdentifierRole: return t.identifier;
+    case TitleRole:      return t.title.isEmpty() ? t.identifier : t.title;
+    case StatusTextRole: return t.statusText;
+    case ProgressRole:   return t.progress;
+    case StateRole:      return static_cast<int>(t.state);
+    case Qt::ToolTipRole:
+        return t.note.isEmpty() ? t.identifier : QString("%1\n%2").arg(t.identifier, t.note);
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case StateColumn:    return stateText(t.state);
+        case TitleColumn:    return t.title.isEmpty() ? t.identifier : t.title;
+        case ArtistColumn:   return t.artist.isEmpty() ? QStringLiteral("-") : t.artist;
+        case FinishedColumn: return t.finishedAt.isValid() ? t.finishedAt.toString("yyyy-MM-dd HH:mm") : QString();
+        case NoteColumn:     return t.note;
+        default: break;
+        }
+        break;
+    default:
+        break;
+    }
+    return QVariant();
+}
+
+QVariant DownloadTaskModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case StateColumn:    return QStringLiteral("状态");
+    case TitleColumn:    return QStringLiteral("歌曲标题");
+    case ArtistColumn:   return QStringLiteral("艺术家");
+    case FinishedColumn: return QStringLiteral("完成时间");
+    case NoteColumn:     return QStringLiteral("备注");
+    default: return QVariant();
+    }
+}
+
+QString DownloadTaskModel::stateText(State state) {
+    switch (state) {
+    case State::Waiting:   return QStringLiteral("⏳ 等待");
+    case State::Running:   return QStringLiteral("⏬ 下载中");
+    case State::Completed: return QStringLiteral("✅ 成功");
+    case State::Failed:    return QStringLiteral("❌ 失败");
+    }
+    return QString();
+}
+
+// ========== 行号索引 ==========
+int DownloadTaskModel::rowOf(const QString& identifier) const {
+    auto it = m_rowOf.constFind(identifier);
+    if (it == m_rowOf.cend()) return -1;
+    // 删除只会让其后的行前移，之前的行号仍然有效
+    if (m_staleFrom < 0 || *it < m_staleFrom) return *it;
+    reindexRows();
+    return m_rowOf.value(identifier, -1);
+}
+
+void DownloadTaskModel::reindexRows() const {
+    for (int i = m_staleFrom; i < m_tasks.size(); ++i) {
+        m_rowOf[m_tasks.at(i).identifier] = i;
+    }
+    m_staleFrom = -1;
+}
+
+// ========== 增删 ==========
+bool DownloadTaskModel::appendTask(const Task& task) {
+    if (task.identifier.isEmpty() || m_rowOf.contains(task.identifier)) return false;
+
+    const int row = m_tasks.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_tasks.append(task);
+    m_rowOf.insert(task.identifier, row);
+    endInsertRows();
+    return true;
+}
+
+DownloadTaskModel::Task DownloadTaskModel::takeTask(const QString& identifier) {
+    const int row = rowOf(identifier);
+    if (row < 0) return Task();
+
+    beginRemoveRows(QModelIndex(), row, row);
+    Task task = m_tasks.takeAt(row);
+    m_rowOf.remove(identifier);
+    // 之后的行整体前移一位：行号等下次查找时再重建，连续删除不必每次重编号
+    if (row < m_tasks.size()) m_staleFrom = m_staleFrom < 0 ? row : std::min(m_staleFrom, row);
+    endRemoveRows();
+    return task;
+}
+
+void DownloadTaskModel::reorderTasks(const QStringList& identifiers) {
+    QVector<int> rows;
+    QVector<Task> tasks;
+    QSet<int> seen;
+    for (const QString& identifier : identifiers) {
+        const int row = rowOf(identifier);
+        if (row < 0 || seen.contains(row)) continue;
+        seen.insert(row);
+        rows.append(row);
+        tasks.append(m_tasks.at(row));
+    }
+    if (rows.size() < 2) return;
+
+    std::sort(rows.begin(), rows.end());
+    for (int i = 0; i < rows.size(); ++i) {
+        m_tasks[rows[i]] = tasks[i];
+        m_rowOf[tasks[i].identifier] = rows[i];
+    }
+    // 行数不变，只是行内容互换：对受影响的区间发一次 dataChanged
+    emit dataChanged(index(rows.first(), 0), index(rows.last(), ColumnCount - 1));
+}
+
+void DownloadTaskModel::clear() {
+    if (m_tasks.isEmpty()) return;
+    beginResetModel();
+    m_tasks.clear();
+    m_rowOf.clear();
+    m_staleFrom = -1;
+    endResetModel();
+}
+
+// ========== 更新 ==========
+void DownloadTaskModel::setStatus(const QString& identifier, State state, const QString& statusText) {
+    const int row = rowOf(identifier);
+    if (row < 0) return;
+
+    Task& t = m_tasks[row];
+    if (t.state == state && t.statusText == statusText) return;
+    t.state = state;
+    t.statusText = statusText;
+    emitRowChanged(row);
+}
+
+void DownloadTaskModel::setProgress(const QString& identifier, double progress, const QString& statusText) {
+    const int row = rowOf(identifier);
+    if (row < 0) return;
+
+    Task& t = m_tasks[row];
+    // 进度以百分比整数为粒度，避免同一百分比的重复重绘
+    if (int(t.progress * 100) == int(progress * 100) && t.statusText == statusText) return;
+    t.progress = progress;
+    t.statusText = statusText;
+    if (t.state == State::Waiting) t.state = State::Running;
+    emitRowChanged(row);
+}
+
+void DownloadTaskModel::emitRowChanged(int row) {
+    emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+}
@@ -0,0 +1,76 @@
+// ui/components/DownloadTaskModel.h
+#pragma once
+#include <QAbstractTableModel>
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief 下载任务列表模型（下载队列与下载历史各用一个实例）
+ *
+ * 任务以值的形式存放在连续数组中，另有 identifier -> 行号 的索引，
+ * 进度更新只对单行发出 dataChanged，视图只绘制可见行，上万条任务也不会创建任何控件。
+ * 删除一行时不逐个改写其后的行号，只记下最早过期的行，下次按行号查找时一次重建。
+ *
+ * 列：状态 / 歌曲标题 / 艺术家 / 完成时间 / 备注（历史页按表格显示；队列页只用第 0 列，由委托绘制整行）
+ */
+class DownloadTaskModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum class State { Waiting, Running, Completed, Failed };
+
+    enum Column { StateColumn = 0, TitleColumn, ArtistColumn, FinishedColumn, NoteColumn, ColumnCount };
+
+    enum Role {
+        IdentifierRole = Qt::UserRole + 1,
+        TitleRole,
+        StatusTextRole,
+        ProgressRole,      // 0.0 ~ 1.0
+        StateRole          // State 的整数值
+    };
+
+    struct Task {
+        QString identifier;
+        QString title;
+        QString artist;
+        QString statusText;
+        QString note;
+        double progress = 0.0;
+        State state = State::Waiting;
+        QDateTime finishedAt;
+    };
+
+    explicit DownloadTaskModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    bool contains(const QString& identifier) const { return m_rowOf.contains(identifier); }
+    int rowOf(const QString& identifier) const;
+
+    // 追加到末尾；identifier 已存在时返回 false
+    bool appendTask(const Task& task);
+    // 取出并移除任务；不存在时返回空 Task
+    Task takeTask(const QString& identifier);
+    // 把 identifiers 中已有的任务按给定先后放回它们原来占用的那些行，其余行不动
+    void reorderTasks(const QStringList& identifiers);
+
+    void setStatus(const QString& identifier, State state, const QString& statusText);
+    void setProgress(const QString& identifier, double progress, const QString& statusText);
+
+    void clear();
+
+private:
+    static QString stateText(State state);
+    void emitRowChanged(int row);
+    void reindexRows() const;
+
+    QVector<Task> m_tasks;
+    mutable QHash<QString, int> m_rowOf;   // identifier -> 行号（m_staleFrom 及之后的可能已过期）
+    mutable int m_staleFrom = -1;          // -1 表示索引全部有效
+};
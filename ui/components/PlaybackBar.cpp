@@ -1,5 +1,6 @@
 #include "PlaybackBar.h"
 #include "HoverButton.h"
+#include "../../service/CoverArtService.h"
 
 #include <QDebug>
 #include <QGraphicsDropShadowEffect>
@@ -8,6 +9,10 @@
 #include <QSlider>
 #include <QVBoxLayout>
 
+namespace {
+    constexpr int kCoverSide = 30; // 封面边长（逻辑像素）
+}
+
 PlaybackBar::PlaybackBar(QWidget* parent)
     : QWidget(parent)
     , m_isPlaying(false)
@@ -27,6 +32,14 @@ PlaybackBar::PlaybackBar(QWidget* parent)
             emit positionPreview(m_pendingPreviewValue);
         }
         });
+
+    // 封面异步就绪：只接收当前歌曲、当前尺寸的结果
+    connect(&CoverArtService::instance(), &CoverArtService::coverReady, this,
+        [this](const QString& songId, int size, const QPixmap&) {
+            if (songId == m_currentSong.getId() && size == qRound(kCoverSide * devicePixelRatioF())) {
+                updateCover();
+            }
+        });
 }
 
 void PlaybackBar::setupUI()
@@ -45,10 +58,10 @@ void PlaybackBar::setupUI()
     songInfoLayout->setContentsMargins(16, 8, 16, 8);
     songInfoLayout->setSpacing(0);
 
-    auto* musicIcon = new QLabel("🎵");
-    musicIcon->setStyleSheet("font-size: 20px; color: #FB7299;");
-    musicIcon->setFixedWidth(30);
-    musicIcon->setAlignment(Qt::AlignCenter);
+    m_coverLabel = new QLabel();
+    m_coverLabel->setFixedSize(kCoverSide, kCoverSide);
+    m_coverLabel->setAlignment(Qt::AlignCenter);
+    showDefaultCover();
 
     auto* textContainer = new QWidget();
     auto* textLayout = new QVBoxLayout(textContainer);
@@ -64,7 +77,7 @@ void PlaybackBar::setupUI()
     textLayout->addWidget(m_songTitle);
     textLayout->addWidget(m_artistName);
 
-    songInfoLayout->addWidget(musicIcon);
+    songInfoLayout->addWidget(m_coverLabel);
     songInfoLayout->addWidget(textContainer, 1);
 
     // 中间：播放控制区域
@@ -228,10 +241,33 @@ void PlaybackBar::setSong(const Song& song)
     m_currentSong = song;
     m_songTitle->setText(song.getTitle());
     m_artistName->setText(song.getArtist());
+    updateCover();
+}
+
+void PlaybackBar::updateCover()
+{
+    const qreal dpr = devicePixelRatioF();
+    QPixmap pixmap = CoverArtService::instance().cover(m_currentSong, qRound(kCoverSide * dpr));
+    if (pixmap.isNull()) {
+        showDefaultCover(); // 未就绪或无封面，就绪后由 coverReady 再次刷新
+        return;
+    }
+    pixmap.setDevicePixelRatio(dpr);
+    m_coverLabel->setStyleSheet(QString());
+    m_coverLabel->setText(QString());
+    m_coverLabel->setPixmap(pixmap);
+}
+
+void PlaybackBar::showDefaultCover()
+{
+    m_coverLabel->setPixmap(QPixmap());
+    m_coverLabel->setText("🎵");
+    m_coverLabel->setStyleSheet("font-size: 20px; color: #FB7299;");
 }
 
 void PlaybackBar::setDuration(int seconds)
 {
+    if (seconds == m_totalDuration && m_positionSlider->maximum() == seconds) return;
     m_totalDuration = seconds;
     m_positionSlider->setMaximum(seconds);
     m_totalTimeLabel->setText(formatTime(seconds));
@@ -243,6 +279,10 @@ void PlaybackBar::setPosition(int seconds)
     if (m_isDraggingPosition) {
         return;
     }
+    // 服务端按亚秒间隔推送，显示的秒数没变时不重设文字，避免标签重新排版
+    if (seconds == m_currentPosition && m_positionSlider->value() == seconds) {
+        return;
+    }
     m_currentPosition = seconds;
     m_positionSlider->setValue(seconds);
     m_currentTimeLabel->setText(formatTime(seconds));
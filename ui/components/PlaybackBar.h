@@ -45,7 +45,10 @@ private:
     void updateTimeLabels();
     void updateModeButtonDisplay();
     QString formatTime(int seconds) const;
+    void updateCover();
+    void showDefaultCover();
 
+    QLabel* m_coverLabel = nullptr;
     QLabel* m_songTitle = nullptr;
     QLabel* m_artistName = nullptr;
 
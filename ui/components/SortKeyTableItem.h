@@ -0,0 +1,31 @@
+// ui/components/SortKeyTableItem.h
+#pragma once
+#include <QTableWidgetItem>
+#include <QByteArray>
+
+/**
+ * @brief 按预计算排序键比较的表格项
+ *
+ * 排序键是可逐字节比较的字节串（见 SortKey），比较只是一次 memcmp，
+ * 无需在每次比较时做本地化排序；多列排序通过在键后拼接次要列的键实现。
+ */
+class SortKeyTableItem : public QTableWidgetItem {
+public:
+    static constexpr int Type = QTableWidgetItem::UserType + 1;
+
+    SortKeyTableItem(const QString& text, const QByteArray& sortKey)
+        : QTableWidgetItem(text, Type)
+        , m_sortKey(sortKey)
+    {
+    }
+
+    bool operator<(const QTableWidgetItem& other) const override {
+        if (other.type() != Type) return QTableWidgetItem::operator<(other);
+        return m_sortKey < static_cast<const SortKeyTableItem&>(other).m_sortKey;
+    }
+
+    QTableWidgetItem* clone() const override { return new SortKeyTableItem(*this); }
+
+private:
+    QByteArray m_sortKey;
+};
@@ -10,6 +10,7 @@
 #include <QSignalBlocker>
 #include <QColor>
 #include <QDebug>
+#include <algorithm>
 #include "../../service/PlaybackService.h"
 
 static QString displayTitle(const Song& s) {
@@ -18,6 +19,15 @@ static QString displayTitle(const Song& s) {
     return a.isEmpty() ? t : QString("%1 - %2").arg(t, a);
 }
 
+static QString queueItemText(int row, const Song& s) {
+    return QString::number(row + 1).rightJustified(2, ' ') + ". " + displayTitle(s);
+}
+
+static QString playlistItemText(int row, const Song& s, bool current) {
+    const QString text = queueItemText(row, s);
+    return current ? "▶ " + text : text;
+}
+
 PlaylistDialog::PlaylistDialog(QWidget* parent) : QDialog(parent) {
     setWindowTitle("正在播放");
     setWindowFlag(Qt::Tool);
@@ -66,14 +76,13 @@ void PlaylistDialog::setupUI() {
         }
         });
 
-    // 双击队列项：立即播放该项并从队列移除（等价于“下一首”指定）
+    // 双击队列项：移到队首后立即播放（播放时出队），其余队列保持不变
     connect(m_queueView, &QListWidget::itemDoubleClicked, this, [this](QListWidgetItem* item) {
         if (m_updatingSelection) return;
         int row = m_queueView->row(item);
         if (row >= 0 && row < m_queue.size()) {
             auto& ps = PlaybackService::instance();
-            ps.clearPlaybackQueue();
-            ps.addNextToQueue(m_queue[row]);
+            ps.moveInQueue(row, 0);
             ps.playNext();
         }
         });
@@ -84,27 +93,129 @@ void PlaylistDialog::setupUI() {
         });
 }
 
-void PlaylistDialog::setPlaylist(const QList<Song>& list, int currentIndex) {
+void PlaylistDialog::setPlaylist(const QList<Song>& list, int currentIndex, quint64 revision) {
     m_playlist = list;
+    m_playlistRevision = revision;
     m_currentIndex = currentIndex;
     refreshPlaylist();
 }
 
-void PlaylistDialog::setQueue(const QList<Song>& queue) {
+bool PlaylistDialog::insertPlaylistSongs(int index, const QList<Song>& songs, quint64 revision) {
+    if (revision <= m_playlistRevision) return true;
+    if (index < 0 || index > m_playlist.size() || revision != m_playlistRevision + 1) return false;
+    m_playlistRevision = revision;
+
+    // 就地插入：尾部一次后移，不重建整个列表
+    const qsizetype oldSize = m_playlist.size();
+    m_playlist.resize(oldSize + songs.size());
+    std::move_backward(m_playlist.begin() + index, m_playlist.begin() + oldSize, m_playlist.end());
+    std::copy(songs.cbegin(), songs.cend(), m_playlist.begin() + index);
+    if (m_currentIndex >= index) m_currentIndex += songs.size();
+    {
+        QSignalBlocker block(m_playlistView);
+        for (int i = 0; i < songs.size(); ++i) {
+            m_playlistView->insertItem(index + i, new QListWidgetItem(playlistItemText(index + i, songs[i], false)));
+        }
+    }
+    renumberPlaylist(index + songs.size());
+    return true;
+}
+
+bool PlaylistDialog::removePlaylistSongs(int index, int count, quint64 revision) {
+    if (revision <= m_playlistRevision) return true;
+    if (index < 0 || count < 0 || index + count > m_playlist.size() || revision != m_playlistRevision + 1) return false;
+    m_playlistRevision = revision;
+
+    m_playlist.remove(index, count);
+    int firstDirty = index;
+    if (m_currentIndex >= index + count) {
+        m_currentIndex -= count;
+    }
+    else if (m_currentIndex >= index) {
+        // 与 PlaylistManager 一致：当前曲目被删时停在原位置，越界则退到末尾
+        m_currentIndex = m_playlist.isEmpty() ? -1 : qMin(index, int(m_playlist.size()) - 1);
+        if (m_currentIndex >= 0) firstDirty = qMin(firstDirty, m_currentIndex);
+    }
+    {
+        QSignalBlocker block(m_playlistView);
+        for (int i = 0; i < count; ++i) delete m_playlistView->takeItem(index);
+    }
+    renumberPlaylist(firstDirty);
+    return true;
+}
+
+void PlaylistDialog::renumberPlaylist(int fromRow) {
+    QSignalBlocker block(m_playlistView);
+    for (int i = qMax(0, fromRow); i < m_playlist.size(); ++i) {
+        auto* item = m_playlistView->item(i);
+        if (!item) continue;
+        item->setText(playlistItemText(i, m_playlist[i], i == m_currentIndex));
+        item->setForeground(i == m_currentIndex ? QBrush(QColor("#FB7299")) : QBrush());
+    }
+}
+
+void PlaylistDialog::setQueue(const QList<Song>& queue, quint64 revision) {
     m_queue = queue;
+    m_queueRevision = revision;
     refreshQueue();
 }
 
+bool PlaylistDialog::acceptQueueRevision(quint64 revision) {
+    if (revision != m_queueRevision + 1) return false;
+    m_queueRevision = revision;
+    return true;
+}
+
+bool PlaylistDialog::insertQueueSongs(int index, const QList<Song>& songs, quint64 revision) {
+    if (revision <= m_queueRevision) return true;   // 整体刷新时已包含
+    if (index < 0 || index > m_queue.size() || !acceptQueueRevision(revision)) return false;
+
+    m_queue = m_queue.mid(0, index) + songs + m_queue.mid(index);
+    {
+        QSignalBlocker block(m_queueView);
+        for (int i = 0; i < songs.size(); ++i) {
+            m_queueView->insertItem(index + i, new QListWidgetItem(queueItemText(index + i, songs[i])));
+        }
+    }
+    renumberQueue(index + songs.size());
+    return true;
+}
+
+bool PlaylistDialog::removeQueueSongs(int index, int count, quint64 revision) {
+    if (revision <= m_queueRevision) return true;
+    if (index < 0 || count < 0 || index + count > m_queue.size() || !acceptQueueRevision(revision)) return false;
+
+    m_queue.remove(index, count);
+    for (int i = 0; i < count; ++i) delete m_queueView->takeItem(index);
+    renumberQueue(index);
+    return true;
+}
+
+bool PlaylistDialog::moveQueueSong(int from, int to, quint64 revision) {
+    if (revision <= m_queueRevision) return true;
+    if (from < 0 || from >= m_queue.size() || to < 0 || to >= m_queue.size()
+        || !acceptQueueRevision(revision)) return false;
+
+    m_queue.move(from, to);
+    m_queueView->insertItem(to, m_queueView->takeItem(from));
+    renumberQueue(qMin(from, to));
+    return true;
+}
+
+// 序号只改受影响的那一段之后的行
+void PlaylistDialog::renumberQueue(int fromRow) {
+    QSignalBlocker block(m_queueView);
+    for (int i = qMax(0, fromRow); i < m_queue.size(); ++i) {
+        if (auto* item = m_queueView->item(i)) item->setText(queueItemText(i, m_queue[i]));
+    }
+}
+
 void PlaylistDialog::refreshPlaylist() {
     QSignalBlocker block(m_playlistView);
     m_playlistView->clear();
     for (int i = 0; i < m_playlist.size(); ++i) {
-        QString text = QString::number(i + 1).rightJustified(2, ' ') + ". " + displayTitle(m_playlist[i]);
-        auto* item = new QListWidgetItem(text);
-        if (i == m_currentIndex) {
-            item->setText("▶ " + item->text());
-            item->setForeground(QColor("#FB7299"));
-        }
+        auto* item = new QListWidgetItem(playlistItemText(i, m_playlist[i], i == m_currentIndex));
+        if (i == m_currentIndex) item->setForeground(QColor("#FB7299"));
         m_playlistView->addItem(item);
     }
     if (m_currentIndex >= 0 && m_currentIndex < m_playlist.size()) {
@@ -119,8 +230,7 @@ void PlaylistDialog::refreshQueue() {
     QSignalBlocker block(m_queueView);
     m_queueView->clear();
     for (int i = 0; i < m_queue.size(); ++i) {
-        QString text = QString::number(i + 1).rightJustified(2, ' ') + ". " + displayTitle(m_queue[i]);
-        m_queueView->addItem(new QListWidgetItem(text));
+        m_queueView->addItem(new QListWidgetItem(queueItemText(i, m_queue[i])));
     }
 }
 
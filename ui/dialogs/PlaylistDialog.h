@@ -10,8 +10,17 @@ class PlaylistDialog : public QDialog {
     Q_OBJECT
 public:
     explicit PlaylistDialog(QWidget* parent = nullptr);
-    void setPlaylist(const QList<Song>& list, int currentIndex);
-    void setQueue(const QList<Song>& queue);
+    void setPlaylist(const QList<Song>& list, int currentIndex, quint64 revision);
+
+    // 播放列表增量：规则同队列增量
+    bool insertPlaylistSongs(int index, const QList<Song>& songs, quint64 revision);
+    bool removePlaylistSongs(int index, int count, quint64 revision);
+    void setQueue(const QList<Song>& queue, quint64 revision);
+
+    // 队列增量：revision 不接续时返回 false，调用方应改用 setQueue 整体刷新
+    bool insertQueueSongs(int index, const QList<Song>& songs, quint64 revision);
+    bool removeQueueSongs(int index, int count, quint64 revision);
+    bool moveQueueSong(int from, int to, quint64 revision);
 
 public slots:
     // 仅更新选中行与可视标记，不重建列表
@@ -21,13 +30,18 @@ private:
     void setupUI();
     void refreshPlaylist();
     void refreshQueue();
+    void renumberPlaylist(int fromRow);
+    void renumberQueue(int fromRow);
+    bool acceptQueueRevision(quint64 revision);
 
     QListWidget* m_playlistView = nullptr;
     QListWidget* m_queueView = nullptr;
     QPushButton* m_clearQueueBtn = nullptr;
 
     QList<Song> m_playlist;
+    quint64 m_playlistRevision = 0;
     QList<Song> m_queue;
+    quint64 m_queueRevision = 0;
     int m_currentIndex = -1;
     bool m_updatingSelection = false;
 };
@@ -1,6 +1,7 @@
 // ui/pages/DownloadManagerPage.cpp
 #include "DownloadManagerPage.h"
-#include "../components/DownloadTaskItem.h"
+#include "../components/DownloadTaskModel.h"
+#include "../components/DownloadTaskDelegate.h"
 #include "../../common/AppConfig.h"
 #include "../../service/DownloadService.h"
 
@@ -29,7 +30,9 @@ DownloadManagerPage::DownloadManagerPage(DownloadViewModel* viewModel, QWidget*
     setupConnections();
     loadDefaultSettings();
 
-    // 页面就绪后，同步现有并行任务（若此时已有任务在跑）
+    // 页面是首次打开时才构建的：先用 ViewModel 已缓存的任务回填队列与历史，
+    // 再同步现有并行任务（若此时已有任务在跑）
+    restoreTasksFromViewModel();
     m_viewModel->syncConcurrentTasksToUI();
 
     QString downloadPath = m_viewModel->getDownloadPath();
@@ -112,21 +115,29 @@ void DownloadManagerPage::setupUI()
     m_tabWidget = new QTabWidget();
     m_tabWidget->setObjectName("downloadTabWidget");
 
-    // 下载队列 Tab
-    m_queueList = new QListWidget();
+    // 下载队列 Tab（模型 + 委托绘制，不为每个任务创建控件）
+    m_queueModel = new DownloadTaskModel(this);
+    m_queueList = new QListView();
     m_queueList->setObjectName("downloadQueueList");
-    m_queueList->setSpacing(8);
+    m_queueList->setModel(m_queueModel);
+    m_queueList->setItemDelegate(new DownloadTaskDelegate(m_queueList));
+    m_queueList->setUniformItemSizes(true);
+    m_queueList->setSpacing(4);
+    m_queueList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_queueList->setSelectionMode(QAbstractItemView::ExtendedSelection);
     m_queueList->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
     m_tabWidget->addTab(m_queueList, "⏳ 下载队列");
 
     // 下载历史 Tab
-    m_historyTable = new QTableWidget();
+    m_historyModel = new DownloadTaskModel(this);
+    m_historyTable = new QTableView();
     m_historyTable->setObjectName("downloadHistoryTable");
-    m_historyTable->setColumnCount(5);
-    m_historyTable->setHorizontalHeaderLabels({
-        "状态", "歌曲标题", "艺术家", "完成时间", "备注"
-        });
+    m_historyTable->setModel(m_historyModel);
     m_historyTable->horizontalHeader()->setStretchLastSection(true);
+    m_historyTable->verticalHeader()->setVisible(false);
+    // 固定行高：上万行时无需逐行测量
+    m_historyTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_historyTable->setWordWrap(false);
     m_historyTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_historyTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_tabWidget->addTab(m_historyTable, "📋 下载历史");
@@ -153,7 +164,7 @@ void DownloadManagerPage::setupUI()
             QMessageBox::Yes | QMessageBox::No
         );
         if (reply == QMessageBox::Yes) {
-            m_historyTable->setRowCount(0);
+            m_historyModel->clear();
             m_statusLabel->setText("🗑️ 历史记录已清空");
         }
         });
@@ -187,6 +198,8 @@ void DownloadManagerPage::setupConnections()
         this, &DownloadManagerPage::onTaskFailed);
     connect(m_viewModel, &DownloadViewModel::taskSkipped,
         this, &DownloadManagerPage::onTaskSkipped);
+    connect(m_viewModel, &DownloadViewModel::queueReordered,
+        this, &DownloadManagerPage::onQueueReordered);
 
     // 状态文本自动更新
     connect(m_viewModel, &DownloadViewModel::statusTextChanged, this, [this]() {
@@ -278,9 +291,13 @@ void DownloadManagerPage::onStartDownloadClicked()
 void DownloadManagerPage::onTaskAdded(const QString& identifier)
 {
     qDebug() << "UI: 任务已添加:" << identifier;
-    if (!findTaskItem(identifier)) {
-        addTaskToQueue(identifier);
-    }
+    ensureTaskInQueue(identifier);
+}
+
+void DownloadManagerPage::onQueueReordered(const QStringList& identifiers)
+{
+    qDebug() << "UI: 等待队列已重新排序，共" << identifiers.size() << "个任务";
+    m_queueModel->reorderTasks(identifiers);
 }
 
 void DownloadManagerPage::onTaskStarted(const QString& identifier)
@@ -288,13 +305,8 @@ void DownloadManagerPage::onTaskStarted(const QString& identifier)
     qDebug() << "UI: 任务开始:" << identifier;
 
     // 若 UI 无条目，现场补建
-    if (!findTaskItem(identifier)) {
-        addTaskToQueue(identifier);
-    }
-
-    if (DownloadTaskItem* item = findTaskItem(identifier)) {
-        item->setStatus("正在下载...");
-    }
+    ensureTaskInQueue(identifier);
+    m_queueModel->setStatus(identifier, DownloadTaskModel::State::Running, "正在下载...");
 }
 
 void DownloadManagerPage::onTaskProgressUpdated(
@@ -303,58 +315,20 @@ void DownloadManagerPage::onTaskProgressUpdated(
     const QString& message)
 {
     // 若 UI 无条目，现场补建
-    if (!findTaskItem(identifier)) {
-        addTaskToQueue(identifier);
-    }
-
-    if (DownloadTaskItem* item = findTaskItem(identifier)) {
-        item->setProgress(progress);
-        item->setStatus(message);
-    }
+    ensureTaskInQueue(identifier);
+    m_queueModel->setProgress(identifier, progress, message);
 }
 
 void DownloadManagerPage::onTaskCompleted(const QString& identifier, const Song& song)
 {
     qDebug() << "UI: 任务完成:" << song.getTitle();
-
-    // 若 UI 无条目，先补建再转历史
-    if (!findTaskItem(identifier)) {
-        addTaskToQueue(identifier);
-    }
-
-    moveTaskToHistory(identifier, true);
-
-    // 添加到历史表格
-    int row = m_historyTable->rowCount();
-    m_historyTable->insertRow(row);
-    m_historyTable->setItem(row, 0, new QTableWidgetItem("✅ 成功"));
-    m_historyTable->setItem(row, 1, new QTableWidgetItem(song.getTitle()));
-    m_historyTable->setItem(row, 2, new QTableWidgetItem(song.getArtist()));
-    m_historyTable->setItem(row, 3,
-        new QTableWidgetItem(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm")));
-    m_historyTable->setItem(row, 4, new QTableWidgetItem("下载成功"));
+    moveTaskToHistory(identifier, true, song, "下载成功");
 }
 
 void DownloadManagerPage::onTaskFailed(const QString& identifier, const QString& error)
 {
     qDebug() << "UI: 任务失败:" << identifier << error;
-
-    // 若 UI 无条目，先补建再转历史
-    if (!findTaskItem(identifier)) {
-        addTaskToQueue(identifier);
-    }
-
-    moveTaskToHistory(identifier, false);
-
-    // 添加到历史表格
-    int row = m_historyTable->rowCount();
-    m_historyTable->insertRow(row);
-    m_historyTable->setItem(row, 0, new QTableWidgetItem("❌ 失败"));
-    m_historyTable->setItem(row, 1, new QTableWidgetItem(identifier));
-    m_historyTable->setItem(row, 2, new QTableWidgetItem("-"));
-    m_historyTable->setItem(row, 3,
-        new QTableWidgetItem(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm")));
-    m_historyTable->setItem(row, 4, new QTableWidgetItem(error));
+    moveTaskToHistory(identifier, false, Song(), error);
 }
 
 void DownloadManagerPage::onTaskSkipped(const QString& identifier, const Song& existingSong)
@@ -381,43 +355,66 @@ void DownloadManagerPage::onTaskSkipped(const QString& identifier, const Song& e
     m_urlInput->clear();
 }
 
-void DownloadManagerPage::addTaskToQueue(const QString& identifier)
+void DownloadManagerPage::restoreTasksFromViewModel()
 {
-    DownloadService::DownloadTask tempTask;
-    tempTask.identifier = identifier;
-    tempTask.status = DownloadService::DownloadStatus::Idle;
-
-    auto* taskItem = new DownloadTaskItem(tempTask, this);
-    m_taskItems.insert(identifier, taskItem);
-
-    auto* listItem = new QListWidgetItem(m_queueList);
-    listItem->setSizeHint(taskItem->sizeHint());
-    m_queueList->addItem(listItem);
-    m_queueList->setItemWidget(listItem, taskItem);
+    // 已按顺序给出：队列按加入顺序，历史按完成顺序
+    const auto tasks = m_viewModel->getAllTasks();
+    for (const auto& info : tasks) {
+        DownloadTaskModel::Task task;
+        task.identifier = info.identifier;
+        task.title = info.title;
+        task.progress = info.progress;
+
+        if (info.status == "✅ 完成" || info.status == "❌ 失败") {
+            const bool success = info.status == "✅ 完成";
+            task.state = success ? DownloadTaskModel::State::Completed : DownloadTaskModel::State::Failed;
+            task.progress = success ? 1.0 : info.progress;
+            task.note = success ? QStringLiteral("下载成功") : info.errorMessage;
+            m_historyModel->appendTask(task);
+        }
+        else {
+            task.state = info.progress > 0.0 ? DownloadTaskModel::State::Running : DownloadTaskModel::State::Waiting;
+            task.statusText = info.status;
+            m_queueModel->appendTask(task);
+        }
+    }
+    if (!tasks.isEmpty()) {
+        qDebug() << "📋 已从 ViewModel 回填" << tasks.size() << "个任务";
+    }
 }
 
-void DownloadManagerPage::moveTaskToHistory(const QString& identifier, bool success)
+void DownloadManagerPage::addTaskToQueue(const QString& identifier)
 {
-    Q_UNUSED(success);
-
-    DownloadTaskItem* item = m_taskItems.value(identifier, nullptr);
-    if (!item) return;
+    DownloadTaskModel::Task task;
+    task.identifier = identifier;
+    task.statusText = "等待下载...";
+    m_queueModel->appendTask(task);
+}
 
-    for (int i = 0; i < m_queueList->count(); ++i) {
-        QListWidgetItem* listItem = m_queueList->item(i);
-        if (m_queueList->itemWidget(listItem) == item) {
-            m_queueList->takeItem(i);
-            break;
-        }
+void DownloadManagerPage::ensureTaskInQueue(const QString& identifier)
+{
+    if (!m_queueModel->contains(identifier)) {
+        addTaskToQueue(identifier);
     }
-
-    m_taskItems.remove(identifier);
-    item->deleteLater();
 }
 
-DownloadTaskItem* DownloadManagerPage::findTaskItem(const QString& identifier) const
+void DownloadManagerPage::moveTaskToHistory(const QString& identifier, bool success, const Song& song, const QString& note)
 {
-    return m_taskItems.value(identifier, nullptr);
+    // 队列中没有该条目（例如页面打开前就已开始的任务）时也照常记入历史
+    DownloadTaskModel::Task task = m_queueModel->takeTask(identifier);
+    task.identifier = identifier;
+    if (success) {
+        task.title = song.getTitle();
+        task.artist = song.getArtist();
+    }
+    task.state = success ? DownloadTaskModel::State::Completed : DownloadTaskModel::State::Failed;
+    task.progress = success ? 1.0 : task.progress;
+    task.note = note;
+    task.finishedAt = QDateTime::currentDateTime();
+
+    // 同一 identifier 再次下载时替换旧记录
+    m_historyModel->takeTask(identifier);
+    m_historyModel->appendTask(task);
 }
 
 void DownloadManagerPage::loadDefaultSettings()
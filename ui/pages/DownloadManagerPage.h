@@ -3,16 +3,15 @@
 #include <QLineEdit>
 #include <QComboBox>
 #include <QPushButton>
-#include <QListWidget>
-#include <QTableWidget>
+#include <QListView>
+#include <QTableView>
 #include <QTabWidget>
 #include <QLabel>
-#include <QMap>
 
 #include "../../viewmodel/DownloadViewModel.h" 
 #include "../../common/entities/Song.h"
 
-class DownloadTaskItem;
+class DownloadTaskModel;
 
 class DownloadManagerPage : public QWidget {
     Q_OBJECT
@@ -32,6 +31,7 @@ private slots:
     void onTaskCompleted(const QString& identifier, const Song& song);
     void onTaskFailed(const QString& identifier, const QString& error);
     void onTaskSkipped(const QString& identifier, const Song& existingSong);
+    void onQueueReordered(const QStringList& identifiers);
     void onBatchDownloadClicked();
 
 private:
@@ -42,8 +42,9 @@ private:
     void loadDefaultSettings();
 
     void addTaskToQueue(const QString& identifier);
-    void moveTaskToHistory(const QString& identifier, bool success);
-    DownloadTaskItem* findTaskItem(const QString& identifier) const;
+    void restoreTasksFromViewModel();
+    void ensureTaskInQueue(const QString& identifier);
+    void moveTaskToHistory(const QString& identifier, bool success, const Song& song, const QString& note);
 
     // UI 组件
     QLineEdit* m_urlInput = nullptr;
@@ -52,12 +53,14 @@ private:
     QPushButton* m_batchDownloadBtn = nullptr;
 
     QTabWidget* m_tabWidget = nullptr;
-    QListWidget* m_queueList = nullptr;
-    QTableWidget* m_historyTable = nullptr;
+    QListView* m_queueList = nullptr;
+    QTableView* m_historyTable = nullptr;
+
+    // 队列/历史的数据模型（行按 identifier 索引）
+    DownloadTaskModel* m_queueModel = nullptr;
+    DownloadTaskModel* m_historyModel = nullptr;
 
     QLabel* m_statusLabel = nullptr;
 
     DownloadViewModel* m_viewModel = nullptr;
-
-    QMap<QString, DownloadTaskItem*> m_taskItems;
 };
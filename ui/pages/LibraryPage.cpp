@@ -21,9 +21,22 @@
 #include <QSet>
 #include "../../service/PlaybackService.h"
 #include "../../common/AppConfig.h"
+#include "../components/CoverArtDelegate.h"
+#include "../components/SortKeyTableItem.h"
+#include "../../common/SortKey.h"
+#include <QtEndian>
 
 static const char* kMyMusicId = "";        
 static const char* kMyMusicText = "我的音乐";
+static const int kIndexedSearchLimit = 500; // 索引搜索最多展示的结果数
+
+// 64 位整数的可逐字节比较形式（大端 + 翻转符号位）
+static QByteArray orderedBytes(qint64 value) {
+    const quint64 biased = static_cast<quint64>(value) ^ (quint64(1) << 63);
+    QByteArray bytes(8, Qt::Uninitialized);
+    qToBigEndian(biased, bytes.data());
+    return bytes;
+}
 
 LibraryPage::LibraryPage(LibraryViewModel* viewModel, QWidget* parent)
     : QWidget(parent)
@@ -140,6 +153,7 @@ void LibraryPage::setupUI() {
     m_songTable->setSortingEnabled(true);
     m_songTable->setContextMenuPolicy(Qt::CustomContextMenu);
     m_songTable->setFrameShape(QFrame::NoFrame);
+    m_songTable->setItemDelegateForColumn(0, new CoverArtDelegate(m_songTable)); // 标题列左侧显示封面
 
     // 右侧装配
     rightLayout->addLayout(titleBox);
@@ -328,11 +342,18 @@ void LibraryPage::onSidebarContextMenuRequested(const QPoint& pos) {
 /* ------------ 右侧歌曲表 ------------ */
 void LibraryPage::reloadSongs() {
     const QString pid = currentPlaylistId();
-    QList<Song> songs = pid.isEmpty()
-        ? m_viewModel->getAllSongs()
-        : m_viewModel->getPlaylistSongs(pid);
+    loadSongsWhenReady(pid.isEmpty()
+        ? m_viewModel->getAllSongsAsync()
+        : m_viewModel->getPlaylistSongsAsync(pid));
+}
 
-    loadSongs(songs);
+void LibraryPage::loadSongsWhenReady(QFuture<QList<Song>> future) {
+    // SQL 在查询线程执行；被取代（取消）的查询不会回调，序号再兜底过滤乱序结果
+    const quint64 ticket = ++m_songQueryTicket;
+    future.then(this, [this, ticket](const QList<Song>& songs) {
+        if (ticket != m_songQueryTicket) return;
+        loadSongs(songs);
+        });
 }
 
 void LibraryPage::loadSongs(const QList<Song>& songs) {
@@ -346,19 +367,30 @@ void LibraryPage::loadSongs(const QList<Song>& songs) {
 
     // 计算总时长
     qlonglong totalDuration = 0; // 秒
+    const SortKey::Mode sortMode = SortKey::configuredMode();
     for (int i = 0; i < m_currentSongs.size(); ++i) {
         const Song& s = m_currentSongs.at(i);
 
-        auto* titleItem = new QTableWidgetItem(s.getTitle());
-        auto* artistItem = new QTableWidgetItem(s.getArtist());
-        auto* durationItem = new QTableWidgetItem(formatDuration(s.getDurationSeconds()));
-        auto* timeItem = new QTableWidgetItem(s.getDownloadDate().toString("yyyy-MM-dd HH:mm"));
+        // 排序键随歌曲从数据库读出；个别未入库的歌曲现算
+        QByteArray titleKey = s.getTitleSortKey();
+        QByteArray artistKey = s.getArtistSortKey();
+        if (titleKey.isEmpty()) titleKey = SortKey::build(s.getTitle(), sortMode);
+        if (artistKey.isEmpty()) artistKey = SortKey::build(s.getArtist(), sortMode);
+
+        // 多列排序：本列相同则依次比较 标题 / 艺术家
+        auto* titleItem = new SortKeyTableItem(s.getTitle(), titleKey + '\0' + artistKey);
+        auto* artistItem = new SortKeyTableItem(s.getArtist(), artistKey + '\0' + titleKey);
+        auto* durationItem = new SortKeyTableItem(formatDuration(s.getDurationSeconds()),
+            orderedBytes(s.getDurationSeconds()) + titleKey);
+        auto* timeItem = new SortKeyTableItem(s.getDownloadDate().toString("yyyy-MM-dd HH:mm"),
+            orderedBytes(s.getDownloadDate().toSecsSinceEpoch()) + titleKey);
 
         durationItem->setData(Qt::UserRole, static_cast<qlonglong>(s.getDurationSeconds()));
         timeItem->setData(Qt::UserRole, s.getDownloadDate().toSecsSinceEpoch());
 
-        // 便于右键操作定位
-        titleItem->setData(Qt::UserRole + 1, s.getId());
+        // 便于右键操作定位；本地路径供封面委托抽取内嵌封面
+        titleItem->setData(CoverArtDelegate::SongIdRole, s.getId());
+        titleItem->setData(CoverArtDelegate::FilePathRole, s.getLocalFilePath());
 
         m_songTable->setItem(i, 0, titleItem);
         m_songTable->setItem(i, 1, artistItem);
@@ -435,9 +467,22 @@ void LibraryPage::onSongTableContextMenuRequested(const QPoint& pos) {
 
     // 添加到歌单（批量）
     QMenu* addMenu = menu.addMenu("添加到歌单");
+    // 歌单列表与成员关系均来自内存索引，右键不再查询数据库
     const auto pls = m_viewModel->getAllPlaylists();
+    const QHash<QString, int> contained = m_viewModel->getPlaylistMembershipCounts(sids);
     for (const auto& pl : pls) {
+        const int n = contained.value(pl.getId());
         QAction* act = addMenu->addAction(pl.getName());
+        if (n >= sids.size()) {
+            // 已全部在该歌单中
+            act->setCheckable(true);
+            act->setChecked(true);
+            act->setEnabled(false);
+            continue;
+        }
+        if (n > 0) {
+            act->setText(QString("%1（已含 %2/%3）").arg(pl.getName()).arg(n).arg(sids.size()));
+        }
         connect(act, &QAction::triggered, this, [=] { actAddToPlaylist(sids, pl.getId()); });
     }
     if (pls.isEmpty()) {
@@ -464,11 +509,8 @@ void LibraryPage::onSongTableContextMenuRequested(const QPoint& pos) {
         for (const auto& s : view) if (idset.contains(s.getId())) picked << s;
         if (picked.isEmpty()) return;
 
-        auto& ps = PlaybackService::instance();
-        // 逆序插入，保证“第一首选中”的最先播放
-        for (int i = picked.size() - 1; i >= 0; --i) {
-            ps.addNextToQueue(picked[i]);
-        }
+        // 整段插到队首，保持选中顺序
+        PlaybackService::instance().insertIntoQueue(0, picked);
         showToast(QString("已添加到播放队列（下一首） • %1 首").arg(picked.size()));
         });
 
@@ -482,19 +524,7 @@ void LibraryPage::onSongTableContextMenuRequested(const QPoint& pos) {
         for (const auto& s : view) if (idset.contains(s.getId())) picked << s;
         if (picked.isEmpty()) return;
 
-        auto& ps = PlaybackService::instance();
-        // 使用仅有的 API 实现“追加到末尾”：
-        // 最终队列 = 原队列 + 选中歌曲。要用 addNextToQueue 实现：
-        // 步骤：保存原队列 → 清空 → 先倒序压入 picked（让它们暂时在前）→ 再倒序压入旧队列（恢复到前部）
-        const QList<Song> oldQ = ps.getPlaybackQueue();
-        ps.clearPlaybackQueue();
-
-        for (int i = picked.size() - 1; i >= 0; --i) {
-            ps.addNextToQueue(picked[i]);         // 暂时放到前面
-        }
-        for (int i = oldQ.size() - 1; i >= 0; --i) {
-            ps.addNextToQueue(oldQ[i]);           // 恢复原队列到前部
-        }
+        PlaybackService::instance().insertIntoQueue(-1, picked);
         showToast(QString("已添加到播放队列（末尾） • %1 首").arg(picked.size()));
         });
 
@@ -710,6 +740,13 @@ void LibraryPage::onPlaylistsChanged() {
 /* -------- 搜索：防抖实现 -------- */
 void LibraryPage::onSearchTextChanged(const QString& text) {
     m_searchQuery = text.trimmed(); // 记录搜索文本
+
+    // 内存索引就绪时无需防抖：边输入边搜索
+    if (!m_searchQuery.isEmpty() && !inPlaylistMode() && m_viewModel->isSearchIndexReady()) {
+        m_searchDebounceTimer->stop();
+        onSearchTimeout();
+        return;
+    }
     m_searchDebounceTimer->start(); // 重启定时器
 }
 
@@ -719,18 +756,14 @@ void LibraryPage::onSearchTimeout() {
         return;
     }
     if (inPlaylistMode()) {
-        QList<Song> base = m_viewModel->getPlaylistSongs(currentPlaylistId());
-        QList<Song> filtered;
-        for (const auto& s : base) {
-            if (s.getTitle().contains(m_searchQuery, Qt::CaseInsensitive) ||
-                s.getArtist().contains(m_searchQuery, Qt::CaseInsensitive)) {
-                filtered.append(s);
-            }
-        }
-        loadSongs(filtered);
+        loadSongsWhenReady(m_viewModel->searchPlaylistSongsAsync(currentPlaylistId(), m_searchQuery));
+    }
+    else if (m_viewModel->isSearchIndexReady()) {
+        ++m_songQueryTicket; // 作废尚未返回的异步结果
+        loadSongs(m_viewModel->searchSongsIndexed(m_searchQuery, kIndexedSearchLimit));
     }
     else {
-        loadSongs(m_viewModel->searchSongs(m_searchQuery));
+        loadSongsWhenReady(m_viewModel->searchSongsAsync(m_searchQuery));
     }
 }
 
@@ -765,8 +798,12 @@ void LibraryPage::actAddToPlaylist(const QStringList& songIds, const QString& pl
 void LibraryPage::actRemoveFromCurrentPlaylist(const QStringList& songIds) {
     const QString pid = currentPlaylistId();
     if (pid.isEmpty() || songIds.isEmpty()) return;
-    for (const auto& id : songIds) m_viewModel->removeSongFromPlaylist(pid, id); // 你的接口是单个移除
-    onSongsChanged();
+
+    // 批量作用域：一个事务 + 一次 songsChanged，表格只刷新一次
+    m_viewModel->beginBatch();
+    for (const auto& id : songIds) m_viewModel->removeSongFromPlaylist(pid, id);
+    m_viewModel->commitBatch();
+
     showToast(QString("已从当前歌单移除 • %1 首").arg(songIds.size()));
 }
 
@@ -780,9 +817,10 @@ void LibraryPage::actDeleteSongs(const QStringList& songIds) {
         QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
     if (ret != QMessageBox::Yes) return;
 
+    m_viewModel->beginBatch();
     for (const auto& id : songIds) m_viewModel->deleteSong(id);
+    m_viewModel->commitBatch();
 
-    onSongsChanged();
     showToast(QString("已删除 • %1 首").arg(songIds.size()));
 }
 
@@ -10,6 +10,7 @@
 #include <QShortcut>
 #include <QTimer>
 #include <QStringList>
+#include <QFuture>
 
 #include "../../common/entities/Song.h"
 #include "../../common/entities/Playlist.h"
@@ -63,6 +64,7 @@ private:
     // 右侧歌曲表
     void reloadSongs();
     void loadSongs(const QList<Song>& songs);
+    void loadSongsWhenReady(QFuture<QList<Song>> future); // 异步查询完成后再装载（仅采用最新一次）
     QString formatDuration(qlonglong seconds) const;
     QString humanizeDuration(qlonglong seconds) const; // 友好显示总时长
     void updateHeaderText();
@@ -125,6 +127,9 @@ private:
     QTimer* m_searchDebounceTimer = nullptr;
     QString  m_searchQuery;
 
+    // 异步查询序号：只装载最新一次查询的结果
+    quint64 m_songQueryTicket = 0;
+
     // 当前显示的歌曲
     QList<Song> m_currentSongs;
 
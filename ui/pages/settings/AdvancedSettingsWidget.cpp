@@ -1,5 +1,10 @@
 #include "AdvancedSettingsWidget.h"
 #include "../../../common/AppConfig.h"
+#include "../../../common/StallWatchdog.h"
+#include "../../../service/PlaybackService.h"
+#include "../../../service/DspChain.h"
+#include <QFileInfo>
+#include <QDir>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
@@ -70,8 +75,168 @@ void AdvancedSettingsWidget::setupUI()
     advancedLayout->addWidget(infoLabel);
 
     mainLayout->addWidget(advancedGroup);
+
+    // ========== 播放衔接 ==========
+    QGroupBox* transitionGroup = new QGroupBox("🎧 播放衔接");
+    transitionGroup->setObjectName("settingsGroup");
+    QVBoxLayout* transitionLayout = new QVBoxLayout(transitionGroup);
+    transitionLayout->setSpacing(12);
+
+    m_gaplessCheck = new QCheckBox("预加载下一首，结尾无缝衔接");
+    m_gaplessCheck->setObjectName("settingsCheckbox");
+
+    QHBoxLayout* crossfadeLayout = new QHBoxLayout();
+    QLabel* crossfadeLabel = new QLabel("交叉淡化:");
+    crossfadeLabel->setFixedWidth(100);
+    crossfadeLabel->setObjectName("settingsLabel");
+
+    m_crossfadeSpin = new QSpinBox();
+    m_crossfadeSpin->setObjectName("settingsSpinBox");
+    m_crossfadeSpin->setRange(0, 12000);
+    m_crossfadeSpin->setSingleStep(500);
+    m_crossfadeSpin->setSuffix(" ms");
+    m_crossfadeSpin->setSpecialValueText("关闭");
+
+    m_trackLatencyLabel = new QLabel();
+    m_trackLatencyLabel->setObjectName("infoLabel");
+
+    crossfadeLayout->addWidget(crossfadeLabel);
+    crossfadeLayout->addWidget(m_crossfadeSpin);
+    crossfadeLayout->addStretch();
+    crossfadeLayout->addWidget(m_trackLatencyLabel);
+
+    QHBoxLayout* prefetchLayout = new QHBoxLayout();
+    QLabel* prefetchLabel = new QLabel("预读曲目:");
+    prefetchLabel->setFixedWidth(100);
+    prefetchLabel->setObjectName("settingsLabel");
+
+    m_prefetchCountSpin = new QSpinBox();
+    m_prefetchCountSpin->setObjectName("settingsSpinBox");
+    m_prefetchCountSpin->setRange(0, 20);
+    m_prefetchCountSpin->setSuffix(" 首");
+    m_prefetchCountSpin->setSpecialValueText("关闭");
+
+    m_prefetchStatsLabel = new QLabel();
+    m_prefetchStatsLabel->setObjectName("infoLabel");
+
+    prefetchLayout->addWidget(prefetchLabel);
+    prefetchLayout->addWidget(m_prefetchCountSpin);
+    prefetchLayout->addStretch();
+    prefetchLayout->addWidget(m_prefetchStatsLabel);
+
+    m_weightedShuffleCheck = new QCheckBox("随机播放时优先收藏的歌曲");
+    m_weightedShuffleCheck->setObjectName("settingsCheckbox");
+
+    transitionLayout->addWidget(m_gaplessCheck);
+    transitionLayout->addLayout(crossfadeLayout);
+    transitionLayout->addLayout(prefetchLayout);
+    transitionLayout->addWidget(m_weightedShuffleCheck);
+
+    mainLayout->addWidget(transitionGroup);
+
+    // ========== 音频处理 ==========
+    QGroupBox* dspGroup = new QGroupBox("🎛 音频处理");
+    dspGroup->setObjectName("settingsGroup");
+    QVBoxLayout* dspLayout = new QVBoxLayout(dspGroup);
+    dspLayout->setSpacing(12);
+
+    m_renderPipelineCheck = new QCheckBox("使用内置渲染管线（均衡器 / 限幅器，下一首生效）");
+    m_renderPipelineCheck->setObjectName("settingsCheckbox");
+
+    QHBoxLayout* eqLayout = new QHBoxLayout();
+    QLabel* eqLabel = new QLabel("均衡器:");
+    eqLabel->setFixedWidth(100);
+    eqLabel->setObjectName("settingsLabel");
+    eqLayout->addWidget(eqLabel);
+    for (int freq : DspChain::kGraphicEqFrequencies) {
+        QSpinBox* spin = new QSpinBox();
+        spin->setObjectName("settingsSpinBox");
+        spin->setRange(-12, 12);
+        spin->setSuffix(" dB");
+        spin->setPrefix(freq >= 1000 ? QString("%1k ").arg(freq / 1000.0) : QString("%1 ").arg(freq));
+        m_eqSpins << spin;
+        eqLayout->addWidget(spin);
+    }
+    eqLayout->addStretch();
+
+    QHBoxLayout* limiterLayout = new QHBoxLayout();
+    m_limiterCheck = new QCheckBox("前瞻限幅（-1 dBFS，防止均衡后削波）");
+    m_limiterCheck->setObjectName("settingsCheckbox");
+
+    m_dspBenchmarkBtn = new QPushButton("⏱ 测试开销");
+    m_dspBenchmarkBtn->setObjectName("testBtn");
+    m_dspBenchmarkBtn->setFixedWidth(100);
+
+    m_dspCostLabel = new QLabel();
+    m_dspCostLabel->setObjectName("infoLabel");
+
+    limiterLayout->addWidget(m_limiterCheck);
+    limiterLayout->addStretch();
+    limiterLayout->addWidget(m_dspCostLabel);
+    limiterLayout->addWidget(m_dspBenchmarkBtn);
+
+    dspLayout->addWidget(m_renderPipelineCheck);
+    dspLayout->addLayout(eqLayout);
+    dspLayout->addLayout(limiterLayout);
+
+    mainLayout->addWidget(dspGroup);
+
+    // ========== 卡顿监视 ==========
+    QGroupBox* stallGroup = new QGroupBox("🐢 界面卡顿监视");
+    stallGroup->setObjectName("settingsGroup");
+    QVBoxLayout* stallLayout = new QVBoxLayout(stallGroup);
+    stallLayout->setSpacing(12);
+
+    QHBoxLayout* thresholdLayout = new QHBoxLayout();
+    QLabel* thresholdLabel = new QLabel("卡顿阈值:");
+    thresholdLabel->setFixedWidth(100);
+    thresholdLabel->setObjectName("settingsLabel");
+
+    m_stallThresholdSpin = new QSpinBox();
+    m_stallThresholdSpin->setObjectName("settingsSpinBox");
+    m_stallThresholdSpin->setRange(0, 10000);
+    m_stallThresholdSpin->setSingleStep(50);
+    m_stallThresholdSpin->setSuffix(" ms");
+    m_stallThresholdSpin->setSpecialValueText("关闭");
+
+    m_refreshStallLogBtn = new QPushButton("🔄 刷新");
+    m_refreshStallLogBtn->setObjectName("testBtn");
+    m_refreshStallLogBtn->setFixedWidth(80);
+    m_clearStallLogBtn = new QPushButton("🗑 清空");
+    m_clearStallLogBtn->setObjectName("testBtn");
+    m_clearStallLogBtn->setFixedWidth(80);
+
+    thresholdLayout->addWidget(thresholdLabel);
+    thresholdLayout->addWidget(m_stallThresholdSpin);
+    thresholdLayout->addStretch();
+    thresholdLayout->addWidget(m_refreshStallLogBtn);
+    thresholdLayout->addWidget(m_clearStallLogBtn);
+
+    m_stallLogView = new QPlainTextEdit();
+    m_stallLogView->setObjectName("stallLogView");
+    m_stallLogView->setReadOnly(true);
+    m_stallLogView->setLineWrapMode(QPlainTextEdit::NoWrap);
+    m_stallLogView->setMinimumHeight(160);
+    m_stallLogView->setPlaceholderText("暂无卡顿记录");
+
+    QLabel* stallInfoLabel = new QLabel(
+        "💡 主线程处理单个事件超过阈值时记录一条：开始时间、耗时、正在处理的事件（由外到内）。"
+    );
+    stallInfoLabel->setObjectName("infoLabel");
+    stallInfoLabel->setWordWrap(true);
+
+    stallLayout->addLayout(thresholdLayout);
+    stallLayout->addWidget(m_stallLogView);
+    stallLayout->addWidget(stallInfoLabel);
+
+    mainLayout->addWidget(stallGroup);
     mainLayout->addStretch();
 
+    connect(m_refreshStallLogBtn, &QPushButton::clicked,
+        this, &AdvancedSettingsWidget::refreshStallLog);
+    connect(m_clearStallLogBtn, &QPushButton::clicked,
+        this, &AdvancedSettingsWidget::onClearStallLogClicked);
+
     connect(m_proxyEnabledCheck, &QCheckBox::toggled, this, [this](bool checked) {
         m_proxyUrlInput->setEnabled(checked);
         m_testProxyBtn->setEnabled(checked);
@@ -79,6 +244,50 @@ void AdvancedSettingsWidget::setupUI()
 
     connect(m_testProxyBtn, &QPushButton::clicked,
         this, &AdvancedSettingsWidget::onTestProxyClicked);
+
+    // 均衡与限幅只在内置管线里生效
+    connect(m_renderPipelineCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        for (QSpinBox* spin : m_eqSpins) spin->setEnabled(checked);
+        m_limiterCheck->setEnabled(checked);
+        });
+    connect(m_dspBenchmarkBtn, &QPushButton::clicked, this, [this]() {
+        const double micros = DspChain::benchmark(60);
+        updateDspCostLabel();
+        m_dspCostLabel->setText(m_dspCostLabel->text()
+            + QString("，离线测试 %1 µs/s（%2%）").arg(micros, 0, 'f', 0).arg(micros / 1e4, 0, 'f', 2));
+        });
+
+    // 交叉淡化依赖预加载
+    connect(m_gaplessCheck, &QCheckBox::toggled, m_crossfadeSpin, &QSpinBox::setEnabled);
+    connect(&PlaybackService::instance(), &PlaybackService::trackChangeLatencyMeasured,
+        this, [this](qint64 ms, bool preloaded) { updateTrackLatencyLabel(ms, preloaded); });
+}
+
+void AdvancedSettingsWidget::updatePrefetchStatsLabel()
+{
+    const TrackPrefetcher::Stats st = PlaybackService::instance().prefetchStats();
+    const int total = st.hits + st.misses;
+    m_prefetchStatsLabel->setText(QString("命中 %1/%2，已预读 %3 MB")
+        .arg(st.hits).arg(total).arg(st.bytesPrefetched / (1024 * 1024)));
+}
+
+void AdvancedSettingsWidget::updateDspCostLabel()
+{
+    const double micros = PlaybackService::instance().dspMicrosPerSecond();
+    m_dspCostLabel->setText(micros > 0.0
+        ? QString("DSP 开销 %1 µs/s").arg(micros, 0, 'f', 0)
+        : QString("DSP 开销：—"));
+}
+
+void AdvancedSettingsWidget::updateTrackLatencyLabel(qint64 ms, bool preloaded)
+{
+    updatePrefetchStatsLabel();
+    if (ms < 0) {
+        m_trackLatencyLabel->setText("最近换曲延迟：—");
+        return;
+    }
+    m_trackLatencyLabel->setText(QString("最近换曲延迟：%1 ms%2")
+        .arg(ms).arg(preloaded ? "（预加载）" : ""));
 }
 
 void AdvancedSettingsWidget::setupStyles()
@@ -92,6 +301,26 @@ void AdvancedSettingsWidget::loadSettings()
 
     m_proxyEnabledCheck->setChecked(config.getProxyEnabled());
     m_proxyUrlInput->setText(config.getProxyUrl());
+    m_stallThresholdSpin->setValue(config.getStallThresholdMs());
+    m_gaplessCheck->setChecked(config.getGaplessPlayback());
+    m_crossfadeSpin->setValue(config.getCrossfadeMs());
+    m_crossfadeSpin->setEnabled(config.getGaplessPlayback());
+    m_weightedShuffleCheck->setChecked(config.getWeightedShuffle());
+    updateTrackLatencyLabel(PlaybackService::instance().lastTrackChangeLatency(), false);
+    m_prefetchCountSpin->setValue(config.getPrefetchTrackCount());
+    updatePrefetchStatsLabel();
+
+    m_renderPipelineCheck->setChecked(config.getRenderPipelineEnabled());
+    const QList<int> eqGains = config.getEqGainsDb();
+    for (int i = 0; i < m_eqSpins.size(); ++i) {
+        m_eqSpins[i]->setValue(i < eqGains.size() ? eqGains[i] : 0);
+        m_eqSpins[i]->setEnabled(config.getRenderPipelineEnabled());
+    }
+    m_limiterCheck->setChecked(config.getLimiterEnabled());
+    m_limiterCheck->setEnabled(config.getRenderPipelineEnabled());
+    updateDspCostLabel();
+
+    refreshStallLog();
 }
 
 bool AdvancedSettingsWidget::validate()
@@ -112,6 +341,57 @@ void AdvancedSettingsWidget::applySettings()
 
     config.setProxyEnabled(m_proxyEnabledCheck->isChecked());
     config.setProxyUrl(m_proxyUrlInput->text());
+
+    config.setGaplessPlayback(m_gaplessCheck->isChecked());
+    config.setCrossfadeMs(m_crossfadeSpin->value());
+    PlaybackService& playback = PlaybackService::instance();
+    playback.setGaplessPlayback(config.getGaplessPlayback());
+    playback.setCrossfadeDuration(config.getCrossfadeMs());
+    config.setPrefetchTrackCount(m_prefetchCountSpin->value());
+    playback.setPrefetchTrackCount(config.getPrefetchTrackCount());
+    config.setWeightedShuffle(m_weightedShuffleCheck->isChecked());
+    playback.setWeightedShuffle(config.getWeightedShuffle());
+
+    QList<int> eqGains;
+    for (QSpinBox* spin : m_eqSpins) eqGains << spin->value();
+    config.setEqGainsDb(eqGains);
+    config.setLimiterEnabled(m_limiterCheck->isChecked());
+    config.setRenderPipelineEnabled(m_renderPipelineCheck->isChecked());
+    playback.setEqualizerGains(config.getEqGainsDb());
+    playback.setLimiterEnabled(config.getLimiterEnabled());
+    playback.setRenderPipelineEnabled(config.getRenderPipelineEnabled());
+
+    const int threshold = m_stallThresholdSpin->value();
+    if (threshold != config.getStallThresholdMs()) {
+        config.setStallThresholdMs(threshold);
+        StallWatchdog& watchdog = StallWatchdog::instance();
+        // 运行中只改阈值；从关闭切到开启（或反之）时重新启停
+        if (watchdog.isRunning() && threshold > 0) {
+            watchdog.setThresholdMs(threshold);
+        }
+        else {
+            watchdog.start(threshold,
+                QFileInfo(config.getConfigFilePath()).absoluteDir().filePath("stall.log"));
+        }
+    }
+}
+
+void AdvancedSettingsWidget::refreshStallLog()
+{
+    const QStringList lines = StallWatchdog::instance().recentLines();
+    // 新的记录在最上面
+    QStringList reversed;
+    reversed.reserve(lines.size());
+    for (auto it = lines.crbegin(); it != lines.crend(); ++it) {
+        reversed << *it;
+    }
+    m_stallLogView->setPlainText(reversed.join('\n'));
+}
+
+void AdvancedSettingsWidget::onClearStallLogClicked()
+{
+    StallWatchdog::instance().clearLog();
+    m_stallLogView->clear();
 }
 
 void AdvancedSettingsWidget::onTestProxyClicked()
@@ -7,6 +7,9 @@
 #include <QNetworkProxy>
 #include <QNetworkReply>
 #include <QTimer>
+#include <QSpinBox>
+#include <QPlainTextEdit>
+#include <QLabel>
 
 class AdvancedSettingsWidget : public QWidget {
     Q_OBJECT
@@ -20,12 +23,38 @@ public:
 
 private slots:
 	void onTestProxyClicked();
+    void refreshStallLog();
+    void onClearStallLogClicked();
 
 private:
     void setupUI();
     void setupStyles();
+    void updateTrackLatencyLabel(qint64 ms, bool preloaded);
+    void updatePrefetchStatsLabel();
+    void updateDspCostLabel();
 
     QCheckBox* m_proxyEnabledCheck = nullptr;
     QLineEdit* m_proxyUrlInput = nullptr;
     QPushButton* m_testProxyBtn = nullptr;
+
+    // 播放衔接
+    QCheckBox* m_gaplessCheck = nullptr;
+    QSpinBox* m_crossfadeSpin = nullptr;
+    QLabel* m_trackLatencyLabel = nullptr;
+    QSpinBox* m_prefetchCountSpin = nullptr;
+    QLabel* m_prefetchStatsLabel = nullptr;
+    QCheckBox* m_weightedShuffleCheck = nullptr;
+
+    // 音频处理（自有渲染管线）
+    QCheckBox* m_renderPipelineCheck = nullptr;
+    QList<QSpinBox*> m_eqSpins;
+    QCheckBox* m_limiterCheck = nullptr;
+    QPushButton* m_dspBenchmarkBtn = nullptr;
+    QLabel* m_dspCostLabel = nullptr;
+
+    // 主线程卡顿监视
+    QSpinBox* m_stallThresholdSpin = nullptr;
+    QPlainTextEdit* m_stallLogView = nullptr;
+    QPushButton* m_refreshStallLogBtn = nullptr;
+    QPushButton* m_clearStallLogBtn = nullptr;
 };
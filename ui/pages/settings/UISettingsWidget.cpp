@@ -1,5 +1,6 @@
 #include "UISettingsWidget.h"
 #include "../../../common/AppConfig.h"
+#include "../../../viewmodel/LibraryViewModel.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
@@ -15,6 +16,10 @@ UISettingsWidget::UISettingsWidget(QWidget* parent)
     // 连接主题切换信号
     connect(m_themeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
         this, &UISettingsWidget::onThemeChanged);
+
+    // 排序方式切换结束（后台重算完成或失败）：复选框回到实际生效的状态
+    connect(&LibraryViewModel::instance(), &LibraryViewModel::sortByPinyinApplied,
+        m_sortByPinyinCheck, &QCheckBox::setChecked);
 }
 
 void UISettingsWidget::setupUI()
@@ -42,16 +47,22 @@ void UISettingsWidget::setupUI()
     themeLayout->addWidget(m_themeCombo);
     themeLayout->addStretch();
 
+    // 排序方式（切换后重算全部歌曲的排序键）
+    m_sortByPinyinCheck = new QCheckBox("中文标题与歌手按拼音排序");
+    m_sortByPinyinCheck->setObjectName("settingsCheckbox");
+
     // 说明文本
     QLabel* infoLabel = new QLabel(
         "💡 提示：\n"
         "• 主题切换会立即生效\n"
+        "• 排序方式在保存设置后于后台重算，完成后列表自动按新方式排列\n"
         "• 建议在切换后保存设置"
     );
     infoLabel->setObjectName("infoLabel");
     infoLabel->setWordWrap(true);
 
     uiLayout->addLayout(themeLayout);
+    uiLayout->addWidget(m_sortByPinyinCheck);
     uiLayout->addSpacing(10);
     uiLayout->addWidget(infoLabel);
 
@@ -94,6 +105,8 @@ void UISettingsWidget::loadSettings()
         m_themeCombo->setCurrentIndex(index);
         m_themeCombo->blockSignals(false);
     }
+
+    m_sortByPinyinCheck->setChecked(AppConfig::instance().getSortByPinyin());
 }
 
 bool UISettingsWidget::validate()
@@ -108,4 +121,9 @@ void UISettingsWidget::applySettings()
 
     QString themeName = (theme == ThemeManager::Theme::Dark) ? "dark" : "light";
     AppConfig::instance().setTheme(themeName);
+
+    // 排序键在后台重算，结束后由 sortByPinyinApplied 同步复选框；上一次切换未完成时不受理
+    if (!LibraryViewModel::instance().setSortByPinyin(m_sortByPinyinCheck->isChecked())) {
+        m_sortByPinyinCheck->setChecked(AppConfig::instance().getSortByPinyin());
+    }
 }
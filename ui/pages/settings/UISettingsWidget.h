@@ -1,6 +1,7 @@
 #pragma once
 #include <QWidget>
 #include <QComboBox>
+#include <QCheckBox>
 #include "../../themes/ThemeManager.h"
 
 class UISettingsWidget : public QWidget {
@@ -21,4 +22,5 @@ private:
     void setupStyles();
 
     QComboBox* m_themeCombo = nullptr;
+    QCheckBox* m_sortByPinyinCheck = nullptr;
 };
@@ -0,0 +1,54 @@
+#include "ThemeBenchmark.h"
+#include "ThemeManager.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QWidget>
+#include <QDebug>
+#include <QVector>
+#include <algorithm>
+#include <numeric>
+
+ThemeBenchmark::Result ThemeBenchmark::run(QWidget* window, int rounds) {
+    Result result;
+    if (!window || rounds <= 0) return result;
+
+    ThemeManager& tm = ThemeManager::instance();
+    const ThemeManager::Theme original = tm.currentTheme();
+    auto other = [](ThemeManager::Theme t) {
+        return t == ThemeManager::Theme::Dark ? ThemeManager::Theme::Light : ThemeManager::Theme::Dark;
+    };
+
+    // 预热：两套主题各编译、应用一次
+    tm.loadTheme(other(original));
+    tm.loadTheme(original);
+    QApplication::processEvents();
+
+    QVector<qint64> samples;
+    samples.reserve(rounds);
+    for (int i = 0; i < rounds; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        tm.loadTheme(other(tm.currentTheme()));
+        window->repaint();
+        samples.append(timer.elapsed());
+
+        // 让延迟的布局/事件在两次计时之间处理掉，不计入下一轮
+        QApplication::processEvents();
+    }
+
+    if (tm.currentTheme() != original) {
+        tm.loadTheme(original);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    result.rounds = rounds;
+    result.minMs = samples.first();
+    result.maxMs = samples.last();
+    result.medianMs = samples.at(samples.size() / 2);
+    result.meanMs = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+
+    qDebug() << "🎨 主题切换基准：" << rounds << "次，最小" << result.minMs << "ms，中位数" << result.medianMs
+        << "ms，平均" << QString::number(result.meanMs, 'f', 1) << "ms，最大" << result.maxMs << "ms"
+        << (result.medianMs <= kTargetMs ? "✅" : "⚠️ 超过目标") << kTargetMs << "ms";
+    return result;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <QtGlobal>
+
+class QWidget;
+
+/**
+ * @brief 主题切换耗时基准
+ *
+ * 在已填充好的窗口上来回切换深色/浅色主题，每次计时包含
+ * ThemeManager::loadTheme（含 themeChanged 触发的样式应用）以及一次同步重绘。
+ * 先各切换一次作为预热（填充编译缓存），结束后恢复原主题。
+ */
+class ThemeBenchmark {
+public:
+    struct Result {
+        int rounds = 0;
+        qint64 minMs = 0;
+        qint64 medianMs = 0;
+        qint64 maxMs = 0;
+        double meanMs = 0.0;
+    };
+
+    static constexpr qint64 kTargetMs = 50;
+
+    static Result run(QWidget* window, int rounds);
+};
@@ -6,6 +6,9 @@
 #include <QDebug>
 #include <QRegularExpression>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QPromise>
+#include <QThreadPool>
 
 ThemeManager& ThemeManager::instance() {
     static ThemeManager instance;
@@ -13,27 +16,109 @@ ThemeManager& ThemeManager::instance() {
 }
 
 ThemeManager::ThemeManager() {
-    loadTheme(Theme::Dark);
+    // 主题在首次 loadTheme（或 preloadAsync）时才读取编译，构造本身不做文件 IO
 }
 
 bool ThemeManager::loadTheme(Theme theme) {
-    QString themeName = (theme == Theme::Dark) ? "dark" : "light";
-    QString qss = loadThemeFile(themeName);
-
-    if (qss.isEmpty()) {
-        qWarning() << "❌ 无法加载主题：" << themeName;
+    const CompiledTheme* compiled = compiledTheme(theme);
+    if (!compiled) {
         return false;
     }
 
     m_currentTheme = theme;
-    m_currentStyleSheet = qss;
-    parseColorVariables(qss);
+    m_currentStyleSheet = compiled->styleSheet;
+    m_colorMap = compiled->colors;
+    m_currentPalette = compiled->palette;
 
-    qDebug() << "✅ 主题已加载：" << themeName;
+    qDebug() << "✅ 主题已加载：" << currentThemeName();
     emit themeChanged(theme);
     return true;
 }
 
+const ThemeManager::CompiledTheme* ThemeManager::compiledTheme(Theme theme) {
+    auto it = m_compiled.constFind(theme);
+    if (it != m_compiled.constEnd()) {
+        return &it.value();
+    }
+
+    // 后台预编译的结果（尚未完成时在此等待）
+    if (m_pending.contains(theme)) {
+        QFuture<CompiledTheme> future = m_pending.take(theme);
+        const CompiledTheme compiled = future.result();
+        if (!compiled.styleSheet.isEmpty()) {
+            return &m_compiled.insert(theme, compiled).value();
+        }
+    }
+
+    const QString themeName = (theme == Theme::Dark) ? "dark" : "light";
+    const QString qss = loadThemeFile(themeName);
+    if (qss.isEmpty()) {
+        qWarning() << "❌ 无法加载主题：" << themeName;
+        return nullptr;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    it = m_compiled.insert(theme, compile(qss));
+    qDebug() << "  - 主题" << themeName << "已编译：样式表" << qss.size() << "->" << it->styleSheet.size()
+        << "字符，颜色变量" << it->colors.size() << "个，耗时" << timer.elapsed() << "ms";
+    return &it.value();
+}
+
+ThemeManager::CompiledTheme ThemeManager::compile(const QString& qss) {
+    CompiledTheme compiled;
+    compiled.colors = parseColorVariables(qss);
+    compiled.styleSheet = minifyStyleSheet(qss);
+    compiled.palette = buildPalette(compiled.colors);
+    return compiled;
+}
+
+QString ThemeManager::minifyStyleSheet(const QString& qss) {
+    // 去注释（颜色变量已先行解析）、压缩空白；样式表越短，Qt 每次 setStyleSheet 的解析越快
+    static const QRegularExpression comments(R"(/\*.*?\*/)", QRegularExpression::DotMatchesEverythingOption);
+    static const QRegularExpression spaces(R"(\s+)");
+    static const QRegularExpression aroundPunct(R"(\s*([{};])\s*)");
+
+    QString out = qss;
+    out.remove(comments);
+    out.replace(spaces, QStringLiteral(" "));
+    // 只去掉 { } ; 两侧的空白：选择器中的空格是后代组合符，冒号两侧的空格也有语义，均需保留
+    out.replace(aroundPunct, QStringLiteral("\\1"));
+    return out.trimmed();
+}
+
+QPalette ThemeManager::buildPalette(const QMap<QString, QColor>& colors) {
+    QPalette palette;
+    auto color = [&colors](const char* key, const QColor& fallback) {
+        return colors.value(QLatin1String(key), fallback);
+    };
+
+    const QColor background = color("background", QColor("#1A1A1A"));
+    const QColor surface = color("surface", background);
+    const QColor surfaceLight = color("surface-light", surface);
+    const QColor text = color("text", QColor("#FFFFFF"));
+    const QColor textSecondary = color("text-secondary", text);
+    const QColor primary = color("primary", QColor("#FB7299"));
+
+    palette.setColor(QPalette::Window, background);
+    palette.setColor(QPalette::WindowText, text);
+    palette.setColor(QPalette::Base, background);
+    palette.setColor(QPalette::AlternateBase, surface);
+    palette.setColor(QPalette::Text, text);
+    palette.setColor(QPalette::Button, surface);
+    palette.setColor(QPalette::ButtonText, text);
+    palette.setColor(QPalette::ToolTipBase, surfaceLight);
+    palette.setColor(QPalette::ToolTipText, text);
+    palette.setColor(QPalette::PlaceholderText, textSecondary);
+    palette.setColor(QPalette::Highlight, primary);
+    palette.setColor(QPalette::HighlightedText, QColor("#FFFFFF"));
+    palette.setColor(QPalette::Link, primary);
+    palette.setColor(QPalette::Mid, color("border", surfaceLight));
+    palette.setColor(QPalette::Disabled, QPalette::Text, color("text-tertiary", textSecondary));
+    palette.setColor(QPalette::Disabled, QPalette::WindowText, color("text-tertiary", textSecondary));
+    return palette;
+}
+
 bool ThemeManager::loadTheme(const QString& themeName) {
     Theme theme = stringToTheme(themeName);
     return loadTheme(theme);
@@ -43,6 +128,27 @@ bool ThemeManager::reloadCurrentTheme() {
     return loadTheme(m_currentTheme);
 }
 
+void ThemeManager::preloadAsync(const QString& themeName) {
+    const Theme theme = stringToTheme(themeName);
+    if (m_compiled.contains(theme) || m_pending.contains(theme)) {
+        return;
+    }
+
+    // 静态库中的资源须先注册，工作线程才能读到 :/themes
+    Q_INIT_RESOURCE(themes);
+
+    auto promise = std::make_shared<QPromise<CompiledTheme>>();
+    m_pending.insert(theme, promise->future());
+    promise->start();
+
+    const QString name = (theme == Theme::Dark) ? "dark" : "light";
+    QThreadPool::globalInstance()->start([promise, name]() {
+        const QString qss = loadThemeFile(name);
+        promise->addResult(qss.isEmpty() ? CompiledTheme() : compile(qss));
+        promise->finish();
+        });
+}
+
 QString ThemeManager::loadThemeFile(const QString& themeName) {
     // 优先从资源文件加载
     QString resourcePath = QString(":/themes/%1.qss").arg(themeName);
@@ -72,25 +178,18 @@ QString ThemeManager::loadThemeFile(const QString& themeName) {
     return content;
 }
 
-void ThemeManager::parseColorVariables(const QString& qss) {
-    m_colorMap.clear();
+QMap<QString, QColor> ThemeManager::parseColorVariables(const QString& qss) {
+    QMap<QString, QColor> colors;
 
     // 解析颜色变量（格式: /* @varName: #RRGGBB */）
-    QRegularExpression re(R"(/\*\s*@(\w+):\s*(#[0-9A-Fa-f]{6})\s*\*/)");
+    static const QRegularExpression re(R"(/\*\s*@([\w-]+):\s*(#[0-9A-Fa-f]{6})\s*\*/)");
     QRegularExpressionMatchIterator it = re.globalMatch(qss);
 
     while (it.hasNext()) {
         QRegularExpressionMatch match = it.next();
-        QString varName = match.captured(1);
-        QString colorHex = match.captured(2);
-        m_colorMap[varName] = QColor(colorHex);
-    }
-
-    qDebug() << "  - 解析到" << m_colorMap.size() << "个颜色变量";
-
-    for (auto it = m_colorMap.constBegin(); it != m_colorMap.constEnd(); ++it) {
-        qDebug() << "    " << it.key() << ":" << it.value().name();
+        colors[match.captured(1)] = QColor(match.captured(2));
     }
+    return colors;
 }
 
 QString ThemeManager::currentThemeName() const {
@@ -103,8 +202,22 @@ void ThemeManager::applyToWidget(QWidget* widget) {
         return;
     }
 
-    widget->setStyleSheet(m_currentStyleSheet);
-    qDebug() << "✅ 主题已应用到 widget：" << widget->objectName();
+    // setStyleSheet 会自行重新 polish 整棵子控件树，调用方无需再逐个 unpolish/polish；
+    // 期间暂停绘制，避免每个子控件各自触发一次重绘
+    QElapsedTimer timer;
+    timer.start();
+
+    const bool updatesWereEnabled = widget->updatesEnabled();
+    widget->setUpdatesEnabled(false);
+    widget->setPalette(m_currentPalette);
+    if (widget->styleSheet() != m_currentStyleSheet) {
+        widget->setStyleSheet(m_currentStyleSheet);
+    }
+    widget->setUpdatesEnabled(updatesWereEnabled);
+    widget->update();
+
+    m_lastApplyMs = timer.elapsed();
+    qDebug() << "✅ 主题已应用到 widget：" << widget->objectName() << "耗时" << m_lastApplyMs << "ms";
 }
 
 void ThemeManager::applyToApplication(QApplication* app) {
@@ -113,6 +226,7 @@ void ThemeManager::applyToApplication(QApplication* app) {
         return;
     }
 
+    app->setPalette(m_currentPalette);
     app->setStyleSheet(m_currentStyleSheet);
     qDebug() << "✅ 主题已应用到 QApplication";
 }
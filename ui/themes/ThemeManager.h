@@ -2,6 +2,8 @@
 #include <QObject>
 #include <QColor>
 #include <QMap>
+#include <QPalette>
+#include <QFuture>
 #include <QString>
 
 class QWidget;
@@ -24,6 +26,9 @@ public:
     bool loadTheme(const QString& themeName);
     bool reloadCurrentTheme();
 
+    // 启动时在后台线程预先读取并编译主题，与配置/数据库初始化并行；随后的 loadTheme 直接取结果
+    void preloadAsync(const QString& themeName);
+
     // 应用主题
     void applyToWidget(QWidget* widget);
     void applyToApplication(QApplication* app);
@@ -32,6 +37,10 @@ public:
     Theme currentTheme() const { return m_currentTheme; }
     QString currentThemeName() const;
     QString getStyleSheet() const { return m_currentStyleSheet; }
+    QPalette getPalette() const { return m_currentPalette; }
+
+    // 最近一次 applyToWidget 的耗时（毫秒），用于基准测试与日志
+    qint64 lastApplyMs() const { return m_lastApplyMs; }
 
     // 颜色访问（用于动态绘制）
     QColor getColor(const QString& colorKey) const;
@@ -50,12 +59,28 @@ private:
     ThemeManager(const ThemeManager&) = delete;
     ThemeManager& operator=(const ThemeManager&) = delete;
 
-    QString loadThemeFile(const QString& themeName);
-    void parseColorVariables(const QString& qss);
+    // 主题编译结果：首次加载时解析一次，之后切换直接复用
+    struct CompiledTheme {
+        QString styleSheet;              // 去掉注释与多余空白后的样式表
+        QMap<QString, QColor> colors;    // /* @name: #RRGGBB */ 颜色变量
+        QPalette palette;                // 由颜色变量生成，供自绘控件与未被样式表覆盖的控件使用
+    };
+
+    const CompiledTheme* compiledTheme(Theme theme);
+    static CompiledTheme compile(const QString& qss);
+    static QString minifyStyleSheet(const QString& qss);
+    static QPalette buildPalette(const QMap<QString, QColor>& colors);
+
+    static QString loadThemeFile(const QString& themeName);
+    static QMap<QString, QColor> parseColorVariables(const QString& qss);
     QString getThemeFilePath(Theme theme) const;
     Theme stringToTheme(const QString& themeName) const;
 
     Theme m_currentTheme = Theme::Dark;
     QString m_currentStyleSheet;
     QMap<QString, QColor> m_colorMap;
+    QPalette m_currentPalette;
+    QMap<Theme, CompiledTheme> m_compiled;
+    QMap<Theme, QFuture<CompiledTheme>> m_pending;   // 后台编译中的主题
+    qint64 m_lastApplyMs = 0;
 };
@@ -9,6 +9,7 @@
 #include "../../viewmodel/DownloadViewModel.h"
 #include "../../viewmodel/LibraryViewModel.h"
 #include "../themes/ThemeManager.h"
+#include "../themes/ThemeBenchmark.h"
 #include "../../common/AppConfig.h"
 #include "../pages/settings/SettingsPage.h"
 #include "../../service/PlaybackService.h"
@@ -17,6 +18,7 @@
 #include "../components/Toast.h"
 #include "../dialogs/PlaylistDialog.h"
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QScreen>
 #include <QDebug>
 #include <QFile>
@@ -162,12 +164,39 @@ void MainWindow::setupPlaybackBar()
         if (!m_playlistDialog) {
             m_playlistDialog = new PlaylistDialog(this);
             // 初始填充
-            m_playlistDialog->setPlaylist(ps->getCurrentPlaylist(), ps->getCurrentSongIndex());
-            m_playlistDialog->setQueue(ps->getPlaybackQueue());
+            quint64 playlistRevision = 0;
+            const QList<Song> playlist = ps->getCurrentPlaylist(&playlistRevision);
+            m_playlistDialog->setPlaylist(playlist, ps->getCurrentSongIndex(), playlistRevision);
+            quint64 queueRevision = 0;
+            const QList<Song> queue = ps->getPlaybackQueue(&queueRevision);
+            m_playlistDialog->setQueue(queue, queueRevision);
 
             // 变化监听：使用 QueuedConnection，避免同帧重入
-            connect(ps, &PlaybackService::playlistChanged, this, [this, ps](const QList<Song>& pl) {
-                if (m_playlistDialog) m_playlistDialog->setPlaylist(pl, ps->getCurrentSongIndex());
+            // 播放列表：整体替换只标记过期，对话框可见时才重取（隐藏时留到下次打开）；
+            // 编辑只收增量，版本不接续时整体重取
+            auto resyncPlaylist = [this, ps]() {
+                if (!m_playlistDialog) return;
+                if (!m_playlistDialog->isVisible()) {
+                    m_playlistDialogStale = true;
+                    return;
+                }
+                m_playlistDialogStale = false;
+                quint64 revision = 0;
+                const QList<Song> pl = ps->getCurrentPlaylist(&revision);
+                m_playlistDialog->setPlaylist(pl, ps->getCurrentSongIndex(), revision);
+            };
+            connect(ps, &PlaybackService::playlistReset, this, [resyncPlaylist](quint64) {
+                resyncPlaylist();
+                }, Qt::QueuedConnection);
+            connect(ps, &PlaybackService::playlistSongsInserted, this,
+                [this, resyncPlaylist](int index, const QList<Song>& songs, quint64 revision) {
+                    if (!m_playlistDialog || m_playlistDialogStale) return;
+                    if (!m_playlistDialog->insertPlaylistSongs(index, songs, revision)) resyncPlaylist();
+                }, Qt::QueuedConnection);
+            connect(ps, &PlaybackService::playlistSongsRemoved, this,
+                [this, resyncPlaylist](int index, int count, quint64 revision) {
+                    if (!m_playlistDialog || m_playlistDialogStale) return;
+                    if (!m_playlistDialog->removePlaylistSongs(index, count, revision)) resyncPlaylist();
                 }, Qt::QueuedConnection);
 
             // 关键：仅更新选中行，不重建列表
@@ -175,8 +204,23 @@ void MainWindow::setupPlaybackBar()
                 if (m_playlistDialog) m_playlistDialog->setCurrentIndex(idx);
                 }, Qt::QueuedConnection);
 
-            connect(ps, &PlaybackService::playbackQueueChanged, this, [this](const QList<Song>& q) {
-                if (m_playlistDialog) m_playlistDialog->setQueue(q);
+            // 队列只收增量；版本不接续（漏收或乱序）时整体重取一次
+            auto resyncQueue = [this, ps]() {
+                quint64 revision = 0;
+                const QList<Song> q = ps->getPlaybackQueue(&revision);
+                if (m_playlistDialog) m_playlistDialog->setQueue(q, revision);
+            };
+            connect(ps, &PlaybackService::queueSongsInserted, this,
+                [this, resyncQueue](int index, const QList<Song>& songs, quint64 revision) {
+                    if (m_playlistDialog && !m_playlistDialog->insertQueueSongs(index, songs, revision)) resyncQueue();
+                }, Qt::QueuedConnection);
+            connect(ps, &PlaybackService::queueSongsRemoved, this,
+                [this, resyncQueue](int index, int count, quint64 revision) {
+                    if (m_playlistDialog && !m_playlistDialog->removeQueueSongs(index, count, revision)) resyncQueue();
+                }, Qt::QueuedConnection);
+            connect(ps, &PlaybackService::queueSongMoved, this,
+                [this, resyncQueue](int from, int to, quint64 revision) {
+                    if (m_playlistDialog && !m_playlistDialog->moveQueueSong(from, to, revision)) resyncQueue();
                 }, Qt::QueuedConnection);
         }
 
@@ -184,6 +228,13 @@ void MainWindow::setupPlaybackBar()
             m_playlistDialog->hide();
         }
         else {
+            // 隐藏期间播放列表被整体替换过：打开前重取一次
+            if (m_playlistDialogStale) {
+                m_playlistDialogStale = false;
+                quint64 revision = 0;
+                const QList<Song> pl = ps->getCurrentPlaylist(&revision);
+                m_playlistDialog->setPlaylist(pl, ps->getCurrentSongIndex(), revision);
+            }
             // 挂靠主窗右下
             QPoint p = this->geometry().bottomRight() - QPoint(m_playlistDialog->width() + 20, m_playlistDialog->height() + 20);
             m_playlistDialog->move(p);
@@ -194,6 +245,15 @@ void MainWindow::setupPlaybackBar()
 
 
 
+    // —— 位置推送节奏：配置为 0 时按显示器刷新周期对齐 —— //
+    int positionInterval = AppConfig::instance().getPositionUpdateIntervalMs();
+    if (positionInterval <= 0) {
+        const QScreen* s = screen();
+        const qreal hz = s ? s->refreshRate() : 60.0;
+        positionInterval = qRound(1000.0 / (hz > 0 ? hz : 60.0));
+    }
+    ps->setPositionUpdateInterval(positionInterval);
+
     // —— 连接 Service -> UI 状态 —— //
     connect(ps, &PlaybackService::playbackStateChanged, this, [this](PlaybackState st) {
         m_playbackBar->setPlaybackState(st == PlaybackState::Playing);
@@ -748,6 +808,7 @@ void MainWindow::onNavigationButtonClicked()
 void MainWindow::switchToPage(int pageIndex)
 {
     if (pageIndex >= 0 && pageIndex < ui->contentStackedWidget->count()) {
+        ensurePage(pageIndex);
         ui->contentStackedWidget->setCurrentIndex(pageIndex);
         m_currentPageIndex = pageIndex;
 
@@ -857,6 +918,33 @@ bool MainWindow::eventFilter(QObject* obj, QEvent* event)
     return QMainWindow::eventFilter(obj, event);
 }
 
+// ========== 可见性 ==========
+// 窗口隐藏或最小化时暂停播放位置推送（播放本身不受影响），恢复显示时立即补发一次
+void MainWindow::updatePositionUpdates()
+{
+    PlaybackService::instance().setPositionUpdatesSuspended(!isVisible() || isMinimized());
+}
+
+void MainWindow::changeEvent(QEvent* event)
+{
+    if (event->type() == QEvent::WindowStateChange) {
+        updatePositionUpdates();
+    }
+    QMainWindow::changeEvent(event);
+}
+
+void MainWindow::showEvent(QShowEvent* event)
+{
+    QMainWindow::showEvent(event);
+    updatePositionUpdates();
+}
+
+void MainWindow::hideEvent(QHideEvent* event)
+{
+    QMainWindow::hideEvent(event);
+    updatePositionUpdates();
+}
+
 void MainWindow::setupContentPages()
 {
     qDebug() << "🔧 开始初始化内容页面...";
@@ -866,31 +954,14 @@ void MainWindow::setupContentPages()
         return;
     }
 
-    // ===== 下载管理（保持不变） =====
+    // ===== 下载管理 =====
+    // ViewModel 立即创建（需要从启动起就接收下载信号），页面本身等首次打开时再构建
     DownloadService* downloadService = m_app->getDownloadService();
     if (!downloadService) {
         qCritical() << "❌ 无法创建页面：DownloadService 为空";
         return;
     }
     m_downloadViewModel = new DownloadViewModel(downloadService, this);
-    m_downloadManagerPage = new DownloadManagerPage(m_downloadViewModel, this);
-
-    QWidget* oldDownloadPage = ui->contentStackedWidget->widget(1);
-    ui->contentStackedWidget->removeWidget(oldDownloadPage);
-    if (oldDownloadPage) oldDownloadPage->deleteLater();
-    ui->contentStackedWidget->insertWidget(1, m_downloadManagerPage);
-
-    // ===== 设置（保持不变） =====
-    m_settingsPage = new SettingsPage(this);
-    QWidget* oldSettingsPage = ui->contentStackedWidget->widget(2);
-    ui->contentStackedWidget->removeWidget(oldSettingsPage);
-    if (oldSettingsPage) oldSettingsPage->deleteLater();
-    ui->contentStackedWidget->insertWidget(2, m_settingsPage);
-
-    connect(m_settingsPage, &SettingsPage::settingsChanged,
-        m_downloadManagerPage, &DownloadManagerPage::onSettingsChanged);
-    connect(m_settingsPage, &SettingsPage::settingsChanged,
-        downloadService, &DownloadService::refreshConfig);
 
     // ===== 🎵 音乐库 =====
     {
@@ -908,6 +979,17 @@ void MainWindow::setupContentPages()
                 if (list.isEmpty() || index < 0 || index >= list.size()) return;
                 PlaybackService::instance().playPlaylist(list, index);
             });
+
+        // 曲库增删改 -> 播放服务维护推荐候选（曲库层不直接依赖播放服务）
+        PlaybackService* ps = &PlaybackService::instance();
+        connect(libraryVM, &LibraryViewModel::librarySongUpserted, ps, &PlaybackService::noteLibrarySongChanged);
+        connect(libraryVM, &LibraryViewModel::librarySongRemoved, ps, &PlaybackService::noteLibrarySongRemoved);
+
+        // 单任务下载入库 -> 更新搜索索引（并行下载由 LibraryService 直接处理）
+        connect(downloadService, &DownloadService::taskCompleted, libraryVM,
+            [libraryVM](const DownloadService::DownloadTask&, const Song& song) {
+                libraryVM->notifySongDownloaded(song);
+            });
     }
 
     //  关键：显式切回“音乐库”页，修复启动落在下载页的问题
@@ -918,10 +1000,53 @@ void MainWindow::setupContentPages()
         m_settingsBtn->setChecked(false);
     }
 
-    qDebug() << "✅ 所有页面已集成完成";
+    qDebug() << "✅ 首屏页面已集成完成（下载管理/设置页延迟到首次打开时构建）";
     qDebug() << "   内容页面总数:" << ui->contentStackedWidget->count();
 }
 
+// ========== 延迟构建页面 ==========
+void MainWindow::ensurePage(int pageIndex)
+{
+    if (!m_app) return;
+
+    if (pageIndex == 1 && !m_downloadManagerPage && m_downloadViewModel) {
+        QElapsedTimer timer;
+        timer.start();
+        m_downloadManagerPage = new DownloadManagerPage(m_downloadViewModel, this);
+        replacePage(1, m_downloadManagerPage);
+
+        if (m_settingsPage) {
+            connect(m_settingsPage, &SettingsPage::settingsChanged,
+                m_downloadManagerPage, &DownloadManagerPage::onSettingsChanged);
+        }
+        qDebug() << "🔧 下载管理页已构建，耗时" << timer.elapsed() << "ms";
+    }
+    else if (pageIndex == 2 && !m_settingsPage) {
+        QElapsedTimer timer;
+        timer.start();
+        m_settingsPage = new SettingsPage(this);
+        replacePage(2, m_settingsPage);
+
+        if (m_downloadManagerPage) {
+            connect(m_settingsPage, &SettingsPage::settingsChanged,
+                m_downloadManagerPage, &DownloadManagerPage::onSettingsChanged);
+        }
+        if (DownloadService* downloadService = m_app->getDownloadService()) {
+            connect(m_settingsPage, &SettingsPage::settingsChanged,
+                downloadService, &DownloadService::refreshConfig);
+        }
+        qDebug() << "🔧 设置页已构建，耗时" << timer.elapsed() << "ms";
+    }
+}
+
+void MainWindow::replacePage(int pageIndex, QWidget* page)
+{
+    QWidget* oldPage = ui->contentStackedWidget->widget(pageIndex);
+    ui->contentStackedWidget->removeWidget(oldPage);
+    if (oldPage) oldPage->deleteLater();
+    ui->contentStackedWidget->insertWidget(pageIndex, page);
+}
+
 void MainWindow::setApp(BiliMusicPlayerApp* app)
 {
     m_app = app;
@@ -930,6 +1055,20 @@ void MainWindow::setApp(BiliMusicPlayerApp* app)
     setupContentPages();
 }
 
+void MainWindow::runThemeSwitchBenchmark(int rounds)
+{
+    // 每个页面都显示一次，让其控件完成首次 polish/布局，模拟用户用过一段时间后的完整窗口
+    const int current = m_currentPageIndex;
+    for (int i = 0; i < ui->contentStackedWidget->count(); ++i) {
+        switchToPage(i);
+        QApplication::processEvents();
+    }
+    switchToPage(current);
+    QApplication::processEvents();
+
+    ThemeBenchmark::run(this, rounds);
+}
+
 void MainWindow::loadThemeFromConfig()
 {
     AppConfig& config = AppConfig::instance();
@@ -954,47 +1093,9 @@ void MainWindow::onThemeChanged(ThemeManager::Theme theme)
 
     qDebug() << "🎨 主题已切换：" << ThemeManager::instance().currentThemeName();
 
+    // 样式表设置在主窗口上，Qt 会随之重新 polish 全部子控件（含各页面与播放栏），
+    // 不再手动逐个 unpolish/polish，否则同一批控件要被处理两遍
     ThemeManager::instance().applyToWidget(this);
 
-    this->style()->unpolish(this);
-    this->style()->polish(this);
-    this->update();
-
-    QList<QWidget*> allWidgets = this->findChildren<QWidget*>();
-    for (QWidget* widget : allWidgets) {
-        if (widget) {
-            widget->style()->unpolish(widget);
-            widget->style()->polish(widget);
-            widget->update();
-        }
-    }
-
-    if (m_downloadManagerPage) {
-        m_downloadManagerPage->style()->unpolish(m_downloadManagerPage);
-        m_downloadManagerPage->style()->polish(m_downloadManagerPage);
-        m_downloadManagerPage->update();
-        qDebug() << "  - 下载管理页面已刷新";
-    }
-    if (m_settingsPage) {
-        m_settingsPage->style()->unpolish(m_settingsPage);
-        m_settingsPage->style()->polish(m_settingsPage);
-        m_settingsPage->update();
-        qDebug() << "  - 设置页面已刷新";
-    }
-    if (m_playbackBar) {
-        m_playbackBar->style()->unpolish(m_playbackBar);
-        m_playbackBar->style()->polish(m_playbackBar);
-        m_playbackBar->update();
-        qDebug() << "  - 播放栏已刷新";
-    }
-    if (m_libraryPage) {
-        m_libraryPage->style()->unpolish(m_libraryPage);
-        m_libraryPage->style()->polish(m_libraryPage);
-        m_libraryPage->update();
-        qDebug() << "  - 音乐库页面已刷新";
-    }
-
-
-
-    qDebug() << "✅ 所有组件已更新主题";
+    qDebug() << "✅ 所有组件已更新主题，耗时" << ThemeManager::instance().lastApplyMs() << "ms";
 }
\ No newline at end of file
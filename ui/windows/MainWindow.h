@@ -28,8 +28,14 @@ public:
 
     void setApp(BiliMusicPlayerApp* app);
 
+    // 主题切换基准：先依次打开所有页面（保证控件树完整），再来回切换主题 rounds 次并输出耗时
+    void runThemeSwitchBenchmark(int rounds);
+
 protected:
     bool eventFilter(QObject* obj, QEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
 
 private slots:
     void onNavigationButtonClicked();
@@ -38,10 +44,13 @@ private slots:
 private:
     void setupTitleBar();
     void setupPlaybackBar();
+    void updatePositionUpdates();
     void setupContentPages();
     void setupStyles();
     void addShadowEffect();
     void switchToPage(int pageIndex);
+    void ensurePage(int pageIndex);
+    void replacePage(int pageIndex, QWidget* page);
     void loadThemeFromConfig();
     QString getEmbeddedStyle() const;
 
@@ -51,14 +60,15 @@ private:
     QPushButton* m_musicLibraryBtn;
     QPushButton* m_downloadManagerBtn;
     QPushButton* m_settingsBtn;
-    PlaybackBar* m_playbackBar;
-    DownloadManagerPage* m_downloadManagerPage;
-    SettingsPage* m_settingsPage;
+    PlaybackBar* m_playbackBar = nullptr;
+    DownloadManagerPage* m_downloadManagerPage = nullptr;   // 首次切换到该页时才构建
+    SettingsPage* m_settingsPage = nullptr;                 // 首次切换到该页时才构建
 	LibraryPage* m_libraryPage=nullptr;
 
     // ViewModel 实例
     DownloadViewModel* m_downloadViewModel = nullptr;
     PlaylistDialog* m_playlistDialog = nullptr;
+    bool m_playlistDialogStale = false;   // 隐藏期间播放列表被整体替换，下次打开时重取
     // 应用实例
     BiliMusicPlayerApp* m_app = nullptr;
 
@@ -6,6 +6,7 @@
 #include <QDesktopServices>
 #include <QUrl>
 #include <QDebug>
+#include <algorithm>
 
 DownloadViewModel::DownloadViewModel(DownloadService* service, QObject* parent)
     : QObject(parent)
@@ -85,40 +86,15 @@ void DownloadViewModel::connectConcurrentSignals()
             info.title = id;
             info.status = "等待中...";
             info.progress = 0.0;
+            info.order = ++m_taskOrderSeq;
             m_taskCache[id] = info;
             emit taskAdded(id);
             qDebug() << "VM: ensureAdded ->" << id;
         }
         };
 
-    connect(&cdm, &ConcurrentDownloadManager::taskAdded, this,
-        [this, ensureAdded](const QString& /*taskId*/, const DownloadTaskState& task) {
-            const QString id = task.getIdentifier();
-            ensureAdded(id);
-            updateStatusText();
-        });
-
-    connect(&cdm, &ConcurrentDownloadManager::taskStarted, this,
-        [this, &cdm, ensureAdded](const QString& taskId) {
-            const QString id = cdm.getTask(taskId).getIdentifier();
-            ensureAdded(id);
-            if (m_taskCache.contains(id)) m_taskCache[id].status = "下载中...";
-            emit taskStarted(id);
-            updateStatusText();
-        });
-
-    connect(&cdm, &ConcurrentDownloadManager::taskProgress, this,
-        [this, &cdm, ensureAdded](const QString& taskId, double progress, const QString& message) {
-            const QString id = cdm.getTask(taskId).getIdentifier();
-            ensureAdded(id);
-            if (m_taskCache.contains(id)) {
-                m_taskCache[id].progress = progress;
-                m_taskCache[id].status = message;
-            }
-            emit taskProgressUpdated(id, progress, message);
-            updateStatusText();
-        });
-
+    // 新增/开始/进度统一由 changesAvailable → syncConcurrentTasksToUI 增量送达（同一事件循环内合并），
+    // 这里不再逐条转发，也不在每个进度包上按 taskId 复制任务；完成/失败仍逐条转发（需要歌曲与错误信息）
     connect(&cdm, &ConcurrentDownloadManager::taskCompleted, this,
         [this, &cdm, ensureAdded](const QString& taskId, const Song& song) {
             QString id = song.getId();
@@ -128,6 +104,7 @@ void DownloadViewModel::connectConcurrentSignals()
                 m_taskCache[id].title = song.getTitle();
                 m_taskCache[id].status = "✅ 完成";
                 m_taskCache[id].progress = 1.0;
+                m_taskCache[id].order = ++m_taskOrderSeq;
             }
             emit taskCompleted(id, song);
             updateStatusText();
@@ -140,6 +117,7 @@ void DownloadViewModel::connectConcurrentSignals()
             if (m_taskCache.contains(id)) {
                 m_taskCache[id].status = "❌ 失败";
                 m_taskCache[id].errorMessage = error;
+                m_taskCache[id].order = ++m_taskOrderSeq;
             }
             emit taskFailed(id, error);
             updateStatusText();
@@ -155,6 +133,13 @@ void DownloadViewModel::connectConcurrentSignals()
             allTasksCompleted();
             updateStatusText();
         });
+
+    // 增量刷新：管理器合并后的变更通知到达时，只拉取上次同步之后的任务
+    connect(&cdm, &ConcurrentDownloadManager::changesAvailable, this,
+        [this](quint64 version) {
+            if (version <= m_syncedVersion) return;
+            syncConcurrentTasksToUI();
+        });
 }
 
 void DownloadViewModel::setCurrentQualityPreset(const QString& preset)
@@ -221,7 +206,9 @@ bool DownloadViewModel::isDownloading() const
 
 QList<DownloadViewModel::TaskInfo> DownloadViewModel::getAllTasks() const
 {
-    return m_taskCache.values();
+    QList<TaskInfo> tasks = m_taskCache.values();
+    std::sort(tasks.begin(), tasks.end(), [](const TaskInfo& a, const TaskInfo& b) { return a.order < b.order; });
+    return tasks;
 }
 
 DownloadViewModel::TaskInfo DownloadViewModel::getTaskInfo(const QString& identifier) const
@@ -256,6 +243,7 @@ void DownloadViewModel::onServiceTaskAdded(const DownloadService::DownloadTask&
     info.title = task.identifier; // 初始标题
     info.status = "等待中...";
     info.progress = 0.0;
+    info.order = ++m_taskOrderSeq;
 
     m_taskCache[task.identifier] = info;
     m_queueSize = m_service->getQueueSize();
@@ -295,7 +283,8 @@ void DownloadViewModel::onServiceTaskCompleted(
     if (m_taskCache.contains(task.identifier)) {
         m_taskCache[task.identifier].title = song.getTitle();
         m_taskCache[task.identifier].status = "✅ 完成";
-        m_taskCache[task.identifier].progress = 100.0;
+        m_taskCache[task.identifier].progress = 1.0;
+        m_taskCache[task.identifier].order = ++m_taskOrderSeq;
     }
 
     m_completedCount = m_service->getCompletedCount();
@@ -314,6 +303,7 @@ void DownloadViewModel::onServiceTaskFailed(
     if (m_taskCache.contains(task.identifier)) {
         m_taskCache[task.identifier].status = "❌ 失败";
         m_taskCache[task.identifier].errorMessage = error;
+        m_taskCache[task.identifier].order = ++m_taskOrderSeq;
     }
 
     m_queueSize = m_service->getQueueSize();
@@ -329,13 +319,15 @@ void DownloadViewModel::onServiceTaskSkipped(const QString& identifier, const So
     updateStatusText();
 }
 
-// 页面打开/切换到“下载队列”时调用，补建并行任务的 UI 条目
+// 页面打开/切换到“下载队列”时调用，并由 changesAvailable 驱动增量刷新，补建并行任务的 UI 条目
+// 只拉取上次同步之后变更过的任务（首次同步时为全部任务）
 void DownloadViewModel::syncConcurrentTasksToUI()
 {
     auto& cdm = ConcurrentDownloadManager::instance();
-    const auto tasks = cdm.getAllTasks();
+    const auto changes = cdm.changesSince(m_syncedVersion);
+    m_syncedVersion = changes.toVersion;
 
-    for (const auto& t : tasks) {
+    for (const auto& t : changes.changed) {
         const QString id = t.getIdentifier();
         if (id.isEmpty()) continue;
 
@@ -345,33 +337,69 @@ void DownloadViewModel::syncConcurrentTasksToUI()
             info.title = id;
             info.status = "等待中...";
             info.progress = 0.0;
+            info.order = ++m_taskOrderSeq;
             m_taskCache[id] = info;
             emit taskAdded(id); // 让 UI 建条目
             qDebug() << "VM: syncConcurrentTasksToUI -> add" << id;
         }
 
-        // 尝试同步状态（可选）
-        if (t.getStatus() == DownloadTaskState::Status::Running) {
-            m_taskCache[id].status = "下载中...";
-            emit taskStarted(id);
-        }
-        else if (t.getStatus() == DownloadTaskState::Status::Retrying
-            || t.getStatus() == DownloadTaskState::Status::Pending) {
-            m_taskCache[id].status = "等待中...";
+        TaskInfo& info = m_taskCache[id];
+        switch (t.getStatus()) {
+        case DownloadTaskState::Status::Running:
+            if (t.getProgress() > 0.0) {
+                info.progress = t.getProgress();
+                if (!t.getCurrentMessage().isEmpty()) info.status = t.getCurrentMessage();
+                emit taskProgressUpdated(id, info.progress, info.status);
+            }
+            else {
+                info.status = "下载中...";
+                emit taskStarted(id);
+            }
+            break;
+        case DownloadTaskState::Status::Retrying:
+        case DownloadTaskState::Status::Pending:
+            info.status = "等待中...";
+            break;
+        default:
+            // 完成/失败已由对应信号送达 UI，这里不重复发出
+            break;
         }
-        // 若 DownloadTaskState 暴露进度，则可取消注释同步当前进度文本
-        // double p = t.getProgress();
-        // QString msg = t.getProgressMessage();
-        // if (p > 0.0) {
-        //     m_taskCache[id].progress = p;
-        //     if (!msg.isEmpty()) m_taskCache[id].status = msg;
-        //     emit taskProgressUpdated(id, p, m_taskCache[id].status);
-        // }
+    }
+
+    if (changes.queueReordered) {
+        applyPendingOrder(changes.pendingOrder);
     }
 
     updateStatusText();
 }
 
+void DownloadViewModel::applyPendingOrder(const QStringList& identifiers)
+{
+    // 这些任务占用的顺序号不变，只按新的先后重新分配，与其它任务的相对位置保持不变
+    QStringList known;
+    QList<quint64> orders;
+    for (const QString& id : identifiers) {
+        auto it = m_taskCache.find(id);
+        if (it == m_taskCache.end()) continue;
+        known << id;
+        orders << it->order;
+    }
+    if (known.size() < 2) return;
+
+    std::sort(orders.begin(), orders.end());
+    bool moved = false;
+    for (int i = 0; i < known.size(); ++i) {
+        TaskInfo& info = m_taskCache[known[i]];
+        if (info.order != orders[i]) {
+            info.order = orders[i];
+            moved = true;
+        }
+    }
+    if (moved) {
+        emit queueReordered(known);
+    }
+}
+
 void DownloadViewModel::updateStatusText()
 {
     auto& cdm = ConcurrentDownloadManager::instance();
@@ -1,7 +1,7 @@
 // viewmodel/DownloadViewModel.h
 #pragma once
 #include <QObject>
-#include <QMap>
+#include <QHash>
 #include "../service/DownloadService.h"
 #include "../common/entities/Song.h"
 
@@ -18,8 +18,9 @@ public:
         QString identifier;
         QString title;
         QString status;
-        double progress;
+        double progress = 0.0;      // 0.0 ~ 1.0
         QString errorMessage;
+        quint64 order = 0;          // 加入时编号，结束时重新编号：未结束的按加入顺序、已结束的按完成顺序
     };
 
     explicit DownloadViewModel(DownloadService* service, QObject* parent = nullptr);
@@ -45,7 +46,7 @@ public:
 
     // === 查询方法 ===
     Q_INVOKABLE bool isDownloading() const;
-    Q_INVOKABLE QList<TaskInfo> getAllTasks() const;
+    Q_INVOKABLE QList<TaskInfo> getAllTasks() const;    // 按 TaskInfo::order 排序
     Q_INVOKABLE TaskInfo getTaskInfo(const QString& identifier) const;
 
     // 配置相关
@@ -69,6 +70,8 @@ signals:
     void taskCompleted(const QString& identifier, const Song& song);
     void taskFailed(const QString& identifier, const QString& error);
     void taskSkipped(const QString& identifier, const Song& existingSong);
+    // 等待中的任务被调整了下载先后（identifiers 为新的先后顺序）
+    void queueReordered(const QStringList& identifiers);
 
     // 批量操作信号
     void allTasksCompleted();
@@ -87,6 +90,8 @@ private slots:
 
 private:
     void updateStatusText();
+    // 按并行下载管理器的待处理队列顺序重排等待中的任务
+    void applyPendingOrder(const QStringList& identifiers);
     void connectServiceSignals();
     // 订阅并行下载管理器的事件并转发给 UI
     void connectConcurrentSignals();
@@ -100,6 +105,10 @@ private:
     int m_completedCount = 0;
     QString m_currentQualityPreset;
 
-    // 任务缓存（用于快速查询）
-    QMap<QString, TaskInfo> m_taskCache;
+    // 任务缓存（用于快速查询）；顺序见 TaskInfo::order
+    QHash<QString, TaskInfo> m_taskCache;
+    quint64 m_taskOrderSeq = 0;
+
+    // 已同步到的并行下载变更版本（见 ConcurrentDownloadManager::changesSince）
+    quint64 m_syncedVersion = 0;
 };
@@ -1,7 +1,10 @@
 // viewmodel/LibraryViewModel.cpp
 #include "LibraryViewModel.h"
+#include "../common/AppConfig.h"
 #include <QDebug>
 
+static const QString kSongViewChannel = QStringLiteral("songView");
+
 LibraryViewModel::LibraryViewModel(QObject* parent)
     : QObject(parent)
     , m_libraryService(new LibraryService(this))
@@ -28,6 +31,22 @@ LibraryViewModel::LibraryViewModel(QObject* parent)
     connect(m_libraryService, &LibraryService::songRemovedFromPlaylist,
         this, &LibraryViewModel::onSongRemovedFromPlaylist);
 
+    connect(m_libraryService, &LibraryService::batchCommitted,
+        this, &LibraryViewModel::onBatchCommitted);
+
+    connect(m_libraryService, &LibraryService::searchIndexReady,
+        this, &LibraryViewModel::searchIndexReady);
+    connect(m_libraryService, &LibraryService::songUpserted,
+        this, &LibraryViewModel::librarySongUpserted);
+    connect(m_libraryService, &LibraryService::songRemoved,
+        this, &LibraryViewModel::librarySongRemoved);
+
+    connect(m_libraryService, &LibraryService::sortByPinyinApplied, this, [this](bool enabled) {
+        // 切换成功：列表里的排序键是按旧方式取出的，重新加载
+        if (enabled == m_requestedSortByPinyin) emit songsChanged();
+        emit sortByPinyinApplied(enabled);
+        });
+
     connect(m_libraryService, &LibraryService::exportCompleted,
         this, &LibraryViewModel::onExportCompleted);
     connect(m_libraryService, &LibraryService::operationFailed,
@@ -55,6 +74,34 @@ QList<Song> LibraryViewModel::searchSongs(const QString& keyword) {
     return m_libraryService->searchSongs(keyword);
 }
 
+QFuture<QList<Song>> LibraryViewModel::getAllSongsAsync() {
+    return m_libraryService->getAllSongsAsync(kSongViewChannel);
+}
+
+QFuture<QList<Song>> LibraryViewModel::searchSongsAsync(const QString& keyword) {
+    return m_libraryService->searchSongsAsync(keyword, kSongViewChannel);
+}
+
+QFuture<QList<Song>> LibraryViewModel::getPlaylistSongsAsync(const QString& playlistId) {
+    return m_libraryService->getPlaylistSongsAsync(playlistId, kSongViewChannel);
+}
+
+QFuture<QList<Song>> LibraryViewModel::searchPlaylistSongsAsync(const QString& playlistId, const QString& keyword) {
+    return m_libraryService->searchPlaylistSongsAsync(playlistId, keyword, kSongViewChannel);
+}
+
+bool LibraryViewModel::isSearchIndexReady() const {
+    return m_libraryService->isSearchIndexReady();
+}
+
+QList<Song> LibraryViewModel::searchSongsIndexed(const QString& keyword, int topK) {
+    return m_libraryService->searchIndexed(keyword, topK);
+}
+
+void LibraryViewModel::notifySongDownloaded(const Song& song) {
+    m_libraryService->notifySongAdded(song);
+}
+
 void LibraryViewModel::updateSong(const QString& id, const QString& title, const QString& artist) {
     qDebug() << "LibraryViewModel: 请求更新歌曲 -" << id;
     m_libraryService->updateSongInfo(id, title, artist);
@@ -67,11 +114,9 @@ void LibraryViewModel::deleteSong(const QString& id) {
 
 void LibraryViewModel::deleteSongs(const QStringList& ids) {
     qDebug() << "LibraryViewModel: 请求批量删除" << ids.size() << "首歌曲";
-    int count = m_libraryService->deleteSongs(ids);
-    if (count > 0) {
-        emit songsDeleted(count);
-        invalidateCache();
-    }
+    // 聚合通知（songsDeleted / songsChanged）由 onBatchCommitted 统一发出
+    LibraryService::BatchScope batch(m_libraryService);
+    m_libraryService->deleteSongs(ids);
 }
 
 void LibraryViewModel::toggleFavorite(const QString& id) {
@@ -132,6 +177,33 @@ bool LibraryViewModel::isSongInPlaylist(const QString& playlistId, const QString
     return m_libraryService->isSongInPlaylist(playlistId, songId);
 }
 
+QHash<QString, int> LibraryViewModel::getPlaylistMembershipCounts(const QStringList& songIds) {
+    return m_libraryService->getPlaylistMembershipCounts(songIds);
+}
+
+// ========== 排序方式 ==========
+
+bool LibraryViewModel::setSortByPinyin(bool enabled) {
+    if (AppConfig::instance().getSortByPinyin() == enabled) return true;
+    if (!m_libraryService->setSortByPinyin(enabled)) return false;
+    m_requestedSortByPinyin = enabled;
+    return true;
+}
+
+// ========== 批量作用域 ==========
+
+void LibraryViewModel::beginBatch() {
+    m_libraryService->beginBatch();
+}
+
+bool LibraryViewModel::commitBatch() {
+    return m_libraryService->commitBatch();
+}
+
+void LibraryViewModel::rollbackBatch() {
+    m_libraryService->rollbackBatch();
+}
+
 // ========== 导出/导入 ==========
 
 void LibraryViewModel::exportPlaylist(const QString& playlistId, const QString& filePath) {
@@ -238,6 +310,33 @@ void LibraryViewModel::onSongRemovedFromPlaylist(const QString& playlistId, cons
     qDebug() << "✅ LibraryViewModel: 歌曲从歌单移除通知已发送";
 }
 
+void LibraryViewModel::onBatchCommitted(const LibraryService::BatchChanges& changes) {
+    emit batchCommitted(changes);
+
+    if (!changes.deletedSongIds.isEmpty()) {
+        emit songsDeleted(changes.deletedSongIds.size());
+    }
+    for (auto it = changes.removedFromPlaylist.constBegin(); it != changes.removedFromPlaylist.constEnd(); ++it) {
+        emit songsRemovedFromPlaylist(it.key(), it.value());
+    }
+    for (auto it = changes.addedToPlaylist.constBegin(); it != changes.addedToPlaylist.constEnd(); ++it) {
+        emit songsAddedToPlaylist(it.key(), it.value());
+    }
+
+    // 每类数据变更只通知一次，视图只需刷新一次
+    if (changes.songsChanged()) {
+        emit songsChanged();
+    }
+    if (!changes.changedPlaylistIds.isEmpty()) {
+        emit playlistsChanged();
+    }
+    if (!changes.deletedSongIds.isEmpty() || !changes.changedPlaylistIds.isEmpty()) {
+        invalidateCache();
+    }
+
+    qDebug() << "✅ LibraryViewModel: 批量变更通知已发送";
+}
+
 void LibraryViewModel::onExportCompleted(bool success, const QString& message) {
     emit exportCompleted(success, message);
     if (success) {
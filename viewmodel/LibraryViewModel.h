@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QList>
+#include <QFuture>
 #include "../service/LibraryService.h"
 #include "../common/entities/Song.h"
 #include "../common/entities/Playlist.h"
@@ -36,6 +37,46 @@ public:
      */
     Q_INVOKABLE QList<Song> searchSongs(const QString& keyword);
 
+    // ========== 异步查询（歌曲列表视图） ==========
+    // 均提交到同一个“歌曲视图”通道：新的查询会取代尚未完成的旧查询
+
+    /**
+     * @brief 异步获取所有歌曲
+     */
+    QFuture<QList<Song>> getAllSongsAsync();
+
+    /**
+     * @brief 异步搜索歌曲
+     */
+    QFuture<QList<Song>> searchSongsAsync(const QString& keyword);
+
+    /**
+     * @brief 异步获取歌单中的歌曲
+     */
+    QFuture<QList<Song>> getPlaylistSongsAsync(const QString& playlistId);
+
+    /**
+     * @brief 异步在歌单内搜索歌曲
+     */
+    QFuture<QList<Song>> searchPlaylistSongsAsync(const QString& playlistId, const QString& keyword);
+
+    // ========== 内存搜索索引 ==========
+
+    /**
+     * @brief 搜索索引是否已构建完成
+     */
+    bool isSearchIndexReady() const;
+
+    /**
+     * @brief 通过内存索引搜索（标题/艺术家/拼音/首字母/罗马字），返回按相关度排序的前 topK 首
+     */
+    QList<Song> searchSongsIndexed(const QString& keyword, int topK);
+
+    /**
+     * @brief 通知新下载入库的歌曲（更新搜索索引）
+     */
+    void notifySongDownloaded(const Song& song);
+
     /**
      * @brief 更新歌曲信息
      */
@@ -113,6 +154,36 @@ public:
      */
     Q_INVOKABLE bool isSongInPlaylist(const QString& playlistId, const QString& songId);
 
+    /**
+     * @brief 每个歌单已包含所给歌曲中的多少首（仅含命中的歌单，内存索引，不访问数据库）
+     */
+    QHash<QString, int> getPlaylistMembershipCounts(const QStringList& songIds);
+
+    // ========== 排序方式 ==========
+
+    /**
+     * @brief 中文标题按拼音排序的开关：后台重算排序键，完成后发出 sortByPinyinApplied 并刷新歌曲列表
+     * @return 上一次切换尚未完成时返回 false
+     */
+    Q_INVOKABLE bool setSortByPinyin(bool enabled);
+
+    // ========== 批量作用域 ==========
+
+    /**
+     * @brief 开始批量作用域：之后的多次变更共用一个事务，且不再逐条发出通知
+     */
+    Q_INVOKABLE void beginBatch();
+
+    /**
+     * @brief 提交批量作用域：提交事务并发出一次聚合的变更通知（songsChanged 等各一次）
+     */
+    Q_INVOKABLE bool commitBatch();
+
+    /**
+     * @brief 放弃批量作用域中的数据库变更
+     */
+    Q_INVOKABLE void rollbackBatch();
+
     // ========== 导出/导入 ==========
 
     /**
@@ -162,6 +233,18 @@ signals:
     // ========== 歌单-歌曲关联信号 ==========
     void songsAddedToPlaylist(const QString& playlistId, int count);
     void songRemovedFromPlaylist(const QString& playlistId, const QString& songId);
+    void songsRemovedFromPlaylist(const QString& playlistId, const QStringList& songIds);
+
+    // ========== 排序方式信号 ==========
+    void sortByPinyinApplied(bool enabled);   // 实际生效的方式（失败时为原来的方式）
+
+    // ========== 批量作用域信号 ==========
+    void batchCommitted(const LibraryService::BatchChanges& changes);
+
+    // ========== 搜索索引信号 ==========
+    void searchIndexReady();
+    void librarySongUpserted(const Song& song);
+    void librarySongRemoved(const QString& id);
 
     // ========== 导出信号 ==========
     void exportCompleted(bool success, const QString& message);
@@ -181,6 +264,7 @@ private slots:
     void onPlaylistCleared(const QString& id);
     void onSongsAddedToPlaylist(const QString& playlistId, int count);
     void onSongRemovedFromPlaylist(const QString& playlistId, const QString& songId);
+    void onBatchCommitted(const LibraryService::BatchChanges& changes);
     void onExportCompleted(bool success, const QString& message);
     void onOperationFailed(const QString& operation, const QString& error);
 
@@ -191,5 +275,7 @@ private:
     mutable int m_cachedSongCount = -1;
     mutable int m_cachedPlaylistCount = -1;
 
+    bool m_requestedSortByPinyin = false;
+
     void invalidateCache();
 };